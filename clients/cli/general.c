@@ -363,15 +363,65 @@ static const NmcMetaGenericInfo *const metagen_general_logging[_NMC_GENERIC_INFO
 
 /*****************************************************************************/
 
+static gconstpointer
+_metagen_general_netlink_get_fcn (const NMMetaEnvironment *environment,
+                                  gpointer environment_user_data,
+                                  const NmcMetaGenericInfo *info,
+                                  gpointer target,
+                                  NMMetaAccessorGetType get_type,
+                                  NMMetaAccessorGetFlags get_flags,
+                                  NMMetaAccessorGetOutFlags *out_flags,
+                                  gpointer *out_to_free)
+{
+	static const char *const keys[_NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_NUM] = {
+		[NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_MESSAGES]     = "messages",
+		[NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_BYTES]        = "bytes",
+		[NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_TRUNCATED]    = "truncated",
+		[NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_OVERFLOWS]    = "overflows",
+		[NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_RESYNCS]      = "resyncs",
+		[NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_PEAK_BACKLOG] = "peak-backlog",
+		[NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_RCVBUF_SIZE]  = "rcvbuf-size",
+		[NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_IP4_ROUTES_FILTERED] = "ip4-routes-filtered",
+		[NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_IP6_ROUTES_FILTERED] = "ip6-routes-filtered",
+	};
+	GVariant *stats = target;
+	guint64 value;
+
+	nm_assert (info->info_type < _NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_NUM);
+
+	NMC_HANDLE_TERMFORMAT (NM_META_TERM_COLOR_NORMAL);
+
+	if (!g_variant_lookup (stats, keys[info->info_type], "t", &value))
+		return NULL;
+	return (*out_to_free = g_strdup_printf ("%"G_GUINT64_FORMAT, value));
+}
+
+static const NmcMetaGenericInfo *const metagen_general_netlink[_NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_NUM + 1] = {
+#define _METAGEN_GENERAL_NETLINK(type, name) \
+	[type] = NMC_META_GENERIC(name, .info_type = type, .get_fcn = _metagen_general_netlink_get_fcn)
+	_METAGEN_GENERAL_NETLINK (NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_MESSAGES,     "MESSAGES"),
+	_METAGEN_GENERAL_NETLINK (NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_BYTES,        "BYTES"),
+	_METAGEN_GENERAL_NETLINK (NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_TRUNCATED,    "TRUNCATED"),
+	_METAGEN_GENERAL_NETLINK (NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_OVERFLOWS,    "OVERFLOWS"),
+	_METAGEN_GENERAL_NETLINK (NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_RESYNCS,      "RESYNCS"),
+	_METAGEN_GENERAL_NETLINK (NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_PEAK_BACKLOG, "PEAK-BACKLOG"),
+	_METAGEN_GENERAL_NETLINK (NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_RCVBUF_SIZE,  "RCVBUF-SIZE"),
+	_METAGEN_GENERAL_NETLINK (NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_IP4_ROUTES_FILTERED, "IP4-ROUTES-FILTERED"),
+	_METAGEN_GENERAL_NETLINK (NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_IP6_ROUTES_FILTERED, "IP6-ROUTES-FILTERED"),
+};
+
+/*****************************************************************************/
+
 static void
 usage_general (void)
 {
 	g_printerr (_("Usage: nmcli general { COMMAND | help }\n\n"
-	              "COMMAND := { status | hostname | permissions | logging }\n\n"
+	              "COMMAND := { status | hostname | permissions | logging | netlink }\n\n"
 	              "  status\n\n"
 	              "  hostname [<hostname>]\n\n"
 	              "  permissions\n\n"
-	              "  logging [level <log level>] [domains <log domains>]\n\n"));
+	              "  logging [level <log level>] [domains <log domains>]\n\n"
+	              "  netlink\n\n"));
 }
 
 static void
@@ -416,6 +466,16 @@ usage_general_logging (void)
 	              "for the list of possible logging domains.\n\n"));
 }
 
+static void
+usage_general_netlink (void)
+{
+	g_printerr (_("Usage: nmcli general netlink { help }\n"
+	              "\n"
+	              "Show the counters of the netlink socket on which NetworkManager receives\n"
+	              "events from the kernel. Growing OVERFLOWS and RESYNCS mean that\n"
+	              "NetworkManager cannot keep up with the kernel.\n\n"));
+}
+
 static void
 usage_networking (void)
 {
@@ -766,6 +826,65 @@ do_general_logging (NmCli *nmc, int argc, char **argv)
 	return nmc->return_value;
 }
 
+static NMCResultCode
+do_general_netlink (NmCli *nmc, int argc, char **argv)
+{
+	gs_free_error GError *error = NULL;
+	gs_unref_object GDBusConnection *dbus_connection = NULL;
+	gs_unref_variant GVariant *ret = NULL;
+	gs_unref_variant GVariant *stats = NULL;
+	const char *fields_str = NULL;
+
+	next_arg (nmc, &argc, &argv, NULL);
+	if (nmc->complete)
+		return nmc->return_value;
+
+	if (argc > 0) {
+		g_string_printf (nmc->return_text, _("Error: invalid extra argument '%s'."), *argv);
+		return NMC_RESULT_ERROR_USER_INPUT;
+	}
+
+	/* libnm has no API for the statistics. Call the method directly. */
+	dbus_connection = g_bus_get_sync (G_BUS_TYPE_SYSTEM, NULL, &error);
+	if (dbus_connection) {
+		ret = g_dbus_connection_call_sync (dbus_connection,
+		                                   NM_DBUS_SERVICE,
+		                                   NM_DBUS_PATH,
+		                                   NM_DBUS_INTERFACE,
+		                                   "GetNetlinkStatistics",
+		                                   NULL,
+		                                   G_VARIANT_TYPE ("(a{st})"),
+		                                   G_DBUS_CALL_FLAGS_NONE,
+		                                   -1,
+		                                   NULL,
+		                                   &error);
+	}
+	if (!ret) {
+		g_dbus_error_strip_remote_error (error);
+		g_string_printf (nmc->return_text, _("Error: failed to get netlink statistics: %s"),
+		                 error->message);
+		return NMC_RESULT_ERROR_UNKNOWN;
+	}
+	g_variant_get (ret, "(@a{st})", &stats);
+
+	if (!nmc->required_fields || strcasecmp (nmc->required_fields, "common") == 0) {
+	} else if (strcasecmp (nmc->required_fields, "all") == 0) {
+	} else
+		fields_str = nmc->required_fields;
+
+	if (!nmc_print (&nmc->nmc_config,
+	                (gpointer const []) { stats, NULL },
+	                _("NetworkManager netlink statistics"),
+	                (const NMMetaAbstractInfo *const*) metagen_general_netlink,
+	                fields_str,
+	                &error)) {
+		g_string_printf (nmc->return_text, _("Error: 'general netlink': %s"), error->message);
+		return NMC_RESULT_ERROR_USER_INPUT;
+	}
+
+	return nmc->return_value;
+}
+
 static void
 save_hostname_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
@@ -817,6 +936,7 @@ static const NMCCommand general_cmds[] = {
 	{ "hostname",     do_general_hostname,     usage_general_hostname,     TRUE,   TRUE },
 	{ "permissions",  do_general_permissions,  usage_general_permissions,  TRUE,   TRUE },
 	{ "logging",      do_general_logging,      usage_general_logging,      TRUE,   TRUE },
+	{ "netlink",      do_general_netlink,      usage_general_netlink,      TRUE,   TRUE },
 	{ NULL,           do_general_status,       usage_general,              TRUE,   TRUE },
 };
 
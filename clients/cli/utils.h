@@ -112,6 +112,17 @@ typedef enum {
 	NMC_GENERIC_INFO_TYPE_GENERAL_LOGGING_DOMAINS,
 	_NMC_GENERIC_INFO_TYPE_GENERAL_LOGGING_NUM,
 
+	NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_MESSAGES = 0,
+	NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_BYTES,
+	NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_TRUNCATED,
+	NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_OVERFLOWS,
+	NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_RESYNCS,
+	NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_PEAK_BACKLOG,
+	NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_RCVBUF_SIZE,
+	NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_IP4_ROUTES_FILTERED,
+	NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_IP6_ROUTES_FILTERED,
+	_NMC_GENERIC_INFO_TYPE_GENERAL_NETLINK_NUM,
+
 	NMC_GENERIC_INFO_TYPE_IP4_CONFIG_ADDRESS = 0,
 	NMC_GENERIC_INFO_TYPE_IP4_CONFIG_GATEWAY,
 	NMC_GENERIC_INFO_TYPE_IP4_CONFIG_ROUTE,
@@ -669,6 +669,52 @@ test_dedup_multi (void)
 	nm_dedup_multi_index_unref (idx);
 }
 
+static void
+test_dedup_multi_many (void)
+{
+	NMDedupMultiIndex *idx;
+	DedupIdxType IDX_20_a_stack;
+	const DedupIdxType *const IDX_20_a = DEDUP_IDX_TYPE_INIT (&IDX_20_a_stack, 20, G_MAXUINT);
+	const NMDedupMultiEntry *entry;
+	const guint N = 5000;
+	guint i, n_round;
+
+	/* add and remove enough objects so that the index has to grow, to
+	 * reuse deleted slots and to shrink again. */
+	idx = nm_dedup_multi_index_new ();
+
+	for (n_round = 0; n_round < 3; n_round++) {
+		for (i = 1; i <= N; i++) {
+			if (n_round > 0 && (i % 2) == 0)
+				continue;
+			g_assert (_dedup_idx_add (idx, IDX_20_a, DEDUP_OBJ_INIT (i, n_round), NM_DEDUP_MULTI_IDX_MODE_APPEND, &entry));
+			g_assert (entry);
+		}
+		g_assert_cmpint (IDX_20_a->parent.len, ==, N);
+
+		for (i = 1; i <= N; i++) {
+			entry = nm_dedup_multi_index_lookup_obj (idx, &IDX_20_a->parent, DEDUP_OBJ_INIT (i, 0));
+			g_assert (entry);
+			g_assert_cmpint (_dedup_entry_assert (entry)->val, ==, i);
+			g_assert (nm_dedup_multi_index_lookup_head (idx, &IDX_20_a->parent, DEDUP_OBJ_INIT (i, 0)) == entry->head);
+		}
+
+		for (i = 1; i <= N; i += 2)
+			g_assert_cmpint (nm_dedup_multi_index_remove_obj (idx, (NMDedupMultiIdxType *) IDX_20_a, DEDUP_OBJ_INIT (i, 0), NULL), ==, 1);
+		g_assert_cmpint (IDX_20_a->parent.len, ==, N / 2);
+
+		for (i = 1; i <= N; i++) {
+			entry = nm_dedup_multi_index_lookup_obj (idx, &IDX_20_a->parent, DEDUP_OBJ_INIT (i, 0));
+			g_assert (!entry == (i % 2 == 1));
+		}
+	}
+
+	g_assert_cmpint (nm_dedup_multi_index_remove_idx (idx, (NMDedupMultiIdxType *) IDX_20_a), ==, N / 2);
+	g_assert (!nm_dedup_multi_index_lookup_head (idx, &IDX_20_a->parent, DEDUP_OBJ_INIT (1, 0)));
+
+	nm_dedup_multi_index_unref (idx);
+}
+
 /*****************************************************************************/
 
 static NMConnection *
@@ -6910,6 +6956,7 @@ int main (int argc, char **argv)
 	g_test_add_func ("/core/general/test_nm_g_slice_free_fcn", test_nm_g_slice_free_fcn);
 	g_test_add_func ("/core/general/test_c_list_sort", test_c_list_sort);
 	g_test_add_func ("/core/general/test_dedup_multi", test_dedup_multi);
+	g_test_add_func ("/core/general/test_dedup_multi_many", test_dedup_multi_many);
 	g_test_add_func ("/core/general/test_utils_str_utf8safe", test_utils_str_utf8safe);
 	g_test_add_func ("/core/general/test_nm_utils_strsplit_set", test_nm_utils_strsplit_set);
 	g_test_add_func ("/core/general/test_nm_in_set", test_nm_in_set);
@@ -25,6 +25,340 @@
 
 #include "nm-hash-utils.h"
 
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*****************************************************************************/
+
+/* DedupTable is an open-addressing hash set of pointers, used for the two
+ * dictionaries of NMDedupMultiIndex.
+ *
+ * It follows the SwissTable layout: next to the array of slots there is
+ * one control byte per slot. A control byte is either EMPTY, DELETED
+ * (a tombstone) or holds the lowest 7 bits of the hash of the value in the
+ * slot. A lookup scans a whole group of control bytes at once (16 with
+ * SSE2, 8 otherwise) and only calls the equal function for slots whose hash
+ * matches. Compared to GHashTable, the values are stored inline, so that a
+ * lookup does not chase pointers to the nodes. */
+
+#define DEDUP_TABLE_CTRL_EMPTY    ((guint8) 0x80)
+#define DEDUP_TABLE_CTRL_DELETED  ((guint8) 0xFE)
+
+#define DEDUP_TABLE_MIN_CAPACITY  16u
+
+#if defined (__SSE2__)
+
+#define DEDUP_TABLE_GROUP_SIZE    16u
+
+typedef guint32 DedupGroupMask;
+
+static inline DedupGroupMask
+_dedup_group_match (const guint8 *ctrl, guint8 h2)
+{
+	return _mm_movemask_epi8 (_mm_cmpeq_epi8 (_mm_set1_epi8 ((char) h2),
+	                                          _mm_loadu_si128 ((const __m128i *) ctrl)));
+}
+
+static inline DedupGroupMask
+_dedup_group_match_empty (const guint8 *ctrl)
+{
+	return _dedup_group_match (ctrl, DEDUP_TABLE_CTRL_EMPTY);
+}
+
+static inline DedupGroupMask
+_dedup_group_match_empty_or_deleted (const guint8 *ctrl)
+{
+	/* EMPTY and DELETED are the control bytes with the high bit set. */
+	return _mm_movemask_epi8 (_mm_loadu_si128 ((const __m128i *) ctrl));
+}
+
+static inline guint
+_dedup_group_mask_next (DedupGroupMask *mask)
+{
+	guint i;
+
+	nm_assert (*mask);
+
+	i = __builtin_ctz (*mask);
+	*mask &= *mask - 1;
+	return i;
+}
+
+#else /* !__SSE2__ */
+
+/* the portable variant checks 8 control bytes at once in a 64 bit word.
+ * The mask has the high bit of each matching byte set. */
+
+#define DEDUP_TABLE_GROUP_SIZE    8u
+
+#define DEDUP_GROUP_LSBS          G_GUINT64_CONSTANT (0x0101010101010101)
+#define DEDUP_GROUP_MSBS          G_GUINT64_CONSTANT (0x8080808080808080)
+
+typedef guint64 DedupGroupMask;
+
+static inline guint64
+_dedup_group_load (const guint8 *ctrl)
+{
+	guint64 v;
+
+	memcpy (&v, ctrl, sizeof (v));
+	return GUINT64_FROM_LE (v);
+}
+
+static inline DedupGroupMask
+_dedup_group_match (const guint8 *ctrl, guint8 h2)
+{
+	guint64 x = _dedup_group_load (ctrl) ^ (DEDUP_GROUP_LSBS * h2);
+
+	/* this can yield false positives, but only for full slots next to a
+	 * real match. The caller compares the full hash anyway. */
+	return (x - DEDUP_GROUP_LSBS) & ~x & DEDUP_GROUP_MSBS;
+}
+
+static inline DedupGroupMask
+_dedup_group_match_empty (const guint8 *ctrl)
+{
+	guint64 v = _dedup_group_load (ctrl);
+
+	/* EMPTY is the only control byte with the high bit set and bit 1 unset. */
+	return v & (~v << 6) & DEDUP_GROUP_MSBS;
+}
+
+static inline DedupGroupMask
+_dedup_group_match_empty_or_deleted (const guint8 *ctrl)
+{
+	return _dedup_group_load (ctrl) & DEDUP_GROUP_MSBS;
+}
+
+static inline guint
+_dedup_group_mask_next (DedupGroupMask *mask)
+{
+	guint i;
+
+	nm_assert (*mask);
+
+	i = __builtin_ctzll (*mask) >> 3;
+	*mask &= *mask - 1;
+	return i;
+}
+
+#endif /* __SSE2__ */
+
+typedef struct {
+	/* one allocation for the slots, the full hashes and the control bytes. */
+	gpointer *slots;
+	guint *hashes;
+	guint8 *ctrl;
+
+	/* zero or a power of two, not less than DEDUP_TABLE_MIN_CAPACITY. */
+	guint capacity;
+	guint n_used;
+	guint n_deleted;
+
+	GHashFunc hash_func;
+	GEqualFunc equal_func;
+} DedupTable;
+
+static void
+_dedup_table_init (DedupTable *t, GHashFunc hash_func, GEqualFunc equal_func)
+{
+	memset (t, 0, sizeof (*t));
+	t->hash_func = hash_func;
+	t->equal_func = equal_func;
+}
+
+static void
+_dedup_table_alloc (DedupTable *t, guint capacity)
+{
+	nm_assert (capacity >= DEDUP_TABLE_MIN_CAPACITY);
+	nm_assert (nm_utils_is_power_of_two (capacity));
+
+	t->slots = g_malloc (capacity * (sizeof (gpointer) + sizeof (guint) + 1));
+	t->hashes = (guint *) &t->slots[capacity];
+	t->ctrl = (guint8 *) &t->hashes[capacity];
+	memset (t->ctrl, DEDUP_TABLE_CTRL_EMPTY, capacity);
+	t->capacity = capacity;
+	t->n_used = 0;
+	t->n_deleted = 0;
+}
+
+static guint
+_dedup_table_find_free (const DedupTable *t, guint hash)
+{
+	const guint group_mask = (t->capacity / DEDUP_TABLE_GROUP_SIZE) - 1;
+	guint g, stride;
+
+	/* triangular probing over the groups visits each group once. */
+	g = (hash >> 7) & group_mask;
+	for (stride = 1; ; stride++) {
+		DedupGroupMask m;
+
+		m = _dedup_group_match_empty_or_deleted (&t->ctrl[g * DEDUP_TABLE_GROUP_SIZE]);
+		if (m)
+			return (g * DEDUP_TABLE_GROUP_SIZE) + _dedup_group_mask_next (&m);
+		nm_assert (stride <= group_mask);
+		g = (g + stride) & group_mask;
+	}
+}
+
+static void
+_dedup_table_set (DedupTable *t, guint i, guint hash, gpointer value)
+{
+	t->slots[i] = value;
+	t->hashes[i] = hash;
+	t->ctrl[i] = hash & 0x7F;
+}
+
+static void
+_dedup_table_resize (DedupTable *t, guint n_needed)
+{
+	gpointer *old_slots = t->slots;
+	const guint8 *old_ctrl = t->ctrl;
+	const guint *old_hashes = t->hashes;
+	guint old_capacity = t->capacity;
+	guint capacity;
+	guint i;
+
+	/* after resizing, the table is at most half full. That also drops
+	 * all tombstones. */
+	capacity = DEDUP_TABLE_MIN_CAPACITY;
+	while (capacity / 2 < n_needed)
+		capacity *= 2;
+
+	_dedup_table_alloc (t, capacity);
+	for (i = 0; i < old_capacity; i++) {
+		if (old_ctrl[i] & 0x80)
+			continue;
+		_dedup_table_set (t,
+		                  _dedup_table_find_free (t, old_hashes[i]),
+		                  old_hashes[i],
+		                  old_slots[i]);
+		t->n_used++;
+	}
+	g_free (old_slots);
+}
+
+static gpointer *
+_dedup_table_lookup_slot (const DedupTable *t, gconstpointer key)
+{
+	guint group_mask;
+	guint hash;
+	guint8 h2;
+	guint g, stride;
+
+	if (t->n_used == 0)
+		return NULL;
+
+	hash = t->hash_func (key);
+	h2 = hash & 0x7F;
+	group_mask = (t->capacity / DEDUP_TABLE_GROUP_SIZE) - 1;
+	g = (hash >> 7) & group_mask;
+	for (stride = 1; ; stride++) {
+		const guint8 *ctrl = &t->ctrl[g * DEDUP_TABLE_GROUP_SIZE];
+		DedupGroupMask m;
+
+		m = _dedup_group_match (ctrl, h2);
+		while (m) {
+			guint i = (g * DEDUP_TABLE_GROUP_SIZE) + _dedup_group_mask_next (&m);
+
+			if (   t->hashes[i] == hash
+			    && t->equal_func (t->slots[i], key))
+				return &t->slots[i];
+		}
+		if (_dedup_group_match_empty (ctrl))
+			return NULL;
+		if (stride > group_mask)
+			return NULL;
+		g = (g + stride) & group_mask;
+	}
+}
+
+static gpointer
+_dedup_table_lookup (const DedupTable *t, gconstpointer key)
+{
+	gpointer *slot;
+
+	slot = _dedup_table_lookup_slot (t, key);
+	return slot ? *slot : NULL;
+}
+
+static void
+_dedup_table_add (DedupTable *t, gpointer value)
+{
+	guint hash;
+	guint i;
+
+	nm_assert (value);
+	nm_assert (!_dedup_table_lookup (t, value));
+
+	/* keep the load (including tombstones) below 7/8, so that every
+	 * probe sequence ends at an EMPTY control byte. */
+	if ((t->n_used + t->n_deleted + 1) > t->capacity / 8 * 7)
+		_dedup_table_resize (t, t->n_used + 1);
+
+	hash = t->hash_func (value);
+	i = _dedup_table_find_free (t, hash);
+	if (t->ctrl[i] == DEDUP_TABLE_CTRL_DELETED)
+		t->n_deleted--;
+	_dedup_table_set (t, i, hash, value);
+	t->n_used++;
+}
+
+static gboolean
+_dedup_table_remove (DedupTable *t, gconstpointer value)
+{
+	gpointer *slot;
+	guint i;
+
+	slot = _dedup_table_lookup_slot (t, value);
+	if (!slot)
+		return FALSE;
+
+	i = slot - t->slots;
+
+	/* if the group still has an EMPTY slot, it was never full. Then no
+	 * probe sequence went past this group, and the slot can become EMPTY
+	 * again instead of a tombstone. */
+	if (_dedup_group_match_empty (&t->ctrl[i / DEDUP_TABLE_GROUP_SIZE * DEDUP_TABLE_GROUP_SIZE]))
+		t->ctrl[i] = DEDUP_TABLE_CTRL_EMPTY;
+	else {
+		t->ctrl[i] = DEDUP_TABLE_CTRL_DELETED;
+		t->n_deleted++;
+	}
+	t->slots[i] = NULL;
+	t->n_used--;
+
+	if (   t->capacity > DEDUP_TABLE_MIN_CAPACITY
+	    && t->n_used < t->capacity / 8)
+		_dedup_table_resize (t, t->n_used);
+	return TRUE;
+}
+
+static gboolean
+_dedup_table_iter_next (const DedupTable *t, guint *iter, gpointer *out_value)
+{
+	for (; *iter < t->capacity; (*iter)++) {
+		if (!(t->ctrl[*iter] & 0x80)) {
+			*out_value = t->slots[(*iter)++];
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+static void
+_dedup_table_destroy (DedupTable *t)
+{
+	g_free (t->slots);
+	t->slots = NULL;
+	t->hashes = NULL;
+	t->ctrl = NULL;
+	t->capacity = 0;
+	t->n_used = 0;
+	t->n_deleted = 0;
+}
+
 /*****************************************************************************/
 
 typedef struct {
@@ -43,8 +377,8 @@ typedef struct {
 
 struct _NMDedupMultiIndex {
 	int ref_count;
-	GHashTable *idx_entries;
-	GHashTable *idx_objs;
+	DedupTable idx_entries;
+	DedupTable idx_objs;
 };
 
 /*****************************************************************************/
@@ -90,7 +424,7 @@ _entry_lookup_obj (const NMDedupMultiIndex *self,
 	};
 
 	ASSERT_idx_type (idx_type);
-	return g_hash_table_lookup (self->idx_entries, &stack_entry);
+	return _dedup_table_lookup (&self->idx_entries, &stack_entry);
 }
 
 static NMDedupMultiHeadEntry *
@@ -114,11 +448,11 @@ _entry_lookup_head (const NMDedupMultiIndex *self,
 			nm_assert (c_list_length (&idx_type->lst_idx_head) == 1);
 			head_entry = c_list_entry (idx_type->lst_idx_head.next, NMDedupMultiHeadEntry, lst_idx);
 		}
-		nm_assert (head_entry == g_hash_table_lookup (self->idx_entries, &stack_entry));
+		nm_assert (head_entry == _dedup_table_lookup (&self->idx_entries, &stack_entry));
 		return head_entry;
 	}
 
-	return g_hash_table_lookup (self->idx_entries, &stack_entry);
+	return _dedup_table_lookup (&self->idx_entries, &stack_entry);
 }
 
 static void
@@ -385,12 +719,10 @@ _add (NMDedupMultiIndex *self,
 	idx_type->len++;
 	head_entry->len++;
 
-	if (   add_head_entry
-	    && !nm_g_hash_table_add (self->idx_entries, head_entry))
-		nm_assert_not_reached ();
+	if (add_head_entry)
+		_dedup_table_add (&self->idx_entries, head_entry);
 
-	if (!nm_g_hash_table_add (self->idx_entries, entry))
-		nm_assert_not_reached ();
+	_dedup_table_add (&self->idx_entries, entry);
 
 	NM_SET_OUT (out_entry, entry);
 	NM_SET_OUT (out_obj_old, NULL);
@@ -513,14 +845,14 @@ _remove_entry (NMDedupMultiIndex *self,
 	nm_assert (entry->obj);
 	nm_assert (entry->head);
 	nm_assert (!c_list_is_empty (&entry->lst_entries));
-	nm_assert (g_hash_table_lookup (self->idx_entries, entry) == entry);
+	nm_assert (_dedup_table_lookup (&self->idx_entries, entry) == entry);
 
 	head_entry = (NMDedupMultiHeadEntry *) entry->head;
 	obj = entry->obj;
 
 	nm_assert (head_entry);
 	nm_assert (head_entry->len > 0);
-	nm_assert (g_hash_table_lookup (self->idx_entries, head_entry) == head_entry);
+	nm_assert (_dedup_table_lookup (&self->idx_entries, head_entry) == head_entry);
 
 	idx_type = (NMDedupMultiIdxType *) head_entry->idx_type;
 	ASSERT_idx_type (idx_type);
@@ -534,11 +866,11 @@ _remove_entry (NMDedupMultiIndex *self,
 
 	NM_SET_OUT (out_head_entry_removed, head_entry != NULL);
 
-	if (!g_hash_table_remove (self->idx_entries, entry))
+	if (!_dedup_table_remove (&self->idx_entries, entry))
 		nm_assert_not_reached ();
 
 	if (   head_entry
-	    && !g_hash_table_remove (self->idx_entries, head_entry))
+	    && !_dedup_table_remove (&self->idx_entries, head_entry))
 		nm_assert_not_reached ();
 
 	c_list_unlink_stale (&entry->lst_entries);
@@ -567,7 +899,7 @@ _remove_head (NMDedupMultiIndex *self,
 	nm_assert (head_entry);
 	nm_assert (head_entry->len > 0);
 	nm_assert (head_entry->len == c_list_length (&head_entry->lst_entries_head));
-	nm_assert (g_hash_table_lookup (self->idx_entries, head_entry) == head_entry);
+	nm_assert (_dedup_table_lookup (&self->idx_entries, head_entry) == head_entry);
 
 	n = 0;
 	c_list_for_each_safe (iter_entry, iter_entry_safe, &head_entry->lst_entries_head) {
@@ -819,11 +1151,11 @@ nm_dedup_multi_index_obj_release (NMDedupMultiIndex *self,
 {
 	nm_assert (self);
 	nm_assert (obj);
-	nm_assert (g_hash_table_lookup (self->idx_objs, obj) == obj);
+	nm_assert (_dedup_table_lookup (&self->idx_objs, obj) == obj);
 	nm_assert (((const NMDedupMultiObj *) obj)->_multi_idx == self);
 
 	((NMDedupMultiObj *) obj)->_multi_idx = NULL;
-	if (!g_hash_table_remove (self->idx_objs, obj))
+	if (!_dedup_table_remove (&self->idx_objs, obj))
 		nm_assert_not_reached ();
 }
 
@@ -834,7 +1166,7 @@ nm_dedup_multi_index_obj_find (NMDedupMultiIndex *self,
 	g_return_val_if_fail (self, NULL);
 	g_return_val_if_fail (obj, NULL);
 
-	return g_hash_table_lookup (self->idx_objs, obj);
+	return _dedup_table_lookup (&self->idx_objs, obj);
 }
 
 gconstpointer
@@ -848,12 +1180,12 @@ nm_dedup_multi_index_obj_intern (NMDedupMultiIndex *self,
 	nm_assert (obj_new);
 
 	if (obj_new->_multi_idx == self) {
-		nm_assert (g_hash_table_lookup (self->idx_objs, obj_new) == obj_new);
+		nm_assert (_dedup_table_lookup (&self->idx_objs, obj_new) == obj_new);
 		nm_dedup_multi_obj_ref (obj_new);
 		return obj_new;
 	}
 
-	obj_old = g_hash_table_lookup (self->idx_objs, obj_new);
+	obj_old = _dedup_table_lookup (&self->idx_objs, obj_new);
 	nm_assert (obj_old != obj_new);
 
 	if (obj_old) {
@@ -870,8 +1202,7 @@ nm_dedup_multi_index_obj_intern (NMDedupMultiIndex *self,
 	nm_assert (obj_new);
 	nm_assert (!obj_new->_multi_idx);
 
-	if (!nm_g_hash_table_add (self->idx_objs, (gpointer) obj_new))
-		nm_assert_not_reached ();
+	_dedup_table_add (&self->idx_objs, (gpointer) obj_new);
 
 	((NMDedupMultiObj *) obj_new)->_multi_idx = self;
 	return obj_new;
@@ -1066,8 +1397,8 @@ nm_dedup_multi_index_new (void)
 
 	self = g_slice_new0 (NMDedupMultiIndex);
 	self->ref_count = 1;
-	self->idx_entries = g_hash_table_new ((GHashFunc) _dict_idx_entries_hash, (GEqualFunc) _dict_idx_entries_equal);
-	self->idx_objs    = g_hash_table_new ((GHashFunc) _dict_idx_objs_hash,    (GEqualFunc) _dict_idx_objs_equal);
+	_dedup_table_init (&self->idx_entries, (GHashFunc) _dict_idx_entries_hash, (GEqualFunc) _dict_idx_entries_equal);
+	_dedup_table_init (&self->idx_objs,    (GHashFunc) _dict_idx_objs_hash,    (GEqualFunc) _dict_idx_objs_equal);
 	return self;
 }
 
@@ -1084,7 +1415,7 @@ nm_dedup_multi_index_ref (NMDedupMultiIndex *self)
 NMDedupMultiIndex *
 nm_dedup_multi_index_unref (NMDedupMultiIndex *self)
 {
-	GHashTableIter iter;
+	guint iter;
 	const NMDedupMultiIdxType *idx_type;
 	NMDedupMultiEntry *entry;
 	const NMDedupMultiObj *obj;
@@ -1096,8 +1427,8 @@ nm_dedup_multi_index_unref (NMDedupMultiIndex *self)
 		return NULL;
 
 more:
-	g_hash_table_iter_init (&iter, self->idx_entries);
-	while (g_hash_table_iter_next (&iter, (gpointer *) &entry, NULL)) {
+	iter = 0;
+	while (_dedup_table_iter_next (&self->idx_entries, &iter, (gpointer *) &entry)) {
 		if (entry->is_head)
 			idx_type = ((NMDedupMultiHeadEntry *) entry)->idx_type;
 		else
@@ -1106,17 +1437,16 @@ more:
 		goto more;
 	}
 
-	nm_assert (g_hash_table_size (self->idx_entries) == 0);
+	nm_assert (self->idx_entries.n_used == 0);
 
-	g_hash_table_iter_init (&iter, self->idx_objs);
-	while (g_hash_table_iter_next (&iter, (gpointer *) &obj, NULL)) {
+	iter = 0;
+	while (_dedup_table_iter_next (&self->idx_objs, &iter, (gpointer *) &obj)) {
 		nm_assert (obj->_multi_idx == self);
 		((NMDedupMultiObj * )obj)->_multi_idx = NULL;
 	}
-	g_hash_table_remove_all (self->idx_objs);
 
-	g_hash_table_unref (self->idx_entries);
-	g_hash_table_unref (self->idx_objs);
+	_dedup_table_destroy (&self->idx_entries);
+	_dedup_table_destroy (&self->idx_objs);
 
 	g_slice_free (NMDedupMultiIndex, self);
 	return NULL;
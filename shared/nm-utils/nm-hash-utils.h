@@ -48,6 +48,16 @@ nm_hash_complete (NMHashState *state)
 	return (((guint) (h >> 32)) ^ ((guint) h)) ?: 1396707757u;
 }
 
+static inline guint64
+nm_hash_complete_u64 (NMHashState *state)
+{
+	nm_assert (state);
+
+	/* like nm_hash_complete(), but returns the full 64 bit. Unlike
+	 * nm_hash_complete(), this may return zero. */
+	return siphash24_finalize (&state->_state);
+}
+
 static inline void
 nm_hash_update (NMHashState *state, const void *ptr, gsize n)
 {
@@ -220,6 +220,15 @@ typedef struct _NMDevicePrivate {
 	guint device_link_changed_id;
 	guint device_ip_link_changed_id;
 
+	/* with a coalescing window on the platform, the device subscribes to
+	 * the change sets of its ifindex and ip-ifindex instead of connecting
+	 * to the platform signals. */
+	bool platform_changes_coalesced:1;
+	struct {
+		NMPlatformChangesSubscription *subscription;
+		int ifindex;
+	} platform_changes[2];
+
 	NMDeviceState state;
 	NMDeviceStateReason state_reason;
 	struct {
@@ -326,6 +335,15 @@ typedef struct _NMDevicePrivate {
 	guint32 mtu_initial;
 	guint32 ip6_mtu_initial;
 
+	/* while an asynchronous change of the MTU is in progress, the IPv6 MTU
+	 * waits for it. If the MTU must be committed again in the meantime,
+	 * that happens after the change completes. */
+	struct {
+		guint32 ip6_mtu;
+		bool pending:1;
+		bool commit_again:1;
+	} mtu_async;
+
 	guint32         v4_route_table;
 	guint32         v6_route_table;
 
@@ -379,6 +397,22 @@ typedef struct _NMDevicePrivate {
 	NMIP4Config *   wwan_ip4_config; /* WWAN configuration */
 	GSList *        vpn4_configs;   /* VPNs which use this device */
 
+	/* The last composite built by ip4_config_merge_and_apply(), keyed by
+	 * a hash over the versions of the configs it was merged from. This
+	 * only helps when no input changed at all, the change of any input
+	 * rebuilds the composite from all of them. */
+	struct {
+		NMIP4Config *composite;
+		GPtrArray *  dev_route_blacklist;
+		guint64      inputs_hash;
+		guint64      composite_version;
+	} ip4_merge_cache;
+
+	/* The versions of the last config that replaced the content of
+	 * @ip4_config, and of @ip4_config right after that. */
+	guint64 ip4_config_replaced_from_version;
+	guint64 ip4_config_replaced_version;
+
 	bool v4_has_shadowed_routes;
 	const char *ip4_rp_filter;
 
@@ -434,6 +468,14 @@ typedef struct _NMDevicePrivate {
 	NMIP6Config *  ext_ip6_config; /* Stuff added outside NM */
 	NMIP6Config *  ext_ip6_config_captured; /* Configuration captured from platform. */
 	GSList *       vpn6_configs;   /* VPNs which use this device */
+
+	struct {
+		NMIP6Config *composite;
+		guint64      inputs_hash;
+		guint64      composite_version;
+	} ip6_merge_cache;
+	guint64        ip6_config_replaced_from_version;
+	guint64        ip6_config_replaced_version;
 	bool           nm_ipv6ll; /* TRUE if NM handles the device's IPv6LL address */
 	NMIP6Config *  dad6_ip6_config;
 
@@ -492,7 +534,7 @@ typedef struct _NMDevicePrivate {
 	guint check_delete_unrealized_id;
 
 	struct {
-		guint timeout_id;
+		NMPlatformLinkStatsSubscription *subscription;
 		guint refresh_rate_ms;
 		guint64 tx_bytes;
 		guint64 rx_bytes;
@@ -542,6 +584,7 @@ static void _set_state_full (NMDevice *self,
                              gboolean quitting);
 static void queued_state_clear (NMDevice *device);
 static gboolean queued_ip4_config_change (gpointer user_data);
+static void _platform_changes_sync (NMDevice *self);
 static gboolean queued_ip6_config_change (gpointer user_data);
 static void ip_check_ping_watch_cb (GPid pid, gint status, gpointer user_data);
 static gboolean ip_config_valid (NMDeviceState state);
@@ -556,6 +599,7 @@ static void realize_start_setup (NMDevice *self,
                                  NMUnmanFlagOp unmanaged_user_explicit);
 static void _set_mtu (NMDevice *self, guint32 mtu);
 static void _commit_mtu (NMDevice *self, const NMIP4Config *config);
+static gboolean bring_up_finish (NMDevice *self, int ifindex, gboolean block);
 static void dhcp_schedule_restart (NMDevice *self, int addr_family, const char *reason);
 static void _cancel_activation (NMDevice *self);
 
@@ -825,30 +869,19 @@ nm_device_assume_state_reset (NMDevice *self)
 
 /*****************************************************************************/
 
-static void
-init_ip4_config_dns_priority (NMDevice *self, NMIP4Config *config)
-{
-	gs_free char *value = NULL;
-	gint priority;
-
-	value = nm_config_data_get_connection_default (NM_CONFIG_GET_DATA,
-	                                               "ipv4.dns-priority",
-	                                               self);
-	priority = _nm_utils_ascii_str_to_int64 (value, 10, G_MININT, G_MAXINT, 0);
-	nm_ip4_config_set_dns_priority (config, priority ?: NM_DNS_PRIORITY_DEFAULT_NORMAL);
-}
-
-static void
-init_ip6_config_dns_priority (NMDevice *self, NMIP6Config *config)
+static gint
+get_ip_config_dns_priority (NMDevice *self, int addr_family)
 {
 	gs_free char *value = NULL;
 	gint priority;
 
 	value = nm_config_data_get_connection_default (NM_CONFIG_GET_DATA,
-	                                               "ipv6.dns-priority",
+	                                                 addr_family == AF_INET
+	                                               ? "ipv4.dns-priority"
+	                                               : "ipv6.dns-priority",
 	                                               self);
 	priority = _nm_utils_ascii_str_to_int64 (value, 10, G_MININT, G_MAXINT, 0);
-	nm_ip6_config_set_dns_priority (config, priority ?: NM_DNS_PRIORITY_DEFAULT_NORMAL);
+	return priority ?: NM_DNS_PRIORITY_DEFAULT_NORMAL;
 }
 
 /*****************************************************************************/
@@ -1111,6 +1144,7 @@ nm_device_take_over_link (NMDevice *self, const char *ifname, gboolean *renamed)
 
 	if (success) {
 		priv->ifindex = ifindex;
+		_platform_changes_sync (self);
 		_notify (self, PROP_IFINDEX);
 	}
 
@@ -1241,6 +1275,7 @@ nm_device_set_ip_iface (NMDevice *self, const char *iface)
 	/* We don't care about any saved values from the old iface */
 	g_hash_table_remove_all (priv->ip6_saved_properties);
 
+	_platform_changes_sync (self);
 	_notify (self, PROP_IP_IFACE);
 	return TRUE;
 }
@@ -1423,23 +1458,53 @@ _stats_update_counters (NMDevice *self,
 static void
 _stats_update_counters_from_pllink (NMDevice *self, const NMPlatformLink *pllink)
 {
+	/* While subscribed, the counters come from the periodic RTM_GETSTATS
+	 * request. The counters of the cached link are only updated by link
+	 * events and might be older, so they would make the statistics go
+	 * backwards. */
+	if (NM_DEVICE_GET_PRIVATE (self)->stats.subscription)
+		return;
+
 	_stats_update_counters (self, pllink->tx_bytes, pllink->rx_bytes);
 }
 
-static gboolean
-_stats_timeout_cb (gpointer user_data)
+static void
+_stats_collected_cb (NMPlatform *platform,
+                     const GArray *stats,
+                     gpointer user_data)
 {
 	NMDevice *self = user_data;
-	int ifindex;
+	const NMPlatformLinkStats *s;
 
-	ifindex = nm_device_get_ip_ifindex (self);
+	s = nm_platform_link_stats_lookup (stats, nm_device_get_ip_ifindex (self));
+	if (s)
+		_stats_update_counters (self, s->tx_bytes, s->rx_bytes);
+}
 
-	_LOGT (LOGD_DEVICE, "stats: refresh %d", ifindex);
+static void
+_stats_subscribe (NMDevice *self, guint refresh_rate_ms)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
 
-	if (ifindex > 0)
-		nm_platform_link_refresh (nm_device_get_platform (self), ifindex);
+	nm_assert (!priv->stats.subscription);
+
+	/* the platform fetches the counters of all devices with the same
+	 * refresh rate at once. */
+	priv->stats.subscription = nm_platform_link_stats_subscribe (nm_device_get_platform (self),
+	                                                             refresh_rate_ms,
+	                                                             _stats_collected_cb,
+	                                                             self);
+}
+
+static void
+_stats_unsubscribe (NMDevice *self)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
 
-	return G_SOURCE_CONTINUE;
+	if (priv->stats.subscription) {
+		nm_platform_link_stats_unsubscribe (nm_device_get_platform (self),
+		                                    g_steal_pointer (&priv->stats.subscription));
+	}
 }
 
 static guint
@@ -1484,7 +1549,7 @@ _stats_set_refresh_rate (NMDevice *self, guint refresh_rate_ms)
 	if (_stats_refresh_rate_real (old_rate) == refresh_rate_ms)
 		return;
 
-	nm_clear_g_source (&priv->stats.timeout_id);
+	_stats_unsubscribe (self);
 
 	if (!refresh_rate_ms)
 		return;
@@ -1496,7 +1561,7 @@ _stats_set_refresh_rate (NMDevice *self, guint refresh_rate_ms)
 	if (ifindex > 0)
 		nm_platform_link_refresh (nm_device_get_platform (self), ifindex);
 
-	priv->stats.timeout_id = g_timeout_add (refresh_rate_ms, _stats_timeout_cb, self);
+	_stats_subscribe (self, refresh_rate_ms);
 }
 
 /*****************************************************************************/
@@ -2848,20 +2913,9 @@ device_ip_link_changed (NMDevice *self)
 }
 
 static void
-link_changed_cb (NMPlatform *platform,
-                 int obj_type_i,
-                 int ifindex,
-                 NMPlatformLink *info,
-                 int change_type_i,
-                 NMDevice *self)
+_link_changed_queue (NMDevice *self, int ifindex)
 {
-	const NMPlatformSignalChangeType change_type = change_type_i;
-	NMDevicePrivate *priv;
-
-	if (change_type != NM_PLATFORM_SIGNAL_CHANGED)
-		return;
-
-	priv = NM_DEVICE_GET_PRIVATE (self);
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
 
 	if (ifindex == nm_device_get_ifindex (self)) {
 		if (!priv->device_link_changed_id) {
@@ -2876,6 +2930,22 @@ link_changed_cb (NMPlatform *platform,
 	}
 }
 
+static void
+link_changed_cb (NMPlatform *platform,
+                 int obj_type_i,
+                 int ifindex,
+                 NMPlatformLink *info,
+                 int change_type_i,
+                 NMDevice *self)
+{
+	const NMPlatformSignalChangeType change_type = change_type_i;
+
+	if (change_type != NM_PLATFORM_SIGNAL_CHANGED)
+		return;
+
+	_link_changed_queue (self, ifindex);
+}
+
 /*****************************************************************************/
 
 typedef struct {
@@ -3204,6 +3274,7 @@ nm_device_update_from_platform_link (NMDevice *self, const NMPlatformLink *plink
 	ifindex = plink ? plink->ifindex : 0;
 	if (priv->ifindex != ifindex) {
 		priv->ifindex = ifindex;
+		_platform_changes_sync (self);
 		_notify (self, PROP_IFINDEX);
 		NM_DEVICE_GET_CLASS (self)->link_changed (self, plink);
 	}
@@ -3393,10 +3464,9 @@ realize_start_setup (NMDevice *self,
 
 	device_init_sriov_num_vfs (self);
 
-	nm_assert (!priv->stats.timeout_id);
 	real_rate = _stats_refresh_rate_real (priv->stats.refresh_rate_ms);
 	if (real_rate)
-		priv->stats.timeout_id = g_timeout_add (real_rate, _stats_timeout_cb, self);
+		_stats_subscribe (self, real_rate);
 
 	klass->realize_start_notify (self, plink);
 
@@ -3554,6 +3624,7 @@ nm_device_unrealize (NMDevice *self, gboolean remove_resources, GError **error)
 		_notify (self, PROP_IFINDEX);
 	}
 	priv->ip_ifindex = 0;
+	_platform_changes_sync (self);
 	if (nm_clear_g_free (&priv->ip_iface))
 		_notify (self, PROP_IP_IFACE);
 
@@ -3576,7 +3647,7 @@ nm_device_unrealize (NMDevice *self, gboolean remove_resources, GError **error)
 		_notify (self, PROP_PHYSICAL_PORT_ID);
 	}
 
-	nm_clear_g_source (&priv->stats.timeout_id);
+	_stats_unsubscribe (self);
 	_stats_update_counters (self, 0, 0);
 
 	priv->hw_addr_len_ = 0;
@@ -5321,26 +5392,99 @@ tc_commit (NMDevice *self)
  * for wireless devices, set SSID, keys, etc.
  *
  */
+typedef struct {
+	NMDevice *self;
+	NMActRequest *act_request;
+	int ifindex;
+} ActivateStage2LinkUpData;
+
+static void activate_stage2_device_config_continue (NMDevice *self, gboolean link_up, gboolean no_firmware);
+
+static ActivateStage2LinkUpData *
+activate_stage2_link_up_data_new (NMDevice *self, int ifindex)
+{
+	ActivateStage2LinkUpData *data;
+
+	data = g_slice_new (ActivateStage2LinkUpData);
+	data->self = g_object_ref (self);
+	data->act_request = g_object_ref (NM_DEVICE_GET_PRIVATE (self)->act_request);
+	data->ifindex = ifindex;
+	return data;
+}
+
 static void
-activate_stage2_device_config (NMDevice *self)
+activate_stage2_link_up_cb (NMPlatform *platform, NMPlatformError result, gpointer user_data)
 {
+	ActivateStage2LinkUpData *data = user_data;
+	NMDevice *self = data->self;
 	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
-	NMActStageReturn ret;
+
+	if (   priv->act_request != data->act_request
+	    || priv->state != NM_DEVICE_STATE_CONFIG
+	    || nm_device_get_ip_ifindex (self) != data->ifindex) {
+		/* the activation went on without us (or was aborted). */
+		_LOGD (LOGD_PLATFORM, "bringing up device %d completed, but the activation changed meanwhile", data->ifindex);
+	} else {
+		activate_stage2_device_config_continue (self,
+		                                        (   result == NM_PLATFORM_ERROR_SUCCESS
+		                                         && bring_up_finish (self, data->ifindex, FALSE)),
+		                                        result == NM_PLATFORM_ERROR_NO_FIRMWARE);
+	}
+
+	g_object_unref (data->act_request);
+	g_object_unref (data->self);
+	g_slice_free (ActivateStage2LinkUpData, data);
+}
+
+static void
+activate_stage2_device_config (NMDevice *self)
+{
 	gboolean no_firmware = FALSE;
-	CList *iter;
 
 	nm_device_state_changed (self, NM_DEVICE_STATE_CONFIG, NM_DEVICE_STATE_REASON_NONE);
 
 	/* Assumed connections were already set up outside NetworkManager */
 	if (!nm_device_sys_iface_state_is_external_or_assume (self)) {
-		NMDeviceStateReason failure_reason = NM_DEVICE_STATE_REASON_NONE;
+		int ifindex;
 
 		if (!tc_commit (self)) {
 			_LOGW (LOGD_IP6, "failed applying traffic control rules");
 			nm_device_state_changed (self, NM_DEVICE_STATE_FAILED, NM_DEVICE_STATE_REASON_CONFIG_FAILED);
 		}
 
-		if (!nm_device_bring_up (self, FALSE, &no_firmware)) {
+		ifindex = nm_device_get_ip_ifindex (self);
+		if (   ifindex > 0
+		    && nm_device_get_enabled (self)) {
+			/* don't block on kernel while bringing up the link. Other devices
+			 * can make progress in the meantime. */
+			_LOGD (LOGD_PLATFORM, "bringing up device %d", ifindex);
+			nm_platform_link_set_up_async (nm_device_get_platform (self),
+			                               ifindex,
+			                               activate_stage2_link_up_cb,
+			                               activate_stage2_link_up_data_new (self, ifindex));
+			return;
+		}
+
+		activate_stage2_device_config_continue (self,
+		                                        nm_device_bring_up (self, FALSE, &no_firmware),
+		                                        no_firmware);
+		return;
+	}
+
+	activate_stage2_device_config_continue (self, TRUE, FALSE);
+}
+
+static void
+activate_stage2_device_config_continue (NMDevice *self, gboolean link_up, gboolean no_firmware)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+	NMActStageReturn ret;
+	CList *iter;
+
+	if (!nm_device_sys_iface_state_is_external_or_assume (self)) {
+		NMDeviceStateReason failure_reason = NM_DEVICE_STATE_REASON_NONE;
+
+		if (!link_up) {
 			if (no_firmware)
 				nm_device_state_changed (self, NM_DEVICE_STATE_FAILED, NM_DEVICE_STATE_REASON_FIRMWARE_MISSING);
 			else
@@ -5903,6 +6047,51 @@ dhcp4_cleanup (NMDevice *self, CleanupType cleanup_type, gboolean release)
 	}
 }
 
+static void
+ip4_merge_cache_clear (NMDevice *self)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+
+	g_clear_object (&priv->ip4_merge_cache.composite);
+	g_clear_pointer (&priv->ip4_merge_cache.dev_route_blacklist, g_ptr_array_unref);
+}
+
+static guint64
+ip4_merge_inputs_hash (NMDevice *self,
+                       gboolean commit,
+                       NMIPConfigMergeFlags merge_flags,
+                       gint dns_priority)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+	NMIP4Config *const inputs[] = {
+		priv->dev_ip4_config,
+		priv->ext_ip4_config,
+		priv->wwan_ip4_config,
+		priv->con_ip4_config,
+	};
+	NMHashState h;
+	GSList *iter;
+	guint i;
+
+	nm_hash_init (&h, 2419476251u);
+	nm_hash_update_vals (&h,
+	                     nm_device_get_ip_ifindex (self),
+	                     merge_flags,
+	                     dns_priority,
+	                     default_route_metric_penalty_get (self, AF_INET),
+	                     NM_HASH_COMBINE_BOOLS (guint8, commit));
+	for (i = 0; i < G_N_ELEMENTS (inputs); i++)
+		nm_hash_update_val (&h, inputs[i] ? nm_ip4_config_get_version (inputs[i]) : (guint64) 0);
+	for (iter = priv->vpn4_configs; iter; iter = iter->next)
+		nm_hash_update_val (&h, nm_ip4_config_get_version (iter->data));
+	if (commit) {
+		nm_hash_update_vals (&h,
+		                     nm_device_get_route_table (self, AF_INET, TRUE),
+		                     nm_device_get_route_metric (self, AF_INET));
+	}
+	return nm_hash_complete_u64 (&h);
+}
+
 static gboolean
 ip4_config_merge_and_apply (NMDevice *self,
                             gboolean commit)
@@ -5914,6 +6103,10 @@ ip4_config_merge_and_apply (NMDevice *self,
 	gboolean ignore_auto_routes = FALSE;
 	gboolean ignore_auto_dns = FALSE;
 	gboolean ignore_default_routes = FALSE;
+	NMIPConfigMergeFlags merge_flags;
+	gint dns_priority;
+	guint64 inputs_hash = 0;
+	gboolean cacheable;
 	GSList *iter;
 	gs_unref_ptrarray GPtrArray *ip4_dev_route_blacklist = NULL;
 
@@ -5936,8 +6129,10 @@ ip4_config_merge_and_apply (NMDevice *self,
 		}
 	}
 
-	composite = _ip4_config_new (self);
-	init_ip4_config_dns_priority (self, composite);
+	merge_flags =   (ignore_auto_routes ? NM_IP_CONFIG_MERGE_NO_ROUTES : 0)
+	              | (ignore_default_routes ? NM_IP_CONFIG_MERGE_NO_DEFAULT_ROUTES : 0)
+	              | (ignore_auto_dns ? NM_IP_CONFIG_MERGE_NO_DNS : 0);
+	dns_priority = get_ip_config_dns_priority (self, AF_INET);
 
 	if (commit) {
 		if (priv->queued_ip4_config_id)
@@ -5948,11 +6143,31 @@ ip4_config_merge_and_apply (NMDevice *self,
 	if (commit)
 		priv->default_route_metric_penalty_ip4_has = default_route_metric_penalty_detect (self);
 
+	/* The pre-commit hook may modify the composite based on state that
+	 * is not covered by the inputs hash. */
+	cacheable = !(commit && NM_DEVICE_GET_CLASS (self)->ip4_config_pre_commit);
+
+	if (cacheable) {
+		inputs_hash = ip4_merge_inputs_hash (self, commit, merge_flags, dns_priority);
+		if (   priv->ip4_merge_cache.composite
+		    && priv->ip4_merge_cache.inputs_hash == inputs_hash
+		    && priv->ip4_merge_cache.composite_version == nm_ip4_config_get_version (priv->ip4_merge_cache.composite)) {
+			/* None of the inputs changed since the last merge. Reuse the previous
+			 * composite, but still set it so that lifetimes get committed. */
+			_LOGT (LOGD_IP4, "ip4-config: reuse unchanged composite config");
+			composite = g_object_ref (priv->ip4_merge_cache.composite);
+			if (priv->ip4_merge_cache.dev_route_blacklist)
+				ip4_dev_route_blacklist = g_ptr_array_ref (priv->ip4_merge_cache.dev_route_blacklist);
+			goto apply;
+		}
+	}
+
+	composite = _ip4_config_new (self);
+	nm_ip4_config_set_dns_priority (composite, dns_priority);
+
 	if (priv->dev_ip4_config) {
 		nm_ip4_config_merge (composite, priv->dev_ip4_config,
-		                       (ignore_auto_routes ? NM_IP_CONFIG_MERGE_NO_ROUTES : 0)
-		                     | (ignore_default_routes ? NM_IP_CONFIG_MERGE_NO_DEFAULT_ROUTES : 0)
-		                     | (ignore_auto_dns ? NM_IP_CONFIG_MERGE_NO_DNS : 0),
+		                     merge_flags,
 		                     default_route_metric_penalty_get (self, AF_INET));
 	}
 
@@ -5967,9 +6182,7 @@ ip4_config_merge_and_apply (NMDevice *self,
 	 */
 	if (priv->wwan_ip4_config) {
 		nm_ip4_config_merge (composite, priv->wwan_ip4_config,
-		                       (ignore_auto_routes ? NM_IP_CONFIG_MERGE_NO_ROUTES : 0)
-		                     | (ignore_default_routes ? NM_IP_CONFIG_MERGE_NO_DEFAULT_ROUTES : 0)
-		                     | (ignore_auto_dns ? NM_IP_CONFIG_MERGE_NO_DNS : 0),
+		                     merge_flags,
 		                     default_route_metric_penalty_get (self, AF_INET));
 	}
 
@@ -5992,7 +6205,25 @@ ip4_config_merge_and_apply (NMDevice *self,
 			NM_DEVICE_GET_CLASS (self)->ip4_config_pre_commit (self, composite);
 	}
 
+	ip4_merge_cache_clear (self);
+
+apply:
 	success = nm_device_set_ip4_config (self, composite, commit, ip4_dev_route_blacklist);
+
+	/* The composite must stay unmodified while cached. If it was adopted as the
+	 * device's config, it gets updated in place later and cannot be reused. */
+	if (   cacheable
+	    && composite != priv->ip4_config
+	    && composite != priv->ip4_merge_cache.composite) {
+		ip4_merge_cache_clear (self);
+		priv->ip4_merge_cache.composite = g_object_ref (composite);
+		priv->ip4_merge_cache.dev_route_blacklist = ip4_dev_route_blacklist
+		                                            ? g_ptr_array_ref (ip4_dev_route_blacklist)
+		                                            : NULL;
+		priv->ip4_merge_cache.inputs_hash = inputs_hash;
+		priv->ip4_merge_cache.composite_version = nm_ip4_config_get_version (composite);
+	} else if (composite == priv->ip4_config)
+		ip4_merge_cache_clear (self);
 	g_object_unref (composite);
 
 	if (commit)
@@ -6583,6 +6814,53 @@ dhcp6_cleanup (NMDevice *self, CleanupType cleanup_type, gboolean release)
 	}
 }
 
+static void
+ip6_merge_cache_clear (NMDevice *self)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+
+	g_clear_object (&priv->ip6_merge_cache.composite);
+}
+
+static guint64
+ip6_merge_inputs_hash (NMDevice *self,
+                       gboolean commit,
+                       NMIPConfigMergeFlags merge_flags,
+                       NMSettingIP6ConfigPrivacy privacy,
+                       gint dns_priority)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+	NMIP6Config *const inputs[] = {
+		priv->ac_ip6_config,
+		priv->dhcp6.ip6_config,
+		priv->ext_ip6_config,
+		priv->wwan_ip6_config,
+		priv->con_ip6_config,
+	};
+	NMHashState h;
+	GSList *iter;
+	guint i;
+
+	nm_hash_init (&h, 1648294507u);
+	nm_hash_update_vals (&h,
+	                     nm_device_get_ip_ifindex (self),
+	                     merge_flags,
+	                     privacy,
+	                     dns_priority,
+	                     default_route_metric_penalty_get (self, AF_INET6),
+	                     NM_HASH_COMBINE_BOOLS (guint8, commit));
+	for (i = 0; i < G_N_ELEMENTS (inputs); i++)
+		nm_hash_update_val (&h, inputs[i] ? nm_ip6_config_get_version (inputs[i]) : (guint64) 0);
+	for (iter = priv->vpn6_configs; iter; iter = iter->next)
+		nm_hash_update_val (&h, nm_ip6_config_get_version (iter->data));
+	if (commit) {
+		nm_hash_update_vals (&h,
+		                     nm_device_get_route_table (self, AF_INET6, TRUE),
+		                     nm_device_get_route_metric (self, AF_INET6));
+	}
+	return nm_hash_complete_u64 (&h);
+}
+
 static gboolean
 ip6_config_merge_and_apply (NMDevice *self,
                             gboolean commit)
@@ -6594,6 +6872,11 @@ ip6_config_merge_and_apply (NMDevice *self,
 	gboolean ignore_auto_routes = FALSE;
 	gboolean ignore_auto_dns = FALSE;
 	gboolean ignore_default_routes = FALSE;
+	NMIPConfigMergeFlags merge_flags;
+	NMSettingIP6ConfigPrivacy privacy;
+	gint dns_priority;
+	guint64 inputs_hash = 0;
+	gboolean cacheable;
 	const char *token = NULL;
 	GSList *iter;
 
@@ -6621,12 +6904,13 @@ ip6_config_merge_and_apply (NMDevice *self,
 		}
 	}
 
-	composite = _ip6_config_new (self);
-	nm_ip6_config_set_privacy (composite,
-	                           priv->ndisc ?
-	                           priv->ndisc_use_tempaddr :
-	                           NM_SETTING_IP6_CONFIG_PRIVACY_UNKNOWN);
-	init_ip6_config_dns_priority (self, composite);
+	merge_flags =   (ignore_auto_routes ? NM_IP_CONFIG_MERGE_NO_ROUTES : 0)
+	              | (ignore_default_routes ? NM_IP_CONFIG_MERGE_NO_DEFAULT_ROUTES : 0)
+	              | (ignore_auto_dns ? NM_IP_CONFIG_MERGE_NO_DNS : 0);
+	privacy =   priv->ndisc
+	          ? priv->ndisc_use_tempaddr
+	          : NM_SETTING_IP6_CONFIG_PRIVACY_UNKNOWN;
+	dns_priority = get_ip_config_dns_priority (self, AF_INET6);
 
 	if (commit) {
 		if (priv->queued_ip6_config_id)
@@ -6637,19 +6921,35 @@ ip6_config_merge_and_apply (NMDevice *self,
 	if (commit)
 		priv->default_route_metric_penalty_ip6_has = default_route_metric_penalty_detect (self);
 
+	/* Routes that are temporarily not available are device state that
+	 * is not covered by the inputs hash. */
+	cacheable =    !priv->rt6_temporary_not_available
+	            || g_hash_table_size (priv->rt6_temporary_not_available) == 0;
+
+	if (cacheable) {
+		inputs_hash = ip6_merge_inputs_hash (self, commit, merge_flags, privacy, dns_priority);
+		if (   priv->ip6_merge_cache.composite
+		    && priv->ip6_merge_cache.inputs_hash == inputs_hash
+		    && priv->ip6_merge_cache.composite_version == nm_ip6_config_get_version (priv->ip6_merge_cache.composite)) {
+			_LOGT (LOGD_IP6, "ip6-config: reuse unchanged composite config");
+			composite = g_object_ref (priv->ip6_merge_cache.composite);
+			goto apply;
+		}
+	}
+
+	composite = _ip6_config_new (self);
+	nm_ip6_config_set_privacy (composite, privacy);
+	nm_ip6_config_set_dns_priority (composite, dns_priority);
+
 	/* Merge all the IP configs into the composite config */
 	if (priv->ac_ip6_config) {
 		nm_ip6_config_merge (composite, priv->ac_ip6_config,
-		                       (ignore_auto_routes ? NM_IP_CONFIG_MERGE_NO_ROUTES : 0)
-		                     | (ignore_default_routes ? NM_IP_CONFIG_MERGE_NO_DEFAULT_ROUTES : 0)
-		                     | (ignore_auto_dns ? NM_IP_CONFIG_MERGE_NO_DNS : 0),
+		                     merge_flags,
 		                     default_route_metric_penalty_get (self, AF_INET6));
 	}
 	if (priv->dhcp6.ip6_config) {
 		nm_ip6_config_merge (composite, priv->dhcp6.ip6_config,
-		                       (ignore_auto_routes ? NM_IP_CONFIG_MERGE_NO_ROUTES : 0)
-		                     | (ignore_default_routes ? NM_IP_CONFIG_MERGE_NO_DEFAULT_ROUTES : 0)
-		                     | (ignore_auto_dns ? NM_IP_CONFIG_MERGE_NO_DNS : 0),
+		                     merge_flags,
 		                     default_route_metric_penalty_get (self, AF_INET6));
 	}
 
@@ -6664,9 +6964,7 @@ ip6_config_merge_and_apply (NMDevice *self,
 	 */
 	if (priv->wwan_ip6_config) {
 		nm_ip6_config_merge (composite, priv->wwan_ip6_config,
-		                       (ignore_auto_routes ? NM_IP_CONFIG_MERGE_NO_ROUTES : 0)
-		                     | (ignore_default_routes ? NM_IP_CONFIG_MERGE_NO_DEFAULT_ROUTES : 0)
-		                     | (ignore_auto_dns ? NM_IP_CONFIG_MERGE_NO_DNS : 0),
+		                     merge_flags,
 		                     default_route_metric_penalty_get (self, AF_INET6));
 	}
 
@@ -6695,6 +6993,9 @@ ip6_config_merge_and_apply (NMDevice *self,
 		                                    nm_device_get_route_metric (self, AF_INET6));
 	}
 
+	ip6_merge_cache_clear (self);
+
+apply:
 	/* Allow setting MTU etc */
 	if (commit) {
 		NMUtilsIPv6IfaceId iid;
@@ -6707,6 +7008,17 @@ ip6_config_merge_and_apply (NMDevice *self,
 	}
 
 	success = nm_device_set_ip6_config (self, composite, commit);
+
+	/* See ip4_config_merge_and_apply() */
+	if (   cacheable
+	    && composite != priv->ip6_config
+	    && composite != priv->ip6_merge_cache.composite) {
+		ip6_merge_cache_clear (self);
+		priv->ip6_merge_cache.composite = g_object_ref (composite);
+		priv->ip6_merge_cache.inputs_hash = inputs_hash;
+		priv->ip6_merge_cache.composite_version = nm_ip6_config_get_version (composite);
+	} else if (composite == priv->ip6_config)
+		ip6_merge_cache_clear (self);
 	g_object_unref (composite);
 	if (commit)
 		priv->v6_commit_first_time = FALSE;
@@ -7421,6 +7733,70 @@ _set_mtu (NMDevice *self, guint32 mtu)
 	}
 }
 
+static void
+_commit_ip6_mtu (NMDevice *self, guint32 ip6_mtu, gboolean anticipated_failure)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+	char sbuf[64];
+
+	if (   !ip6_mtu
+	    || ip6_mtu == nm_device_ipv6_sysctl_get_uint32 (self, "mtu", 0))
+		return;
+
+	if (!nm_device_ipv6_sysctl_set (self, "mtu",
+	                                nm_sprintf_buf (sbuf, "%u", (unsigned) ip6_mtu))) {
+		int errsv = errno;
+
+		_NMLOG (anticipated_failure && errsv == EINVAL ? LOGL_DEBUG : LOGL_WARN,
+		        LOGD_DEVICE,
+		        "mtu: failure to set IPv6 MTU%s",
+		        anticipated_failure && errsv == EINVAL
+		           ? ": Is the underlying MTU value successfully set?"
+		           : "");
+	}
+	priv->carrier_wait_until_ms = nm_utils_get_monotonic_timestamp_ms () + CARRIER_WAIT_TIME_AFTER_MTU_MS;
+}
+
+static void
+_commit_mtu_link_cb (NMPlatform *platform, NMPlatformError result, gpointer user_data)
+{
+	gs_unref_object NMDevice *self = user_data;
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+	NMDeviceState state;
+	gboolean anticipated_failure = FALSE;
+	gboolean commit_again;
+
+	nm_assert (priv->mtu_async.pending);
+
+	commit_again = priv->mtu_async.commit_again;
+	priv->mtu_async.pending = FALSE;
+	priv->mtu_async.commit_again = FALSE;
+
+	if (result == NM_PLATFORM_ERROR_CANT_SET_MTU) {
+		anticipated_failure = TRUE;
+		_LOGW (LOGD_DEVICE, "mtu: failure to set MTU. %s",
+		       NM_IS_DEVICE_VLAN (self)
+		         ? "Is the parent's MTU size large enough?"
+		         : (!c_list_is_empty (&priv->slaves)
+		              ? "Are the MTU sizes of the slaves large enough?"
+		              : "Did you configure the MTU correctly?"));
+	}
+
+	state = nm_device_get_state (self);
+	if (   state < NM_DEVICE_STATE_CONFIG
+	    || state >= NM_DEVICE_STATE_DEACTIVATING) {
+		_LOGT (LOGD_DEVICE, "mtu: set MTU completed, skip IPv6 MTU due to state %s", nm_device_state_to_str (state));
+		return;
+	}
+
+	if (commit_again) {
+		_commit_mtu (self, priv->ip4_config);
+		return;
+	}
+
+	_commit_ip6_mtu (self, priv->mtu_async.ip6_mtu, anticipated_failure);
+}
+
 static void
 _commit_mtu (NMDevice *self, const NMIP4Config *config)
 {
@@ -7433,7 +7809,7 @@ _commit_mtu (NMDevice *self, const NMIP4Config *config)
 		guint32 value;
 	} ip6_mtu_sysctl = { 0, };
 	int ifindex;
-	char sbuf[64], sbuf1[64], sbuf2[64];
+	char sbuf1[64], sbuf2[64];
 
 	ifindex = nm_device_get_ip_ifindex (self);
 	if (ifindex <= 0)
@@ -7444,6 +7820,14 @@ _commit_mtu (NMDevice *self, const NMIP4Config *config)
 		return;
 	}
 
+	if (priv->mtu_async.pending) {
+		/* the MTU in the platform cache is outdated. Retry once the
+		 * pending change completes. */
+		_LOGT (LOGD_DEVICE, "mtu: commit-mtu... postponed while changing MTU");
+		priv->mtu_async.commit_again = TRUE;
+		return;
+	}
+
 	{
 		gboolean mtu_is_user_config = FALSE;
 		guint32 mtu = 0;
@@ -7540,8 +7924,6 @@ _commit_mtu (NMDevice *self, const NMIP4Config *config)
 	})
 	if (   (mtu_desired && mtu_desired != mtu_plat)
 	    || (ip6_mtu && ip6_mtu != _IP6_MTU_SYS ())) {
-		gboolean anticipated_failure = FALSE;
-
 		if (!priv->mtu_initial && !priv->ip6_mtu_initial) {
 			/* before touching any of the MTU parameters, record the
 			 * original setting to restore on deactivation. */
@@ -7550,32 +7932,20 @@ _commit_mtu (NMDevice *self, const NMIP4Config *config)
 		}
 
 		if (mtu_desired && mtu_desired != mtu_plat) {
-			if (nm_platform_link_set_mtu (nm_device_get_platform (self), ifindex, mtu_desired) == NM_PLATFORM_ERROR_CANT_SET_MTU) {
-				anticipated_failure = TRUE;
-				_LOGW (LOGD_DEVICE, "mtu: failure to set MTU. %s",
-				       NM_IS_DEVICE_VLAN (self)
-				         ? "Is the parent's MTU size large enough?"
-				         : (!c_list_is_empty (&priv->slaves)
-				              ? "Are the MTU sizes of the slaves large enough?"
-				              : "Did you configure the MTU correctly?"));
-			}
+			/* the IPv6 MTU cannot be larger than the link MTU, so we set it
+			 * after kernel changed the latter. */
+			priv->mtu_async.pending = TRUE;
+			priv->mtu_async.ip6_mtu = ip6_mtu;
 			priv->carrier_wait_until_ms = nm_utils_get_monotonic_timestamp_ms () + CARRIER_WAIT_TIME_AFTER_MTU_MS;
+			nm_platform_link_set_mtu_async (nm_device_get_platform (self),
+			                                ifindex,
+			                                mtu_desired,
+			                                _commit_mtu_link_cb,
+			                                g_object_ref (self));
+			return;
 		}
 
-		if (ip6_mtu && ip6_mtu != _IP6_MTU_SYS ()) {
-			if (!nm_device_ipv6_sysctl_set (self, "mtu",
-			                                nm_sprintf_buf (sbuf, "%u", (unsigned) ip6_mtu))) {
-				int errsv = errno;
-
-				_NMLOG (anticipated_failure && errsv == EINVAL ? LOGL_DEBUG : LOGL_WARN,
-				        LOGD_DEVICE,
-				        "mtu: failure to set IPv6 MTU%s",
-				        anticipated_failure && errsv == EINVAL
-				           ? ": Is the underlying MTU value successfully set?"
-				           : "");
-			}
-			priv->carrier_wait_until_ms = nm_utils_get_monotonic_timestamp_ms () + CARRIER_WAIT_TIME_AFTER_MTU_MS;
-		}
+		_commit_ip6_mtu (self, ip6_mtu, FALSE);
 	}
 #undef _IP6_MTU_SYS
 }
@@ -10278,7 +10648,13 @@ nm_device_set_ip4_config (NMDevice *self,
 	}
 
 	if (new_config) {
-		if (old_config) {
+		if (   old_config
+		    && priv->ip4_config_replaced_from_version == nm_ip4_config_get_version (new_config)
+		    && priv->ip4_config_replaced_version == nm_ip4_config_get_version (old_config)) {
+			/* Neither config changed since @old_config got the content of @new_config,
+			 * for example because the merge reused the previous composite. Spare
+			 * comparing all addresses and routes again. */
+		} else if (old_config) {
 			/* has_changes is set only on relevant changes, because when the configuration changes,
 			 * this causes a re-read and reset. This should only happen for relevant changes */
 			nm_ip4_config_replace (old_config, new_config, &has_changes);
@@ -10286,6 +10662,8 @@ nm_device_set_ip4_config (NMDevice *self,
 				_LOGD (LOGD_IP4, "ip4-config: update IP4Config instance (%s)",
 				       nm_exported_object_get_path (NM_EXPORTED_OBJECT (old_config)));
 			}
+			priv->ip4_config_replaced_from_version = nm_ip4_config_get_version (new_config);
+			priv->ip4_config_replaced_version = nm_ip4_config_get_version (old_config);
 		} else {
 			has_changes = TRUE;
 			priv->ip4_config = g_object_ref (new_config);
@@ -10458,7 +10836,11 @@ nm_device_set_ip6_config (NMDevice *self,
 	}
 
 	if (new_config) {
-		if (old_config) {
+		if (   old_config
+		    && priv->ip6_config_replaced_from_version == nm_ip6_config_get_version (new_config)
+		    && priv->ip6_config_replaced_version == nm_ip6_config_get_version (old_config)) {
+			/* See nm_device_set_ip4_config() */
+		} else if (old_config) {
 			/* has_changes is set only on relevant changes, because when the configuration changes,
 			 * this causes a re-read and reset. This should only happen for relevant changes */
 			nm_ip6_config_replace (old_config, new_config, &has_changes);
@@ -10466,6 +10848,8 @@ nm_device_set_ip6_config (NMDevice *self,
 				_LOGD (LOGD_IP6, "ip6-config: update IP6Config instance (%s)",
 				       nm_exported_object_get_path (NM_EXPORTED_OBJECT (old_config)));
 			}
+			priv->ip6_config_replaced_from_version = nm_ip6_config_get_version (new_config);
+			priv->ip6_config_replaced_version = nm_ip6_config_get_version (old_config);
 		} else {
 			has_changes = TRUE;
 			priv->ip6_config = g_object_ref (new_config);
@@ -10867,9 +11251,6 @@ _get_carrier_wait_ms (NMDevice *self)
 gboolean
 nm_device_bring_up (NMDevice *self, gboolean block, gboolean *no_firmware)
 {
-	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
-	gboolean device_is_up = FALSE;
-	NMDeviceCapabilities capabilities;
 	int ifindex;
 
 	g_return_val_if_fail (NM_IS_DEVICE (self), FALSE);
@@ -10890,6 +11271,17 @@ nm_device_bring_up (NMDevice *self, gboolean block, gboolean *no_firmware)
 			return FALSE;
 	}
 
+	return bring_up_finish (self, ifindex, block);
+}
+
+/* the second half of nm_device_bring_up(), after the link was set up. */
+static gboolean
+bring_up_finish (NMDevice *self, int ifindex, gboolean block)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+	gboolean device_is_up = FALSE;
+	NMDeviceCapabilities capabilities;
+
 	/* Store carrier immediately. */
 	nm_device_set_carrier_from_platform (self);
 
@@ -11426,6 +11818,44 @@ queued_ip6_config_change (gpointer user_data)
 	return FALSE;
 }
 
+static void
+_ip_config_change_queue (NMDevice *self, int addr_family)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+
+	if (addr_family == AF_INET) {
+		if (nm_device_get_unmanaged_flags (self, NM_UNMANAGED_PLATFORM_INIT)) {
+			priv->queued_ip4_config_pending = TRUE;
+			nm_assert_se (!nm_clear_g_source (&priv->queued_ip4_config_id));
+		} else if (!priv->queued_ip4_config_id) {
+			priv->queued_ip4_config_pending = FALSE;
+			priv->queued_ip4_config_id = g_idle_add (queued_ip4_config_change, self);
+			_LOGD (LOGD_DEVICE, "queued IP4 config change");
+		}
+	} else {
+		if (nm_device_get_unmanaged_flags (self, NM_UNMANAGED_PLATFORM_INIT)) {
+			priv->queued_ip6_config_pending = TRUE;
+			nm_assert_se (!nm_clear_g_source (&priv->queued_ip6_config_id));
+		} else if (!priv->queued_ip6_config_id) {
+			priv->queued_ip6_config_pending = FALSE;
+			priv->queued_ip6_config_id = g_idle_add (queued_ip6_config_change, self);
+			_LOGD (LOGD_DEVICE, "queued IP6 config change");
+		}
+	}
+}
+
+static void
+_dad6_failed_add (NMDevice *self, const NMPlatformIP6Address *addr)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+
+	if (   priv->state > NM_DEVICE_STATE_DISCONNECTED
+	    && priv->state < NM_DEVICE_STATE_DEACTIVATING) {
+		priv->dad6_failed_addrs = g_slist_append (priv->dad6_failed_addrs,
+		                                          g_memdup (addr, sizeof (NMPlatformIP6Address)));
+	}
+}
+
 static void
 device_ipx_changed (NMPlatform *platform,
                     int obj_type_i,
@@ -11436,52 +11866,92 @@ device_ipx_changed (NMPlatform *platform,
 {
 	const NMPObjectType obj_type = obj_type_i;
 	const NMPlatformSignalChangeType change_type = change_type_i;
-	NMDevicePrivate *priv;
 	NMPlatformIP6Address *addr;
 
 	if (nm_device_get_ip_ifindex (self) != ifindex)
 		return;
 
-	priv = NM_DEVICE_GET_PRIVATE (self);
-
 	switch (obj_type) {
 	case NMP_OBJECT_TYPE_IP4_ADDRESS:
 	case NMP_OBJECT_TYPE_IP4_ROUTE:
-		if (nm_device_get_unmanaged_flags (self, NM_UNMANAGED_PLATFORM_INIT)) {
-			priv->queued_ip4_config_pending = TRUE;
-			nm_assert_se (!nm_clear_g_source (&priv->queued_ip4_config_id));
-		} else if (!priv->queued_ip4_config_id) {
-			priv->queued_ip4_config_pending = FALSE;
-			priv->queued_ip4_config_id = g_idle_add (queued_ip4_config_change, self);
-			_LOGD (LOGD_DEVICE, "queued IP4 config change");
-		}
+		_ip_config_change_queue (self, AF_INET);
 		break;
 	case NMP_OBJECT_TYPE_IP6_ADDRESS:
 		addr = platform_object;
 
-		if (   priv->state > NM_DEVICE_STATE_DISCONNECTED
-		    && priv->state < NM_DEVICE_STATE_DEACTIVATING
-		    && (   (change_type == NM_PLATFORM_SIGNAL_CHANGED && addr->n_ifa_flags & IFA_F_DADFAILED)
-		        || (change_type == NM_PLATFORM_SIGNAL_REMOVED && addr->n_ifa_flags & IFA_F_TENTATIVE))) {
-			priv->dad6_failed_addrs = g_slist_append (priv->dad6_failed_addrs,
-			                                          g_memdup (addr, sizeof (NMPlatformIP6Address)));
-		}
+		if (   (change_type == NM_PLATFORM_SIGNAL_CHANGED && addr->n_ifa_flags & IFA_F_DADFAILED)
+		    || (change_type == NM_PLATFORM_SIGNAL_REMOVED && addr->n_ifa_flags & IFA_F_TENTATIVE))
+			_dad6_failed_add (self, addr);
 		/* fall through */
 	case NMP_OBJECT_TYPE_IP6_ROUTE:
-		if (nm_device_get_unmanaged_flags (self, NM_UNMANAGED_PLATFORM_INIT)) {
-			priv->queued_ip6_config_pending = TRUE;
-			nm_assert_se (!nm_clear_g_source (&priv->queued_ip6_config_id));
-		} else if (!priv->queued_ip6_config_id) {
-			priv->queued_ip6_config_pending = FALSE;
-			priv->queued_ip6_config_id = g_idle_add (queued_ip6_config_change, self);
-			_LOGD (LOGD_DEVICE, "queued IP6 config change");
-		}
+		_ip_config_change_queue (self, AF_INET6);
 		break;
 	default:
 		g_return_if_reached ();
 	}
 }
 
+static void
+platform_changes_cb (NMPlatform *platform,
+                     const NMPlatformChangeSet *change_set,
+                     gpointer user_data)
+{
+	NMDevice *self = user_data;
+	guint i;
+
+	if (NM_FLAGS_HAS (change_set->changes, NM_PLATFORM_CHANGE_LINK_CHANGED))
+		_link_changed_queue (self, change_set->ifindex);
+
+	if (nm_device_get_ip_ifindex (self) != change_set->ifindex)
+		return;
+
+	if (NM_FLAGS_ANY (change_set->changes,   NM_PLATFORM_CHANGE_IP4_ADDRESS
+	                                       | NM_PLATFORM_CHANGE_IP4_ROUTE))
+		_ip_config_change_queue (self, AF_INET);
+
+	if (change_set->ip6_dad_failed) {
+		for (i = 0; i < change_set->ip6_dad_failed->len; i++)
+			_dad6_failed_add (self, &g_array_index (change_set->ip6_dad_failed, NMPlatformIP6Address, i));
+	}
+
+	if (NM_FLAGS_ANY (change_set->changes,   NM_PLATFORM_CHANGE_IP6_ADDRESS
+	                                       | NM_PLATFORM_CHANGE_IP6_ROUTE))
+		_ip_config_change_queue (self, AF_INET6);
+}
+
+static void
+_platform_changes_sync (NMDevice *self)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+	NMPlatform *platform;
+	int ifindexes[2];
+	guint i;
+
+	if (!priv->platform_changes_coalesced)
+		return;
+
+	platform = nm_device_get_platform (self);
+
+	ifindexes[0] = priv->ifindex;
+	ifindexes[1] = priv->ip_ifindex != priv->ifindex ? priv->ip_ifindex : 0;
+
+	for (i = 0; i < G_N_ELEMENTS (ifindexes); i++) {
+		if (priv->platform_changes[i].ifindex == ifindexes[i])
+			continue;
+		if (priv->platform_changes[i].subscription) {
+			nm_platform_changes_unsubscribe (platform, priv->platform_changes[i].subscription);
+			priv->platform_changes[i].subscription = NULL;
+		}
+		priv->platform_changes[i].ifindex = ifindexes[i];
+		if (ifindexes[i] > 0) {
+			priv->platform_changes[i].subscription = nm_platform_changes_subscribe (platform,
+			                                                                        ifindexes[i],
+			                                                                        platform_changes_cb,
+			                                                                        self);
+		}
+	}
+}
+
 /*****************************************************************************/
 
 NM_UTILS_FLAGS2STR_DEFINE (nm_unmanaged_flags2str, NMUnmanagedFlags,
@@ -12590,6 +13060,8 @@ _cleanup_generic_post (NMDevice *self, CleanupType cleanup_type)
 	 */
 	nm_device_set_ip4_config (self, NULL, TRUE, NULL);
 	nm_device_set_ip6_config (self, NULL, TRUE);
+	ip4_merge_cache_clear (self);
+	ip6_merge_cache_clear (self);
 	g_clear_object (&priv->proxy_config);
 	g_clear_object (&priv->con_ip4_config);
 	g_clear_object (&priv->dev_ip4_config);
@@ -14389,11 +14861,16 @@ constructed (GObject *object)
 
 	/* Watch for external IP config changes */
 	platform = nm_device_get_platform (self);
-	g_signal_connect (platform, NM_PLATFORM_SIGNAL_IP4_ADDRESS_CHANGED, G_CALLBACK (device_ipx_changed), self);
-	g_signal_connect (platform, NM_PLATFORM_SIGNAL_IP6_ADDRESS_CHANGED, G_CALLBACK (device_ipx_changed), self);
-	g_signal_connect (platform, NM_PLATFORM_SIGNAL_IP4_ROUTE_CHANGED, G_CALLBACK (device_ipx_changed), self);
-	g_signal_connect (platform, NM_PLATFORM_SIGNAL_IP6_ROUTE_CHANGED, G_CALLBACK (device_ipx_changed), self);
-	g_signal_connect (platform, NM_PLATFORM_SIGNAL_LINK_CHANGED, G_CALLBACK (link_changed_cb), self);
+	if (nm_platform_changes_get_window (platform) > 0) {
+		priv->platform_changes_coalesced = TRUE;
+		_platform_changes_sync (self);
+	} else {
+		g_signal_connect (platform, NM_PLATFORM_SIGNAL_IP4_ADDRESS_CHANGED, G_CALLBACK (device_ipx_changed), self);
+		g_signal_connect (platform, NM_PLATFORM_SIGNAL_IP6_ADDRESS_CHANGED, G_CALLBACK (device_ipx_changed), self);
+		g_signal_connect (platform, NM_PLATFORM_SIGNAL_IP4_ROUTE_CHANGED, G_CALLBACK (device_ipx_changed), self);
+		g_signal_connect (platform, NM_PLATFORM_SIGNAL_IP6_ROUTE_CHANGED, G_CALLBACK (device_ipx_changed), self);
+		g_signal_connect (platform, NM_PLATFORM_SIGNAL_LINK_CHANGED, G_CALLBACK (link_changed_cb), self);
+	}
 
 	priv->settings = g_object_ref (NM_SETTINGS_GET);
 	g_assert (priv->settings);
@@ -14434,6 +14911,16 @@ dispose (GObject *object)
 	platform = nm_device_get_platform (self);
 	g_signal_handlers_disconnect_by_func (platform, G_CALLBACK (device_ipx_changed), self);
 	g_signal_handlers_disconnect_by_func (platform, G_CALLBACK (link_changed_cb), self);
+	if (priv->platform_changes_coalesced) {
+		guint i;
+
+		for (i = 0; i < G_N_ELEMENTS (priv->platform_changes); i++) {
+			if (priv->platform_changes[i].subscription)
+				nm_platform_changes_unsubscribe (platform, g_steal_pointer (&priv->platform_changes[i].subscription));
+			priv->platform_changes[i].ifindex = 0;
+		}
+		priv->platform_changes_coalesced = FALSE;
+	}
 
 	g_slist_free_full (priv->arping.dad_list, (GDestroyNotify) nm_arping_manager_destroy);
 	priv->arping.dad_list = NULL;
@@ -14465,7 +14952,7 @@ dispose (GObject *object)
 
 	nm_clear_g_source (&priv->check_delete_unrealized_id);
 
-	nm_clear_g_source (&priv->stats.timeout_id);
+	_stats_unsubscribe (self);
 
 	carrier_disconnected_action_cancel (self);
 
@@ -39,6 +39,7 @@
 #include <libpsl.h>
 #endif
 
+#include "nm-utils/nm-hash-utils.h"
 #include "nm-utils.h"
 #include "nm-core-internal.h"
 #include "nm-dns-manager.h"
@@ -128,8 +129,8 @@ typedef struct {
 	char *hostname;
 	guint updates_queue;
 
-	guint8 hash[HASH_LEN];  /* SHA1 hash of current DNS config */
-	guint8 prev_hash[HASH_LEN];  /* Hash when begin_updates() was called */
+	guint64 hash;       /* hash of current DNS config */
+	guint64 prev_hash;  /* Hash when begin_updates() was called */
 
 	NMDnsManagerResolvConfManager rc_manager;
 	char *mode;
@@ -814,32 +815,47 @@ update_resolv_conf (NMDnsManager *self,
 	return SR_SUCCESS;
 }
 
-static void
-compute_hash (NMDnsManager *self, const NMGlobalDnsConfig *global, guint8 buffer[HASH_LEN])
+static guint64
+compute_hash (NMDnsManager *self, const NMGlobalDnsConfig *global)
 {
 	NMDnsManagerPrivate *priv = NM_DNS_MANAGER_GET_PRIVATE (self);
-	GChecksum *sum;
-	gsize len = HASH_LEN;
+	NMHashState h;
 	guint i;
 
-	sum = g_checksum_new (G_CHECKSUM_SHA1);
-	g_assert (len == g_checksum_type_get_length (G_CHECKSUM_SHA1));
+	nm_hash_init (&h, 1542637771u);
+
+	if (global) {
+		GChecksum *sum;
+		guint8 buffer[HASH_LEN];
+		gsize len = HASH_LEN;
 
-	if (global)
+		sum = g_checksum_new (G_CHECKSUM_SHA1);
+		g_assert (len == g_checksum_type_get_length (G_CHECKSUM_SHA1));
 		nm_global_dns_config_update_checksum (global, sum);
-	else {
+		g_checksum_get_digest (sum, buffer, &len);
+		g_checksum_free (sum);
+
+		nm_hash_update (&h, buffer, len);
+	} else {
 		for (i = 0; i < priv->configs->len; i++) {
 			NMDnsIPConfigData *data = priv->configs->pdata[i];
+			guint64 config_hash;
 
 			if (NM_IS_IP4_CONFIG (data->config))
-				nm_ip4_config_hash ((NMIP4Config *) data->config, sum, TRUE);
+				config_hash = nm_ip4_config_get_content_hash ((NMIP4Config *) data->config, TRUE);
 			else if (NM_IS_IP6_CONFIG (data->config))
-				nm_ip6_config_hash ((NMIP6Config *) data->config, sum, TRUE);
+				config_hash = nm_ip6_config_get_content_hash ((NMIP6Config *) data->config, TRUE);
+			else
+				continue;
+
+			/* configs without DNS information don't change the hash, so that
+			 * adding or removing them is not considered a change. */
+			if (config_hash)
+				nm_hash_update_val (&h, config_hash);
 		}
 	}
 
-	g_checksum_get_digest (sum, buffer, &len);
-	g_checksum_free (sum);
+	return nm_hash_complete_u64 (&h);
 }
 
 static gboolean
@@ -1046,7 +1062,7 @@ update_dns (NMDnsManager *self,
 	}
 
 	/* Update hash with config we're applying */
-	compute_hash (self, global_config, priv->hash);
+	priv->hash = compute_hash (self, global_config);
 
 	_collect_resolv_conf_data (self, global_config, priv->configs, priv->hostname,
 	                           &searches, &options, &nameservers, &nis_servers, &nis_domain);
@@ -1389,7 +1405,7 @@ nm_dns_manager_begin_updates (NMDnsManager *self, const char *func)
 
 	/* Save current hash when starting a new batch */
 	if (priv->updates_queue == 0)
-		memcpy (priv->prev_hash, priv->hash, sizeof (priv->hash));
+		priv->prev_hash = priv->hash;
 
 	priv->updates_queue++;
 
@@ -1402,7 +1418,7 @@ nm_dns_manager_end_updates (NMDnsManager *self, const char *func)
 	NMDnsManagerPrivate *priv;
 	GError *error = NULL;
 	gboolean changed;
-	guint8 new[HASH_LEN];
+	guint64 new;
 
 	g_return_if_fail (self != NULL);
 
@@ -1414,8 +1430,8 @@ nm_dns_manager_end_updates (NMDnsManager *self, const char *func)
 		priv->need_sort = FALSE;
 	}
 
-	compute_hash (self, nm_config_data_get_global_dns_config (nm_config_get_data (priv->config)), new);
-	changed = (memcmp (new, priv->prev_hash, sizeof (new)) != 0) ? TRUE : FALSE;
+	new = compute_hash (self, nm_config_data_get_global_dns_config (nm_config_get_data (priv->config)));
+	changed = (new != priv->prev_hash);
 	_LOGD ("(%s): DNS configuration %s", func, changed ? "changed" : "did not change");
 
 	priv->updates_queue--;
@@ -1928,7 +1944,7 @@ nm_dns_manager_init (NMDnsManager *self)
 	priv->configs = g_ptr_array_new_full (8, ip_config_data_destroy);
 
 	/* Set the initial hash */
-	compute_hash (self, NULL, NM_DNS_MANAGER_GET_PRIVATE (self)->hash);
+	priv->hash = compute_hash (self, NULL);
 
 	g_signal_connect (G_OBJECT (priv->config),
 	                  NM_CONFIG_SIGNAL_CONFIG_CHANGED,
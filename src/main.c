@@ -46,6 +46,7 @@
 #include "nm-session-monitor.h"
 #include "nm-dispatcher.h"
 #include "settings/nm-settings.h"
+#include "settings/nm-settings-db.h"
 #include "nm-auth-manager.h"
 #include "nm-core-internal.h"
 #include "nm-exported-object.h"
@@ -385,7 +386,31 @@ main (int argc, char *argv[])
 	             );
 
 	/* Set up platform interaction layer */
-	nm_linux_platform_setup ();
+	{
+		gs_free char *route_filter = NULL;
+
+		route_filter = nm_config_data_get_value (nm_config_get_data_orig (config),
+		                                         NM_CONFIG_KEYFILE_GROUP_MAIN,
+		                                         NM_CONFIG_KEYFILE_KEY_MAIN_ROUTE_FILTER,
+		                                         NM_CONFIG_GET_VALUE_STRIP | NM_CONFIG_GET_VALUE_NO_EMPTY);
+		nm_linux_platform_setup_full (nm_config_data_get_value_boolean (nm_config_get_data_orig (config),
+		                                                                NM_CONFIG_KEYFILE_GROUP_MAIN,
+		                                                                NM_CONFIG_KEYFILE_KEY_MAIN_NETLINK_THREAD,
+		                                                                FALSE),
+		                              route_filter);
+	}
+
+	/* Deliver platform changes to the devices in batches, at most four
+	 * windows after the first change of a burst. */
+	{
+		guint window_ms;
+
+		window_ms = nm_config_data_get_value_int64 (nm_config_get_data_orig (config),
+		                                            NM_CONFIG_KEYFILE_GROUP_MAIN,
+		                                            NM_CONFIG_KEYFILE_KEY_MAIN_PLATFORM_EVENTS_WINDOW,
+		                                            10, 0, 1000, 0);
+		nm_platform_changes_set_window (NM_PLATFORM_GET, window_ms, 4 * window_ms);
+	}
 
 	NM_UTILS_KEEP_ALIVE (config, nm_netns_get (), "NMConfig-depends-on-NMNetns");
 
@@ -454,6 +479,8 @@ done:
 
 	nm_manager_stop (nm_manager_get ());
 
+	nm_settings_db_flush_all ();
+
 	nm_config_state_set (config, TRUE, TRUE);
 
 	nm_dns_manager_stop (nm_dns_manager_get ());
@@ -61,9 +61,14 @@
 
 #define NM_CONFIG_KEYFILE_KEY_MAIN_AUTH_POLKIT              "auth-polkit"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_AUTOCONNECT_RETRIES_DEFAULT "autoconnect-retries-default"
+#define NM_CONFIG_KEYFILE_KEY_MAIN_CONNECTION_STATE_LOG     "connection-state-log"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_DHCP                     "dhcp"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_DEBUG                    "debug"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_HOSTNAME_MODE            "hostname-mode"
+#define NM_CONFIG_KEYFILE_KEY_MAIN_NETLINK_THREAD           "netlink-thread"
+#define NM_CONFIG_KEYFILE_KEY_MAIN_PLATFORM_EVENTS_WINDOW   "platform-events-window"
+#define NM_CONFIG_KEYFILE_KEY_MAIN_ROUTE_FILTER             "route-filter"
+#define NM_CONFIG_KEYFILE_KEY_MAIN_SETTINGS_READ_THREADS    "settings-read-threads"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_SLAVES_ORDER             "slaves-order"
 #define NM_CONFIG_KEYFILE_KEY_LOGGING_BACKEND               "backend"
 #define NM_CONFIG_KEYFILE_KEY_CONFIG_ENABLE                 "enable"
@@ -71,6 +76,7 @@
 #define NM_CONFIG_KEYFILE_KEY_KEYFILE_PATH                  "path"
 #define NM_CONFIG_KEYFILE_KEY_KEYFILE_UNMANAGED_DEVICES     "unmanaged-devices"
 #define NM_CONFIG_KEYFILE_KEY_KEYFILE_HOSTNAME              "hostname"
+#define NM_CONFIG_KEYFILE_KEY_KEYFILE_CACHE                 "cache"
 #define NM_CONFIG_KEYFILE_KEY_IFNET_AUTO_REFRESH            "auto_refresh"
 #define NM_CONFIG_KEYFILE_KEY_IFNET_MANAGED                 "managed"
 #define NM_CONFIG_KEYFILE_KEY_IFUPDOWN_MANAGED              "managed"
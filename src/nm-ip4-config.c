@@ -29,6 +29,7 @@
 #include <linux/rtnetlink.h>
 
 #include "nm-utils/nm-dedup-multi.h"
+#include "nm-utils/nm-hash-utils.h"
 
 #include "nm-utils.h"
 #include "platform/nmp-object.h"
@@ -97,6 +98,7 @@ _nm_ip_config_add_obj (NMDedupMultiIndex *multi_idx,
                        const NMPlatformObject *pl_new,
                        gboolean merge,
                        gboolean append_force,
+                       guint64 *inout_hash,
                        const NMPObject **out_obj_old /* returns a reference! */,
                        const NMPObject **out_obj_new /* does not return a reference */)
 {
@@ -190,6 +192,9 @@ _nm_ip_config_add_obj (NMDedupMultiIndex *multi_idx,
 		}
 	}
 
+	if (inout_hash && entry_old)
+		*inout_hash -= _nm_ip_config_hash_obj (entry_old->obj);
+
 	if (!nm_dedup_multi_index_add_full (multi_idx,
 	                                    &idx_type->parent,
 	                                    obj_new,
@@ -204,6 +209,9 @@ _nm_ip_config_add_obj (NMDedupMultiIndex *multi_idx,
 		return FALSE;
 	}
 
+	if (inout_hash)
+		*inout_hash += _nm_ip_config_hash_obj (entry_new->obj);
+
 	NM_SET_OUT (out_obj_new, entry_new->obj);
 	return TRUE;
 
@@ -217,6 +225,293 @@ append_force_and_out:
 	return FALSE;
 }
 
+/*****************************************************************************/
+
+guint64
+_nm_ip_config_version_next (void)
+{
+	static guint64 version;
+
+	return ++version;
+}
+
+/* The "a{sv}" D-Bus representation of each address and route is cached per
+ * NMPObject. Objects are immutable, so when the list changes only the added
+ * or modified entries need to be converted anew. */
+GHashTable *
+_nm_ip_config_variant_cache_new (void)
+{
+	return g_hash_table_new_full (nm_direct_hash,
+	                              NULL,
+	                              (GDestroyNotify) nmp_object_unref,
+	                              (GDestroyNotify) g_variant_unref);
+}
+
+/* Moves the variant for @obj from @cache_old over to @cache_new. Returns
+ * %NULL if @obj was not cached. */
+GVariant *
+_nm_ip_config_variant_cache_move (GHashTable *cache_old,
+                                  GHashTable *cache_new,
+                                  const NMPObject *obj)
+{
+	GVariant *variant;
+
+	if (!cache_old)
+		return NULL;
+
+	variant = g_hash_table_lookup (cache_old, obj);
+	if (variant) {
+		g_hash_table_insert (cache_new,
+		                     (gpointer) nmp_object_ref (obj),
+		                     g_variant_ref (variant));
+	}
+	return variant;
+}
+
+/* Adds (and sinks) @variant as the representation of @obj. */
+GVariant *
+_nm_ip_config_variant_cache_add (GHashTable *cache,
+                                 const NMPObject *obj,
+                                 GVariant *variant)
+{
+	g_hash_table_insert (cache,
+	                     (gpointer) nmp_object_ref (obj),
+	                     g_variant_ref_sink (variant));
+	return variant;
+}
+
+/* Returns the "(aa{sv}u)" reply of GetRoutes(): up to @limit entries of
+ * @route_data starting at @offset, and the total number of routes. A
+ * @limit of zero means no limit. */
+GVariant *
+_nm_ip_config_route_data_slice (GVariant *route_data, guint32 offset, guint32 limit)
+{
+	GVariantBuilder builder;
+	gsize n, i, end;
+
+	n = g_variant_n_children (route_data);
+	end = n;
+	if (offset >= n)
+		offset = end = n;
+	else if (limit > 0 && limit < n - offset)
+		end = offset + limit;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("aa{sv}"));
+	for (i = offset; i < end; i++) {
+		gs_unref_variant GVariant *child = g_variant_get_child_value (route_data, i);
+
+		g_variant_builder_add_value (&builder, child);
+	}
+	return g_variant_new ("(aa{sv}u)", &builder, (guint32) n);
+}
+
+/* The content hash only covers the fields that nm_ip4_config_equal() and
+ * nm_ip6_config_equal() compare. */
+guint64
+_nm_ip_config_hash_obj (const NMPObject *obj)
+{
+	NMHashState h;
+
+	switch (NMP_OBJECT_GET_TYPE (obj)) {
+	case NMP_OBJECT_TYPE_IP4_ADDRESS: {
+		const NMPlatformIP4Address *a = NMP_OBJECT_CAST_IP4_ADDRESS (obj);
+
+		nm_hash_init (&h, NM_IP_CONFIG_HASH_SEED_ADDRESS);
+		nm_hash_update_vals (&h,
+		                     a->address,
+		                     a->plen,
+		                     a->peer_address & _nm_utils_ip4_prefix_to_netmask (a->plen));
+		break;
+	}
+	case NMP_OBJECT_TYPE_IP6_ADDRESS: {
+		const NMPlatformIP6Address *a = NMP_OBJECT_CAST_IP6_ADDRESS (obj);
+
+		nm_hash_init (&h, NM_IP_CONFIG_HASH_SEED_ADDRESS);
+		nm_hash_update_vals (&h,
+		                     a->address,
+		                     a->plen);
+		break;
+	}
+	case NMP_OBJECT_TYPE_IP4_ROUTE: {
+		const NMPlatformIP4Route *r = NMP_OBJECT_CAST_IP4_ROUTE (obj);
+
+		nm_hash_init (&h, NM_IP_CONFIG_HASH_SEED_ROUTE);
+		nm_hash_update_vals (&h,
+		                     r->network,
+		                     r->plen,
+		                     r->gateway,
+		                     r->metric);
+		break;
+	}
+	case NMP_OBJECT_TYPE_IP6_ROUTE: {
+		const NMPlatformIP6Route *r = NMP_OBJECT_CAST_IP6_ROUTE (obj);
+
+		nm_hash_init (&h, NM_IP_CONFIG_HASH_SEED_ROUTE);
+		nm_hash_update_vals (&h,
+		                     r->network,
+		                     r->plen,
+		                     r->gateway,
+		                     r->metric);
+		break;
+	}
+	default:
+		g_return_val_if_reached (0);
+	}
+	return nm_hash_complete_u64 (&h);
+}
+
+guint64
+_nm_ip_config_hash_objs (const NMDedupMultiHeadEntry *head_entry)
+{
+	NMDedupMultiIter iter;
+	guint64 hash = 0;
+
+	nm_dedup_multi_iter_init (&iter, head_entry);
+	while (nm_dedup_multi_iter_next (&iter))
+		hash += _nm_ip_config_hash_obj (iter.current->obj);
+	return hash;
+}
+
+static gboolean
+_obj_equal (const NMPObject *a, const NMPObject *b)
+{
+	nm_assert (NMP_OBJECT_GET_TYPE (a) == NMP_OBJECT_GET_TYPE (b));
+
+	switch (NMP_OBJECT_GET_TYPE (a)) {
+	case NMP_OBJECT_TYPE_IP4_ADDRESS: {
+		const NMPlatformIP4Address *x = NMP_OBJECT_CAST_IP4_ADDRESS (a);
+		const NMPlatformIP4Address *y = NMP_OBJECT_CAST_IP4_ADDRESS (b);
+
+		return    x->address == y->address
+		       && x->plen == y->plen
+		       && ((x->peer_address ^ y->peer_address) & _nm_utils_ip4_prefix_to_netmask (x->plen)) == 0;
+	}
+	case NMP_OBJECT_TYPE_IP6_ADDRESS: {
+		const NMPlatformIP6Address *x = NMP_OBJECT_CAST_IP6_ADDRESS (a);
+		const NMPlatformIP6Address *y = NMP_OBJECT_CAST_IP6_ADDRESS (b);
+
+		return    IN6_ARE_ADDR_EQUAL (&x->address, &y->address)
+		       && x->plen == y->plen;
+	}
+	case NMP_OBJECT_TYPE_IP4_ROUTE: {
+		const NMPlatformIP4Route *x = NMP_OBJECT_CAST_IP4_ROUTE (a);
+		const NMPlatformIP4Route *y = NMP_OBJECT_CAST_IP4_ROUTE (b);
+
+		return    x->network == y->network
+		       && x->plen == y->plen
+		       && x->gateway == y->gateway
+		       && x->metric == y->metric;
+	}
+	case NMP_OBJECT_TYPE_IP6_ROUTE: {
+		const NMPlatformIP6Route *x = NMP_OBJECT_CAST_IP6_ROUTE (a);
+		const NMPlatformIP6Route *y = NMP_OBJECT_CAST_IP6_ROUTE (b);
+
+		return    IN6_ARE_ADDR_EQUAL (&x->network, &y->network)
+		       && x->plen == y->plen
+		       && IN6_ARE_ADDR_EQUAL (&x->gateway, &y->gateway)
+		       && x->metric == y->metric;
+	}
+	default:
+		g_return_val_if_reached (FALSE);
+	}
+}
+
+gboolean
+_nm_ip_config_objs_equal (const NMDedupMultiHeadEntry *head_a, const NMDedupMultiHeadEntry *head_b)
+{
+	NMDedupMultiIter iter_a, iter_b;
+
+	if ((head_a ? head_a->len : 0) != (head_b ? head_b->len : 0))
+		return FALSE;
+
+	nm_dedup_multi_iter_init (&iter_a, head_a);
+	nm_dedup_multi_iter_init (&iter_b, head_b);
+	while (nm_dedup_multi_iter_next (&iter_a)) {
+		if (!nm_dedup_multi_iter_next (&iter_b))
+			g_return_val_if_reached (FALSE);
+		if (!_obj_equal (iter_a.current->obj, iter_b.current->obj))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+/* Array elements are hashed together with their index, so that the
+ * sum of the element hashes depends on the order. */
+guint64
+_nm_ip_config_hash_arr_elem (NMIPConfigHashSeed seed, guint idx, gconstpointer elem, gsize elem_size)
+{
+	NMHashState h;
+
+	nm_hash_init (&h, seed);
+	nm_hash_update_val (&h, idx);
+	nm_hash_update (&h, elem, elem_size);
+	return nm_hash_complete_u64 (&h);
+}
+
+guint64
+_nm_ip_config_hash_arr (NMIPConfigHashSeed seed, const GArray *arr)
+{
+	guint64 hash = 0;
+	guint i;
+	guint elt_size;
+
+	elt_size = g_array_get_element_size ((GArray *) arr);
+	for (i = 0; i < arr->len; i++)
+		hash += _nm_ip_config_hash_arr_elem (seed, i, &arr->data[i * elt_size], elt_size);
+	return hash;
+}
+
+guint64
+_nm_ip_config_hash_strarr_elem (NMIPConfigHashSeed seed, guint idx, const char *str)
+{
+	NMHashState h;
+
+	if (!str)
+		return 0;
+
+	nm_hash_init (&h, seed);
+	nm_hash_update_val (&h, idx);
+	nm_hash_update_str (&h, str);
+	return nm_hash_complete_u64 (&h);
+}
+
+guint64
+_nm_ip_config_hash_strarr (NMIPConfigHashSeed seed, const GPtrArray *arr)
+{
+	guint64 hash = 0;
+	guint i;
+
+	for (i = 0; i < arr->len; i++)
+		hash += _nm_ip_config_hash_strarr_elem (seed, i, arr->pdata[i]);
+	return hash;
+}
+
+gboolean
+_nm_ip_config_arr_equal (const GArray *a, const GArray *b)
+{
+	guint elt_size;
+
+	if (a->len != b->len)
+		return FALSE;
+	elt_size = g_array_get_element_size ((GArray *) a);
+	nm_assert (elt_size == g_array_get_element_size ((GArray *) b));
+	return a->len == 0 || memcmp (a->data, b->data, (gsize) a->len * elt_size) == 0;
+}
+
+gboolean
+_nm_ip_config_strarr_equal (const GPtrArray *a, const GPtrArray *b)
+{
+	guint i;
+
+	if (a->len != b->len)
+		return FALSE;
+	for (i = 0; i < a->len; i++) {
+		if (!nm_streq (a->pdata[i], b->pdata[i]))
+			return FALSE;
+	}
+	return TRUE;
+}
+
 /**
  * _nm_ip_config_lookup_ip_route:
  * @multi_idx:
@@ -300,10 +595,17 @@ typedef struct {
 	GArray *nis;
 	char *nis_domain;
 	GArray *wins;
+	guint64 hash_addresses;
+	guint64 hash_routes;
+	guint64 hash_dns;
+	guint64 hash_nis;
+	guint64 version;
 	GVariant *address_data_variant;
 	GVariant *addresses_variant;
 	GVariant *route_data_variant;
 	GVariant *routes_variant;
+	GHashTable *address_data_children;
+	GHashTable *route_data_children;
 	NMDedupMultiIndex *multi_idx;
 	const NMPObject *best_default_route;
 	union {
@@ -339,6 +641,18 @@ static const NMDedupMultiEntry *_lookup_route (const NMIP4Config *self,
 
 /*****************************************************************************/
 
+static guint64
+_hash_dns (const NMIP4ConfigPrivate *priv)
+{
+	return   _nm_ip_config_hash_arr (NM_IP_CONFIG_HASH_SEED_NAMESERVER, priv->nameservers)
+	       + _nm_ip_config_hash_arr (NM_IP_CONFIG_HASH_SEED_WINS, priv->wins)
+	       + _nm_ip_config_hash_strarr (NM_IP_CONFIG_HASH_SEED_DOMAIN, priv->domains)
+	       + _nm_ip_config_hash_strarr (NM_IP_CONFIG_HASH_SEED_SEARCH, priv->searches)
+	       + _nm_ip_config_hash_strarr (NM_IP_CONFIG_HASH_SEED_DNS_OPTION, priv->dns_options);
+}
+
+/*****************************************************************************/
+
 int
 nm_ip4_config_get_ifindex (const NMIP4Config *self)
 {
@@ -502,6 +816,12 @@ nmtst_ip4_config_get_gateway (NMIP4Config *config)
 
 /*****************************************************************************/
 
+static void
+_version_bump (NMIP4ConfigPrivate *priv)
+{
+	priv->version = _nm_ip_config_version_next ();
+}
+
 static void
 _notify_addresses (NMIP4Config *self)
 {
@@ -509,6 +829,7 @@ _notify_addresses (NMIP4Config *self)
 
 	nm_clear_g_variant (&priv->address_data_variant);
 	nm_clear_g_variant (&priv->addresses_variant);
+	_version_bump (priv);
 	_notify (self, PROP_ADDRESS_DATA);
 	_notify (self, PROP_ADDRESSES);
 }
@@ -521,6 +842,7 @@ _notify_routes (NMIP4Config *self)
 	nm_assert (priv->best_default_route == _nm_ip4_config_best_default_route_find (self));
 	nm_clear_g_variant (&priv->route_data_variant);
 	nm_clear_g_variant (&priv->routes_variant);
+	_version_bump (priv);
 	_notify (self, PROP_ROUTE_DATA);
 	_notify (self, PROP_ROUTES);
 }
@@ -612,6 +934,7 @@ nm_ip4_config_capture (NMDedupMultiIndex *multi_idx, NMPlatform *platform, int i
 			                            NULL,
 			                            FALSE,
 			                            TRUE,
+			                            &priv->hash_addresses,
 			                            NULL,
 			                            NULL))
 				nm_assert_not_reached ();
@@ -645,8 +968,11 @@ nm_ip4_config_capture (NMDedupMultiIndex *multi_idx, NMPlatform *platform, int i
 			if (nm_utils_resolve_conf_parse (AF_INET,
 			                                 rc_contents,
 			                                 priv->nameservers,
-			                                 priv->dns_options))
+			                                 priv->dns_options)) {
+				priv->hash_dns = _hash_dns (priv);
+				_version_bump (priv);
 				_notify (self, PROP_NAMESERVERS);
+			}
 		}
 	}
 
@@ -1359,11 +1685,15 @@ nm_ip4_config_subtract (NMIP4Config *dst,
 	/* addresses */
 	changed = FALSE;
 	nm_ip_config_iter_ip4_address_for_each (&ipconf_iter, src, &a) {
+		nm_auto_nmpobj const NMPObject *obj_old = NULL;
+
 		if (nm_dedup_multi_index_remove_obj (dst_priv->multi_idx,
 		                                     &dst_priv->idx_ip4_addresses,
 		                                     NMP_OBJECT_UP_CAST (a),
-		                                     NULL))
+		                                     (gconstpointer *) &obj_old)) {
+			dst_priv->hash_addresses -= _nm_ip_config_hash_obj (obj_old);
 			changed = TRUE;
+		}
 	}
 	if (changed)
 		_notify_addresses (dst);
@@ -1401,6 +1731,7 @@ nm_ip4_config_subtract (NMIP4Config *dst,
 		                                     &dst_priv->idx_ip4_routes,
 		                                     o_lookup,
 		                                     (gconstpointer *) &obj_old)) {
+			dst_priv->hash_routes -= _nm_ip_config_hash_obj (obj_old);
 			if (dst_priv->best_default_route == obj_old) {
 				nm_clear_nmp_object (&dst_priv->best_default_route);
 				changed_default_route = TRUE;
@@ -1495,6 +1826,7 @@ nm_ip4_config_intersect (NMIP4Config *dst,
 		                                     NMP_OBJECT_UP_CAST (a)))
 			continue;
 
+		dst_priv->hash_addresses -= _nm_ip_config_hash_obj (ipconf_iter.current->obj);
 		if (nm_dedup_multi_index_remove_entry (dst_priv->multi_idx,
 		                                       ipconf_iter.current) != 1)
 			nm_assert_not_reached ();
@@ -1533,6 +1865,7 @@ nm_ip4_config_intersect (NMIP4Config *dst,
 			continue;
 		}
 
+		dst_priv->hash_routes -= _nm_ip_config_hash_obj (ipconf_iter.current->obj);
 		if (nm_dedup_multi_index_remove_entry (dst_priv->multi_idx,
 		                                       ipconf_iter.current) != 1)
 			nm_assert_not_reached ();
@@ -1643,9 +1976,11 @@ nm_ip4_config_replace (NMIP4Config *dst, const NMIP4Config *src, gboolean *relev
 			                       FALSE,
 			                       TRUE,
 			                       NULL,
+			                       NULL,
 			                       NULL);
 		}
 		nm_dedup_multi_index_dirty_remove_idx (dst_priv->multi_idx, &dst_priv->idx_ip4_addresses, FALSE);
+		dst_priv->hash_addresses = src_priv->hash_addresses;
 		_notify_addresses (dst);
 	}
 
@@ -1695,10 +2030,12 @@ nm_ip4_config_replace (NMIP4Config *dst, const NMIP4Config *src, gboolean *relev
 			                       FALSE,
 			                       TRUE,
 			                       NULL,
+			                       NULL,
 			                       &obj_new);
 			new_best_default_route = _nm_ip_config_best_default_route_find_better (new_best_default_route, obj_new);
 		}
 		nm_dedup_multi_index_dirty_remove_idx (dst_priv->multi_idx, &dst_priv->idx_ip4_routes, FALSE);
+		dst_priv->hash_routes = src_priv->hash_routes;
 		if (_nm_ip_config_best_default_route_set (&dst_priv->best_default_route, new_best_default_route))
 			_notify (dst, PROP_GATEWAY);
 		_notify_routes (dst);
@@ -1836,7 +2173,7 @@ nm_ip4_config_replace (NMIP4Config *dst, const NMIP4Config *src, gboolean *relev
 
 	/* metered */
 	if (src_priv->metered != dst_priv->metered) {
-		dst_priv->metered = src_priv->metered;
+		nm_ip4_config_set_metered (dst, src_priv->metered);
 		has_minor_changes = TRUE;
 	}
 
@@ -1929,6 +2266,7 @@ nm_ip4_config_reset_addresses (NMIP4Config *self)
 {
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
+	priv->hash_addresses = 0;
 	if (nm_dedup_multi_index_remove_idx (priv->multi_idx,
 	                                     &priv->idx_ip4_addresses) > 0)
 		_notify_addresses (self);
@@ -1946,6 +2284,7 @@ _add_address (NMIP4Config *self, const NMPObject *obj_new, const NMPlatformIP4Ad
 	                           (const NMPlatformObject *) new,
 	                           TRUE,
 	                           FALSE,
+	                           &priv->hash_addresses,
 	                           NULL,
 	                           NULL))
 		_notify_addresses (self);
@@ -2061,6 +2400,7 @@ nm_ip4_config_reset_routes (NMIP4Config *self)
 {
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
+	priv->hash_routes = 0;
 	if (nm_dedup_multi_index_remove_idx (priv->multi_idx,
 	                                     &priv->idx_ip4_routes) > 0) {
 		if (nm_clear_nmp_object (&priv->best_default_route))
@@ -2090,6 +2430,7 @@ _add_route (NMIP4Config *self,
 	                           (const NMPlatformObject *) new,
 	                           TRUE,
 	                           FALSE,
+	                           &priv->hash_routes,
 	                           &obj_old,
 	                           &obj_new_2)) {
 		gboolean changed_default_route = FALSE;
@@ -2212,7 +2553,9 @@ nm_ip4_config_reset_nameservers (NMIP4Config *self)
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
 	if (priv->nameservers->len != 0) {
+		priv->hash_dns -= _nm_ip_config_hash_arr (NM_IP_CONFIG_HASH_SEED_NAMESERVER, priv->nameservers);
 		g_array_set_size (priv->nameservers, 0);
+		_version_bump (priv);
 		_notify (self, PROP_NAMESERVERS);
 	}
 }
@@ -2229,7 +2572,9 @@ nm_ip4_config_add_nameserver (NMIP4Config *self, guint32 new)
 		if (new == g_array_index (priv->nameservers, guint32, i))
 			return;
 
+	priv->hash_dns += _nm_ip_config_hash_arr_elem (NM_IP_CONFIG_HASH_SEED_NAMESERVER, priv->nameservers->len, &new, sizeof (new));
 	g_array_append_val (priv->nameservers, new);
+	_version_bump (priv);
 	_notify (self, PROP_NAMESERVERS);
 }
 
@@ -2240,7 +2585,10 @@ nm_ip4_config_del_nameserver (NMIP4Config *self, guint i)
 
 	g_return_if_fail (i < priv->nameservers->len);
 
+	priv->hash_dns -= _nm_ip_config_hash_arr (NM_IP_CONFIG_HASH_SEED_NAMESERVER, priv->nameservers);
 	g_array_remove_index (priv->nameservers, i);
+	priv->hash_dns += _nm_ip_config_hash_arr (NM_IP_CONFIG_HASH_SEED_NAMESERVER, priv->nameservers);
+	_version_bump (priv);
 	_notify (self, PROP_NAMESERVERS);
 }
 
@@ -2276,7 +2624,9 @@ nm_ip4_config_reset_domains (NMIP4Config *self)
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
 	if (priv->domains->len != 0) {
+		priv->hash_dns -= _nm_ip_config_hash_strarr (NM_IP_CONFIG_HASH_SEED_DOMAIN, priv->domains);
 		g_ptr_array_set_size (priv->domains, 0);
+		_version_bump (priv);
 		_notify (self, PROP_DOMAINS);
 	}
 }
@@ -2294,7 +2644,9 @@ nm_ip4_config_add_domain (NMIP4Config *self, const char *domain)
 		if (!g_strcmp0 (g_ptr_array_index (priv->domains, i), domain))
 			return;
 
+	priv->hash_dns += _nm_ip_config_hash_strarr_elem (NM_IP_CONFIG_HASH_SEED_DOMAIN, priv->domains->len, domain);
 	g_ptr_array_add (priv->domains, g_strdup (domain));
+	_version_bump (priv);
 	_notify (self, PROP_DOMAINS);
 }
 
@@ -2305,7 +2657,10 @@ nm_ip4_config_del_domain (NMIP4Config *self, guint i)
 
 	g_return_if_fail (i < priv->domains->len);
 
+	priv->hash_dns -= _nm_ip_config_hash_strarr (NM_IP_CONFIG_HASH_SEED_DOMAIN, priv->domains);
 	g_ptr_array_remove_index (priv->domains, i);
+	priv->hash_dns += _nm_ip_config_hash_strarr (NM_IP_CONFIG_HASH_SEED_DOMAIN, priv->domains);
+	_version_bump (priv);
 	_notify (self, PROP_DOMAINS);
 }
 
@@ -2333,7 +2688,9 @@ nm_ip4_config_reset_searches (NMIP4Config *self)
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
 	if (priv->searches->len != 0) {
+		priv->hash_dns -= _nm_ip_config_hash_strarr (NM_IP_CONFIG_HASH_SEED_SEARCH, priv->searches);
 		g_ptr_array_set_size (priv->searches, 0);
+		_version_bump (priv);
 		_notify (self, PROP_SEARCHES);
 	}
 }
@@ -2366,7 +2723,9 @@ nm_ip4_config_add_search (NMIP4Config *self, const char *new)
 		return;
 	}
 
+	priv->hash_dns += _nm_ip_config_hash_strarr_elem (NM_IP_CONFIG_HASH_SEED_SEARCH, priv->searches->len, search);
 	g_ptr_array_add (priv->searches, search);
+	_version_bump (priv);
 	_notify (self, PROP_SEARCHES);
 }
 
@@ -2377,7 +2736,10 @@ nm_ip4_config_del_search (NMIP4Config *self, guint i)
 
 	g_return_if_fail (i < priv->searches->len);
 
+	priv->hash_dns -= _nm_ip_config_hash_strarr (NM_IP_CONFIG_HASH_SEED_SEARCH, priv->searches);
 	g_ptr_array_remove_index (priv->searches, i);
+	priv->hash_dns += _nm_ip_config_hash_strarr (NM_IP_CONFIG_HASH_SEED_SEARCH, priv->searches);
+	_version_bump (priv);
 	_notify (self, PROP_SEARCHES);
 }
 
@@ -2405,7 +2767,9 @@ nm_ip4_config_reset_dns_options (NMIP4Config *self)
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
 	if (priv->dns_options->len != 0) {
+		priv->hash_dns -= _nm_ip_config_hash_strarr (NM_IP_CONFIG_HASH_SEED_DNS_OPTION, priv->dns_options);
 		g_ptr_array_set_size (priv->dns_options, 0);
+		_version_bump (priv);
 		_notify (self, PROP_DNS_OPTIONS);
 	}
 }
@@ -2423,7 +2787,9 @@ nm_ip4_config_add_dns_option (NMIP4Config *self, const char *new)
 		if (!g_strcmp0 (g_ptr_array_index (priv->dns_options, i), new))
 			return;
 
+	priv->hash_dns += _nm_ip_config_hash_strarr_elem (NM_IP_CONFIG_HASH_SEED_DNS_OPTION, priv->dns_options->len, new);
 	g_ptr_array_add (priv->dns_options, g_strdup (new));
+	_version_bump (priv);
 	_notify (self, PROP_DNS_OPTIONS);
 }
 
@@ -2434,7 +2800,10 @@ nm_ip4_config_del_dns_option(NMIP4Config *self, guint i)
 
 	g_return_if_fail (i < priv->dns_options->len);
 
+	priv->hash_dns -= _nm_ip_config_hash_strarr (NM_IP_CONFIG_HASH_SEED_DNS_OPTION, priv->dns_options);
 	g_ptr_array_remove_index (priv->dns_options, i);
+	priv->hash_dns += _nm_ip_config_hash_strarr (NM_IP_CONFIG_HASH_SEED_DNS_OPTION, priv->dns_options);
+	_version_bump (priv);
 	_notify (self, PROP_DNS_OPTIONS);
 }
 
@@ -2463,6 +2832,7 @@ nm_ip4_config_set_dns_priority (NMIP4Config *self, gint priority)
 
 	if (priority != priv->dns_priority) {
 		priv->dns_priority = priority;
+		_version_bump (priv);
 		_notify (self, PROP_DNS_PRIORITY);
 	}
 }
@@ -2482,7 +2852,9 @@ nm_ip4_config_reset_nis_servers (NMIP4Config *self)
 {
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
+	priv->hash_nis -= _nm_ip_config_hash_arr (NM_IP_CONFIG_HASH_SEED_NIS, priv->nis);
 	g_array_set_size (priv->nis, 0);
+	_version_bump (priv);
 }
 
 void
@@ -2495,7 +2867,9 @@ nm_ip4_config_add_nis_server (NMIP4Config *self, guint32 nis)
 		if (nis == g_array_index (priv->nis, guint32, i))
 			return;
 
+	priv->hash_nis += _nm_ip_config_hash_arr_elem (NM_IP_CONFIG_HASH_SEED_NIS, priv->nis->len, &nis, sizeof (nis));
 	g_array_append_val (priv->nis, nis);
+	_version_bump (priv);
 }
 
 void
@@ -2505,7 +2879,10 @@ nm_ip4_config_del_nis_server (NMIP4Config *self, guint i)
 
 	g_return_if_fail (i < priv->nis->len);
 
+	priv->hash_nis -= _nm_ip_config_hash_arr (NM_IP_CONFIG_HASH_SEED_NIS, priv->nis);
 	g_array_remove_index (priv->nis, i);
+	priv->hash_nis += _nm_ip_config_hash_arr (NM_IP_CONFIG_HASH_SEED_NIS, priv->nis);
+	_version_bump (priv);
 }
 
 guint
@@ -2529,8 +2906,11 @@ nm_ip4_config_set_nis_domain (NMIP4Config *self, const char *domain)
 {
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
+	priv->hash_nis -= _nm_ip_config_hash_strarr_elem (NM_IP_CONFIG_HASH_SEED_NIS_DOMAIN, 0, priv->nis_domain);
 	g_free (priv->nis_domain);
 	priv->nis_domain = g_strdup (domain);
+	priv->hash_nis += _nm_ip_config_hash_strarr_elem (NM_IP_CONFIG_HASH_SEED_NIS_DOMAIN, 0, priv->nis_domain);
+	_version_bump (priv);
 }
 
 const char *
@@ -2549,7 +2929,9 @@ nm_ip4_config_reset_wins (NMIP4Config *self)
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
 	if (priv->wins->len != 0) {
+		priv->hash_dns -= _nm_ip_config_hash_arr (NM_IP_CONFIG_HASH_SEED_WINS, priv->wins);
 		g_array_set_size (priv->wins, 0);
+		_version_bump (priv);
 		_notify (self, PROP_WINS_SERVERS);
 	}
 }
@@ -2566,7 +2948,9 @@ nm_ip4_config_add_wins (NMIP4Config *self, guint32 wins)
 		if (wins == g_array_index (priv->wins, guint32, i))
 			return;
 
+	priv->hash_dns += _nm_ip_config_hash_arr_elem (NM_IP_CONFIG_HASH_SEED_WINS, priv->wins->len, &wins, sizeof (wins));
 	g_array_append_val (priv->wins, wins);
+	_version_bump (priv);
 	_notify (self, PROP_WINS_SERVERS);
 }
 
@@ -2577,7 +2961,10 @@ nm_ip4_config_del_wins (NMIP4Config *self, guint i)
 
 	g_return_if_fail (i < priv->wins->len);
 
+	priv->hash_dns -= _nm_ip_config_hash_arr (NM_IP_CONFIG_HASH_SEED_WINS, priv->wins);
 	g_array_remove_index (priv->wins, i);
+	priv->hash_dns += _nm_ip_config_hash_arr (NM_IP_CONFIG_HASH_SEED_WINS, priv->wins);
+	_version_bump (priv);
 	_notify (self, PROP_WINS_SERVERS);
 }
 
@@ -2609,6 +2996,7 @@ nm_ip4_config_set_mtu (NMIP4Config *self, guint32 mtu, NMIPConfigSource source)
 
 	priv->mtu = mtu;
 	priv->mtu_source = source;
+	_version_bump (priv);
 }
 
 guint32
@@ -2635,6 +3023,7 @@ nm_ip4_config_set_metered (NMIP4Config *self, gboolean metered)
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
 	priv->metered = metered;
+	_version_bump (priv);
 }
 
 gboolean
@@ -2708,9 +3097,11 @@ nm_ip4_config_nmpobj_remove (NMIP4Config *self,
 
 	switch (NMP_OBJECT_GET_TYPE (obj_old)) {
 	case NMP_OBJECT_TYPE_IP4_ADDRESS:
+		priv->hash_addresses -= _nm_ip_config_hash_obj (obj_old);
 		_notify_addresses (self);
 		break;
 	case NMP_OBJECT_TYPE_IP4_ROUTE:
+		priv->hash_routes -= _nm_ip_config_hash_obj (obj_old);
 		if (priv->best_default_route == obj_old) {
 			if (_nm_ip_config_best_default_route_set (&priv->best_default_route,
 			                                          _nm_ip4_config_best_default_route_find (self)))
@@ -2726,66 +3117,87 @@ nm_ip4_config_nmpobj_remove (NMIP4Config *self,
 
 /*****************************************************************************/
 
-static inline void
-hash_u32 (GChecksum *sum, guint32 n)
-{
-	g_checksum_update (sum, (const guint8 *) &n, sizeof (n));
-}
-
-void
-nm_ip4_config_hash (const NMIP4Config *self, GChecksum *sum, gboolean dns_only)
+/**
+ * nm_ip4_config_get_content_hash:
+ * @self: the #NMIP4Config
+ * @dns_only: whether to only consider the DNS related parts
+ *
+ * The hash is updated whenever an item is added or removed, so this
+ * is cheap. It only considers the attributes that nm_ip4_config_equal()
+ * compares.
+ *
+ * Returns: a 64 bit hash of the content of @self.
+ */
+guint64
+nm_ip4_config_get_content_hash (const NMIP4Config *self, gboolean dns_only)
 {
-	guint i;
-	const char *s;
-	NMDedupMultiIter ipconf_iter;
-	const NMPlatformIP4Address *address;
-	const NMPlatformIP4Route *route;
+	const NMIP4ConfigPrivate *priv;
 
-	g_return_if_fail (self);
-	g_return_if_fail (sum);
+	g_return_val_if_fail (NM_IS_IP4_CONFIG (self), 0);
 
-	if (!dns_only) {
-		nm_ip_config_iter_ip4_address_for_each (&ipconf_iter, self, &address) {
-			hash_u32 (sum, address->address);
-			hash_u32 (sum, address->plen);
-			hash_u32 (sum, address->peer_address & _nm_utils_ip4_prefix_to_netmask (address->plen));
-		}
+	priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
-		nm_ip_config_iter_ip4_route_for_each (&ipconf_iter, self, &route) {
-			hash_u32 (sum, route->network);
-			hash_u32 (sum, route->plen);
-			hash_u32 (sum, route->gateway);
-			hash_u32 (sum, route->metric);
-		}
+	nm_assert (priv->hash_dns == _hash_dns (priv));
+	nm_assert (priv->hash_addresses == _nm_ip_config_hash_objs (nm_ip4_config_lookup_addresses (self)));
+	nm_assert (priv->hash_routes == _nm_ip_config_hash_objs (nm_ip4_config_lookup_routes (self)));
 
-		for (i = 0; i < nm_ip4_config_get_num_nis_servers (self); i++)
-			hash_u32 (sum, nm_ip4_config_get_nis_server (self, i));
+	if (dns_only)
+		return priv->hash_dns;
+	return priv->hash_dns + priv->hash_addresses + priv->hash_routes + priv->hash_nis;
+}
 
-		s = nm_ip4_config_get_nis_domain (self);
-		if (s)
-			g_checksum_update (sum, (const guint8 *) s, strlen (s));
-	}
+/**
+ * nm_ip4_config_get_version:
+ * @self: the #NMIP4Config
+ *
+ * Every modification of @self assigns it a new version, unique among
+ * all #NMIP4Config and #NMIP6Config instances. A caller that derived
+ * state from @self can remember the version and later tell cheaply
+ * whether @self changed in the meantime.
+ *
+ * Returns: the current version of @self.
+ */
+guint64
+nm_ip4_config_get_version (const NMIP4Config *self)
+{
+	g_return_val_if_fail (NM_IS_IP4_CONFIG (self), 0);
 
-	for (i = 0; i < nm_ip4_config_get_num_nameservers (self); i++)
-		hash_u32 (sum, nm_ip4_config_get_nameserver (self, i));
+	return NM_IP4_CONFIG_GET_PRIVATE (self)->version;
+}
 
-	for (i = 0; i < nm_ip4_config_get_num_wins (self); i++)
-		hash_u32 (sum, nm_ip4_config_get_wins (self, i));
+static gboolean
+_equal_full (const NMIP4Config *a, const NMIP4Config *b)
+{
+	const NMIP4ConfigPrivate *a_priv = NM_IP4_CONFIG_GET_PRIVATE (a);
+	const NMIP4ConfigPrivate *b_priv = NM_IP4_CONFIG_GET_PRIVATE (b);
 
-	for (i = 0; i < nm_ip4_config_get_num_domains (self); i++) {
-		s = nm_ip4_config_get_domain (self, i);
-		g_checksum_update (sum, (const guint8 *) s, strlen (s));
-	}
+	return    _nm_ip_config_objs_equal (nm_ip4_config_lookup_addresses (a),
+	                                    nm_ip4_config_lookup_addresses (b))
+	       && _nm_ip_config_objs_equal (nm_ip4_config_lookup_routes (a),
+	                                    nm_ip4_config_lookup_routes (b))
+	       && _nm_ip_config_arr_equal (a_priv->nis, b_priv->nis)
+	       && nm_streq0 (a_priv->nis_domain, b_priv->nis_domain)
+	       && _nm_ip_config_arr_equal (a_priv->nameservers, b_priv->nameservers)
+	       && _nm_ip_config_arr_equal (a_priv->wins, b_priv->wins)
+	       && _nm_ip_config_strarr_equal (a_priv->domains, b_priv->domains)
+	       && _nm_ip_config_strarr_equal (a_priv->searches, b_priv->searches)
+	       && _nm_ip_config_strarr_equal (a_priv->dns_options, b_priv->dns_options);
+}
 
-	for (i = 0; i < nm_ip4_config_get_num_searches (self); i++) {
-		s = nm_ip4_config_get_search (self, i);
-		g_checksum_update (sum, (const guint8 *) s, strlen (s));
-	}
+static gboolean
+_is_empty (const NMIP4Config *self)
+{
+	const NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
-	for (i = 0; i < nm_ip4_config_get_num_dns_options (self); i++) {
-		s = nm_ip4_config_get_dns_option (self, i);
-		g_checksum_update (sum, (const guint8 *) s, strlen (s));
-	}
+	return    nm_ip4_config_get_num_addresses (self) == 0
+	       && nm_ip4_config_get_num_routes (self) == 0
+	       && priv->nis->len == 0
+	       && !priv->nis_domain
+	       && priv->nameservers->len == 0
+	       && priv->wins->len == 0
+	       && priv->domains->len == 0
+	       && priv->searches->len == 0
+	       && priv->dns_options->len == 0;
 }
 
 /**
@@ -2796,7 +3208,10 @@ nm_ip4_config_hash (const NMIP4Config *self, GChecksum *sum, gboolean dns_only)
  * Compares two #NMIP4Configs for basic equality.  This means that all
  * attributes must exist in the same order in both configs (addresses, routes,
  * domains, DNS servers, etc) but some attributes (address lifetimes, and address
- * and route sources) are ignored.
+ * and route sources) are ignored. A %NULL config is equal to an empty one.
+ *
+ * The content hashes are compared first, the attributes themselves only
+ * if the hashes match.
  *
  * Returns: %TRUE if the configurations are basically equal to each other,
  * %FALSE if not
@@ -2804,118 +3219,229 @@ nm_ip4_config_hash (const NMIP4Config *self, GChecksum *sum, gboolean dns_only)
 gboolean
 nm_ip4_config_equal (const NMIP4Config *a, const NMIP4Config *b)
 {
-	GChecksum *a_checksum = g_checksum_new (G_CHECKSUM_SHA1);
-	GChecksum *b_checksum = g_checksum_new (G_CHECKSUM_SHA1);
-	gsize a_len = g_checksum_type_get_length (G_CHECKSUM_SHA1);
-	gsize b_len = g_checksum_type_get_length (G_CHECKSUM_SHA1);
-	guchar a_data[a_len], b_data[b_len];
-	gboolean equal;
+	if (a == b)
+		return TRUE;
+	if (!a)
+		return _is_empty (b);
+	if (!b)
+		return _is_empty (a);
 
-	if (a)
-		nm_ip4_config_hash (a, a_checksum, FALSE);
-	if (b)
-		nm_ip4_config_hash (b, b_checksum, FALSE);
+	if (nm_ip4_config_get_content_hash (a, FALSE) != nm_ip4_config_get_content_hash (b, FALSE))
+		return FALSE;
 
-	g_checksum_get_digest (a_checksum, a_data, &a_len);
-	g_checksum_get_digest (b_checksum, b_data, &b_len);
+	return _equal_full (a, b);
+}
 
-	g_assert (a_len == b_len);
-	equal = !memcmp (a_data, b_data, a_len);
+/*****************************************************************************/
 
-	g_checksum_free (a_checksum);
-	g_checksum_free (b_checksum);
+static GVariant *
+_address_to_variant (const NMPlatformIP4Address *address)
+{
+	GVariantBuilder addr_builder;
 
-	return equal;
-}
+	g_variant_builder_init (&addr_builder, G_VARIANT_TYPE ("a{sv}"));
+	g_variant_builder_add (&addr_builder, "{sv}",
+	                       "address",
+	                       g_variant_new_string (nm_utils_inet4_ntop (address->address, NULL)));
+	g_variant_builder_add (&addr_builder, "{sv}",
+	                       "prefix",
+	                       g_variant_new_uint32 (address->plen));
+	if (address->peer_address != address->address) {
+		g_variant_builder_add (&addr_builder, "{sv}",
+		                       "peer",
+		                       g_variant_new_string (nm_utils_inet4_ntop (address->peer_address, NULL)));
+	}
 
-/*****************************************************************************/
+	if (*address->label) {
+		g_variant_builder_add (&addr_builder, "{sv}",
+		                       "label",
+		                       g_variant_new_string (address->label));
+	}
+
+	return g_variant_builder_end (&addr_builder);
+}
 
 static void
-get_property (GObject *object, guint prop_id,
-              GValue *value, GParamSpec *pspec)
+_address_data_ensure (NMIP4Config *self)
 {
-	NMIP4Config *self = NM_IP4_CONFIG (object);
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
+	gs_unref_hashtable GHashTable *children_old = NULL;
 	const NMDedupMultiHeadEntry *head_entry;
-	NMDedupMultiIter ipconf_iter;
-	const NMPlatformIP4Route *route;
 	GVariantBuilder builder_data, builder_legacy;
 
-	switch (prop_id) {
-	case PROP_IFINDEX:
-		g_value_set_int (value, priv->ifindex);
-		break;
-	case PROP_ADDRESS_DATA:
-	case PROP_ADDRESSES:
-		nm_assert (!!priv->address_data_variant == !!priv->addresses_variant);
+	nm_assert (!!priv->address_data_variant == !!priv->addresses_variant);
 
-		if (priv->address_data_variant)
-			goto out_addresses_cached;
+	if (priv->address_data_variant)
+		return;
 
-		g_variant_builder_init (&builder_data, G_VARIANT_TYPE ("aa{sv}"));
-		g_variant_builder_init (&builder_legacy, G_VARIANT_TYPE ("aau"));
+	children_old = g_steal_pointer (&priv->address_data_children);
+	priv->address_data_children = _nm_ip_config_variant_cache_new ();
 
-		head_entry = nm_ip4_config_lookup_addresses (self);
-		if (head_entry) {
-			gs_free const NMPObject **addresses = NULL;
-			guint naddr, i;
-
-			addresses = (const NMPObject **) nm_dedup_multi_objs_to_array_head (head_entry, NULL, NULL, &naddr);
-			nm_assert (addresses && naddr);
-
-			g_qsort_with_data (addresses,
-			                   naddr,
-			                   sizeof (addresses[0]),
-			                   _addresses_sort_cmp,
-			                   NULL);
-
-			/* Build address data variant */
-			for (i = 0; i < naddr; i++) {
-				GVariantBuilder addr_builder;
-				const NMPlatformIP4Address *address = NMP_OBJECT_CAST_IP4_ADDRESS (addresses[i]);
-
-				g_variant_builder_init (&addr_builder, G_VARIANT_TYPE ("a{sv}"));
-				g_variant_builder_add (&addr_builder, "{sv}",
-				                       "address",
-				                       g_variant_new_string (nm_utils_inet4_ntop (address->address, NULL)));
-				g_variant_builder_add (&addr_builder, "{sv}",
-				                       "prefix",
-				                       g_variant_new_uint32 (address->plen));
-				if (address->peer_address != address->address) {
-					g_variant_builder_add (&addr_builder, "{sv}",
-					                       "peer",
-					                       g_variant_new_string (nm_utils_inet4_ntop (address->peer_address, NULL)));
-				}
+	g_variant_builder_init (&builder_data, G_VARIANT_TYPE ("aa{sv}"));
+	g_variant_builder_init (&builder_legacy, G_VARIANT_TYPE ("aau"));
 
-				if (*address->label) {
-					g_variant_builder_add (&addr_builder, "{sv}",
-					                       "label",
-					                       g_variant_new_string (address->label));
-				}
+	head_entry = nm_ip4_config_lookup_addresses (self);
+	if (head_entry) {
+		gs_free const NMPObject **addresses = NULL;
+		guint naddr, i;
+
+		addresses = (const NMPObject **) nm_dedup_multi_objs_to_array_head (head_entry, NULL, NULL, &naddr);
+		nm_assert (addresses && naddr);
+
+		g_qsort_with_data (addresses,
+		                   naddr,
+		                   sizeof (addresses[0]),
+		                   _addresses_sort_cmp,
+		                   NULL);
+
+		/* Build address data variant */
+		for (i = 0; i < naddr; i++) {
+			const NMPlatformIP4Address *address = NMP_OBJECT_CAST_IP4_ADDRESS (addresses[i]);
+			GVariant *child;
+
+			child = _nm_ip_config_variant_cache_move (children_old, priv->address_data_children, addresses[i]);
+			if (!child) {
+				child = _nm_ip_config_variant_cache_add (priv->address_data_children, addresses[i],
+				                                         _address_to_variant (address));
+			}
+			g_variant_builder_add_value (&builder_data, child);
+
+			{
+				const guint32 dbus_addr[3] = {
+				    address->address,
+				    address->plen,
+				    (   i == 0
+				     && priv->best_default_route)
+				       ? NMP_OBJECT_CAST_IP4_ROUTE (priv->best_default_route)->gateway
+				       : (guint32) 0,
+				};
 
-				g_variant_builder_add (&builder_data, "a{sv}", &addr_builder);
-
-				{
-					const guint32 dbus_addr[3] = {
-					    address->address,
-					    address->plen,
-					    (   i == 0
-					     && priv->best_default_route)
-					       ? NMP_OBJECT_CAST_IP4_ROUTE (priv->best_default_route)->gateway
-					       : (guint32) 0,
-					};
-
-					g_variant_builder_add (&builder_legacy, "@au",
-					                       g_variant_new_fixed_array (G_VARIANT_TYPE_UINT32,
-					                                                  dbus_addr, 3, sizeof (guint32)));
-				}
+				g_variant_builder_add (&builder_legacy, "@au",
+				                       g_variant_new_fixed_array (G_VARIANT_TYPE_UINT32,
+				                                                  dbus_addr, 3, sizeof (guint32)));
 			}
 		}
+	}
+
+	priv->address_data_variant = g_variant_ref_sink (g_variant_builder_end (&builder_data));
+	priv->addresses_variant = g_variant_ref_sink (g_variant_builder_end (&builder_legacy));
+}
+
+static GVariant *
+_route_to_variant (const NMPlatformIP4Route *route)
+{
+	GVariantBuilder route_builder;
+
+	g_variant_builder_init (&route_builder, G_VARIANT_TYPE ("a{sv}"));
+	g_variant_builder_add (&route_builder, "{sv}",
+	                       "dest",
+	                       g_variant_new_string (nm_utils_inet4_ntop (route->network, NULL)));
+	g_variant_builder_add (&route_builder, "{sv}",
+	                       "prefix",
+	                       g_variant_new_uint32 (route->plen));
+	if (route->gateway) {
+		g_variant_builder_add (&route_builder, "{sv}",
+		                       "next-hop",
+		                       g_variant_new_string (nm_utils_inet4_ntop (route->gateway, NULL)));
+	}
+	g_variant_builder_add (&route_builder, "{sv}",
+	                       "metric",
+	                       g_variant_new_uint32 (route->metric));
+
+	if (!nm_platform_route_table_is_main (route->table_coerced)) {
+		g_variant_builder_add (&route_builder, "{sv}",
+		                       "table",
+		                       g_variant_new_uint32 (nm_platform_route_table_uncoerce (route->table_coerced, TRUE)));
+	}
+
+	return g_variant_builder_end (&route_builder);
+}
+
+static void
+_route_data_ensure (NMIP4Config *self)
+{
+	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
+	gs_unref_hashtable GHashTable *children_old = NULL;
+	NMDedupMultiIter ipconf_iter;
+	const NMPlatformIP4Route *route;
+	GVariantBuilder builder_data, builder_legacy;
+
+	nm_assert (!!priv->route_data_variant == !!priv->routes_variant);
+
+	if (priv->route_data_variant)
+		return;
+
+	children_old = g_steal_pointer (&priv->route_data_children);
+	priv->route_data_children = _nm_ip_config_variant_cache_new ();
+
+	g_variant_builder_init (&builder_data, G_VARIANT_TYPE ("aa{sv}"));
+	g_variant_builder_init (&builder_legacy, G_VARIANT_TYPE ("aau"));
+
+	nm_ip_config_iter_ip4_route_for_each (&ipconf_iter, self, &route) {
+		const NMPObject *obj = ipconf_iter.current->obj;
+		GVariant *child;
+
+		nm_assert (_route_valid (route));
+
+		child = _nm_ip_config_variant_cache_move (children_old, priv->route_data_children, obj);
+		if (!child)
+			child = _nm_ip_config_variant_cache_add (priv->route_data_children, obj, _route_to_variant (route));
+		g_variant_builder_add_value (&builder_data, child);
+
+		/* legacy versions of nm_ip4_route_set_prefix() in libnm-util assert that the
+		 * plen is positive. Skip the default routes not to break older clients. */
+		if (   nm_platform_route_table_is_main (route->table_coerced)
+		    && !NM_PLATFORM_IP_ROUTE_IS_DEFAULT (route)) {
+			const guint32 dbus_route[4] = {
+			    route->network,
+			    route->plen,
+			    route->gateway,
+			    route->metric,
+			};
+
+			g_variant_builder_add (&builder_legacy, "@au",
+			                       g_variant_new_fixed_array (G_VARIANT_TYPE_UINT32,
+			                                                  dbus_route, 4, sizeof (guint32)));
+		}
+	}
+
+	priv->route_data_variant = g_variant_ref_sink (g_variant_builder_end (&builder_data));
+	priv->routes_variant = g_variant_ref_sink (g_variant_builder_end (&builder_legacy));
+}
+
+/*****************************************************************************/
+
+static void
+impl_ip4_config_get_routes (NMIP4Config *self,
+                            GDBusMethodInvocation *context,
+                            guint32 offset,
+                            guint32 limit)
+{
+	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
+
+	_route_data_ensure (self);
+	g_dbus_method_invocation_return_value (context,
+	                                       _nm_ip_config_route_data_slice (priv->route_data_variant,
+	                                                                       offset,
+	                                                                       limit));
+}
+
+/*****************************************************************************/
 
-		priv->address_data_variant = g_variant_ref_sink (g_variant_builder_end (&builder_data));
-		priv->addresses_variant = g_variant_ref_sink (g_variant_builder_end (&builder_legacy));
+static void
+get_property (GObject *object, guint prop_id,
+              GValue *value, GParamSpec *pspec)
+{
+	NMIP4Config *self = NM_IP4_CONFIG (object);
+	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
-out_addresses_cached:
+	switch (prop_id) {
+	case PROP_IFINDEX:
+		g_value_set_int (value, priv->ifindex);
+		break;
+	case PROP_ADDRESS_DATA:
+	case PROP_ADDRESSES:
+		_address_data_ensure (self);
 		g_value_set_variant (value,
 		                     prop_id == PROP_ADDRESS_DATA ?
 		                     priv->address_data_variant :
@@ -2923,64 +3449,7 @@ out_addresses_cached:
 		break;
 	case PROP_ROUTE_DATA:
 	case PROP_ROUTES:
-		nm_assert (!!priv->route_data_variant == !!priv->routes_variant);
-
-		if (priv->route_data_variant)
-			goto out_routes_cached;
-
-		g_variant_builder_init (&builder_data, G_VARIANT_TYPE ("aa{sv}"));
-		g_variant_builder_init (&builder_legacy, G_VARIANT_TYPE ("aau"));
-
-		nm_ip_config_iter_ip4_route_for_each (&ipconf_iter, self, &route) {
-			GVariantBuilder route_builder;
-
-			nm_assert (_route_valid (route));
-
-			g_variant_builder_init (&route_builder, G_VARIANT_TYPE ("a{sv}"));
-			g_variant_builder_add (&route_builder, "{sv}",
-			                       "dest",
-			                       g_variant_new_string (nm_utils_inet4_ntop (route->network, NULL)));
-			g_variant_builder_add (&route_builder, "{sv}",
-			                       "prefix",
-			                       g_variant_new_uint32 (route->plen));
-			if (route->gateway) {
-				g_variant_builder_add (&route_builder, "{sv}",
-				                       "next-hop",
-				                       g_variant_new_string (nm_utils_inet4_ntop (route->gateway, NULL)));
-			}
-			g_variant_builder_add (&route_builder, "{sv}",
-			                       "metric",
-			                       g_variant_new_uint32 (route->metric));
-
-			if (!nm_platform_route_table_is_main (route->table_coerced)) {
-				g_variant_builder_add (&route_builder, "{sv}",
-				                       "table",
-				                       g_variant_new_uint32 (nm_platform_route_table_uncoerce (route->table_coerced, TRUE)));
-			}
-
-			g_variant_builder_add (&builder_data, "a{sv}", &route_builder);
-
-			/* legacy versions of nm_ip4_route_set_prefix() in libnm-util assert that the
-			 * plen is positive. Skip the default routes not to break older clients. */
-			if (   nm_platform_route_table_is_main (route->table_coerced)
-			    && !NM_PLATFORM_IP_ROUTE_IS_DEFAULT (route)) {
-				const guint32 dbus_route[4] = {
-				    route->network,
-				    route->plen,
-				    route->gateway,
-				    route->metric,
-				};
-
-				g_variant_builder_add (&builder_legacy, "@au",
-				                       g_variant_new_fixed_array (G_VARIANT_TYPE_UINT32,
-				                                                  dbus_route, 4, sizeof (guint32)));
-			}
-		}
-
-		priv->route_data_variant = g_variant_ref_sink (g_variant_builder_end (&builder_data));
-		priv->routes_variant = g_variant_ref_sink (g_variant_builder_end (&builder_legacy));
-
-out_routes_cached:
+		_route_data_ensure (self);
 		g_value_set_variant (value,
 		                     prop_id == PROP_ROUTE_DATA ?
 		                     priv->route_data_variant :
@@ -3071,6 +3540,7 @@ nm_ip4_config_init (NMIP4Config *self)
 	priv->dns_options = g_ptr_array_new_with_free_func (g_free);
 	priv->nis = g_array_new (FALSE, TRUE, sizeof (guint32));
 	priv->wins = g_array_new (FALSE, TRUE, sizeof (guint32));
+	_version_bump (priv);
 }
 
 NMIP4Config *
@@ -3098,6 +3568,8 @@ finalize (GObject *object)
 	nm_clear_g_variant (&priv->addresses_variant);
 	nm_clear_g_variant (&priv->route_data_variant);
 	nm_clear_g_variant (&priv->routes_variant);
+	g_clear_pointer (&priv->address_data_children, g_hash_table_unref);
+	g_clear_pointer (&priv->route_data_children, g_hash_table_unref);
 
 	g_array_unref (priv->nameservers);
 	g_ptr_array_unref (priv->domains);
@@ -3201,5 +3673,6 @@ nm_ip4_config_class_init (NMIP4ConfigClass *config_class)
 
 	nm_exported_object_class_add_interface (NM_EXPORTED_OBJECT_CLASS (config_class),
 	                                        NMDBUS_TYPE_IP4_CONFIG_SKELETON,
+	                                        "GetRoutes", impl_ip4_config_get_routes,
 	                                        NULL);
 }
@@ -105,6 +105,7 @@ gboolean _nm_ip_config_add_obj (NMDedupMultiIndex *multi_idx,
                                 const NMPlatformObject *pl_new,
                                 gboolean merge,
                                 gboolean append_force,
+                                guint64 *inout_hash,
                                 const NMPObject **out_obj_old,
                                 const NMPObject **out_obj_new);
 
@@ -120,6 +121,42 @@ void _nm_ip_config_merge_route_attributes (int addr_family,
 
 /*****************************************************************************/
 
+/* The content hash of NMIP4Config/NMIP6Config is the sum of the hashes
+ * of the individual items, so that it can be updated when adding or
+ * removing an item. Each kind of item hashes with its own seed. */
+typedef enum {
+	NM_IP_CONFIG_HASH_SEED_ADDRESS = 1,
+	NM_IP_CONFIG_HASH_SEED_ROUTE,
+	NM_IP_CONFIG_HASH_SEED_NAMESERVER,
+	NM_IP_CONFIG_HASH_SEED_DOMAIN,
+	NM_IP_CONFIG_HASH_SEED_SEARCH,
+	NM_IP_CONFIG_HASH_SEED_DNS_OPTION,
+	NM_IP_CONFIG_HASH_SEED_NIS,
+	NM_IP_CONFIG_HASH_SEED_NIS_DOMAIN,
+	NM_IP_CONFIG_HASH_SEED_WINS,
+} NMIPConfigHashSeed;
+
+guint64 _nm_ip_config_hash_obj (const NMPObject *obj);
+guint64 _nm_ip_config_hash_objs (const NMDedupMultiHeadEntry *head_entry);
+gboolean _nm_ip_config_objs_equal (const NMDedupMultiHeadEntry *head_a, const NMDedupMultiHeadEntry *head_b);
+
+guint64 _nm_ip_config_hash_arr_elem (NMIPConfigHashSeed seed, guint idx, gconstpointer elem, gsize elem_size);
+guint64 _nm_ip_config_hash_arr (NMIPConfigHashSeed seed, const GArray *arr);
+guint64 _nm_ip_config_hash_strarr_elem (NMIPConfigHashSeed seed, guint idx, const char *str);
+guint64 _nm_ip_config_hash_strarr (NMIPConfigHashSeed seed, const GPtrArray *arr);
+
+guint64 _nm_ip_config_version_next (void);
+
+GHashTable *_nm_ip_config_variant_cache_new (void);
+GVariant *_nm_ip_config_variant_cache_move (GHashTable *cache_old, GHashTable *cache_new, const NMPObject *obj);
+GVariant *_nm_ip_config_variant_cache_add (GHashTable *cache, const NMPObject *obj, GVariant *variant);
+GVariant *_nm_ip_config_route_data_slice (GVariant *route_data, guint32 offset, guint32 limit);
+
+gboolean _nm_ip_config_arr_equal (const GArray *a, const GArray *b);
+gboolean _nm_ip_config_strarr_equal (const GPtrArray *a, const GPtrArray *b);
+
+/*****************************************************************************/
+
 #define NM_TYPE_IP4_CONFIG (nm_ip4_config_get_type ())
 #define NM_IP4_CONFIG(obj) (G_TYPE_CHECK_INSTANCE_CAST ((obj), NM_TYPE_IP4_CONFIG, NMIP4Config))
 #define NM_IP4_CONFIG_CLASS(klass) (G_TYPE_CHECK_CLASS_CAST ((klass), NM_TYPE_IP4_CONFIG, NMIP4ConfigClass))
@@ -270,7 +307,8 @@ const NMPObject *nm_ip4_config_nmpobj_lookup (const NMIP4Config *self,
 gboolean nm_ip4_config_nmpobj_remove (NMIP4Config *self,
                                       const NMPObject *needle);
 
-void nm_ip4_config_hash (const NMIP4Config *self, GChecksum *sum, gboolean dns_only);
+guint64 nm_ip4_config_get_content_hash (const NMIP4Config *self, gboolean dns_only);
+guint64 nm_ip4_config_get_version (const NMIP4Config *self);
 gboolean nm_ip4_config_equal (const NMIP4Config *a, const NMIP4Config *b);
 
 /*****************************************************************************/
@@ -65,10 +65,16 @@ typedef struct {
 	GPtrArray *domains;
 	GPtrArray *searches;
 	GPtrArray *dns_options;
+	guint64 hash_addresses;
+	guint64 hash_routes;
+	guint64 hash_dns;
+	guint64 version;
 	GVariant *address_data_variant;
 	GVariant *addresses_variant;
 	GVariant *route_data_variant;
 	GVariant *routes_variant;
+	GHashTable *address_data_children;
+	GHashTable *route_data_children;
 	NMDedupMultiIndex *multi_idx;
 	const NMPObject *best_default_route;
 	union {
@@ -119,6 +125,23 @@ static const NMDedupMultiEntry *_lookup_route (const NMIP6Config *self,
 
 /*****************************************************************************/
 
+static guint64
+_hash_dns (const NMIP6ConfigPrivate *priv)
+{
+	return   _nm_ip_config_hash_arr (NM_IP_CONFIG_HASH_SEED_NAMESERVER, priv->nameservers)
+	       + _nm_ip_config_hash_strarr (NM_IP_CONFIG_HASH_SEED_DOMAIN, priv->domains)
+	       + _nm_ip_config_hash_strarr (NM_IP_CONFIG_HASH_SEED_SEARCH, priv->searches)
+	       + _nm_ip_config_hash_strarr (NM_IP_CONFIG_HASH_SEED_DNS_OPTION, priv->dns_options);
+}
+
+static void
+_version_bump (NMIP6ConfigPrivate *priv)
+{
+	priv->version = _nm_ip_config_version_next ();
+}
+
+/*****************************************************************************/
+
 int
 nm_ip6_config_get_ifindex (const NMIP6Config *self)
 {
@@ -137,6 +160,7 @@ nm_ip6_config_set_privacy (NMIP6Config *self, NMSettingIP6ConfigPrivacy privacy)
 	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 
 	priv->privacy = privacy;
+	_version_bump (priv);
 }
 
 /*****************************************************************************/
@@ -209,6 +233,7 @@ _notify_addresses (NMIP6Config *self)
 
 	nm_clear_g_variant (&priv->address_data_variant);
 	nm_clear_g_variant (&priv->addresses_variant);
+	_version_bump (priv);
 	_notify (self, PROP_ADDRESS_DATA);
 	_notify (self, PROP_ADDRESSES);
 }
@@ -221,6 +246,7 @@ _notify_routes (NMIP6Config *self)
 	nm_assert (priv->best_default_route == _nm_ip6_config_best_default_route_find (self));
 	nm_clear_g_variant (&priv->route_data_variant);
 	nm_clear_g_variant (&priv->routes_variant);
+	_version_bump (priv);
 	_notify (self, PROP_ROUTE_DATA);
 	_notify (self, PROP_ROUTES);
 }
@@ -396,6 +422,7 @@ nm_ip6_config_capture (NMDedupMultiIndex *multi_idx, NMPlatform *platform, int i
 			                            NULL,
 			                            FALSE,
 			                            TRUE,
+			                            &priv->hash_addresses,
 			                            NULL,
 			                            NULL))
 				nm_assert_not_reached ();
@@ -428,8 +455,11 @@ nm_ip6_config_capture (NMDedupMultiIndex *multi_idx, NMPlatform *platform, int i
 			if (nm_utils_resolve_conf_parse (AF_INET6,
 			                                 rc_contents,
 			                                 priv->nameservers,
-			                                 priv->dns_options))
+			                                 priv->dns_options)) {
+				priv->hash_dns = _hash_dns (priv);
+				_version_bump (priv);
 				_notify (self, PROP_NAMESERVERS);
+			}
 		}
 	}
 
@@ -985,11 +1015,15 @@ nm_ip6_config_subtract (NMIP6Config *dst,
 	/* addresses */
 	changed = FALSE;
 	nm_ip_config_iter_ip6_address_for_each (&ipconf_iter, src, &a) {
+		nm_auto_nmpobj const NMPObject *obj_old = NULL;
+
 		if (nm_dedup_multi_index_remove_obj (dst_priv->multi_idx,
 		                                     &dst_priv->idx_ip6_addresses,
 		                                     NMP_OBJECT_UP_CAST (a),
-		                                     NULL))
+		                                     (gconstpointer *) &obj_old)) {
+			dst_priv->hash_addresses -= _nm_ip_config_hash_obj (obj_old);
 			changed = TRUE;
+		}
 	}
 	if (changed)
 		_notify_addresses (dst);
@@ -1027,6 +1061,7 @@ nm_ip6_config_subtract (NMIP6Config *dst,
 		                                     &dst_priv->idx_ip6_routes,
 		                                     o_lookup,
 		                                     (gconstpointer *) &obj_old)) {
+			dst_priv->hash_routes -= _nm_ip_config_hash_obj (obj_old);
 			if (dst_priv->best_default_route == obj_old) {
 				nm_clear_nmp_object (&dst_priv->best_default_route);
 				changed_default_route = TRUE;
@@ -1099,6 +1134,7 @@ nm_ip6_config_intersect (NMIP6Config *dst,
 		                                     NMP_OBJECT_UP_CAST (a)))
 			continue;
 
+		dst_priv->hash_addresses -= _nm_ip_config_hash_obj (ipconf_iter.current->obj);
 		if (nm_dedup_multi_index_remove_entry (dst_priv->multi_idx,
 		                                       ipconf_iter.current) != 1)
 			nm_assert_not_reached ();
@@ -1137,6 +1173,7 @@ nm_ip6_config_intersect (NMIP6Config *dst,
 			continue;
 		}
 
+		dst_priv->hash_routes -= _nm_ip_config_hash_obj (ipconf_iter.current->obj);
 		if (nm_dedup_multi_index_remove_entry (dst_priv->multi_idx,
 		                                       ipconf_iter.current) != 1)
 			nm_assert_not_reached ();
@@ -1247,9 +1284,11 @@ nm_ip6_config_replace (NMIP6Config *dst, const NMIP6Config *src, gboolean *relev
 			                       FALSE,
 			                       TRUE,
 			                       NULL,
+			                       NULL,
 			                       NULL);
 		}
 		nm_dedup_multi_index_dirty_remove_idx (dst_priv->multi_idx, &dst_priv->idx_ip6_addresses, FALSE);
+		dst_priv->hash_addresses = src_priv->hash_addresses;
 		_notify_addresses (dst);
 	}
 
@@ -1299,10 +1338,12 @@ nm_ip6_config_replace (NMIP6Config *dst, const NMIP6Config *src, gboolean *relev
 			                       FALSE,
 			                       TRUE,
 			                       NULL,
+			                       NULL,
 			                       &obj_new);
 			new_best_default_route = _nm_ip_config_best_default_route_find_better (new_best_default_route, obj_new);
 		}
 		nm_dedup_multi_index_dirty_remove_idx (dst_priv->multi_idx, &dst_priv->idx_ip6_routes, FALSE);
+		dst_priv->hash_routes = src_priv->hash_routes;
 		if (_nm_ip_config_best_default_route_set (&dst_priv->best_default_route, new_best_default_route))
 			_notify (dst, PROP_GATEWAY);
 		_notify_routes (dst);
@@ -1501,6 +1542,7 @@ nm_ip6_config_reset_addresses_ndisc (NMIP6Config *self,
 		                           FALSE,
 		                           TRUE,
 		                           NULL,
+		                           NULL,
 		                           NULL))
 			changed = TRUE;
 	}
@@ -1508,8 +1550,10 @@ nm_ip6_config_reset_addresses_ndisc (NMIP6Config *self,
 	if (nm_dedup_multi_index_dirty_remove_idx (priv->multi_idx, &priv->idx_ip6_addresses, FALSE) > 0)
 		changed = TRUE;
 
-	if (changed)
+	if (changed) {
+		priv->hash_addresses = _nm_ip_config_hash_objs (nm_ip6_config_lookup_addresses (self));
 		_notify_addresses (self);
+	}
 }
 
 void
@@ -1517,6 +1561,7 @@ nm_ip6_config_reset_addresses (NMIP6Config *self)
 {
 	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 
+	priv->hash_addresses = 0;
 	if (nm_dedup_multi_index_remove_idx (priv->multi_idx,
 	                                     &priv->idx_ip6_addresses) > 0)
 		_notify_addresses (self);
@@ -1536,6 +1581,7 @@ _add_address (NMIP6Config *self,
 	                           (const NMPlatformObject *) new,
 	                           TRUE,
 	                           FALSE,
+	                           &priv->hash_addresses,
 	                           NULL,
 	                           NULL))
 		_notify_addresses (self);
@@ -1754,6 +1800,7 @@ nm_ip6_config_reset_routes_ndisc (NMIP6Config *self,
 		                           FALSE,
 		                           TRUE,
 		                           NULL,
+		                           NULL,
 		                           &obj_new))
 			changed = TRUE;
 		new_best_default_route = _nm_ip_config_best_default_route_find_better (new_best_default_route, obj_new);
@@ -1781,6 +1828,7 @@ nm_ip6_config_reset_routes_ndisc (NMIP6Config *self,
 			                           FALSE,
 			                           TRUE,
 			                           NULL,
+			                           NULL,
 			                           &obj_new))
 				changed = TRUE;
 			new_best_default_route = _nm_ip_config_best_default_route_find_better (new_best_default_route, obj_new);
@@ -1803,8 +1851,10 @@ nm_ip6_config_reset_routes_ndisc (NMIP6Config *self,
 		_notify (self, PROP_GATEWAY);
 	}
 
-	if (changed)
+	if (changed) {
+		priv->hash_routes = _nm_ip_config_hash_objs (nm_ip6_config_lookup_routes (self));
 		_notify_routes (self);
+	}
 }
 
 void
@@ -1812,6 +1862,7 @@ nm_ip6_config_reset_routes (NMIP6Config *self)
 {
 	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 
+	priv->hash_routes = 0;
 	if (nm_dedup_multi_index_remove_idx (priv->multi_idx,
 	                                     &priv->idx_ip6_routes) > 0) {
 		if (nm_clear_nmp_object (&priv->best_default_route))
@@ -1841,6 +1892,7 @@ _add_route (NMIP6Config *self,
 	                           (const NMPlatformObject *) new,
 	                           TRUE,
 	                           FALSE,
+	                           &priv->hash_routes,
 	                           &obj_old,
 	                           &obj_new_2)) {
 		gboolean changed_default_route = FALSE;
@@ -1989,7 +2041,9 @@ nm_ip6_config_reset_nameservers (NMIP6Config *self)
 	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 
 	if (priv->nameservers->len != 0) {
+		priv->hash_dns -= _nm_ip_config_hash_arr (NM_IP_CONFIG_HASH_SEED_NAMESERVER, priv->nameservers);
 		g_array_set_size (priv->nameservers, 0);
+		_version_bump (priv);
 		_notify (self, PROP_NAMESERVERS);
 	}
 }
@@ -2006,7 +2060,9 @@ nm_ip6_config_add_nameserver (NMIP6Config *self, const struct in6_addr *new)
 		if (IN6_ARE_ADDR_EQUAL (new, &g_array_index (priv->nameservers, struct in6_addr, i)))
 			return;
 
+	priv->hash_dns += _nm_ip_config_hash_arr_elem (NM_IP_CONFIG_HASH_SEED_NAMESERVER, priv->nameservers->len, new, sizeof (*new));
 	g_array_append_val (priv->nameservers, *new);
+	_version_bump (priv);
 	_notify (self, PROP_NAMESERVERS);
 }
 
@@ -2017,7 +2073,10 @@ nm_ip6_config_del_nameserver (NMIP6Config *self, guint i)
 
 	g_return_if_fail (i < priv->nameservers->len);
 
+	priv->hash_dns -= _nm_ip_config_hash_arr (NM_IP_CONFIG_HASH_SEED_NAMESERVER, priv->nameservers);
 	g_array_remove_index (priv->nameservers, i);
+	priv->hash_dns += _nm_ip_config_hash_arr (NM_IP_CONFIG_HASH_SEED_NAMESERVER, priv->nameservers);
+	_version_bump (priv);
 	_notify (self, PROP_NAMESERVERS);
 }
 
@@ -2045,7 +2104,9 @@ nm_ip6_config_reset_domains (NMIP6Config *self)
 	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 
 	if (priv->domains->len != 0) {
+		priv->hash_dns -= _nm_ip_config_hash_strarr (NM_IP_CONFIG_HASH_SEED_DOMAIN, priv->domains);
 		g_ptr_array_set_size (priv->domains, 0);
+		_version_bump (priv);
 		_notify (self, PROP_DOMAINS);
 	}
 }
@@ -2063,7 +2124,9 @@ nm_ip6_config_add_domain (NMIP6Config *self, const char *domain)
 		if (!g_strcmp0 (g_ptr_array_index (priv->domains, i), domain))
 			return;
 
+	priv->hash_dns += _nm_ip_config_hash_strarr_elem (NM_IP_CONFIG_HASH_SEED_DOMAIN, priv->domains->len, domain);
 	g_ptr_array_add (priv->domains, g_strdup (domain));
+	_version_bump (priv);
 	_notify (self, PROP_DOMAINS);
 }
 
@@ -2074,7 +2137,10 @@ nm_ip6_config_del_domain (NMIP6Config *self, guint i)
 
 	g_return_if_fail (i < priv->domains->len);
 
+	priv->hash_dns -= _nm_ip_config_hash_strarr (NM_IP_CONFIG_HASH_SEED_DOMAIN, priv->domains);
 	g_ptr_array_remove_index (priv->domains, i);
+	priv->hash_dns += _nm_ip_config_hash_strarr (NM_IP_CONFIG_HASH_SEED_DOMAIN, priv->domains);
+	_version_bump (priv);
 	_notify (self, PROP_DOMAINS);
 }
 
@@ -2102,7 +2168,9 @@ nm_ip6_config_reset_searches (NMIP6Config *self)
 	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 
 	if (priv->searches->len != 0) {
+		priv->hash_dns -= _nm_ip_config_hash_strarr (NM_IP_CONFIG_HASH_SEED_SEARCH, priv->searches);
 		g_ptr_array_set_size (priv->searches, 0);
+		_version_bump (priv);
 		_notify (self, PROP_SEARCHES);
 	}
 }
@@ -2135,7 +2203,9 @@ nm_ip6_config_add_search (NMIP6Config *self, const char *new)
 		return;
 	}
 
+	priv->hash_dns += _nm_ip_config_hash_strarr_elem (NM_IP_CONFIG_HASH_SEED_SEARCH, priv->searches->len, search);
 	g_ptr_array_add (priv->searches, search);
+	_version_bump (priv);
 	_notify (self, PROP_SEARCHES);
 }
 
@@ -2146,7 +2216,10 @@ nm_ip6_config_del_search (NMIP6Config *self, guint i)
 
 	g_return_if_fail (i < priv->searches->len);
 
+	priv->hash_dns -= _nm_ip_config_hash_strarr (NM_IP_CONFIG_HASH_SEED_SEARCH, priv->searches);
 	g_ptr_array_remove_index (priv->searches, i);
+	priv->hash_dns += _nm_ip_config_hash_strarr (NM_IP_CONFIG_HASH_SEED_SEARCH, priv->searches);
+	_version_bump (priv);
 	_notify (self, PROP_SEARCHES);
 }
 
@@ -2174,7 +2247,9 @@ nm_ip6_config_reset_dns_options (NMIP6Config *self)
 	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 
 	if (priv->dns_options->len != 0) {
+		priv->hash_dns -= _nm_ip_config_hash_strarr (NM_IP_CONFIG_HASH_SEED_DNS_OPTION, priv->dns_options);
 		g_ptr_array_set_size (priv->dns_options, 0);
+		_version_bump (priv);
 		_notify (self, PROP_DNS_OPTIONS);
 	}
 }
@@ -2192,7 +2267,9 @@ nm_ip6_config_add_dns_option (NMIP6Config *self, const char *new)
 		if (!g_strcmp0 (g_ptr_array_index (priv->dns_options, i), new))
 			return;
 
+	priv->hash_dns += _nm_ip_config_hash_strarr_elem (NM_IP_CONFIG_HASH_SEED_DNS_OPTION, priv->dns_options->len, new);
 	g_ptr_array_add (priv->dns_options, g_strdup (new));
+	_version_bump (priv);
 	_notify (self, PROP_DNS_OPTIONS);
 }
 
@@ -2203,7 +2280,10 @@ nm_ip6_config_del_dns_option (NMIP6Config *self, guint i)
 
 	g_return_if_fail (i < priv->dns_options->len);
 
+	priv->hash_dns -= _nm_ip_config_hash_strarr (NM_IP_CONFIG_HASH_SEED_DNS_OPTION, priv->dns_options);
 	g_ptr_array_remove_index (priv->dns_options, i);
+	priv->hash_dns += _nm_ip_config_hash_strarr (NM_IP_CONFIG_HASH_SEED_DNS_OPTION, priv->dns_options);
+	_version_bump (priv);
 	_notify (self, PROP_DNS_OPTIONS);
 }
 
@@ -2232,6 +2312,7 @@ nm_ip6_config_set_dns_priority (NMIP6Config *self, gint priority)
 
 	if (priority != priv->dns_priority) {
 		priv->dns_priority = priority;
+		_version_bump (priv);
 		_notify (self, PROP_DNS_PRIORITY);
 	}
 }
@@ -2307,9 +2388,11 @@ nm_ip6_config_nmpobj_remove (NMIP6Config *self,
 
 	switch (NMP_OBJECT_GET_TYPE (obj_old)) {
 	case NMP_OBJECT_TYPE_IP6_ADDRESS:
+		priv->hash_addresses -= _nm_ip_config_hash_obj (obj_old);
 		_notify_addresses (self);
 		break;
 	case NMP_OBJECT_TYPE_IP6_ROUTE:
+		priv->hash_routes -= _nm_ip_config_hash_obj (obj_old);
 		if (priv->best_default_route == obj_old) {
 			if (_nm_ip_config_best_default_route_set (&priv->best_default_route,
 			                                          _nm_ip6_config_best_default_route_find (self)))
@@ -2325,64 +2408,78 @@ nm_ip6_config_nmpobj_remove (NMIP6Config *self,
 
 /*****************************************************************************/
 
-static inline void
-hash_u32 (GChecksum *sum, guint32 n)
+/**
+ * nm_ip6_config_get_content_hash:
+ * @self: the #NMIP6Config
+ * @dns_only: whether to only consider the DNS related parts
+ *
+ * The hash is updated whenever an item is added or removed, so this
+ * is cheap. It only considers the attributes that nm_ip6_config_equal()
+ * compares.
+ *
+ * Returns: a 64 bit hash of the content of @self.
+ */
+guint64
+nm_ip6_config_get_content_hash (const NMIP6Config *self, gboolean dns_only)
 {
-	g_checksum_update (sum, (const guint8 *) &n, sizeof (n));
-}
+	const NMIP6ConfigPrivate *priv;
 
-static inline void
-hash_in6addr (GChecksum *sum, const struct in6_addr *a)
-{
-	if (a)
-		g_checksum_update (sum, (const guint8 *) a, sizeof (*a));
-	else
-		g_checksum_update (sum, (const guint8 *) &in6addr_any, sizeof (in6addr_any));
-}
+	g_return_val_if_fail (NM_IS_IP6_CONFIG (self), 0);
 
-void
-nm_ip6_config_hash (const NMIP6Config *self, GChecksum *sum, gboolean dns_only)
-{
-	guint32 i;
-	const char *s;
-	NMDedupMultiIter ipconf_iter;
-	const NMPlatformIP6Address *address;
-	const NMPlatformIP6Route *route;
+	priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 
-	g_return_if_fail (self);
-	g_return_if_fail (sum);
+	nm_assert (priv->hash_dns == _hash_dns (priv));
+	nm_assert (priv->hash_addresses == _nm_ip_config_hash_objs (nm_ip6_config_lookup_addresses (self)));
+	nm_assert (priv->hash_routes == _nm_ip_config_hash_objs (nm_ip6_config_lookup_routes (self)));
 
-	if (dns_only == FALSE) {
-		nm_ip_config_iter_ip6_address_for_each (&ipconf_iter, self, &address) {
-			hash_in6addr (sum, &address->address);
-			hash_u32 (sum, address->plen);
-		}
+	if (dns_only)
+		return priv->hash_dns;
+	return priv->hash_dns + priv->hash_addresses + priv->hash_routes;
+}
 
-		nm_ip_config_iter_ip6_route_for_each (&ipconf_iter, self, &route) {
-			hash_in6addr (sum, &route->network);
-			hash_u32 (sum, route->plen);
-			hash_in6addr (sum, &route->gateway);
-			hash_u32 (sum, route->metric);
-		}
-	}
+/**
+ * nm_ip6_config_get_version:
+ * @self: the #NMIP6Config
+ *
+ * See nm_ip4_config_get_version().
+ *
+ * Returns: the current version of @self.
+ */
+guint64
+nm_ip6_config_get_version (const NMIP6Config *self)
+{
+	g_return_val_if_fail (NM_IS_IP6_CONFIG (self), 0);
 
-	for (i = 0; i < nm_ip6_config_get_num_nameservers (self); i++)
-		hash_in6addr (sum, nm_ip6_config_get_nameserver (self, i));
+	return NM_IP6_CONFIG_GET_PRIVATE (self)->version;
+}
 
-	for (i = 0; i < nm_ip6_config_get_num_domains (self); i++) {
-		s = nm_ip6_config_get_domain (self, i);
-		g_checksum_update (sum, (const guint8 *) s, strlen (s));
-	}
+static gboolean
+_equal_full (const NMIP6Config *a, const NMIP6Config *b)
+{
+	const NMIP6ConfigPrivate *a_priv = NM_IP6_CONFIG_GET_PRIVATE (a);
+	const NMIP6ConfigPrivate *b_priv = NM_IP6_CONFIG_GET_PRIVATE (b);
 
-	for (i = 0; i < nm_ip6_config_get_num_searches (self); i++) {
-		s = nm_ip6_config_get_search (self, i);
-		g_checksum_update (sum, (const guint8 *) s, strlen (s));
-	}
+	return    _nm_ip_config_objs_equal (nm_ip6_config_lookup_addresses (a),
+	                                    nm_ip6_config_lookup_addresses (b))
+	       && _nm_ip_config_objs_equal (nm_ip6_config_lookup_routes (a),
+	                                    nm_ip6_config_lookup_routes (b))
+	       && _nm_ip_config_arr_equal (a_priv->nameservers, b_priv->nameservers)
+	       && _nm_ip_config_strarr_equal (a_priv->domains, b_priv->domains)
+	       && _nm_ip_config_strarr_equal (a_priv->searches, b_priv->searches)
+	       && _nm_ip_config_strarr_equal (a_priv->dns_options, b_priv->dns_options);
+}
 
-	for (i = 0; i < nm_ip6_config_get_num_dns_options (self); i++) {
-		s = nm_ip6_config_get_dns_option (self, i);
-		g_checksum_update (sum, (const guint8 *) s, strlen (s));
-	}
+static gboolean
+_is_empty (const NMIP6Config *self)
+{
+	const NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
+
+	return    nm_ip6_config_get_num_addresses (self) == 0
+	       && nm_ip6_config_get_num_routes (self) == 0
+	       && priv->nameservers->len == 0
+	       && priv->domains->len == 0
+	       && priv->searches->len == 0
+	       && priv->dns_options->len == 0;
 }
 
 /**
@@ -2393,7 +2490,10 @@ nm_ip6_config_hash (const NMIP6Config *self, GChecksum *sum, gboolean dns_only)
  * Compares two #NMIP6Configs for basic equality.  This means that all
  * attributes must exist in the same order in both configs (addresses, routes,
  * domains, DNS servers, etc) but some attributes (address lifetimes, and address
- * and route sources) are ignored.
+ * and route sources) are ignored. A %NULL config is equal to an empty one.
+ *
+ * The content hashes are compared first, the attributes themselves only
+ * if the hashes match.
  *
  * Returns: %TRUE if the configurations are basically equal to each other,
  * %FALSE if not
@@ -2401,28 +2501,17 @@ nm_ip6_config_hash (const NMIP6Config *self, GChecksum *sum, gboolean dns_only)
 gboolean
 nm_ip6_config_equal (const NMIP6Config *a, const NMIP6Config *b)
 {
-	GChecksum *a_checksum = g_checksum_new (G_CHECKSUM_SHA1);
-	GChecksum *b_checksum = g_checksum_new (G_CHECKSUM_SHA1);
-	gsize a_len = g_checksum_type_get_length (G_CHECKSUM_SHA1);
-	gsize b_len = g_checksum_type_get_length (G_CHECKSUM_SHA1);
-	guchar a_data[a_len], b_data[b_len];
-	gboolean equal;
-
-	if (a)
-		nm_ip6_config_hash (a, a_checksum, FALSE);
-	if (b)
-		nm_ip6_config_hash (b, b_checksum, FALSE);
-
-	g_checksum_get_digest (a_checksum, a_data, &a_len);
-	g_checksum_get_digest (b_checksum, b_data, &b_len);
+	if (a == b)
+		return TRUE;
+	if (!a)
+		return _is_empty (b);
+	if (!b)
+		return _is_empty (a);
 
-	g_assert (a_len == b_len);
-	equal = !memcmp (a_data, b_data, a_len);
-
-	g_checksum_free (a_checksum);
-	g_checksum_free (b_checksum);
+	if (nm_ip6_config_get_content_hash (a, FALSE) != nm_ip6_config_get_content_hash (b, FALSE))
+		return FALSE;
 
-	return equal;
+	return _equal_full (a, b);
 }
 
 /*****************************************************************************/
@@ -2447,81 +2536,202 @@ nameservers_to_gvalue (GArray *array, GValue *value)
 	g_value_take_variant (value, g_variant_builder_end (&builder));
 }
 
+static GVariant *
+_address_to_variant (const NMPlatformIP6Address *address)
+{
+	GVariantBuilder addr_builder;
+
+	g_variant_builder_init (&addr_builder, G_VARIANT_TYPE ("a{sv}"));
+	g_variant_builder_add (&addr_builder, "{sv}",
+	                       "address",
+	                       g_variant_new_string (nm_utils_inet6_ntop (&address->address, NULL)));
+	g_variant_builder_add (&addr_builder, "{sv}",
+	                       "prefix",
+	                       g_variant_new_uint32 (address->plen));
+	if (   !IN6_IS_ADDR_UNSPECIFIED (&address->peer_address)
+	    && !IN6_ARE_ADDR_EQUAL (&address->peer_address, &address->address)) {
+		g_variant_builder_add (&addr_builder, "{sv}",
+		                       "peer",
+		                       g_variant_new_string (nm_utils_inet6_ntop (&address->peer_address, NULL)));
+	}
+
+	return g_variant_builder_end (&addr_builder);
+}
+
 static void
-get_property (GObject *object, guint prop_id,
-              GValue *value, GParamSpec *pspec)
+_address_data_ensure (NMIP6Config *self)
 {
-	NMIP6Config *self = NM_IP6_CONFIG (object);
 	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
+	gs_unref_hashtable GHashTable *children_old = NULL;
 	const NMDedupMultiHeadEntry *head_entry;
+	GVariantBuilder builder_data, builder_legacy;
+
+	nm_assert (!!priv->address_data_variant == !!priv->addresses_variant);
+
+	if (priv->address_data_variant)
+		return;
+
+	children_old = g_steal_pointer (&priv->address_data_children);
+	priv->address_data_children = _nm_ip_config_variant_cache_new ();
+
+	g_variant_builder_init (&builder_data, G_VARIANT_TYPE ("aa{sv}"));
+	g_variant_builder_init (&builder_legacy, G_VARIANT_TYPE ("a(ayuay)"));
+
+	head_entry = nm_ip6_config_lookup_addresses (self);
+	if (head_entry) {
+		gs_free const NMPObject **addresses = NULL;
+		guint naddr, i;
+
+		addresses = (const NMPObject **) nm_dedup_multi_objs_to_array_head (head_entry, NULL, NULL, &naddr);
+		nm_assert (addresses && naddr);
+
+		g_qsort_with_data (addresses,
+		                   naddr,
+		                   sizeof (addresses[0]),
+		                   _addresses_sort_cmp_prop,
+		                   GINT_TO_POINTER (priv->privacy));
+
+		for (i = 0; i < naddr; i++) {
+			const NMPlatformIP6Address *address = NMP_OBJECT_CAST_IP6_ADDRESS (addresses[i]);
+			GVariant *child;
+
+			child = _nm_ip_config_variant_cache_move (children_old, priv->address_data_children, addresses[i]);
+			if (!child) {
+				child = _nm_ip_config_variant_cache_add (priv->address_data_children, addresses[i],
+				                                         _address_to_variant (address));
+			}
+			g_variant_builder_add_value (&builder_data, child);
+
+			g_variant_builder_add (&builder_legacy, "(@ayu@ay)",
+			                       g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE,
+			                                                  &address->address, 16, 1),
+			                       address->plen,
+			                       g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE,
+			                                                  (   i == 0
+			                                                   && priv->best_default_route)
+			                                                     ? &NMP_OBJECT_CAST_IP6_ROUTE (priv->best_default_route)->gateway
+			                                                     : &in6addr_any,
+			                                                  16, 1));
+		}
+	}
+
+	priv->address_data_variant = g_variant_ref_sink (g_variant_builder_end (&builder_data));
+	priv->addresses_variant = g_variant_ref_sink (g_variant_builder_end (&builder_legacy));
+}
+
+static GVariant *
+_route_to_variant (const NMPlatformIP6Route *route)
+{
+	GVariantBuilder route_builder;
+
+	g_variant_builder_init (&route_builder, G_VARIANT_TYPE ("a{sv}"));
+	g_variant_builder_add (&route_builder, "{sv}",
+	                       "dest",
+	                       g_variant_new_string (nm_utils_inet6_ntop (&route->network, NULL)));
+	g_variant_builder_add (&route_builder, "{sv}",
+	                       "prefix",
+	                       g_variant_new_uint32 (route->plen));
+	if (!IN6_IS_ADDR_UNSPECIFIED (&route->gateway)) {
+		g_variant_builder_add (&route_builder, "{sv}",
+		                       "next-hop",
+		                       g_variant_new_string (nm_utils_inet6_ntop (&route->gateway, NULL)));
+	}
+
+	g_variant_builder_add (&route_builder, "{sv}",
+	                       "metric",
+	                       g_variant_new_uint32 (route->metric));
+
+	if (!nm_platform_route_table_is_main (route->table_coerced)) {
+		g_variant_builder_add (&route_builder, "{sv}",
+		                       "table",
+		                       g_variant_new_uint32 (nm_platform_route_table_uncoerce (route->table_coerced, TRUE)));
+	}
+
+	return g_variant_builder_end (&route_builder);
+}
+
+static void
+_route_data_ensure (NMIP6Config *self)
+{
+	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
+	gs_unref_hashtable GHashTable *children_old = NULL;
 	NMDedupMultiIter ipconf_iter;
 	const NMPlatformIP6Route *route;
 	GVariantBuilder builder_data, builder_legacy;
 
-	switch (prop_id) {
-	case PROP_IFINDEX:
-		g_value_set_int (value, priv->ifindex);
-		break;
-	case PROP_ADDRESS_DATA:
-	case PROP_ADDRESSES:
-		nm_assert (!!priv->address_data_variant == !!priv->addresses_variant);
+	nm_assert (!!priv->route_data_variant == !!priv->routes_variant);
 
-		if (priv->address_data_variant)
-			goto out_addresses_cached;
+	if (priv->route_data_variant)
+		return;
 
-		g_variant_builder_init (&builder_data, G_VARIANT_TYPE ("aa{sv}"));
-		g_variant_builder_init (&builder_legacy, G_VARIANT_TYPE ("a(ayuay)"));
+	children_old = g_steal_pointer (&priv->route_data_children);
+	priv->route_data_children = _nm_ip_config_variant_cache_new ();
 
-		head_entry = nm_ip6_config_lookup_addresses (self);
-		if (head_entry) {
-			gs_free const NMPObject **addresses = NULL;
-			guint naddr, i;
-
-			addresses = (const NMPObject **) nm_dedup_multi_objs_to_array_head (head_entry, NULL, NULL, &naddr);
-			nm_assert (addresses && naddr);
-
-			g_qsort_with_data (addresses,
-			                   naddr,
-			                   sizeof (addresses[0]),
-			                   _addresses_sort_cmp_prop,
-			                   GINT_TO_POINTER (priv->privacy));
-
-			for (i = 0; i < naddr; i++) {
-				GVariantBuilder addr_builder;
-				const NMPlatformIP6Address *address = NMP_OBJECT_CAST_IP6_ADDRESS (addresses[i]);
-
-				g_variant_builder_init (&addr_builder, G_VARIANT_TYPE ("a{sv}"));
-				g_variant_builder_add (&addr_builder, "{sv}",
-				                       "address",
-				                       g_variant_new_string (nm_utils_inet6_ntop (&address->address, NULL)));
-				g_variant_builder_add (&addr_builder, "{sv}",
-				                       "prefix",
-				                       g_variant_new_uint32 (address->plen));
-				if (   !IN6_IS_ADDR_UNSPECIFIED (&address->peer_address)
-				    && !IN6_ARE_ADDR_EQUAL (&address->peer_address, &address->address)) {
-					g_variant_builder_add (&addr_builder, "{sv}",
-					                       "peer",
-					                       g_variant_new_string (nm_utils_inet6_ntop (&address->peer_address, NULL)));
-				}
+	g_variant_builder_init (&builder_data, G_VARIANT_TYPE ("aa{sv}"));
+	g_variant_builder_init (&builder_legacy, G_VARIANT_TYPE ("a(ayuayu)"));
 
-				g_variant_builder_add (&builder_data, "a{sv}", &addr_builder);
-
-				g_variant_builder_add (&builder_legacy, "(@ayu@ay)",
-				                       g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE,
-				                                                  &address->address, 16, 1),
-				                       address->plen,
-				                       g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE,
-				                                                  (   i == 0
-				                                                   && priv->best_default_route)
-				                                                     ? &NMP_OBJECT_CAST_IP6_ROUTE (priv->best_default_route)->gateway
-				                                                     : &in6addr_any,
-				                                                  16, 1));
-			}
+	nm_ip_config_iter_ip6_route_for_each (&ipconf_iter, self, &route) {
+		const NMPObject *obj = ipconf_iter.current->obj;
+		GVariant *child;
+
+		nm_assert (_route_valid (route));
+
+		child = _nm_ip_config_variant_cache_move (children_old, priv->route_data_children, obj);
+		if (!child)
+			child = _nm_ip_config_variant_cache_add (priv->route_data_children, obj, _route_to_variant (route));
+		g_variant_builder_add_value (&builder_data, child);
+
+		/* legacy versions of nm_ip6_route_set_prefix() in libnm-util assert that the
+		 * plen is positive. Skip the default routes not to break older clients. */
+		if (   nm_platform_route_table_is_main (route->table_coerced)
+		    && !NM_PLATFORM_IP_ROUTE_IS_DEFAULT (route)) {
+			g_variant_builder_add (&builder_legacy, "(@ayu@ayu)",
+			                       g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE,
+			                                                  &route->network, 16, 1),
+			                       (guint32) route->plen,
+			                       g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE,
+			                                                  &route->gateway, 16, 1),
+			                       (guint32) route->metric);
 		}
+	}
+
+	priv->route_data_variant = g_variant_ref_sink (g_variant_builder_end (&builder_data));
+	priv->routes_variant = g_variant_ref_sink (g_variant_builder_end (&builder_legacy));
+}
+
+/*****************************************************************************/
+
+static void
+impl_ip6_config_get_routes (NMIP6Config *self,
+                            GDBusMethodInvocation *context,
+                            guint32 offset,
+                            guint32 limit)
+{
+	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
+
+	_route_data_ensure (self);
+	g_dbus_method_invocation_return_value (context,
+	                                       _nm_ip_config_route_data_slice (priv->route_data_variant,
+	                                                                       offset,
+	                                                                       limit));
+}
+
+/*****************************************************************************/
+
+static void
+get_property (GObject *object, guint prop_id,
+              GValue *value, GParamSpec *pspec)
+{
+	NMIP6Config *self = NM_IP6_CONFIG (object);
+	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 
-		priv->address_data_variant = g_variant_ref_sink (g_variant_builder_end (&builder_data));
-		priv->addresses_variant = g_variant_ref_sink (g_variant_builder_end (&builder_legacy));
-out_addresses_cached:
+	switch (prop_id) {
+	case PROP_IFINDEX:
+		g_value_set_int (value, priv->ifindex);
+		break;
+	case PROP_ADDRESS_DATA:
+	case PROP_ADDRESSES:
+		_address_data_ensure (self);
 		g_value_set_variant (value,
 		                     prop_id == PROP_ADDRESS_DATA ?
 		                     priv->address_data_variant :
@@ -2530,60 +2740,7 @@ out_addresses_cached:
 
 	case PROP_ROUTE_DATA:
 	case PROP_ROUTES:
-		nm_assert (!!priv->route_data_variant == !!priv->routes_variant);
-
-		if (priv->route_data_variant)
-			goto out_routes_cached;
-
-		g_variant_builder_init (&builder_data, G_VARIANT_TYPE ("aa{sv}"));
-		g_variant_builder_init (&builder_legacy, G_VARIANT_TYPE ("a(ayuayu)"));
-
-		nm_ip_config_iter_ip6_route_for_each (&ipconf_iter, self, &route) {
-			GVariantBuilder route_builder;
-
-			nm_assert (_route_valid (route));
-
-			g_variant_builder_init (&route_builder, G_VARIANT_TYPE ("a{sv}"));
-			g_variant_builder_add (&route_builder, "{sv}",
-			                       "dest",
-			                       g_variant_new_string (nm_utils_inet6_ntop (&route->network, NULL)));
-			g_variant_builder_add (&route_builder, "{sv}",
-			                       "prefix",
-			                       g_variant_new_uint32 (route->plen));
-			if (!IN6_IS_ADDR_UNSPECIFIED (&route->gateway)) {
-				g_variant_builder_add (&route_builder, "{sv}",
-				                       "next-hop",
-				                       g_variant_new_string (nm_utils_inet6_ntop (&route->gateway, NULL)));
-			}
-
-			g_variant_builder_add (&route_builder, "{sv}",
-			                       "metric",
-			                       g_variant_new_uint32 (route->metric));
-
-			if (!nm_platform_route_table_is_main (route->table_coerced)) {
-				g_variant_builder_add (&route_builder, "{sv}",
-				                       "table",
-				                       g_variant_new_uint32 (nm_platform_route_table_uncoerce (route->table_coerced, TRUE)));
-			}
-
-			g_variant_builder_add (&builder_data, "a{sv}", &route_builder);
-
-			/* legacy versions of nm_ip6_route_set_prefix() in libnm-util assert that the
-			 * plen is positive. Skip the default routes not to break older clients. */
-			if (   nm_platform_route_table_is_main (route->table_coerced)
-			    && !NM_PLATFORM_IP_ROUTE_IS_DEFAULT (route)) {
-				g_variant_builder_add (&builder_legacy, "(@ayu@ayu)",
-				                       g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE,
-				                                                  &route->network, 16, 1),
-				                       (guint32) route->plen,
-				                       g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE,
-				                                                  &route->gateway, 16, 1),
-				                       (guint32) route->metric);
-			}
-		}
-		priv->route_data_variant = g_variant_ref_sink (g_variant_builder_end (&builder_data));
-		priv->routes_variant = g_variant_ref_sink (g_variant_builder_end (&builder_legacy));
-out_routes_cached:
+		_route_data_ensure (self);
 		g_value_set_variant (value,
 		                     prop_id == PROP_ROUTE_DATA ?
 		                     priv->route_data_variant :
@@ -2661,6 +2818,7 @@ nm_ip6_config_init (NMIP6Config *self)
 	priv->domains = g_ptr_array_new_with_free_func (g_free);
 	priv->searches = g_ptr_array_new_with_free_func (g_free);
 	priv->dns_options = g_ptr_array_new_with_free_func (g_free);
+	_version_bump (priv);
 }
 
 NMIP6Config *
@@ -2701,6 +2859,8 @@ finalize (GObject *object)
 	nm_clear_g_variant (&priv->addresses_variant);
 	nm_clear_g_variant (&priv->route_data_variant);
 	nm_clear_g_variant (&priv->routes_variant);
+	g_clear_pointer (&priv->address_data_children, g_hash_table_unref);
+	g_clear_pointer (&priv->route_data_children, g_hash_table_unref);
 
 	g_array_unref (priv->nameservers);
 	g_ptr_array_unref (priv->domains);
@@ -2795,5 +2955,6 @@ nm_ip6_config_class_init (NMIP6ConfigClass *config_class)
 
 	nm_exported_object_class_add_interface (NM_EXPORTED_OBJECT_CLASS (config_class),
 	                                        NMDBUS_TYPE_IP6_CONFIG_SKELETON,
+	                                        "GetRoutes", impl_ip6_config_get_routes,
 	                                        NULL);
 }
@@ -200,7 +200,8 @@ const NMPObject *nm_ip6_config_nmpobj_lookup (const NMIP6Config *self,
 gboolean nm_ip6_config_nmpobj_remove (NMIP6Config *self,
                                       const NMPObject *needle);
 
-void nm_ip6_config_hash (const NMIP6Config *self, GChecksum *sum, gboolean dns_only);
+guint64 nm_ip6_config_get_content_hash (const NMIP6Config *self, gboolean dns_only);
+guint64 nm_ip6_config_get_version (const NMIP6Config *self);
 gboolean nm_ip6_config_equal (const NMIP6Config *a, const NMIP6Config *b);
 
 void nm_ip6_config_set_privacy (NMIP6Config *self, NMSettingIP6ConfigPrivacy privacy);
@@ -132,6 +132,13 @@ typedef struct {
 	NMMetered metered;
 
 	GSList *devices;
+	GHashTable *devices_index_data;
+	GHashTable *devices_by_path;
+	GHashTable *devices_by_ifindex;
+	GHashTable *devices_by_iface;
+	GHashTable *devices_by_ip_iface;
+	GHashTable *devices_by_hw_addr_perm;
+	GHashTable *devices_hw_addr_perm_pending;
 	NMState state;
 	NMConfig *config;
 	NMConnectivityState connectivity_state;
@@ -915,26 +922,186 @@ impl_manager_reload (NMManager *self,
 
 /*****************************************************************************/
 
+/* The manager keeps hash indexes over @devices so that lookups by D-Bus path,
+ * ifindex, interface name and permanent MAC address don't walk the whole
+ * list. Keys are not unique (for example, an unrealized device shares the
+ * interface name of a real one), so every index maps a key to a #GPtrArray
+ * of devices in the order they were added. The keys under which a device
+ * is indexed are remembered in a #DeviceIndexData, so that the device can be
+ * re-indexed whenever one of them changes. */
+
+typedef struct {
+	char *path;
+	int ifindex;
+	char *iface;
+	char *ip_iface;
+	char *hw_addr_perm;
+} DeviceIndexData;
+
+static char *
+_hw_addr_perm_to_key (const char *hwaddr)
+{
+	guint8 buf[NM_UTILS_HWADDR_LEN_MAX];
+	const guint8 *addr = buf;
+	gsize len;
+
+	if (!hwaddr)
+		return NULL;
+	if (!_nm_utils_hwaddr_aton (hwaddr, buf, sizeof (buf), &len))
+		return NULL;
+
+	/* like nm_utils_hwaddr_matches(), only compare the GUID part of
+	 * an infiniband address. */
+	if (len == INFINIBAND_ALEN) {
+		addr = &buf[INFINIBAND_ALEN - 8];
+		len = 8;
+	}
+	return nm_utils_hwaddr_ntoa (addr, len);
+}
+
+static void
+_devices_index_add (GHashTable *index, gconstpointer key, gboolean dup_key, NMDevice *device)
+{
+	GPtrArray *devices;
+
+	devices = g_hash_table_lookup (index, key);
+	if (!devices) {
+		devices = g_ptr_array_new ();
+		g_hash_table_insert (index,
+		                     dup_key ? g_strdup (key) : (gpointer) key,
+		                     devices);
+	}
+	g_ptr_array_add (devices, device);
+}
+
+static void
+_devices_index_remove (GHashTable *index, gconstpointer key, NMDevice *device)
+{
+	GPtrArray *devices;
+
+	devices = g_hash_table_lookup (index, key);
+	if (!devices)
+		g_return_if_reached ();
+
+	if (!g_ptr_array_remove (devices, device))
+		g_return_if_reached ();
+	if (devices->len == 0)
+		g_hash_table_remove (index, key);
+}
+
+static void
+_devices_index_update_str (GHashTable *index, char **p_key, const char *key, NMDevice *device)
+{
+	if (nm_streq0 (*p_key, key))
+		return;
+
+	if (*p_key) {
+		_devices_index_remove (index, *p_key, device);
+		g_free (*p_key);
+	}
+	*p_key = g_strdup (key);
+	if (key)
+		_devices_index_add (index, key, TRUE, device);
+}
+
+static void
+_devices_index_update_full (NMManager *self, NMDevice *device, gboolean remove)
+{
+	NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE (self);
+	DeviceIndexData *data;
+	gs_free char *hw_addr_perm = NULL;
+	int ifindex = 0;
+
+	data = g_hash_table_lookup (priv->devices_index_data, device);
+	if (!data) {
+		if (remove)
+			return;
+		data = g_slice_new0 (DeviceIndexData);
+		g_hash_table_insert (priv->devices_index_data, device, data);
+	}
+
+	if (!remove) {
+		ifindex = nm_device_get_ifindex (device);
+		if (ifindex < 0)
+			ifindex = 0;
+		/* don't force the permanent MAC address here. Devices that don't have it
+		 * yet are tracked in devices_hw_addr_perm_pending, see
+		 * find_device_by_permanent_hw_addr(). */
+		hw_addr_perm = _hw_addr_perm_to_key (nm_device_get_permanent_hw_address_full (device, FALSE, NULL));
+	}
+
+	if (data->ifindex != ifindex) {
+		if (data->ifindex > 0)
+			_devices_index_remove (priv->devices_by_ifindex, GINT_TO_POINTER (data->ifindex), device);
+		data->ifindex = ifindex;
+		if (ifindex > 0)
+			_devices_index_add (priv->devices_by_ifindex, GINT_TO_POINTER (ifindex), FALSE, device);
+	}
+
+	_devices_index_update_str (priv->devices_by_path, &data->path,
+	                           remove ? NULL : nm_exported_object_get_path (NM_EXPORTED_OBJECT (device)),
+	                           device);
+	_devices_index_update_str (priv->devices_by_iface, &data->iface,
+	                           remove ? NULL : nm_device_get_iface (device),
+	                           device);
+	_devices_index_update_str (priv->devices_by_ip_iface, &data->ip_iface,
+	                           remove ? NULL : nm_device_get_ip_iface (device),
+	                           device);
+	_devices_index_update_str (priv->devices_by_hw_addr_perm, &data->hw_addr_perm,
+	                           hw_addr_perm,
+	                           device);
+
+	if (!remove && !hw_addr_perm)
+		g_hash_table_add (priv->devices_hw_addr_perm_pending, device);
+	else
+		g_hash_table_remove (priv->devices_hw_addr_perm_pending, device);
+
+	if (remove) {
+		g_hash_table_remove (priv->devices_index_data, device);
+		g_slice_free (DeviceIndexData, data);
+	}
+}
+
+static void
+_devices_index_update (NMManager *self, NMDevice *device)
+{
+	_devices_index_update_full (self, device, FALSE);
+}
+
+static GPtrArray *
+_devices_index_lookup (GHashTable *index, gconstpointer key)
+{
+	return key ? g_hash_table_lookup (index, key) : NULL;
+}
+
 NMDevice *
 nm_manager_get_device_by_path (NMManager *manager, const char *path)
 {
-	GSList *iter;
+	GPtrArray *devices;
 
 	g_return_val_if_fail (path != NULL, NULL);
 
-	for (iter = NM_MANAGER_GET_PRIVATE (manager)->devices; iter; iter = iter->next) {
-		if (!strcmp (nm_exported_object_get_path (NM_EXPORTED_OBJECT (iter->data)), path))
-			return NM_DEVICE (iter->data);
-	}
-	return NULL;
+	devices = _devices_index_lookup (NM_MANAGER_GET_PRIVATE (manager)->devices_by_path, path);
+	if (   !devices
+	    || !nm_streq0 (nm_exported_object_get_path (devices->pdata[0]), path))
+		return NULL;
+	return devices->pdata[0];
 }
 
 NMDevice *
 nm_manager_get_device_by_ifindex (NMManager *manager, int ifindex)
 {
+	NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE (manager);
+	GPtrArray *devices;
 	GSList *iter;
 
-	for (iter = NM_MANAGER_GET_PRIVATE (manager)->devices; iter; iter = iter->next) {
+	if (ifindex > 0) {
+		devices = g_hash_table_lookup (priv->devices_by_ifindex, GINT_TO_POINTER (ifindex));
+		return devices ? devices->pdata[0] : NULL;
+	}
+
+	/* non-positive ifindexes are not indexed. */
+	for (iter = priv->devices; iter; iter = iter->next) {
 		NMDevice *device = NM_DEVICE (iter->data);
 
 		if (nm_device_get_ifindex (device) == ifindex)
@@ -947,33 +1114,52 @@ nm_manager_get_device_by_ifindex (NMManager *manager, int ifindex)
 static NMDevice *
 find_device_by_permanent_hw_addr (NMManager *manager, const char *hwaddr)
 {
-	GSList *iter;
-	const char *device_addr;
+	NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE (manager);
+	gs_free char *key = NULL;
+	GPtrArray *devices;
 
 	g_return_val_if_fail (hwaddr != NULL, NULL);
 
-	if (nm_utils_hwaddr_valid (hwaddr, -1)) {
-		for (iter = NM_MANAGER_GET_PRIVATE (manager)->devices; iter; iter = iter->next) {
-			device_addr = nm_device_get_permanent_hw_address (NM_DEVICE (iter->data));
-			if (device_addr && nm_utils_hwaddr_matches (hwaddr, -1, device_addr, -1))
-				return NM_DEVICE (iter->data);
-		}
+	if (!nm_utils_hwaddr_valid (hwaddr, -1))
+		return NULL;
+
+	if (g_hash_table_size (priv->devices_hw_addr_perm_pending) > 0) {
+		gs_unref_ptrarray GPtrArray *pending = NULL;
+		GHashTableIter h_iter;
+		NMDevice *device;
+		guint i;
+
+		/* Some devices don't know their permanent MAC address yet. Request it
+		 * now, which re-indexes them via notify::perm-hw-address. */
+		pending = g_ptr_array_new_with_free_func (g_object_unref);
+		g_hash_table_iter_init (&h_iter, priv->devices_hw_addr_perm_pending);
+		while (g_hash_table_iter_next (&h_iter, (gpointer *) &device, NULL))
+			g_ptr_array_add (pending, g_object_ref (device));
+		for (i = 0; i < pending->len; i++)
+			nm_device_get_permanent_hw_address (pending->pdata[i]);
 	}
-	return NULL;
+
+	key = _hw_addr_perm_to_key (hwaddr);
+	devices = _devices_index_lookup (priv->devices_by_hw_addr_perm, key);
+	return devices ? devices->pdata[0] : NULL;
 }
 
 static NMDevice *
 find_device_by_ip_iface (NMManager *self, const gchar *iface)
 {
-	GSList *iter;
+	GPtrArray *devices;
+	guint i;
 
 	g_return_val_if_fail (iface != NULL, NULL);
 
-	for (iter = NM_MANAGER_GET_PRIVATE (self)->devices; iter; iter = g_slist_next (iter)) {
-		NMDevice *candidate = iter->data;
+	devices = _devices_index_lookup (NM_MANAGER_GET_PRIVATE (self)->devices_by_ip_iface, iface);
+	if (!devices)
+		return NULL;
 
-		if (   nm_device_is_real (candidate)
-		    && g_strcmp0 (nm_device_get_ip_iface (candidate), iface) == 0)
+	for (i = 0; i < devices->len; i++) {
+		NMDevice *candidate = devices->pdata[i];
+
+		if (nm_device_is_real (candidate))
 			return candidate;
 	}
 	return NULL;
@@ -1002,15 +1188,18 @@ find_device_by_iface (NMManager *self,
 {
 	NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE (self);
 	NMDevice *fallback = NULL;
-	GSList *iter;
+	GPtrArray *devices;
+	guint i;
 
 	g_return_val_if_fail (iface != NULL, NULL);
 
-	for (iter = priv->devices; iter; iter = iter->next) {
-		NMDevice *candidate = iter->data;
+	devices = _devices_index_lookup (priv->devices_by_iface, iface);
+	if (!devices)
+		return NULL;
+
+	for (i = 0; i < devices->len; i++) {
+		NMDevice *candidate = devices->pdata[i];
 
-		if (strcmp (nm_device_get_iface (candidate), iface))
-			continue;
 		if (connection && !nm_device_check_connection_compatible (candidate, connection))
 			continue;
 		if (slave) {
@@ -1320,6 +1509,7 @@ remove_device (NMManager *self,
 
 	nm_settings_device_removed (priv->settings, device, quitting);
 	priv->devices = g_slist_remove (priv->devices, device);
+	_devices_index_update_full (self, device, TRUE);
 
 	_parent_notify_changed (self, device, TRUE);
 
@@ -2365,9 +2555,18 @@ device_ifindex_changed (NMDevice *device,
                         GParamSpec *pspec,
                         NMManager *self)
 {
+	_devices_index_update (self, device);
 	_parent_notify_changed (self, device, FALSE);
 }
 
+static void
+device_perm_hw_address_changed (NMDevice *device,
+                                GParamSpec *pspec,
+                                NMManager *self)
+{
+	_devices_index_update (self, device);
+}
+
 static void
 device_ip_iface_changed (NMDevice *device,
                          GParamSpec *pspec,
@@ -2375,18 +2574,21 @@ device_ip_iface_changed (NMDevice *device,
 {
 	const char *ip_iface = nm_device_get_ip_iface (device);
 	NMDeviceType device_type = nm_device_get_device_type (device);
-	GSList *iter;
+	GPtrArray *devices;
+	guint i;
+
+	_devices_index_update (self, device);
 
 	/* Remove NMDevice objects that are actually child devices of others,
 	 * when the other device finally knows its IP interface name.  For example,
 	 * remove the PPP interface that's a child of a WWAN device, since it's
 	 * not really a standalone NMDevice.
 	 */
-	for (iter = NM_MANAGER_GET_PRIVATE (self)->devices; iter; iter = iter->next) {
-		NMDevice *candidate = NM_DEVICE (iter->data);
+	devices = _devices_index_lookup (NM_MANAGER_GET_PRIVATE (self)->devices_by_iface, ip_iface);
+	for (i = 0; devices && i < devices->len; i++) {
+		NMDevice *candidate = devices->pdata[i];
 
 		if (   candidate != device
-		    && g_strcmp0 (nm_device_get_iface (candidate), ip_iface) == 0
 		    && nm_device_get_device_type (candidate) == device_type
 		    && nm_device_is_real (candidate)) {
 			remove_device (self, candidate, FALSE, FALSE);
@@ -2400,6 +2602,8 @@ device_iface_changed (NMDevice *device,
                       GParamSpec *pspec,
                       NMManager *self)
 {
+	_devices_index_update (self, device);
+
 	/* Virtual connections may refer to the new device name as
 	 * parent device, retry to activate them.
 	 */
@@ -2521,6 +2725,7 @@ add_device (NMManager *self, NMDevice *device, GError **error)
 	g_slist_free (remove);
 
 	priv->devices = g_slist_append (priv->devices, g_object_ref (device));
+	_devices_index_update (self, device);
 
 	g_signal_connect (device, NM_DEVICE_STATE_CHANGED,
 	                  G_CALLBACK (manager_device_state_changed),
@@ -2554,6 +2759,10 @@ add_device (NMManager *self, NMDevice *device, GError **error)
 	                  G_CALLBACK (device_realized),
 	                  self);
 
+	g_signal_connect (device, "notify::" NM_DEVICE_PERM_HW_ADDRESS,
+	                  G_CALLBACK (device_perm_hw_address_changed),
+	                  self);
+
 #if WITH_CONCHECK
 	g_signal_connect (device, "notify::" NM_DEVICE_CONNECTIVITY,
 	                  G_CALLBACK (device_connectivity_changed),
@@ -2588,6 +2797,7 @@ add_device (NMManager *self, NMDevice *device, GError **error)
 	                               manager_sleeping (self));
 
 	dbus_path = nm_exported_object_export (NM_EXPORTED_OBJECT (device));
+	_devices_index_update (self, device);
 	_LOG2I (LOGD_DEVICE, device, "new %s device (%s)", type_desc, dbus_path);
 
 	nm_settings_device_added (priv->settings, device);
@@ -2873,9 +3083,13 @@ platform_query_devices (NMManager *self)
 {
 	NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE (self);
 	gs_unref_ptrarray GPtrArray *links = NULL;
+	gs_free int *ifindexes = NULL;
 	int i;
 	gboolean guess_assume;
 	gs_free char *order = NULL;
+	gint64 ts_start, ts_prefetch, ts_realize;
+
+	ts_start = nm_utils_get_monotonic_timestamp_ns ();
 
 	guess_assume = nm_config_get_first_start (nm_config_get ());
 	order = nm_config_data_get_value (NM_CONFIG_GET_DATA,
@@ -2885,6 +3099,16 @@ platform_query_devices (NMManager *self)
 	links = nm_platform_link_get_all (priv->platform, !nm_streq0 (order, "index"));
 	if (!links)
 		return;
+
+	/* realizing the devices queries the driver info, the permanent MAC address
+	 * and SR-IOV support of every link. Gather them for all links at once. */
+	ifindexes = g_new (int, links->len);
+	for (i = 0; i < links->len; i++)
+		ifindexes[i] = NMP_OBJECT_CAST_LINK (links->pdata[i])->ifindex;
+	ts_prefetch = nm_utils_get_monotonic_timestamp_ns ();
+	nm_platform_link_facts_prefetch (priv->platform, ifindexes, links->len);
+
+	ts_realize = nm_utils_get_monotonic_timestamp_ns ();
 	for (i = 0; i < links->len; i++) {
 		const NMPlatformLink *link = NMP_OBJECT_CAST_LINK (links->pdata[i]);
 		const NMConfigDeviceStateData *dev_state;
@@ -2896,6 +3120,16 @@ platform_query_devices (NMManager *self)
 		                     guess_assume && (!dev_state || !dev_state->connection_uuid),
 		                     dev_state);
 	}
+
+	nm_platform_link_facts_clear (priv->platform);
+
+	_LOGI (LOGD_CORE, "startup: added devices for %u links in %"G_GINT64_FORMAT" ms "
+	                  "(list %"G_GINT64_FORMAT" ms, prefetch %"G_GINT64_FORMAT" ms, realize %"G_GINT64_FORMAT" ms)",
+	       links->len,
+	       (nm_utils_get_monotonic_timestamp_ns () - ts_start) / NM_UTILS_NS_PER_MSEC,
+	       (ts_prefetch - ts_start) / NM_UTILS_NS_PER_MSEC,
+	       (ts_realize - ts_prefetch) / NM_UTILS_NS_PER_MSEC,
+	       (nm_utils_get_monotonic_timestamp_ns () - ts_realize) / NM_UTILS_NS_PER_MSEC);
 }
 
 static void
@@ -5323,6 +5557,35 @@ impl_manager_get_logging (NMManager *manager,
 	                                                      nm_logging_domains_to_string ()));
 }
 
+static void
+impl_manager_get_netlink_statistics (NMManager *manager,
+                                     GDBusMethodInvocation *context)
+{
+	NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE (manager);
+	NMPlatformNetlinkStats stats;
+	NMPlatformSysctlStats sysctl_stats;
+	GVariantBuilder builder;
+
+	nm_platform_netlink_get_stats (priv->platform, &stats);
+	nm_platform_sysctl_get_stats (priv->platform, &sysctl_stats);
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{st}"));
+	g_variant_builder_add (&builder, "{st}", "messages", stats.n_msgs);
+	g_variant_builder_add (&builder, "{st}", "bytes", stats.n_bytes);
+	g_variant_builder_add (&builder, "{st}", "truncated", stats.n_truncated);
+	g_variant_builder_add (&builder, "{st}", "overflows", stats.n_overflows);
+	g_variant_builder_add (&builder, "{st}", "resyncs", stats.n_resyncs);
+	g_variant_builder_add (&builder, "{st}", "peak-backlog", stats.peak_backlog);
+	g_variant_builder_add (&builder, "{st}", "rcvbuf-size", stats.rcvbuf_size);
+	g_variant_builder_add (&builder, "{st}", "ip4-routes-filtered", stats.n_ip4_routes_filtered);
+	g_variant_builder_add (&builder, "{st}", "ip6-routes-filtered", stats.n_ip6_routes_filtered);
+	g_variant_builder_add (&builder, "{st}", "sysctl-writes", sysctl_stats.n_writes);
+	g_variant_builder_add (&builder, "{st}", "sysctl-writes-elided", sysctl_stats.n_writes_elided);
+
+	g_dbus_method_invocation_return_value (context,
+	                                       g_variant_new ("(a{st})", &builder));
+}
+
 typedef struct {
 	guint remaining;
 	GDBusMethodInvocation *context;
@@ -6507,6 +6770,14 @@ nm_manager_init (NMManager *self)
 
 	priv->capabilities = g_array_new (FALSE, FALSE, sizeof (guint32));
 
+	priv->devices_index_data = g_hash_table_new (g_direct_hash, g_direct_equal);
+	priv->devices_by_path = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_ptr_array_unref);
+	priv->devices_by_ifindex = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) g_ptr_array_unref);
+	priv->devices_by_iface = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_ptr_array_unref);
+	priv->devices_by_ip_iface = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_ptr_array_unref);
+	priv->devices_by_hw_addr_perm = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_ptr_array_unref);
+	priv->devices_hw_addr_perm_pending = g_hash_table_new (g_direct_hash, g_direct_equal);
+
 	/* Initialize rfkill structures and states */
 	memset (priv->radio_states, 0, sizeof (priv->radio_states));
 
@@ -6870,6 +7141,15 @@ finalize (GObject *object)
 
 	g_array_free (priv->capabilities, TRUE);
 
+	nm_assert (g_hash_table_size (priv->devices_index_data) == 0);
+	g_hash_table_destroy (priv->devices_index_data);
+	g_hash_table_destroy (priv->devices_by_path);
+	g_hash_table_destroy (priv->devices_by_ifindex);
+	g_hash_table_destroy (priv->devices_by_iface);
+	g_hash_table_destroy (priv->devices_by_ip_iface);
+	g_hash_table_destroy (priv->devices_by_hw_addr_perm);
+	g_hash_table_destroy (priv->devices_hw_addr_perm_pending);
+
 	G_OBJECT_CLASS (nm_manager_parent_class)->finalize (object);
 
 	g_object_unref (priv->platform);
@@ -7139,6 +7419,7 @@ nm_manager_class_init (NMManagerClass *manager_class)
 	                                        "GetPermissions", impl_manager_get_permissions,
 	                                        "SetLogging", impl_manager_set_logging,
 	                                        "GetLogging", impl_manager_get_logging,
+	                                        "GetNetlinkStatistics", impl_manager_get_netlink_statistics,
 	                                        "CheckConnectivity", impl_manager_check_connectivity,
 	                                        "state", impl_manager_get_state,
 	                                        "CheckpointCreate", impl_manager_checkpoint_create,
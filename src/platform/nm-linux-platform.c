@@ -26,6 +26,7 @@
 #include <unistd.h>
 #include <sys/socket.h>
 #include <sys/ioctl.h>
+#include <sys/eventfd.h>
 #include <fcntl.h>
 #include <dlfcn.h>
 #include <arpa/inet.h>
@@ -52,6 +53,7 @@
 #include "wifi/wifi-utils.h"
 #include "wifi/wifi-utils-wext.h"
 #include "nm-utils/unaligned.h"
+#include "nm-utils/c-list.h"
 #include "nm-utils/nm-udev-utils.h"
 
 /*****************************************************************************/
@@ -87,6 +89,34 @@ enum {
 
 #define IFQDISCSIZ                      32
 
+#ifndef SOL_NETLINK
+#define SOL_NETLINK                     270
+#endif
+#define NETLINK_GET_STRICT_CHK          12
+
+/*****************************************************************************/
+
+/* RTM_GETSTATS was added in kernel 4.7. Re-implement the parts of
+ * <linux/if_link.h> that we need, to build against older headers. */
+
+#ifndef RTM_GETSTATS
+#define RTM_NEWSTATS                    92
+#define RTM_GETSTATS                    94
+#endif
+
+#define IFLA_STATS_LINK_64              1
+
+#ifndef IFLA_STATS_FILTER_BIT
+struct if_stats_msg {
+	__u8  family;
+	__u8  pad1;
+	__u16 pad2;
+	__u32 ifindex;
+	__u32 filter_mask;
+};
+#define IFLA_STATS_FILTER_BIT(ATTR)     (1 << (ATTR - 1))
+#endif
+
 /*****************************************************************************/
 
 #ifndef IFLA_PROMISCUITY
@@ -265,6 +295,7 @@ typedef enum {
 	DELAYED_ACTION_TYPE_REFRESH_ALL_QDISCS          = (1LL << /* 5 */ DELAYED_ACTION_IDX_REFRESH_ALL_QDISCS),
 	DELAYED_ACTION_TYPE_REFRESH_ALL_TFILTERS        = (1LL << /* 6 */ DELAYED_ACTION_IDX_REFRESH_ALL_TFILTERS),
 	DELAYED_ACTION_TYPE_REFRESH_LINK                = (1LL <<    7),
+	DELAYED_ACTION_TYPE_REFRESH_PARTIAL             = (1LL <<    8),
 	DELAYED_ACTION_TYPE_MASTER_CONNECTED            = (1LL <<   11),
 	DELAYED_ACTION_TYPE_READ_NETLINK                = (1LL <<   12),
 	DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE        = (1LL <<   13),
@@ -315,6 +346,13 @@ static void cache_on_change (NMPlatform *platform,
 static void cache_prune_all (NMPlatform *platform);
 static gboolean event_handler_read_netlink (NMPlatform *platform, gboolean wait_for_acks);
 
+typedef struct _RouteFilter RouteFilter;
+static RouteFilter *_route_filter_get (NMPlatform *platform);
+
+typedef struct _NetlinkReader NetlinkReader;
+static NetlinkReader *netlink_reader_start (int fd_nl, gsize recv_buf_len, RouteFilter *route_filter);
+static void netlink_reader_stop (NetlinkReader *reader);
+
 /*****************************************************************************/
 
 static NMPlatformError
@@ -387,21 +425,17 @@ _support_user_ipv6ll_get (void)
  * extended IFA_FLAGS support
  *****************************************************************************/
 
-static int _support_kernel_extended_ifa_flags = 0;
+/* Messages are parsed on the netlink reader thread, so this is detected
+ * there and read on the main thread. Only access it atomically. */
+static volatile int _support_kernel_extended_ifa_flags = 0;
 
-#define _support_kernel_extended_ifa_flags_still_undecided() (G_UNLIKELY (_support_kernel_extended_ifa_flags == 0))
+#define _support_kernel_extended_ifa_flags_still_undecided() (G_UNLIKELY (g_atomic_int_get (&_support_kernel_extended_ifa_flags) == 0))
 
 static void
-_support_kernel_extended_ifa_flags_detect (struct nl_msg *msg)
+_support_kernel_extended_ifa_flags_detect (struct nlmsghdr *msg_hdr)
 {
-	struct nlmsghdr *msg_hdr;
 	gboolean support;
 
-	nm_assert (_support_kernel_extended_ifa_flags_still_undecided ());
-	nm_assert (msg);
-
-	msg_hdr = nlmsg_hdr (msg);
-
 	nm_assert (msg_hdr && msg_hdr->nlmsg_type == RTM_NEWADDR);
 
 	/* IFA_FLAGS is set for IPv4 and IPv6 addresses. It was added first to IPv6,
@@ -417,37 +451,37 @@ _support_kernel_extended_ifa_flags_detect (struct nl_msg *msg)
 	 * For IPv4, IFA_F_NOPREFIXROUTE was added later, but there is no easy
 	 * way to detect kernel support. */
 	support = !!nlmsg_find_attr (msg_hdr, sizeof (struct ifaddrmsg), IFA_FLAGS);
-	_support_kernel_extended_ifa_flags = support ? 1 : -1;
+	if (!g_atomic_int_compare_and_exchange (&_support_kernel_extended_ifa_flags, 0, support ? 1 : -1))
+		return;
 	_LOG2D ("kernel-support: extended-ifa-flags: %s", support ? "detected" : "not detected");
 }
 
 static gboolean
 _support_kernel_extended_ifa_flags_get (void)
 {
-	if (_support_kernel_extended_ifa_flags_still_undecided ()) {
+	if (   _support_kernel_extended_ifa_flags_still_undecided ()
+	    && g_atomic_int_compare_and_exchange (&_support_kernel_extended_ifa_flags, 0, 1))
 		_LOG2D ("kernel-support: extended-ifa-flags: %s", "unable to detect kernel support for handling IPv6 temporary addresses. Assume support");
-		_support_kernel_extended_ifa_flags = 1;
-	}
-	return _support_kernel_extended_ifa_flags >= 0;
+	return g_atomic_int_get (&_support_kernel_extended_ifa_flags) >= 0;
 }
 
 /*****************************************************************************
  * Support RTA_PREF
  *****************************************************************************/
 
-static int _support_rta_pref = 0;
-#define _support_rta_pref_still_undecided() (G_UNLIKELY (_support_rta_pref == 0))
+/* like _support_kernel_extended_ifa_flags, detected on the reader thread. */
+static volatile int _support_rta_pref = 0;
+#define _support_rta_pref_still_undecided() (G_UNLIKELY (g_atomic_int_get (&_support_rta_pref) == 0))
 
 static void
 _support_rta_pref_detect (struct nlattr **tb)
 {
 	gboolean supported;
 
-	nm_assert (_support_rta_pref_still_undecided ());
-
 	/* RTA_PREF was added in kernel 4.1, dated 21 June, 2015. */
 	supported = !!tb[RTA_PREF];
-	_support_rta_pref = supported ? 1 : -1;
+	if (!g_atomic_int_compare_and_exchange (&_support_rta_pref, 0, supported ? 1 : -1))
+		return;
 	_LOG2D ("kernel-support: RTA_PREF: ability to set router preference for IPv6 routes: %s",
 	        supported ? "detected" : "not detected");
 }
@@ -455,14 +489,46 @@ _support_rta_pref_detect (struct nlattr **tb)
 static gboolean
 _support_rta_pref_get (void)
 {
-	if (_support_rta_pref_still_undecided ()) {
-		/* if we couldn't detect support, we fallback on compile-time check, whether
-		 * RTA_PREF is present in the kernel headers. */
-		_support_rta_pref = RTA_PREF_SUPPORTED_AT_COMPILETIME ? 1 : -1;
+	/* if we couldn't detect support, we fallback on compile-time check, whether
+	 * RTA_PREF is present in the kernel headers. */
+	if (   _support_rta_pref_still_undecided ()
+	    && g_atomic_int_compare_and_exchange (&_support_rta_pref, 0, RTA_PREF_SUPPORTED_AT_COMPILETIME ? 1 : -1)) {
 		_LOG2D ("kernel-support: RTA_PREF: ability to set router preference for IPv6 routes: %s",
 		        RTA_PREF_SUPPORTED_AT_COMPILETIME ? "assume support" : "assume no support");
 	}
-	return _support_rta_pref >= 0;
+	return g_atomic_int_get (&_support_rta_pref) >= 0;
+}
+
+/*****************************************************************************
+ * Support NETLINK_GET_STRICT_CHK
+ *****************************************************************************/
+
+static int _support_netlink_strict_chk = 0;
+
+/* try to enable strict checking of dump requests on @fd. With that,
+ * kernel filters address dumps by ifindex and route dumps by table and
+ * outgoing interface. */
+static gboolean
+_support_netlink_strict_chk_detect (int fd)
+{
+	int one = 1;
+	gboolean supported;
+
+	/* NETLINK_GET_STRICT_CHK was added in kernel 4.20, dated 23 December, 2018. */
+	supported = (setsockopt (fd, SOL_NETLINK, NETLINK_GET_STRICT_CHK, &one, sizeof (one)) == 0);
+	if (_support_netlink_strict_chk == 0) {
+		_support_netlink_strict_chk = supported ? 1 : -1;
+		_LOG2D ("kernel-support: NETLINK_GET_STRICT_CHK: filtering of dump requests: %s",
+		        supported ? "detected" : "not detected");
+	}
+	return supported;
+}
+
+static gboolean
+_support_netlink_strict_chk_get (void)
+{
+	/* detected when creating the netlink socket. */
+	return _support_netlink_strict_chk > 0;
 }
 
 /******************************************************************
@@ -2109,9 +2175,174 @@ errout:
 	return obj_result;
 }
 
+/*****************************************************************************
+ * route filter
+ *
+ * With full routing tables (e.g. from a BGP daemon), caching every route
+ * costs a lot of memory, although NetworkManager never manages these routes.
+ * The route filter drops such routes while parsing, so they never enter the
+ * cache.
+ *
+ * Only routes with a protocol that NetworkManager never uses itself are
+ * dropped (see nmp_utils_ip_config_source_coerce_to_rtprot()). Hence,
+ * routes that NetworkManager configures are always cached, and the prune
+ * lists of nm_platform_ip_route_get_prune_list() still contain them. Dropped
+ * routes are invisible to NetworkManager, so it also never deletes them.
+ *****************************************************************************/
+
+#define ROUTE_FILTER_PROTECTED_RTPROT(rtprot) \
+	NM_IN_SET ((rtprot), RTPROT_UNSPEC, \
+	                     RTPROT_REDIRECT, \
+	                     RTPROT_KERNEL, \
+	                     RTPROT_BOOT, \
+	                     RTPROT_STATIC, \
+	                     RTPROT_RA, \
+	                     RTPROT_DHCP)
+
+struct _RouteFilter {
+	/* a bitmap of the rtm_protocol values to drop. */
+	guint32 protocols[256 / 32];
+
+	/* drop all (not protected) routes in these tables, or on these
+	 * interfaces. */
+	GArray *tables;
+	GArray *ifindexes;
+
+	/* number of dropped routes, for IPv4 and IPv6. The routes might be
+	 * parsed on the netlink reader thread, so these are atomic. */
+	volatile gint n_filtered[2];
+};
+
+static const struct {
+	const char *name;
+	guint8 rtprot;
+} route_filter_protocol_names[] = {
+	{ "gated",    RTPROT_GATED },
+	{ "mrt",      RTPROT_MRT },
+	{ "zebra",    RTPROT_ZEBRA },
+	{ "bird",     RTPROT_BIRD },
+	{ "dnrouted", RTPROT_DNROUTED },
+	{ "xorp",     RTPROT_XORP },
+	{ "ntk",      RTPROT_NTK },
+	/* newer kernel headers have RTPROT_BABEL, RTPROT_BGP, etc. */
+	{ "babel",    42 },
+	{ "bgp",      186 },
+	{ "isis",     187 },
+	{ "ospf",     188 },
+	{ "rip",      189 },
+	{ "eigrp",    192 },
+};
+
+static void
+_route_filter_free (RouteFilter *filter)
+{
+	g_array_unref (filter->tables);
+	g_array_unref (filter->ifindexes);
+	g_slice_free (RouteFilter, filter);
+}
+
+static RouteFilter *
+_route_filter_new (NMPlatform *platform, const char *spec)
+{
+	gs_free const char **tokens = NULL;
+	RouteFilter *filter;
+	gboolean any = FALSE;
+	gsize i, j;
+
+	tokens = nm_utils_strsplit_set (spec, " \t,");
+	if (!tokens)
+		return NULL;
+
+	filter = g_slice_new0 (RouteFilter);
+	filter->tables = g_array_new (FALSE, FALSE, sizeof (guint32));
+	filter->ifindexes = g_array_new (FALSE, FALSE, sizeof (int));
+
+	for (i = 0; tokens[i]; i++) {
+		const char *s = tokens[i];
+		gint64 v;
+
+		if (g_str_has_prefix (s, "protocol:")) {
+			s += NM_STRLEN ("protocol:");
+			v = -1;
+			for (j = 0; j < G_N_ELEMENTS (route_filter_protocol_names); j++) {
+				if (nm_streq (s, route_filter_protocol_names[j].name)) {
+					v = route_filter_protocol_names[j].rtprot;
+					break;
+				}
+			}
+			if (v < 0)
+				v = _nm_utils_ascii_str_to_int64 (s, 10, 0, 255, -1);
+			if (v < 0)
+				goto invalid;
+			if (ROUTE_FILTER_PROTECTED_RTPROT (v)) {
+				_LOGW ("route-filter: ignore \"%s\" because NetworkManager uses that protocol itself", tokens[i]);
+				continue;
+			}
+			filter->protocols[v / 32] |= (1u << (v % 32));
+		} else if (g_str_has_prefix (s, "table:")) {
+			guint32 table;
+
+			v = _nm_utils_ascii_str_to_int64 (s + NM_STRLEN ("table:"), 10, 1, G_MAXUINT32, -1);
+			if (v < 0)
+				goto invalid;
+			table = v;
+			g_array_append_val (filter->tables, table);
+		} else if (g_str_has_prefix (s, "ifindex:")) {
+			int ifindex;
+
+			v = _nm_utils_ascii_str_to_int64 (s + NM_STRLEN ("ifindex:"), 10, 1, G_MAXINT, -1);
+			if (v < 0)
+				goto invalid;
+			ifindex = v;
+			g_array_append_val (filter->ifindexes, ifindex);
+		} else
+			goto invalid;
+
+		any = TRUE;
+		continue;
+invalid:
+		_LOGW ("route-filter: ignore invalid token \"%s\"", tokens[i]);
+	}
+
+	if (!any) {
+		_route_filter_free (filter);
+		return NULL;
+	}
+
+	_LOGD ("route-filter: don't cache routes matching \"%s\"", spec);
+	return filter;
+}
+
+static gboolean
+_route_filter_drop (const RouteFilter *filter, guint8 rtprot, guint32 table, int ifindex)
+{
+	guint i;
+
+	if (ROUTE_FILTER_PROTECTED_RTPROT (rtprot))
+		return FALSE;
+
+	if (NM_FLAGS_HAS (filter->protocols[rtprot / 32], (1u << (rtprot % 32))))
+		return TRUE;
+
+	for (i = 0; i < filter->tables->len; i++) {
+		if (g_array_index (filter->tables, guint32, i) == table)
+			return TRUE;
+	}
+	for (i = 0; i < filter->ifindexes->len; i++) {
+		if (g_array_index (filter->ifindexes, int, i) == ifindex)
+			return TRUE;
+	}
+	return FALSE;
+}
+
+/*****************************************************************************/
+
 /* Copied and heavily modified from libnl3's rtnl_route_parse() and parse_multipath(). */
 static NMPObject *
-_new_from_nl_route (struct nlmsghdr *nlh, gboolean id_only)
+_new_from_nl_route (struct nlmsghdr *nlh,
+                    gboolean id_only,
+                    RouteFilter *route_filter,
+                    gboolean *out_filtered_replace)
 {
 	static const struct nla_policy policy[RTA_MAX+1] = {
 		[RTA_TABLE]     = { .type = NLA_U32 },
@@ -2233,6 +2464,27 @@ _new_from_nl_route (struct nlmsghdr *nlh, gboolean id_only)
 	} else if (!nh.is_present)
 		goto errout;
 
+	/* Only drop new routes. A RTM_DELROUTE might delete a route that was
+	 * cached before, so let it through.
+	 *
+	 * A RTM_NEWROUTE with NLM_F_REPLACE replaced a route with the same
+	 * weak-id, which might be cached. The parser cannot check the cache
+	 * (it might run on the netlink reader thread), so it returns such a
+	 * route with @out_filtered_replace set. The caller then only removes
+	 * the replaced route from the cache, but doesn't cache the new one. */
+	if (   route_filter
+	    && nlh->nlmsg_type == RTM_NEWROUTE
+	    && _route_filter_drop (route_filter,
+	                           rtm->rtm_protocol,
+	                           tb[RTA_TABLE] ? nla_get_u32 (tb[RTA_TABLE]) : (guint32) rtm->rtm_table,
+	                           nh.ifindex)) {
+		g_atomic_int_inc (&route_filter->n_filtered[is_v4 ? 0 : 1]);
+		if (   !out_filtered_replace
+		    || !NM_FLAGS_HAS (nlh->nlmsg_flags, NLM_F_REPLACE))
+			goto errout;
+		*out_filtered_replace = TRUE;
+	}
+
 	/*****************************************************************/
 
 	mss = 0;
@@ -2416,20 +2668,26 @@ _new_from_nl_tfilter (struct nlmsghdr *nlh, gboolean id_only)
  *   be correctly detected.
  * @cache: (allow-none): for certain objects, the netlink message doesn't contain all the information.
  *   If a cache is given, the object is completed with information from the cache.
- * @nlh: the netlink message header
+ * @msghdr: the netlink message header. The message is parsed in place,
+ *   without copying it to a struct nl_msg first.
  * @id_only: whether only to create an empty object with only the ID fields set.
+ * @route_filter: (allow-none): the routes not to cache.
+ * @out_filtered_replace: (allow-none): set to %TRUE, if the result is a route
+ *   that @route_filter drops, but that replaced another route. The caller must
+ *   not cache it, but remove the replaced route. If %NULL, such routes are
+ *   dropped like the others.
  *
  * Returns: %NULL or a newly created NMPObject instance.
  **/
 static NMPObject *
-nmp_object_new_from_nl (NMPlatform *platform, const NMPCache *cache, struct nl_msg *msg, gboolean id_only)
+_nmp_object_new_from_nl (NMPlatform *platform,
+                         const NMPCache *cache,
+                         struct nlmsghdr *msghdr,
+                         gboolean id_only,
+                         RouteFilter *route_filter,
+                         gboolean *out_filtered_replace)
 {
-	struct nlmsghdr *msghdr;
-
-	if (nlmsg_get_proto (msg) != NETLINK_ROUTE)
-		return NULL;
-
-	msghdr = nlmsg_hdr (msg);
+	NM_SET_OUT (out_filtered_replace, FALSE);
 
 	switch (msghdr->nlmsg_type) {
 	case RTM_NEWLINK:
@@ -2444,7 +2702,7 @@ nmp_object_new_from_nl (NMPlatform *platform, const NMPCache *cache, struct nl_m
 	case RTM_NEWROUTE:
 	case RTM_DELROUTE:
 	case RTM_GETROUTE:
-		return _new_from_nl_route (msghdr, id_only);
+		return _new_from_nl_route (msghdr, id_only, route_filter, out_filtered_replace);
 	case RTM_NEWQDISC:
 	case RTM_DELQDISC:
 	case RTM_GETQDISC:
@@ -2458,6 +2716,14 @@ nmp_object_new_from_nl (NMPlatform *platform, const NMPCache *cache, struct nl_m
 	}
 }
 
+NMPObject *
+nmp_object_new_from_nl (NMPlatform *platform, const NMPCache *cache, struct nlmsghdr *msghdr, gboolean id_only)
+{
+	return _nmp_object_new_from_nl (platform, cache, msghdr, id_only,
+	                                platform ? _route_filter_get (platform) : NULL,
+	                                NULL);
+}
+
 /*****************************************************************************/
 
 static gboolean
@@ -3032,6 +3298,7 @@ typedef enum {
 	DELAYED_ACTION_RESPONSE_TYPE_VOID                       = 0,
 	DELAYED_ACTION_RESPONSE_TYPE_REFRESH_ALL_IN_PROGRESS    = 1,
 	DELAYED_ACTION_RESPONSE_TYPE_ROUTE_GET                  = 2,
+	DELAYED_ACTION_RESPONSE_TYPE_LINK_STATS                 = 3,
 } DelayedActionWaitForNlResponseType;
 
 typedef struct {
@@ -3043,10 +3310,54 @@ typedef struct {
 	union {
 		gint *out_refresh_all_in_progess;
 		NMPObject **out_route_get;
+		GArray *out_link_stats;
 		gpointer out_data;
 	} response;
 } DelayedActionWaitForNlResponseData;
 
+/* A refresh of only a subset of the objects of one type. Instead of
+ * marking all objects of the type as dirty, only the matching objects
+ * are marked and pruned. */
+typedef struct {
+	NMPObjectType obj_type;
+
+	/* if positive, only refresh objects on this ifindex. */
+	int ifindex;
+
+	/* for routes, if not RT_TABLE_UNSPEC, only refresh the routes of this table.
+	 * A partial refresh is either by ifindex or by table, not both. */
+	guint32 table;
+
+	/* the sequence number of the dump request, once it is sent. */
+	guint32 seq_number;
+} DelayedActionRefreshPartialData;
+
+static void do_request_partial_no_delayed_actions (NMPlatform *platform, const DelayedActionRefreshPartialData *data);
+
+/* A link change that was sent by link_change_async(). Contrary to
+ * WAIT_FOR_NL_RESPONSE, nobody blocks waiting for the response. Once
+ * the ACK arrives, the request moves to the list of completed requests,
+ * and the callback is invoked from an idle handler. */
+typedef struct {
+	CList async_lst;
+	guint32 seq_number;
+	WaitForNlResponseResult seq_result;
+	gint64 timeout_abs_ns;
+	ChangeLinkType change_link_type;
+	int ifindex;
+
+	/* the ChangeLinkData of the request. For CHANGE_LINK_TYPE_SET_ADDRESS,
+	 * the address is a copy that we own. */
+	ChangeLinkData change_link_data;
+
+	/* the request, kept to retry with RTM_SETLINK. */
+	struct nl_msg *nlmsg;
+
+	NMPlatformError result;
+	NMPlatformAsyncCallback callback;
+	gpointer user_data;
+} AsyncChangeLinkData;
+
 typedef struct {
 	struct nl_sock *nlh;
 	guint32 nlh_seq_next;
@@ -3054,14 +3365,57 @@ typedef struct {
 	guint32 nlh_seq_last_handled;
 #endif
 	guint32 nlh_seq_last_seen;
+
+	/* whether NETLINK_GET_STRICT_CHK is enabled on @nlh. In that case, dump
+	 * requests can ask kernel to only return the objects of one interface
+	 * or routing table. */
+	bool nlh_strict_chk:1;
+
+	/* a preallocated buffer for recvmsg(). Received messages are parsed
+	 * in place. It only grows, when we encounter MSG_TRUNC. */
+	guint8 *nlh_recv_buf;
+	gsize nlh_recv_buf_len;
+
+	/* the receive buffer size that we last requested for @nlh. It grows
+	 * when the socket overflows or when we see large bursts of events. */
+	gsize nlh_rcvbuf_requested;
+
+	/* the counters for nm_platform_netlink_get_stats(). @nl_burst_bytes
+	 * is the size of the events that we read in one go so far. Replies
+	 * to our own requests (like dumps) don't count, because kernel only
+	 * sends them as we read. Only accessed from the main thread. */
+	NMPlatformNetlinkStats nl_stats;
+	guint64 nl_burst_bytes;
+
+	/* if set, a dedicated thread receives from @nlh. */
+	NetlinkReader *reader;
+	bool netlink_thread:1;
+
+	/* routes that we don't put into the cache. Immutable after construction,
+	 * except for the (atomic) counters. */
+	char *route_filter_spec;
+	RouteFilter *route_filter;
+
 	GIOChannel *event_channel;
 	guint event_id;
 
 	bool pruning[_DELAYED_ACTION_IDX_REFRESH_ALL_NUM];
 
+	/* the partial refreshes that are in progress, and must be pruned
+	 * afterwards. Contains DelayedActionRefreshPartialData. */
+	GArray *pruning_partial;
+
+	/* only for testing: mark the next reply to one of our dumps as
+	 * interrupted, see _nmtst_linux_platform_interrupt_next_dump(). */
+	bool nmtst_interrupt_next_dump:1;
+
 	bool sysctl_get_warned;
 	GHashTable *sysctl_get_prev_values;
 
+	/* the per-interface IP sysctls, by ifname. Contains SysctlIface. */
+	GHashTable *sysctl_ifaces;
+	NMPlatformSysctlStats sysctl_stats;
+
 	NMUdevClient *udev_client;
 
 	struct {
@@ -3075,12 +3429,29 @@ typedef struct {
 
 		GPtrArray *list_master_connected;
 		GPtrArray *list_refresh_link;
+		GArray *list_refresh_partial;
 		GArray *list_wait_for_nl_response;
 
 		gint is_handling;
 	} delayed_action;
 
+	struct {
+		/* the AsyncChangeLinkData waiting for their response, and the
+		 * completed ones whose callback is still to be invoked. */
+		CList pending_lst_head;
+		CList done_lst_head;
+		guint timeout_id;
+		guint idle_id;
+	} async;
+
 	GHashTable *wifi_data;
+
+	struct {
+		/* the facts gathered by link_facts_prefetch(), and an index
+		 * into @arr by ifindex. */
+		struct _LinkFacts *arr;
+		GHashTable *idx;
+	} link_facts;
 } NMLinuxPlatformPrivate;
 
 struct _NMLinuxPlatform {
@@ -3096,8 +3467,24 @@ G_DEFINE_TYPE (NMLinuxPlatform, nm_linux_platform, NM_TYPE_PLATFORM)
 
 #define NM_LINUX_PLATFORM_GET_PRIVATE(self) _NM_GET_PRIVATE (self, NMLinuxPlatform, NM_IS_LINUX_PLATFORM, NMPlatform)
 
-NMPlatform *
-nm_linux_platform_new (gboolean log_with_ptr, gboolean netns_support)
+static RouteFilter *
+_route_filter_get (NMPlatform *platform)
+{
+	return NM_LINUX_PLATFORM_GET_PRIVATE (platform)->route_filter;
+}
+
+enum {
+	PROP_0,
+	PROP_NETLINK_THREAD,
+	PROP_ROUTE_FILTER,
+	LAST_PROP,
+};
+
+static NMPlatform *
+_linux_platform_new (gboolean log_with_ptr,
+                     gboolean netns_support,
+                     gboolean netlink_thread,
+                     const char *route_filter)
 {
 	gboolean use_udev = FALSE;
 
@@ -3109,13 +3496,46 @@ nm_linux_platform_new (gboolean log_with_ptr, gboolean netns_support)
 	                     NM_PLATFORM_LOG_WITH_PTR, log_with_ptr,
 	                     NM_PLATFORM_USE_UDEV, use_udev,
 	                     NM_PLATFORM_NETNS_SUPPORT, netns_support,
+	                     NM_LINUX_PLATFORM_NETLINK_THREAD, netlink_thread,
+	                     NM_LINUX_PLATFORM_ROUTE_FILTER, route_filter,
 	                     NULL);
 }
 
+NMPlatform *
+nm_linux_platform_new (gboolean log_with_ptr, gboolean netns_support)
+{
+	return _linux_platform_new (log_with_ptr, netns_support, FALSE, NULL);
+}
+
 void
 nm_linux_platform_setup (void)
 {
-	nm_platform_setup (nm_linux_platform_new (FALSE, FALSE));
+	nm_platform_setup (_linux_platform_new (FALSE, FALSE, FALSE, NULL));
+}
+
+/**
+ * nm_linux_platform_setup_threaded:
+ *
+ * Like nm_linux_platform_setup(), but receive and parse netlink
+ * messages on a dedicated reader thread.
+ */
+void
+nm_linux_platform_setup_threaded (void)
+{
+	nm_platform_setup (_linux_platform_new (FALSE, FALSE, TRUE, NULL));
+}
+
+/**
+ * nm_linux_platform_setup_full:
+ * @netlink_thread: whether to receive and parse netlink messages
+ *   on a dedicated reader thread.
+ * @route_filter: (allow-none): a list of routes not to cache,
+ *   like "protocol:bird,table:100,ifindex:5".
+ */
+void
+nm_linux_platform_setup_full (gboolean netlink_thread, const char *route_filter)
+{
+	nm_platform_setup (_linux_platform_new (FALSE, FALSE, netlink_thread, route_filter));
 }
 
 /*****************************************************************************/
@@ -3170,8 +3590,207 @@ _log_dbg_sysctl_set_impl (NMPlatform *platform, const char *pathid, int dirfd, c
 		} \
 	} G_STMT_END
 
+/*****************************************************************************/
+
+/* We remember the values of the per-interface IP sysctls (like
+ * /proc/sys/net/ipv6/conf/eth0/accept_ra) that we last wrote or read,
+ * and skip writes that would not change anything. Also, the conf
+ * directories of the interface are kept open, to save the path lookup
+ * (and the switch of the network namespace) for each access.
+ *
+ * The entry of an interface is dropped when the link is added, renamed
+ * or removed, and all values are forgotten when we write a sysctl of
+ * conf/all, conf/default or ipv4/ip_forward. Of course, somebody else
+ * might change the sysctls behind our back. We accept that, just like
+ * we accept that for the platform cache. */
+typedef struct {
+	char ifname[IFNAMSIZ];
+
+	/* the conf directories for IPv4 and IPv6, or -1. */
+	int dirfd[2];
+
+	/* the property name to the last known value. */
+	GHashTable *values;
+} SysctlIface;
+
+/* we don't want to run out of file descriptors. */
+#define SYSCTL_IFACE_DIRFDS_MAX 256
+
+static const char *const sysctl_ip_conf_dirs[2] = {
+	"/proc/sys/net/ipv4/conf/",
+	"/proc/sys/net/ipv6/conf/",
+};
+
+static void
+sysctl_iface_free (gpointer user_data)
+{
+	SysctlIface *iface = user_data;
+
+	nm_close (iface->dirfd[0]);
+	nm_close (iface->dirfd[1]);
+	g_hash_table_unref (iface->values);
+	g_slice_free (SysctlIface, iface);
+}
+
+static void
+sysctl_iface_invalidate (NMPlatform *platform, const char *ifname)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	SysctlIface *iface;
+
+	if (   !priv->sysctl_ifaces
+	    || !ifname
+	    || !ifname[0])
+		return;
+
+	iface = g_hash_table_lookup (priv->sysctl_ifaces, ifname);
+	if (!iface)
+		return;
+
+	priv->sysctl_stats.n_dirfds -= (iface->dirfd[0] >= 0) + (iface->dirfd[1] >= 0);
+	g_hash_table_remove (priv->sysctl_ifaces, ifname);
+}
+
+/* Kernel changes some of the properties by itself, for example the
+ * IPv6 MTU follows the link MTU, and the hop limit is set via router
+ * advertisements. "forwarding" changes with writes to conf/all/forwarding
+ * and ipv4/ip_forward, and "disable_ipv6" is set when DAD fails for the
+ * link-local address. We never skip writing them. */
 static gboolean
-sysctl_set (NMPlatform *platform, const char *pathid, int dirfd, const char *path, const char *value)
+sysctl_iface_property_is_volatile (guint family_idx, const char *property)
+{
+	if (nm_streq (property, "forwarding"))
+		return TRUE;
+	return    family_idx == 1
+	       && NM_IN_STRSET (property, "mtu", "hop_limit", "disable_ipv6");
+}
+
+/* Writing some of the global sysctls makes kernel change the per-interface
+ * values too, like conf/all/forwarding. Forget all values that we know
+ * after writing them. */
+static void
+sysctl_iface_forget_values (NMPlatform *platform, const char *path)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	GHashTableIter iter;
+	SysctlIface *iface;
+	guint i;
+
+	if (!priv->sysctl_ifaces)
+		return;
+
+	if (!nm_streq (path, "/proc/sys/net/ipv4/ip_forward")) {
+		for (i = 0; i < G_N_ELEMENTS (sysctl_ip_conf_dirs); i++) {
+			const char *p;
+
+			if (!g_str_has_prefix (path, sysctl_ip_conf_dirs[i]))
+				continue;
+			p = &path[strlen (sysctl_ip_conf_dirs[i])];
+			if (   g_str_has_prefix (p, "all/")
+			    || g_str_has_prefix (p, "default/"))
+				break;
+		}
+		if (i == G_N_ELEMENTS (sysctl_ip_conf_dirs))
+			return;
+	}
+
+	g_hash_table_iter_init (&iter, priv->sysctl_ifaces);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &iface))
+		g_hash_table_remove_all (iface->values);
+}
+
+/**
+ * sysctl_iface_get:
+ * @platform: the platform instance
+ * @path: the absolute path of a sysctl
+ * @out_family_idx: 0 for IPv4 and 1 for IPv6
+ * @out_property: the property name within @path
+ *
+ * Returns: the #SysctlIface for @path, created if needed, or %NULL
+ *   if @path is not a per-interface IP sysctl.
+ */
+static SysctlIface *
+sysctl_iface_get (NMPlatform *platform,
+                  const char *path,
+                  guint *out_family_idx,
+                  const char **out_property)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	SysctlIface *iface;
+	char ifname[IFNAMSIZ];
+	const char *slash;
+	guint family_idx;
+	gsize l;
+
+	if (!g_str_has_prefix (path, "/proc/sys/net/ipv"))
+		return NULL;
+
+	if (g_str_has_prefix (path, sysctl_ip_conf_dirs[0]))
+		family_idx = 0;
+	else if (g_str_has_prefix (path, sysctl_ip_conf_dirs[1]))
+		family_idx = 1;
+	else
+		return NULL;
+
+	path += strlen (sysctl_ip_conf_dirs[family_idx]);
+	slash = strchr (path, '/');
+	if (!slash)
+		return NULL;
+	l = slash - path;
+	if (l == 0 || l >= IFNAMSIZ)
+		return NULL;
+	if (!slash[1] || strchr (&slash[1], '/'))
+		return NULL;
+	memcpy (ifname, path, l);
+	ifname[l] = '\0';
+
+	/* these are not bound to a link. */
+	if (NM_IN_STRSET (ifname, "all", "default"))
+		return NULL;
+
+	if (!priv->sysctl_ifaces)
+		priv->sysctl_ifaces = g_hash_table_new_full (nm_str_hash, g_str_equal, NULL, sysctl_iface_free);
+
+	iface = g_hash_table_lookup (priv->sysctl_ifaces, ifname);
+	if (!iface) {
+		iface = g_slice_new (SysctlIface);
+		memcpy (iface->ifname, ifname, l + 1);
+		iface->dirfd[0] = -1;
+		iface->dirfd[1] = -1;
+		iface->values = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, g_free);
+		g_hash_table_insert (priv->sysctl_ifaces, iface->ifname, iface);
+	}
+
+	*out_family_idx = family_idx;
+	*out_property = &slash[1];
+	return iface;
+}
+
+static int
+sysctl_iface_get_dirfd (NMPlatform *platform, SysctlIface *iface, guint family_idx)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	nm_auto_pop_netns NMPNetns *netns = NULL;
+	char path[NM_STRLEN ("/proc/sys/net/ipv6/conf/") + IFNAMSIZ];
+
+	if (iface->dirfd[family_idx] >= 0)
+		return iface->dirfd[family_idx];
+
+	if (priv->sysctl_stats.n_dirfds >= SYSCTL_IFACE_DIRFDS_MAX)
+		return -1;
+
+	if (!nm_platform_netns_push (platform, &netns))
+		return -1;
+
+	nm_sprintf_buf (path, "%s%s", sysctl_ip_conf_dirs[family_idx], iface->ifname);
+	iface->dirfd[family_idx] = open (path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (iface->dirfd[family_idx] >= 0)
+		priv->sysctl_stats.n_dirfds++;
+	return iface->dirfd[family_idx];
+}
+
+static gboolean
+sysctl_set_impl (NMPlatform *platform, const char *pathid, int dirfd, const char *path, const char *value)
 {
 	nm_auto_pop_netns NMPNetns *netns = NULL;
 	int fd, tries;
@@ -3181,11 +3800,6 @@ sysctl_set (NMPlatform *platform, const char *pathid, int dirfd, const char *pat
 	gs_free char *actual_free = NULL;
 	int errsv;
 
-	g_return_val_if_fail (path != NULL, FALSE);
-	g_return_val_if_fail (value != NULL, FALSE);
-
-	ASSERT_SYSCTL_ARGS (pathid, dirfd, path);
-
 	if (dirfd < 0) {
 		if (!nm_platform_netns_push (platform, &netns)) {
 			errno = ENETDOWN;
@@ -3291,15 +3905,81 @@ sysctl_set (NMPlatform *platform, const char *pathid, int dirfd, const char *pat
 	return TRUE;
 }
 
-static GSList *sysctl_clear_cache_list;
-
-static void
-_nm_logging_clear_platform_logging_cache_impl (void)
+static gboolean
+sysctl_set (NMPlatform *platform, const char *pathid, int dirfd, const char *path, const char *value)
 {
-	while (sysctl_clear_cache_list) {
-		NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (sysctl_clear_cache_list->data);
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	SysctlIface *iface;
+	const char *property;
+	guint family_idx;
+	int iface_dirfd;
+	gboolean volatile_property;
+	gboolean success;
 
-		sysctl_clear_cache_list = g_slist_delete_link (sysctl_clear_cache_list, sysctl_clear_cache_list);
+	g_return_val_if_fail (path != NULL, FALSE);
+	g_return_val_if_fail (value != NULL, FALSE);
+
+	ASSERT_SYSCTL_ARGS (pathid, dirfd, path);
+
+	priv->sysctl_stats.n_writes++;
+
+	if (dirfd >= 0)
+		return sysctl_set_impl (platform, pathid, dirfd, path, value);
+
+	iface = sysctl_iface_get (platform, path, &family_idx, &property);
+	if (!iface) {
+		success = sysctl_set_impl (platform, NULL, -1, path, value);
+		sysctl_iface_forget_values (platform, path);
+		return success;
+	}
+
+	volatile_property = sysctl_iface_property_is_volatile (family_idx, property);
+	if (   !volatile_property
+	    && nm_streq0 (g_hash_table_lookup (iface->values, property), value)) {
+		priv->sysctl_stats.n_writes_elided++;
+		_LOGt ("sysctl: setting '%s' to '%s' (skipped, already set)", path, value);
+		return TRUE;
+	}
+
+	/* the value becomes unknown, until the write succeeds. */
+	g_hash_table_remove (iface->values, property);
+
+	iface_dirfd = sysctl_iface_get_dirfd (platform, iface, family_idx);
+	if (iface_dirfd >= 0) {
+		success = sysctl_set_impl (platform, path, iface_dirfd, property, value);
+		if (!success && errno == ENOENT) {
+			/* maybe the directory belongs to a link that no longer exists,
+			 * and a new link took its name. Retry with the path. */
+			sysctl_iface_invalidate (platform, iface->ifname);
+			iface = NULL;
+			success = sysctl_set_impl (platform, NULL, -1, path, value);
+		}
+	} else
+		success = sysctl_set_impl (platform, NULL, -1, path, value);
+
+	if (   success
+	    && iface
+	    && !volatile_property)
+		g_hash_table_insert (iface->values, g_strdup (property), g_strdup (value));
+	return success;
+}
+
+static gboolean
+sysctl_get_stats (NMPlatform *platform, NMPlatformSysctlStats *out_stats)
+{
+	*out_stats = NM_LINUX_PLATFORM_GET_PRIVATE (platform)->sysctl_stats;
+	return TRUE;
+}
+
+static GSList *sysctl_clear_cache_list;
+
+static void
+_nm_logging_clear_platform_logging_cache_impl (void)
+{
+	while (sysctl_clear_cache_list) {
+		NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (sysctl_clear_cache_list->data);
+
+		sysctl_clear_cache_list = g_slist_delete_link (sysctl_clear_cache_list, sysctl_clear_cache_list);
 
 		g_hash_table_destroy (priv->sysctl_get_prev_values);
 		priv->sysctl_get_prev_values = NULL;
@@ -3354,16 +4034,44 @@ sysctl_get (NMPlatform *platform, const char *pathid, int dirfd, const char *pat
 	nm_auto_pop_netns NMPNetns *netns = NULL;
 	GError *error = NULL;
 	char *contents;
+	SysctlIface *iface = NULL;
+	const char *property = NULL;
+	guint family_idx;
 
 	ASSERT_SYSCTL_ARGS (pathid, dirfd, path);
 
 	if (dirfd < 0) {
-		if (!nm_platform_netns_push (platform, &netns))
-			return NULL;
 		pathid = path;
+		iface = sysctl_iface_get (platform, path, &family_idx, &property);
+		if (iface) {
+			/* forget the value, in case the read fails. */
+			g_hash_table_remove (iface->values, property);
+			dirfd = sysctl_iface_get_dirfd (platform, iface, family_idx);
+			if (dirfd >= 0)
+				path = property;
+		}
+		if (   dirfd < 0
+		    && !nm_platform_netns_push (platform, &netns))
+			return NULL;
 	}
 
+again:
 	if (nm_utils_file_get_contents (dirfd, path, 1*1024*1024, &contents, NULL, &error) < 0) {
+		if (   iface
+		    && dirfd >= 0
+		    && g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_NOENT)) {
+			/* maybe the directory belongs to a link that no longer exists,
+			 * and a new link took its name. Retry with the path. */
+			g_clear_error (&error);
+			sysctl_iface_invalidate (platform, iface->ifname);
+			iface = NULL;
+			dirfd = -1;
+			path = pathid;
+			if (!nm_platform_netns_push (platform, &netns))
+				return NULL;
+			goto again;
+		}
+
 		/* We assume FAILED means EOPNOTSUP */
 		if (   g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_NOENT)
 		    || g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_NODEV)
@@ -3379,6 +4087,10 @@ sysctl_get (NMPlatform *platform, const char *pathid, int dirfd, const char *pat
 
 	_log_dbg_sysctl_get (platform, pathid, contents);
 
+	if (   iface
+	    && !sysctl_iface_property_is_volatile (family_idx, property))
+		g_hash_table_insert (iface->values, g_strdup (property), g_strdup (contents));
+
 	return contents;
 }
 
@@ -3407,6 +4119,11 @@ check_kernel_support (NMPlatform *platform,
 			response |= NM_PLATFORM_KERNEL_SUPPORT_RTA_PREF;
 	}
 
+	if (NM_FLAGS_HAS (request_flags, NM_PLATFORM_KERNEL_SUPPORT_NETLINK_STRICT_CHK)) {
+		if (_support_netlink_strict_chk_get ())
+			response |= NM_PLATFORM_KERNEL_SUPPORT_NETLINK_STRICT_CHK;
+	}
+
 	return response;
 }
 
@@ -3464,6 +4181,7 @@ NM_UTILS_LOOKUP_STR_DEFINE_STATIC (delayed_action_to_string, DelayedActionType,
 	NM_UTILS_LOOKUP_STR_ITEM (DELAYED_ACTION_TYPE_REFRESH_ALL_QDISCS,        "refresh-all-qdiscs"),
 	NM_UTILS_LOOKUP_STR_ITEM (DELAYED_ACTION_TYPE_REFRESH_ALL_TFILTERS,      "refresh-all-tfilters"),
 	NM_UTILS_LOOKUP_STR_ITEM (DELAYED_ACTION_TYPE_REFRESH_LINK,              "refresh-link"),
+	NM_UTILS_LOOKUP_STR_ITEM (DELAYED_ACTION_TYPE_REFRESH_PARTIAL,           "refresh-partial"),
 	NM_UTILS_LOOKUP_STR_ITEM (DELAYED_ACTION_TYPE_MASTER_CONNECTED,          "master-connected"),
 	NM_UTILS_LOOKUP_STR_ITEM (DELAYED_ACTION_TYPE_READ_NETLINK,              "read-netlink"),
 	NM_UTILS_LOOKUP_STR_ITEM (DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE,      "wait-for-nl-response"),
@@ -3486,6 +4204,18 @@ delayed_action_to_string_full (DelayedActionType action_type, gpointer user_data
 	case DELAYED_ACTION_TYPE_REFRESH_LINK:
 		nm_utils_strbuf_append (&buf, &buf_size, " (ifindex %d)", GPOINTER_TO_INT (user_data));
 		break;
+	case DELAYED_ACTION_TYPE_REFRESH_PARTIAL: {
+		const DelayedActionRefreshPartialData *partial = user_data;
+
+		nm_utils_strbuf_append (&buf, &buf_size, " (%s",
+		                        nmp_class_from_type (partial->obj_type)->obj_type_name);
+		if (partial->ifindex > 0)
+			nm_utils_strbuf_append (&buf, &buf_size, ", ifindex %d", partial->ifindex);
+		if (partial->table != RT_TABLE_UNSPEC)
+			nm_utils_strbuf_append (&buf, &buf_size, ", table %u", partial->table);
+		nm_utils_strbuf_append_c (&buf, &buf_size, ')');
+		break;
+	}
 	case DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE:
 		data = user_data;
 
@@ -3576,6 +4306,9 @@ delayed_action_wait_for_nl_response_complete (NMPlatform *platform,
 			data->response.out_route_get = NULL;
 		}
 		break;
+	case DELAYED_ACTION_RESPONSE_TYPE_LINK_STATS:
+		data->response.out_link_stats = NULL;
+		break;
 	}
 
 	g_array_remove_index_fast (priv->delayed_action.list_wait_for_nl_response, idx);
@@ -3633,6 +4366,12 @@ delayed_action_handle_REFRESH_ALL (NMPlatform *platform, DelayedActionType flags
 	do_request_all_no_delayed_actions (platform, flags);
 }
 
+static void
+delayed_action_handle_REFRESH_PARTIAL (NMPlatform *platform, const DelayedActionRefreshPartialData *data)
+{
+	do_request_partial_no_delayed_actions (platform, data);
+}
+
 static void
 delayed_action_handle_READ_NETLINK (NMPlatform *platform)
 {
@@ -3698,6 +4437,22 @@ delayed_action_handle_one (NMPlatform *platform)
 		return TRUE;
 	}
 
+	if (NM_FLAGS_HAS (priv->delayed_action.flags, DELAYED_ACTION_TYPE_REFRESH_PARTIAL)) {
+		DelayedActionRefreshPartialData data;
+
+		nm_assert (priv->delayed_action.list_refresh_partial->len > 0);
+
+		data = g_array_index (priv->delayed_action.list_refresh_partial, DelayedActionRefreshPartialData, 0);
+		g_array_remove_index (priv->delayed_action.list_refresh_partial, 0);
+		if (priv->delayed_action.list_refresh_partial->len == 0)
+			priv->delayed_action.flags &= ~DELAYED_ACTION_TYPE_REFRESH_PARTIAL;
+
+		_LOGt_delayed_action (DELAYED_ACTION_TYPE_REFRESH_PARTIAL, &data, "handle");
+
+		delayed_action_handle_REFRESH_PARTIAL (platform, &data);
+		return TRUE;
+	}
+
 	if (NM_FLAGS_HAS (priv->delayed_action.flags, DELAYED_ACTION_TYPE_REFRESH_LINK)) {
 		nm_assert (priv->delayed_action.list_refresh_link->len > 0);
 
@@ -3761,12 +4516,29 @@ delayed_action_schedule (NMPlatform *platform, DelayedActionType action_type, gp
 		if (_nm_utils_ptrarray_find_first ((gconstpointer *) priv->delayed_action.list_master_connected->pdata, priv->delayed_action.list_master_connected->len, user_data) < 0)
 			g_ptr_array_add (priv->delayed_action.list_master_connected, user_data);
 		break;
+	case DELAYED_ACTION_TYPE_REFRESH_PARTIAL: {
+		const DelayedActionRefreshPartialData *data = user_data;
+		guint i;
+
+		for (i = 0; i < priv->delayed_action.list_refresh_partial->len; i++) {
+			const DelayedActionRefreshPartialData *d = &g_array_index (priv->delayed_action.list_refresh_partial, DelayedActionRefreshPartialData, i);
+
+			if (   d->obj_type == data->obj_type
+			    && d->ifindex == data->ifindex
+			    && d->table == data->table)
+				break;
+		}
+		if (i == priv->delayed_action.list_refresh_partial->len)
+			g_array_append_vals (priv->delayed_action.list_refresh_partial, data, 1);
+		break;
+	}
 	case DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE:
 		g_array_append_vals (priv->delayed_action.list_wait_for_nl_response, user_data, 1);
 		break;
 	default:
 		nm_assert (!user_data);
 		nm_assert (!NM_FLAGS_HAS (action_type, DELAYED_ACTION_TYPE_REFRESH_LINK));
+		nm_assert (!NM_FLAGS_HAS (action_type, DELAYED_ACTION_TYPE_REFRESH_PARTIAL));
 		nm_assert (!NM_FLAGS_HAS (action_type, DELAYED_ACTION_TYPE_MASTER_CONNECTED));
 		nm_assert (!NM_FLAGS_HAS (action_type, DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE));
 		break;
@@ -3801,27 +4573,83 @@ delayed_action_schedule_WAIT_FOR_NL_RESPONSE (NMPlatform *platform,
 	                         &data);
 }
 
+static void
+delayed_action_schedule_REFRESH_PARTIAL (NMPlatform *platform,
+                                         NMPObjectType obj_type,
+                                         int ifindex,
+                                         guint32 table)
+{
+	DelayedActionRefreshPartialData data = {
+		.obj_type = obj_type,
+		.ifindex = ifindex,
+		.table = table,
+	};
+
+	nm_assert (NM_IN_SET (obj_type, NMP_OBJECT_TYPE_IP4_ADDRESS,
+	                                NMP_OBJECT_TYPE_IP6_ADDRESS,
+	                                NMP_OBJECT_TYPE_IP4_ROUTE,
+	                                NMP_OBJECT_TYPE_IP6_ROUTE,
+	                                NMP_OBJECT_TYPE_QDISC,
+	                                NMP_OBJECT_TYPE_TFILTER));
+	nm_assert ((ifindex > 0) != (table != RT_TABLE_UNSPEC));
+	nm_assert (   table == RT_TABLE_UNSPEC
+	           || NM_IN_SET (obj_type, NMP_OBJECT_TYPE_IP4_ROUTE, NMP_OBJECT_TYPE_IP6_ROUTE));
+
+	delayed_action_schedule (platform,
+	                         DELAYED_ACTION_TYPE_REFRESH_PARTIAL,
+	                         &data);
+}
+
+static gboolean
+delayed_action_refresh_partial_match (const DelayedActionRefreshPartialData *data,
+                                      const NMPObject *obj)
+{
+	if (NMP_OBJECT_GET_TYPE (obj) != data->obj_type)
+		return FALSE;
+	if (   data->ifindex > 0
+	    && obj->object.ifindex != data->ifindex)
+		return FALSE;
+	if (   data->table != RT_TABLE_UNSPEC
+	    && nm_platform_route_table_uncoerce (obj->ip_route.table_coerced, TRUE) != data->table)
+		return FALSE;
+	return TRUE;
+}
+
+static const NMPLookup *
+delayed_action_refresh_partial_lookup_init (NMPLookup *lookup,
+                                            const DelayedActionRefreshPartialData *data)
+{
+	if (data->ifindex > 0)
+		return nmp_lookup_init_object (lookup, data->obj_type, data->ifindex);
+	return nmp_lookup_init_route_by_table (lookup, data->obj_type, data->table);
+}
+
 /*****************************************************************************/
 
 static void
-cache_prune_one_type (NMPlatform *platform, NMPObjectType obj_type)
+cache_prune_lookup (NMPlatform *platform, const NMPLookup *lookup)
 {
 	NMDedupMultiIter iter;
 	const NMPObject *obj;
 	NMPCacheOpsType cache_op;
-	NMPLookup lookup;
 	NMPCache *cache = nm_platform_get_cache (platform);
 
-	nmp_lookup_init_obj_type (&lookup,
-	                          obj_type);
 	nm_dedup_multi_iter_init (&iter,
 	                          nmp_cache_lookup (cache,
-	                                            &lookup));
+	                                            lookup));
 	while (nm_dedup_multi_iter_next (&iter)) {
-		if (iter.current->dirty) {
+		const NMDedupMultiEntry *entry = iter.current;
+
+		if (lookup->cache_id_type != NMP_CACHE_ID_TYPE_OBJECT_TYPE) {
+			/* the dirty flag is tracked by the entries of the
+			 * NMP_CACHE_ID_TYPE_OBJECT_TYPE index. */
+			entry = nmp_cache_lookup_entry (cache, entry->obj);
+		}
+
+		if (entry->dirty) {
 			nm_auto_nmpobj const NMPObject *obj_old = NULL;
 
-			obj = iter.current->obj;
+			obj = entry->obj;
 			_LOGt ("cache-prune: prune %s", nmp_object_to_string (obj, NMP_OBJECT_TO_STRING_ALL, NULL, 0));
 			cache_op = nmp_cache_remove (cache, obj, TRUE, TRUE, &obj_old);
 			nm_assert (cache_op == NMP_CACHE_OPS_REMOVED);
@@ -3831,6 +4659,16 @@ cache_prune_one_type (NMPlatform *platform, NMPObjectType obj_type)
 	}
 }
 
+static void
+cache_prune_one_type (NMPlatform *platform, NMPObjectType obj_type)
+{
+	NMPLookup lookup;
+
+	cache_prune_lookup (platform,
+	                    nmp_lookup_init_obj_type (&lookup,
+	                                              obj_type));
+}
+
 static void
 cache_prune_all (NMPlatform *platform)
 {
@@ -3844,8 +4682,65 @@ cache_prune_all (NMPlatform *platform)
 		if (*p) {
 			*p = FALSE;
 			cache_prune_one_type (platform, delayed_action_refresh_to_object_type (iflags));
+
+			if (   priv->route_filter
+			    && NM_IN_SET (iflags, DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ROUTES,
+			                          DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ROUTES)) {
+				gboolean is_v4 = (iflags == DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ROUTES);
+
+				_LOGD ("route-filter: %u IPv%c routes were not cached so far",
+				       (guint) g_atomic_int_get (&priv->route_filter->n_filtered[is_v4 ? 0 : 1]),
+				       is_v4 ? '4' : '6');
+			}
 		}
 	}
+
+	while (priv->pruning_partial->len > 0) {
+		DelayedActionRefreshPartialData data;
+		NMPLookup lookup;
+
+		data = g_array_index (priv->pruning_partial, DelayedActionRefreshPartialData, priv->pruning_partial->len - 1);
+		g_array_set_size (priv->pruning_partial, priv->pruning_partial->len - 1);
+
+		cache_prune_lookup (platform,
+		                    delayed_action_refresh_partial_lookup_init (&lookup, &data));
+	}
+}
+
+/* @obj is a route from a RTM_NEWROUTE with NLM_F_REPLACE, that the route
+ * filter drops. It is not cached, but kernel replaced a route with the same
+ * weak-id, and we must not keep that one either. */
+static void
+cache_remove_replaced_route (NMPlatform *platform, const NMPObject *obj)
+{
+	NMPCache *cache = nm_platform_get_cache (platform);
+	const NMDedupMultiHeadEntry *head_entry;
+	nm_auto_nmpobj const NMPObject *obj_replace = NULL;
+	NMPCacheOpsType cache_op;
+
+	head_entry = nmp_cache_lookup_all (cache, NMP_CACHE_ID_TYPE_ROUTES_BY_WEAK_ID, obj);
+	if (!head_entry)
+		return;
+
+	/* kernel replaces the first route with the weak-id. The index keeps the
+	 * routes in kernel's order, like for nmp_cache_update_netlink_route(). */
+	obj_replace = nmp_object_ref (nm_dedup_multi_head_entry_get_idx (head_entry, 0)->obj);
+
+	if (head_entry->len > 1) {
+		/* the order might be wrong. Make sure by refreshing the table. */
+		delayed_action_schedule_REFRESH_PARTIAL (platform,
+		                                         NMP_OBJECT_GET_TYPE (obj),
+		                                         0,
+		                                         nm_platform_route_table_uncoerce (obj->ip_route.table_coerced, TRUE));
+	}
+
+	_LOGt ("route-filter: remove replaced %s", nmp_object_to_string (obj_replace, NMP_OBJECT_TO_STRING_ID, NULL, 0));
+	cache_op = nmp_cache_remove (cache, obj_replace, TRUE, FALSE, NULL);
+	if (cache_op != NMP_CACHE_OPS_UNCHANGED) {
+		nm_assert (cache_op == NMP_CACHE_OPS_REMOVED);
+		cache_on_change (platform, cache_op, obj_replace, NULL);
+		nm_platform_cache_update_emit_signal (platform, cache_op, obj_replace, NULL);
+	}
 }
 
 static void
@@ -3911,14 +4806,12 @@ cache_on_change (NMPlatform *platform,
 				ifindex = obj_new->link.ifindex;
 
 			if (ifindex > 0) {
-				delayed_action_schedule (platform,
-				                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ADDRESSES |
-				                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ADDRESSES |
-				                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ROUTES |
-				                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ROUTES |
-				                         DELAYED_ACTION_TYPE_REFRESH_ALL_QDISCS |
-				                         DELAYED_ACTION_TYPE_REFRESH_ALL_TFILTERS,
-				                         NULL);
+				delayed_action_schedule_REFRESH_PARTIAL (platform, NMP_OBJECT_TYPE_IP4_ADDRESS, ifindex, RT_TABLE_UNSPEC);
+				delayed_action_schedule_REFRESH_PARTIAL (platform, NMP_OBJECT_TYPE_IP6_ADDRESS, ifindex, RT_TABLE_UNSPEC);
+				delayed_action_schedule_REFRESH_PARTIAL (platform, NMP_OBJECT_TYPE_IP4_ROUTE, ifindex, RT_TABLE_UNSPEC);
+				delayed_action_schedule_REFRESH_PARTIAL (platform, NMP_OBJECT_TYPE_IP6_ROUTE, ifindex, RT_TABLE_UNSPEC);
+				delayed_action_schedule_REFRESH_PARTIAL (platform, NMP_OBJECT_TYPE_QDISC, ifindex, RT_TABLE_UNSPEC);
+				delayed_action_schedule_REFRESH_PARTIAL (platform, NMP_OBJECT_TYPE_TFILTER, ifindex, RT_TABLE_UNSPEC);
 			}
 		}
 		{
@@ -3953,6 +4846,19 @@ cache_on_change (NMPlatform *platform,
 				}
 			}
 		}
+		{
+			/* the sysctls of a new or renamed link have their default values,
+			 * and the directories of a removed or renamed link are gone. */
+			if (   cache_op == NMP_CACHE_OPS_ADDED
+			    || cache_op == NMP_CACHE_OPS_REMOVED
+			    || (   obj_old && obj_new /* <-- nonsensical, make coverity happy */
+			        && !nm_streq (obj_old->link.name, obj_new->link.name))) {
+				if (obj_old)
+					sysctl_iface_invalidate (platform, obj_old->link.name);
+				if (obj_new)
+					sysctl_iface_invalidate (platform, obj_new->link.name);
+			}
+		}
 		{
 			/* if a link goes down, we must refresh routes */
 			if (   cache_op == NMP_CACHE_OPS_UPDATED
@@ -3966,10 +4872,8 @@ cache_on_change (NMPlatform *platform,
 				/* FIXME: I suspect that IFF_LOWER_UP must not be considered, and I
 				 * think kernel does send RTM_DELROUTE events for IPv6 routes, so
 				 * we might not need to refresh IPv6 routes. */
-				delayed_action_schedule (platform,
-				                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ROUTES |
-				                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ROUTES,
-				                         NULL);
+				delayed_action_schedule_REFRESH_PARTIAL (platform, NMP_OBJECT_TYPE_IP4_ROUTE, obj_new->link.ifindex, RT_TABLE_UNSPEC);
+				delayed_action_schedule_REFRESH_PARTIAL (platform, NMP_OBJECT_TYPE_IP6_ROUTE, obj_new->link.ifindex, RT_TABLE_UNSPEC);
 			}
 		}
 		if (   NM_IN_SET (cache_op, NMP_CACHE_OPS_ADDED, NMP_CACHE_OPS_UPDATED)
@@ -4047,7 +4951,11 @@ cache_on_change (NMPlatform *platform,
 	case NMP_OBJECT_TYPE_IP6_ADDRESS:
 		{
 			/* Address deletion is sometimes accompanied by route deletion. We need to
-			 * check all routes belonging to the same interface. */
+			 * check all routes belonging to the same interface.
+			 *
+			 * This is not restricted to the ifindex of the address, because kernel
+			 * also silently removes routes on other interfaces that use the address
+			 * as preferred source. */
 			if (cache_op == NMP_CACHE_OPS_REMOVED) {
 				delayed_action_schedule (platform,
 				                         (klass->obj_type == NMP_OBJECT_TYPE_IP4_ADDRESS)
@@ -4171,6 +5079,81 @@ _nl_send_nlmsg (NMPlatform *platform,
 	return 0;
 }
 
+/**
+ * _nl_send_nlmsg_batch:
+ * @platform:
+ * @nlmsgs: the messages to send.
+ * @n_nlmsgs: the number of messages in @nlmsgs.
+ * @out_seq_results: an array of @n_nlmsgs results, one for each message.
+ *
+ * Sends all messages with a single sendmsg() call. Kernel processes
+ * them in order, and we wait for the responses afterwards.
+ *
+ * Returns: 0 on success or a negative errno. Beware, it's an errno, not nlerror.
+ */
+static int
+_nl_send_nlmsg_batch (NMPlatform *platform,
+                      struct nl_msg **nlmsgs,
+                      guint n_nlmsgs,
+                      WaitForNlResponseResult *out_seq_results)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	struct sockaddr_nl nladdr = {
+		.nl_family = AF_NETLINK,
+	};
+	struct iovec *iov;
+	struct msghdr msg = {
+		.msg_name = &nladdr,
+		.msg_namelen = sizeof (nladdr),
+	};
+	guint32 local_port;
+	int try_count;
+	int nle;
+	guint i;
+
+	nm_assert (n_nlmsgs > 0);
+
+	iov = g_alloca (sizeof (struct iovec) * n_nlmsgs);
+	local_port = nl_socket_get_local_port (priv->nlh);
+
+	for (i = 0; i < n_nlmsgs; i++) {
+		struct nlmsghdr *nlhdr = nlmsg_hdr (nlmsgs[i]);
+
+		/* kernel expects the messages aligned within the buffer. */
+		nm_assert (nlhdr->nlmsg_len == NLMSG_ALIGN (nlhdr->nlmsg_len));
+
+		nlhdr->nlmsg_seq = _nlh_seq_next_get (priv);
+		if (!nlhdr->nlmsg_pid)
+			nlhdr->nlmsg_pid = local_port;
+		nlhdr->nlmsg_flags |= (NLM_F_REQUEST | NLM_F_ACK);
+
+		iov[i].iov_base = nlhdr;
+		iov[i].iov_len = nlhdr->nlmsg_len;
+	}
+	msg.msg_iov = iov;
+	msg.msg_iovlen = n_nlmsgs;
+
+	try_count = 0;
+again:
+	nle = sendmsg (nl_socket_get_fd (priv->nlh), &msg, 0);
+	if (nle < 0) {
+		nle = errno;
+		if (nle == EINTR && try_count++ < 100)
+			goto again;
+		_LOGD ("netlink: nl-send-nlmsg-batch: failed sending %u messages: %s (%d)", n_nlmsgs, g_strerror (nle), nle);
+		return -nle;
+	}
+
+	for (i = 0; i < n_nlmsgs; i++) {
+		delayed_action_schedule_WAIT_FOR_NL_RESPONSE (platform,
+		                                              nlmsg_hdr (nlmsgs[i])->nlmsg_seq,
+		                                              &out_seq_results[i],
+		                                              DELAYED_ACTION_RESPONSE_TYPE_VOID,
+		                                              NULL);
+	}
+	return 0;
+}
+
 static void
 do_request_link_no_delayed_actions (NMPlatform *platform, int ifindex, const char *name)
 {
@@ -4221,6 +5204,91 @@ do_request_link (NMPlatform *platform, int ifindex, const char *name)
 	delayed_action_handle_all (platform, FALSE);
 }
 
+/* Create a dump request for all objects of type @klass.
+ *
+ * If @ifindex or @table are set, and @strict_chk indicates that kernel
+ * checks dump requests strictly, the request asks kernel to only return
+ * addresses of that interface, or routes of that interface or table. Older
+ * kernels return everything, so the caller must filter the response itself
+ * in any case.
+ *
+ * With NETLINK_GET_STRICT_CHK, kernel rejects dump requests with a short
+ * header, so always send the full header of the object type. */
+static struct nl_msg *
+_nl_msg_new_dump (const NMPClass *klass,
+                  gboolean strict_chk,
+                  int ifindex,
+                  guint32 table)
+{
+	nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+	int nle;
+
+	if (!strict_chk) {
+		ifindex = 0;
+		table = RT_TABLE_UNSPEC;
+	}
+
+	nlmsg = nlmsg_alloc_simple (klass->rtm_gettype, NLM_F_DUMP);
+	if (!nlmsg)
+		return NULL;
+
+	switch (klass->obj_type) {
+	case NMP_OBJECT_TYPE_QDISC:
+	case NMP_OBJECT_TYPE_TFILTER: {
+		struct tcmsg tcmsg = {
+			.tcm_family = AF_UNSPEC,
+		};
+
+		nle = nlmsg_append (nlmsg, &tcmsg, sizeof (tcmsg), NLMSG_ALIGNTO);
+		break;
+	}
+	case NMP_OBJECT_TYPE_LINK: {
+		struct ifinfomsg ifi = {
+			.ifi_family = AF_UNSPEC,
+		};
+
+		nle = nlmsg_append (nlmsg, &ifi, sizeof (ifi), NLMSG_ALIGNTO);
+		break;
+	}
+	case NMP_OBJECT_TYPE_IP4_ADDRESS:
+	case NMP_OBJECT_TYPE_IP6_ADDRESS: {
+		struct ifaddrmsg ifa = {
+			.ifa_family = klass->addr_family,
+			.ifa_index = MAX (ifindex, 0),
+		};
+
+		nle = nlmsg_append (nlmsg, &ifa, sizeof (ifa), NLMSG_ALIGNTO);
+		break;
+	}
+	case NMP_OBJECT_TYPE_IP4_ROUTE:
+	case NMP_OBJECT_TYPE_IP6_ROUTE: {
+		struct rtmsg rtm = {
+			.rtm_family = klass->addr_family,
+			.rtm_table = table <= 0xFF ? table : RT_TABLE_UNSPEC,
+		};
+
+		nle = nlmsg_append (nlmsg, &rtm, sizeof (rtm), NLMSG_ALIGNTO);
+		if (nle < 0)
+			break;
+		if (table > 0xFF)
+			NLA_PUT_U32 (nlmsg, RTA_TABLE, table);
+		if (ifindex > 0)
+			NLA_PUT_U32 (nlmsg, RTA_OIF, ifindex);
+		break;
+	}
+	default:
+		nm_assert_not_reached ();
+		return NULL;
+	}
+	if (nle < 0)
+		return NULL;
+
+	return g_steal_pointer (&nlmsg);
+
+nla_put_failure:
+	return NULL;
+}
+
 static void
 do_request_all_no_delayed_actions (NMPlatform *platform, DelayedActionType action_type)
 {
@@ -4240,7 +5308,6 @@ do_request_all_no_delayed_actions (NMPlatform *platform, DelayedActionType actio
 		NMPObjectType obj_type = delayed_action_refresh_to_object_type (iflags);
 		const NMPClass *klass = nmp_class_from_type (obj_type);
 		nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
-		int nle;
 		gint *out_refresh_all_in_progess;
 
 		out_refresh_all_in_progess = &priv->delayed_action.refresh_all_in_progess[delayed_action_refresh_all_to_idx (iflags)];
@@ -4250,6 +5317,18 @@ do_request_all_no_delayed_actions (NMPlatform *platform, DelayedActionType actio
 		/* clear any delayed action that request a refresh of this object type. */
 		priv->delayed_action.flags &= ~iflags;
 		_LOGt_delayed_action (iflags, NULL, "handle (do-request-all)");
+		if (NM_FLAGS_HAS (priv->delayed_action.flags, DELAYED_ACTION_TYPE_REFRESH_PARTIAL)) {
+			guint i;
+
+			for (i = 0; i < priv->delayed_action.list_refresh_partial->len; ) {
+				if (g_array_index (priv->delayed_action.list_refresh_partial, DelayedActionRefreshPartialData, i).obj_type == obj_type)
+					g_array_remove_index (priv->delayed_action.list_refresh_partial, i);
+				else
+					i++;
+			}
+			if (priv->delayed_action.list_refresh_partial->len == 0)
+				priv->delayed_action.flags &= ~DELAYED_ACTION_TYPE_REFRESH_PARTIAL;
+		}
 		if (obj_type == NMP_OBJECT_TYPE_LINK) {
 			priv->delayed_action.flags &= ~DELAYED_ACTION_TYPE_REFRESH_LINK;
 			g_ptr_array_set_size (priv->delayed_action.list_refresh_link, 0);
@@ -4258,29 +5337,10 @@ do_request_all_no_delayed_actions (NMPlatform *platform, DelayedActionType actio
 
 		event_handler_read_netlink (platform, FALSE);
 
-		/* reimplement
-		 *   nl_rtgen_request (sk, klass->rtm_gettype, klass->addr_family, NLM_F_DUMP);
-		 * because we need the sequence number.
-		 */
-		nlmsg = nlmsg_alloc_simple (klass->rtm_gettype, NLM_F_DUMP);
+		nlmsg = _nl_msg_new_dump (klass, priv->nlh_strict_chk, 0, RT_TABLE_UNSPEC);
 		if (!nlmsg)
 			continue;
 
-		if (   klass->obj_type == NMP_OBJECT_TYPE_QDISC
-		    || klass->obj_type == NMP_OBJECT_TYPE_TFILTER) {
-			struct tcmsg tcmsg = {
-				.tcm_family = AF_UNSPEC,
-			};
-			nle = nlmsg_append (nlmsg, &tcmsg, sizeof (tcmsg), NLMSG_ALIGNTO);
-		} else {
-			struct rtgenmsg gmsg = {
-				.rtgen_family = klass->addr_family,
-			};
-			nle = nlmsg_append (nlmsg, &gmsg, sizeof (gmsg), NLMSG_ALIGNTO);
-		}
-		if (nle < 0)
-			continue;
-
 		if (_nl_send_nlmsg (platform, nlmsg, NULL, DELAYED_ACTION_RESPONSE_TYPE_REFRESH_ALL_IN_PROGRESS, out_refresh_all_in_progess) < 0) {
 			nm_assert (*out_refresh_all_in_progess > 0);
 			*out_refresh_all_in_progess -= 1;
@@ -4289,12 +5349,73 @@ do_request_all_no_delayed_actions (NMPlatform *platform, DelayedActionType actio
 }
 
 static void
-do_request_one_type (NMPlatform *platform, NMPObjectType obj_type)
+do_request_partial_no_delayed_actions (NMPlatform *platform, const DelayedActionRefreshPartialData *data)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+	DelayedActionRefreshPartialData *pruning;
+	NMPLookup lookup;
+	int nle;
+
+	event_handler_read_netlink (platform, FALSE);
+
+	/* With NETLINK_GET_STRICT_CHK, kernel only returns the objects that
+	 * match @data. Otherwise it returns all objects of the type. Either way,
+	 * we only look at those that match @data, and only those get pruned
+	 * afterwards. */
+	nlmsg = _nl_msg_new_dump (nmp_class_from_type (data->obj_type),
+	                          priv->nlh_strict_chk,
+	                          data->ifindex,
+	                          data->table);
+	if (!nlmsg)
+		return;
+
+	nle = _nl_send_nlmsg (platform, nlmsg, NULL, DELAYED_ACTION_RESPONSE_TYPE_VOID, NULL);
+	if (nle < 0) {
+		_LOGE ("do-request-partial: failed sending netlink request \"%s\" (%d)",
+		       nl_geterror (nle), -nle);
+		return;
+	}
+
+	/* we didn't read from the socket yet, so it's fine to mark the objects
+	 * dirty only after sending the request. */
+	nmp_cache_dirty_set_lookup (nm_platform_get_cache (platform),
+	                            delayed_action_refresh_partial_lookup_init (&lookup, data));
+
+	g_array_append_vals (priv->pruning_partial, data, 1);
+	pruning = &g_array_index (priv->pruning_partial, DelayedActionRefreshPartialData, priv->pruning_partial->len - 1);
+	pruning->seq_number = nlmsg_hdr (nlmsg)->nlmsg_seq;
+}
+
+static void
+do_request_partial (NMPlatform *platform, NMPObjectType obj_type, int ifindex)
+{
+	delayed_action_schedule_REFRESH_PARTIAL (platform, obj_type, ifindex, RT_TABLE_UNSPEC);
+	delayed_action_handle_all (platform, FALSE);
+}
+
+void
+_nmtst_linux_platform_refresh_partial (NMPlatform *platform,
+                                       NMPObjectType obj_type,
+                                       int ifindex,
+                                       guint32 table)
 {
-	do_request_all_no_delayed_actions (platform, delayed_action_refresh_from_object_type (obj_type));
+	g_return_if_fail (NM_IS_LINUX_PLATFORM (platform));
+
+	delayed_action_schedule_REFRESH_PARTIAL (platform, obj_type, ifindex, table);
 	delayed_action_handle_all (platform, FALSE);
 }
 
+void
+_nmtst_linux_platform_interrupt_next_dump (NMPlatform *platform)
+{
+	g_return_if_fail (NM_IS_LINUX_PLATFORM (platform));
+
+	/* pretend that kernel sets NLM_F_DUMP_INTR on the next reply to one
+	 * of our dump requests. */
+	NM_LINUX_PLATFORM_GET_PRIVATE (platform)->nmtst_interrupt_next_dump = TRUE;
+}
+
 static void
 event_seq_check_refresh_all (NMPlatform *platform, guint32 seq_number)
 {
@@ -4329,6 +5450,7 @@ event_seq_check (NMPlatform *platform, guint32 seq_number, WaitForNlResponseResu
 {
 	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
 	DelayedActionWaitForNlResponseData *data;
+	AsyncChangeLinkData *async_data;
 	guint i;
 
 	if (seq_number == 0)
@@ -4354,6 +5476,17 @@ event_seq_check (NMPlatform *platform, guint32 seq_number, WaitForNlResponseResu
 		}
 	}
 
+	c_list_for_each_entry (async_data, &priv->async.pending_lst_head, async_lst) {
+		if (async_data->seq_number == seq_number) {
+			if (async_data->seq_result < 0) {
+				/* preserve the error. */
+			} else if (   seq_result != WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_UNKNOWN
+			           || async_data->seq_result == WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN)
+				async_data->seq_result = seq_result;
+			return;
+		}
+	}
+
 #ifdef NM_MORE_LOGGING
 	if (seq_number != priv->nlh_seq_last_handled)
 		_LOGt ("netlink: recvmsg: unwaited sequence number %u", seq_number);
@@ -4361,26 +5494,82 @@ event_seq_check (NMPlatform *platform, guint32 seq_number, WaitForNlResponseResu
 #endif
 }
 
+/* RTM_NEWSTATS is the response to link_get_all_stats(). Kernel only
+ * sends it on request, there are no notifications. */
 static void
-event_valid_msg (NMPlatform *platform, struct nl_msg *msg, gboolean handle_events)
+event_link_stats_msg (NMPlatform *platform, struct nlmsghdr *msghdr)
 {
-	NMLinuxPlatformPrivate *priv;
-	nm_auto_nmpobj NMPObject *obj = NULL;
-	NMPCacheOpsType cache_op;
-	struct nlmsghdr *msghdr;
-	char buf_nlmsghdr[400];
-	gboolean id_only = FALSE;
-	NMPCache *cache = nm_platform_get_cache (platform);
-	gboolean is_dump;
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	const struct if_stats_msg *ifsm;
+	const struct nlattr *nla;
+	struct rtnl_link_stats64 st;
+	NMPlatformLinkStats *s;
+	GArray *out_stats = NULL;
+	guint i;
 
-	msghdr = nlmsg_hdr (msg);
+	if (!NM_FLAGS_HAS (priv->delayed_action.flags, DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE))
+		return;
 
-	if (   _support_kernel_extended_ifa_flags_still_undecided ()
-	    && msghdr->nlmsg_type == RTM_NEWADDR)
-		_support_kernel_extended_ifa_flags_detect (msg);
+	for (i = 0; i < priv->delayed_action.list_wait_for_nl_response->len; i++) {
+		const DelayedActionWaitForNlResponseData *data = &g_array_index (priv->delayed_action.list_wait_for_nl_response, DelayedActionWaitForNlResponseData, i);
 
-	if (!handle_events)
+		if (   data->response_type == DELAYED_ACTION_RESPONSE_TYPE_LINK_STATS
+		    && data->seq_number == msghdr->nlmsg_seq) {
+			out_stats = data->response.out_link_stats;
+			break;
+		}
+	}
+	if (!out_stats)
+		return;
+
+	if (!nlmsg_valid_hdr (msghdr, sizeof (*ifsm)))
+		return;
+	ifsm = nlmsg_data (msghdr);
+
+	nla = nlmsg_find_attr (msghdr, sizeof (*ifsm), IFLA_STATS_LINK_64);
+	if (   !nla
+	    || nla_len (nla) < (int) sizeof (st))
+		return;
+	memcpy (&st, nla_data (nla), sizeof (st));
+
+	g_array_set_size (out_stats, out_stats->len + 1);
+	s = &g_array_index (out_stats, NMPlatformLinkStats, out_stats->len - 1);
+	s->ifindex = ifsm->ifindex;
+	s->rx_packets = st.rx_packets;
+	s->rx_bytes = st.rx_bytes;
+	s->tx_packets = st.tx_packets;
+	s->tx_bytes = st.tx_bytes;
+}
+
+static void
+event_valid_msg (NMPlatform *platform,
+                 struct nlmsghdr *msghdr,
+                 NMPObject *obj_parsed,
+                 gboolean filtered_replace,
+                 gboolean handle_events)
+{
+	NMLinuxPlatformPrivate *priv;
+	nm_auto_nmpobj NMPObject *obj = obj_parsed;
+	NMPCacheOpsType cache_op;
+	char buf_nlmsghdr[400];
+	gboolean id_only = FALSE;
+	NMPCache *cache = nm_platform_get_cache (platform);
+	gboolean is_dump;
+	gboolean is_dump_partial = FALSE;
+
+	if (!obj_parsed) {
+		if (   _support_kernel_extended_ifa_flags_still_undecided ()
+		    && msghdr->nlmsg_type == RTM_NEWADDR)
+			_support_kernel_extended_ifa_flags_detect (msghdr);
+	}
+
+	if (!handle_events)
+		return;
+
+	if (msghdr->nlmsg_type == RTM_NEWSTATS) {
+		event_link_stats_msg (platform, msghdr);
 		return;
+	}
 
 	if (NM_IN_SET (msghdr->nlmsg_type, RTM_DELLINK, RTM_DELADDR, RTM_DELROUTE)) {
 		/* The event notifies about a deleted object. We don't need to initialize all
@@ -4388,21 +5577,55 @@ event_valid_msg (NMPlatform *platform, struct nl_msg *msg, gboolean handle_event
 		id_only = TRUE;
 	}
 
-	obj = nmp_object_new_from_nl (platform, cache, msg, id_only);
+	/* if @obj_parsed is given, the reader thread already parsed the message
+	 * and @msghdr is only the header. */
+	if (!obj) {
+		obj = _nmp_object_new_from_nl (platform, cache, msghdr, id_only,
+		                               _route_filter_get (platform),
+		                               &filtered_replace);
+	}
 	if (!obj) {
 		_LOGT ("event-notification: %s: ignore",
 		       _nl_nlmsghdr_to_str (msghdr, buf_nlmsghdr, sizeof (buf_nlmsghdr)));
 		return;
 	}
 
+	if (filtered_replace) {
+		_LOGT ("event-notification: %s: ignore (route-filter), but remove the replaced route",
+		       _nl_nlmsghdr_to_str (msghdr, buf_nlmsghdr, sizeof (buf_nlmsghdr)));
+		cache_remove_replaced_route (platform, obj);
+		return;
+	}
+
+	priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	if (   priv->pruning_partial->len > 0
+	    && msghdr->nlmsg_seq != 0) {
+		guint i;
+
+		for (i = 0; i < priv->pruning_partial->len; i++) {
+			const DelayedActionRefreshPartialData *partial = &g_array_index (priv->pruning_partial, DelayedActionRefreshPartialData, i);
+
+			if (partial->seq_number != msghdr->nlmsg_seq)
+				continue;
+			if (!delayed_action_refresh_partial_match (partial, obj)) {
+				_LOGt ("event-notification: %s: ignore (not part of partial dump)",
+				       _nl_nlmsghdr_to_str (msghdr, buf_nlmsghdr, sizeof (buf_nlmsghdr)));
+				return;
+			}
+			is_dump_partial = TRUE;
+			break;
+		}
+	}
+
 	switch (msghdr->nlmsg_type) {
 	case RTM_NEWADDR:
 	case RTM_NEWLINK:
 	case RTM_NEWROUTE:
 	case RTM_NEWQDISC:
 	case RTM_NEWTFILTER:
-		is_dump = delayed_action_refresh_all_in_progress (platform,
-		                                                  delayed_action_refresh_from_object_type (NMP_OBJECT_GET_TYPE (obj)));
+		is_dump =    is_dump_partial
+		          || delayed_action_refresh_all_in_progress (platform,
+		                                                     delayed_action_refresh_from_object_type (NMP_OBJECT_GET_TYPE (obj)));
 		break;
 	default:
 		is_dump = FALSE;
@@ -4444,7 +5667,6 @@ event_valid_msg (NMPlatform *platform, struct nl_msg *msg, gboolean handle_event
 			is_ipv6 = NMP_OBJECT_GET_TYPE (obj) == NMP_OBJECT_TYPE_IP6_ROUTE;
 			if (is_ipv6 || NM_FLAGS_HAS (obj->ip_route.r_rtm_flags, RTM_F_CLONED)) {
 				nm_assert (is_ipv6 || !nmp_object_is_alive (obj));
-				priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
 				if (NM_FLAGS_HAS (priv->delayed_action.flags, DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE)) {
 					guint i;
 
@@ -4455,7 +5677,7 @@ event_valid_msg (NMPlatform *platform, struct nl_msg *msg, gboolean handle_event
 						if (   data->response_type == DELAYED_ACTION_RESPONSE_TYPE_ROUTE_GET
 						    && data->response.out_route_get) {
 							nm_assert (!*data->response.out_route_get);
-							if (data->seq_number == nlmsg_hdr (msg)->nlmsg_seq) {
+							if (data->seq_number == msghdr->nlmsg_seq) {
 								*data->response.out_route_get = nmp_object_clone (obj, FALSE);
 								data->response.out_route_get = NULL;
 								break;
@@ -4510,11 +5732,15 @@ event_valid_msg (NMPlatform *platform, struct nl_msg *msg, gboolean handle_event
 
 			if (resync_required) {
 				/* we'd like to avoid such resyncs as they are expensive and we should only rely on the
-				 * netlink events. This needs investigation. */
+				 * netlink events. This needs investigation.
+				 *
+				 * The replaced route has the same weak-id, hence it is in the same table.
+				 * Only resync that table. */
 				_LOGT ("schedule resync of routes after RTM_NEWROUTE");
-				delayed_action_schedule (platform,
-				                         delayed_action_refresh_from_object_type (NMP_OBJECT_GET_TYPE (obj)),
-				                         NULL);
+				delayed_action_schedule_REFRESH_PARTIAL (platform,
+				                                         NMP_OBJECT_GET_TYPE (obj),
+				                                         0,
+				                                         nm_platform_route_table_uncoerce (obj->ip_route.table_coerced, TRUE));
 			}
 			break;
 		}
@@ -4631,12 +5857,38 @@ do_add_addrroute (NMPlatform *platform,
 		 *
 		 * rh#1484434 */
 		if (!nmp_cache_lookup_obj (nm_platform_get_cache (platform), obj_id))
-			do_request_one_type (platform, NMP_OBJECT_GET_TYPE (obj_id));
+			do_request_partial (platform, NMP_OBJECT_GET_TYPE (obj_id), obj_id->object.ifindex);
 	}
 
 	return wait_for_nl_response_to_plerr (seq_result);
 }
 
+static gboolean
+_delete_object_check_result (const NMPObject *obj_id,
+                             WaitForNlResponseResult seq_result,
+                             const char **out_log_detail)
+{
+	const char *log_detail = "";
+	gboolean success = TRUE;
+
+	if (seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK) {
+		/* ok */
+	} else if (NM_IN_SET (-((int) seq_result), ESRCH, ENOENT))
+		log_detail = ", meaning the object was already removed";
+	else if (   NM_IN_SET (-((int) seq_result), ENXIO)
+	         && NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_id), NMP_OBJECT_TYPE_IP6_ADDRESS)) {
+		/* On RHEL7 kernel, deleting a non existing address fails with ENXIO */
+		log_detail = ", meaning the address was already removed";
+	} else if (   NM_IN_SET (-((int) seq_result), EADDRNOTAVAIL)
+	           && NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_id), NMP_OBJECT_TYPE_IP4_ADDRESS, NMP_OBJECT_TYPE_IP6_ADDRESS))
+		log_detail = ", meaning the address was already removed";
+	else
+		success = FALSE;
+
+	*out_log_detail = log_detail;
+	return success;
+}
+
 static gboolean
 do_delete_object (NMPlatform *platform, const NMPObject *obj_id, struct nl_msg *nlmsg)
 {
@@ -4644,7 +5896,7 @@ do_delete_object (NMPlatform *platform, const NMPObject *obj_id, struct nl_msg *
 	int nle;
 	char s_buf[256];
 	gboolean success;
-	const char *log_detail = "";
+	const char *log_detail;
 
 	event_handler_read_netlink (platform, FALSE);
 
@@ -4661,20 +5913,7 @@ do_delete_object (NMPlatform *platform, const NMPObject *obj_id, struct nl_msg *
 
 	nm_assert (seq_result);
 
-	success = TRUE;
-	if (seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK) {
-		/* ok */
-	} else if (NM_IN_SET (-((int) seq_result), ESRCH, ENOENT))
-		log_detail = ", meaning the object was already removed";
-	else if (   NM_IN_SET (-((int) seq_result), ENXIO)
-	         && NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_id), NMP_OBJECT_TYPE_IP6_ADDRESS)) {
-		/* On RHEL7 kernel, deleting a non existing address fails with ENXIO */
-		log_detail = ", meaning the address was already removed";
-	} else if (   NM_IN_SET (-((int) seq_result), EADDRNOTAVAIL)
-	           && NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_id), NMP_OBJECT_TYPE_IP4_ADDRESS, NMP_OBJECT_TYPE_IP6_ADDRESS))
-		log_detail = ", meaning the address was already removed";
-	else
-		success = FALSE;
+	success = _delete_object_check_result (obj_id, seq_result, &log_detail);
 
 	_NMLOG (success ? LOGL_DEBUG : LOGL_WARN,
 	        "do-delete-%s[%s]: %s%s",
@@ -4695,12 +5934,54 @@ do_delete_object (NMPlatform *platform, const NMPObject *obj_id, struct nl_msg *
 		 *
 		 * rh#1484434 */
 		if (nmp_cache_lookup_obj (nm_platform_get_cache (platform), obj_id))
-			do_request_one_type (platform, NMP_OBJECT_GET_TYPE (obj_id));
+			do_request_partial (platform, NMP_OBJECT_GET_TYPE (obj_id), obj_id->object.ifindex);
 	}
 
 	return success;
 }
 
+static NMPlatformError
+do_change_link_result (NMPlatform *platform,
+                       ChangeLinkType change_link_type,
+                       int ifindex,
+                       WaitForNlResponseResult seq_result,
+                       const ChangeLinkData *data,
+                       NMLogLevel *log_level,
+                       const char **log_result,
+                       const char **log_detail)
+{
+	const NMPObject *obj_cache;
+
+	if (seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK) {
+		*log_result = "success";
+	} else if (NM_IN_SET (-((int) seq_result), EEXIST, EADDRINUSE)) {
+		/* */
+	} else if (NM_IN_SET (-((int) seq_result), ESRCH, ENOENT)) {
+		*log_detail = ", firmware not found";
+		return NM_PLATFORM_ERROR_NO_FIRMWARE;
+	} else if (   NM_IN_SET (-((int) seq_result), ERANGE)
+	           && change_link_type == CHANGE_LINK_TYPE_SET_MTU) {
+		*log_detail = ", setting MTU to requested size is not possible";
+		return NM_PLATFORM_ERROR_CANT_SET_MTU;
+	} else if (   NM_IN_SET (-((int) seq_result), ENFILE)
+	           && change_link_type == CHANGE_LINK_TYPE_SET_ADDRESS
+	           && (obj_cache = nmp_cache_lookup_link (nm_platform_get_cache (platform), ifindex))
+	           && obj_cache->link.addr.len == data->set_address.length
+	           && memcmp (obj_cache->link.addr.data, data->set_address.address, data->set_address.length) == 0) {
+		/* workaround ENFILE which may be wrongly returned (bgo #770456).
+		 * If the MAC address is as expected, assume success? */
+		*log_result = "success";
+		*log_detail = " (assume success changing address)";
+	} else if (NM_IN_SET (-((int) seq_result), ENODEV)) {
+		*log_level = LOGL_DEBUG;
+		return NM_PLATFORM_ERROR_NOT_FOUND;
+	} else {
+		*log_level = LOGL_WARN;
+		return NM_PLATFORM_ERROR_UNSPECIFIED;
+	}
+	return NM_PLATFORM_ERROR_SUCCESS;
+}
+
 static NMPlatformError
 do_change_link (NMPlatform *platform,
                 ChangeLinkType change_link_type,
@@ -4717,7 +5998,6 @@ do_change_link (NMPlatform *platform,
 	const char *log_result = "failure";
 	const char *log_detail = "";
 	gs_free char *log_detail_free = NULL;
-	const NMPObject *obj_cache;
 
 	if (!nm_platform_netns_push (platform, &netns)) {
 		log_level = LOGL_ERR;
@@ -4749,34 +6029,8 @@ retry:
 		goto retry;
 	}
 
-	if (seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK) {
-		log_result = "success";
-	} else if (NM_IN_SET (-((int) seq_result), EEXIST, EADDRINUSE)) {
-		/* */
-	} else if (NM_IN_SET (-((int) seq_result), ESRCH, ENOENT)) {
-		log_detail = ", firmware not found";
-		result = NM_PLATFORM_ERROR_NO_FIRMWARE;
-	} else if (   NM_IN_SET (-((int) seq_result), ERANGE)
-	           && change_link_type == CHANGE_LINK_TYPE_SET_MTU) {
-		log_detail = ", setting MTU to requested size is not possible";
-		result = NM_PLATFORM_ERROR_CANT_SET_MTU;
-	} else if (   NM_IN_SET (-((int) seq_result), ENFILE)
-	           && change_link_type == CHANGE_LINK_TYPE_SET_ADDRESS
-	           && (obj_cache = nmp_cache_lookup_link (nm_platform_get_cache (platform), ifindex))
-	           && obj_cache->link.addr.len == data->set_address.length
-	           && memcmp (obj_cache->link.addr.data, data->set_address.address, data->set_address.length) == 0) {
-		/* workaround ENFILE which may be wrongly returned (bgo #770456).
-		 * If the MAC address is as expected, assume success? */
-		log_result = "success";
-		log_detail = " (assume success changing address)";
-		result = NM_PLATFORM_ERROR_SUCCESS;
-	} else if (NM_IN_SET (-((int) seq_result), ENODEV)) {
-		log_level = LOGL_DEBUG;
-		result = NM_PLATFORM_ERROR_NOT_FOUND;
-	} else {
-		log_level = LOGL_WARN;
-		result = NM_PLATFORM_ERROR_UNSPECIFIED;
-	}
+	result = do_change_link_result (platform, change_link_type, ifindex, seq_result, data,
+	                                &log_level, &log_result, &log_detail);
 
 out:
 	_NMLOG (log_level,
@@ -4788,6 +6042,256 @@ out:
 	return result;
 }
 
+/*****************************************************************************/
+
+/* how long we wait for the ACK of an asynchronous request. Kernel handles
+ * the request during sendmsg(), so the ACK is usually already queued. */
+#define ASYNC_CHANGE_LINK_TIMEOUT_MSEC 1000
+
+static gboolean link_change_async_timeout_cb (gpointer user_data);
+static gboolean link_change_async_idle_cb (gpointer user_data);
+
+static void
+link_change_async_data_free (AsyncChangeLinkData *data)
+{
+	c_list_unlink (&data->async_lst);
+	nlmsg_free (data->nlmsg);
+	if (data->change_link_type == CHANGE_LINK_TYPE_SET_ADDRESS)
+		g_free ((gpointer) data->change_link_data.set_address.address);
+	g_slice_free (AsyncChangeLinkData, data);
+}
+
+static int
+link_change_async_send (NMPlatform *platform, AsyncChangeLinkData *data)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	nm_auto_pop_netns NMPNetns *netns = NULL;
+	int nle;
+
+	if (!nm_platform_netns_push (platform, &netns))
+		return -NLE_FAILURE;
+
+	data->seq_number = _nlh_seq_next_get (priv);
+	data->seq_result = WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN;
+	data->timeout_abs_ns = nm_utils_get_monotonic_timestamp_ns () + (ASYNC_CHANGE_LINK_TIMEOUT_MSEC * (NM_UTILS_NS_PER_SECOND / 1000));
+	nlmsg_hdr (data->nlmsg)->nlmsg_seq = data->seq_number;
+
+	nle = nl_send_auto (priv->nlh, data->nlmsg);
+	if (nle < 0) {
+		_LOGD ("netlink: nl-send-nlmsg: failed sending message: %s (%d)", nl_geterror (nle), nle);
+		return nle;
+	}
+	return 0;
+}
+
+static void
+link_change_async_complete (NMPlatform *platform,
+                            AsyncChangeLinkData *data,
+                            WaitForNlResponseResult seq_result,
+                            const char *log_failure)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	NMLogLevel log_level = LOGL_DEBUG;
+	const char *log_result = "failure";
+	const char *log_detail = "";
+	char s_buf[256];
+
+	if (log_failure) {
+		log_level = LOGL_ERR;
+		log_detail = log_failure;
+		data->result = NM_PLATFORM_ERROR_UNSPECIFIED;
+	} else {
+		data->result = do_change_link_result (platform, data->change_link_type, data->ifindex,
+		                                      seq_result, &data->change_link_data,
+		                                      &log_level, &log_result, &log_detail);
+	}
+
+	_NMLOG (log_level,
+	        "do-change-link[%d]: %s changing link (async, seq %u): %s%s",
+	        data->ifindex,
+	        log_result,
+	        data->seq_number,
+	        wait_for_nl_response_to_string (seq_result, s_buf, sizeof (s_buf)),
+	        log_detail);
+
+	/* like do_change_link(), always refetch the link. The refresh happens
+	 * before we invoke the callback, so that it sees the new state. */
+	delayed_action_schedule (platform, DELAYED_ACTION_TYPE_REFRESH_LINK, GINT_TO_POINTER (data->ifindex));
+
+	c_list_unlink (&data->async_lst);
+	c_list_link_tail (&priv->async.done_lst_head, &data->async_lst);
+	if (!priv->async.idle_id)
+		priv->async.idle_id = g_idle_add (link_change_async_idle_cb, platform);
+}
+
+static void
+link_change_async_complete_all (NMPlatform *platform, WaitForNlResponseResult fallback_result)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	AsyncChangeLinkData *data, *data_safe;
+
+	c_list_for_each_entry_safe (data, data_safe, &priv->async.pending_lst_head, async_lst)
+		link_change_async_complete (platform, data, data->seq_result ?: fallback_result, NULL);
+	nm_clear_g_source (&priv->async.timeout_id);
+}
+
+/* called after reading from the netlink socket. Completes the requests
+ * that got their response, and those that timed out. */
+static void
+link_change_async_check (NMPlatform *platform)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	AsyncChangeLinkData *data, *data_safe;
+	gint64 now_ns = 0;
+	gint64 timeout_next_ns = 0;
+	int nle;
+
+	c_list_for_each_entry_safe (data, data_safe, &priv->async.pending_lst_head, async_lst) {
+		if (!data->seq_result) {
+			if ((now_ns ?: (now_ns = nm_utils_get_monotonic_timestamp_ns ())) > data->timeout_abs_ns)
+				link_change_async_complete (platform, data, WAIT_FOR_NL_RESPONSE_RESULT_FAILED_TIMEOUT, NULL);
+			else if (   !timeout_next_ns
+			         || timeout_next_ns > data->timeout_abs_ns)
+				timeout_next_ns = data->timeout_abs_ns;
+			continue;
+		}
+
+		if (   NM_IN_SET (-((int) data->seq_result), EOPNOTSUPP)
+		    && nlmsg_hdr (data->nlmsg)->nlmsg_type == RTM_NEWLINK) {
+			nlmsg_hdr (data->nlmsg)->nlmsg_type = RTM_SETLINK;
+			nle = link_change_async_send (platform, data);
+			if (nle < 0) {
+				link_change_async_complete (platform, data, WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN,
+				                            ", failure sending netlink request");
+			} else if (   !timeout_next_ns
+			           || timeout_next_ns > data->timeout_abs_ns)
+				timeout_next_ns = data->timeout_abs_ns;
+			continue;
+		}
+
+		link_change_async_complete (platform, data, data->seq_result, NULL);
+	}
+
+	nm_clear_g_source (&priv->async.timeout_id);
+	if (timeout_next_ns) {
+		now_ns = nm_utils_get_monotonic_timestamp_ns ();
+		priv->async.timeout_id = g_timeout_add (NM_MAX (1, (timeout_next_ns - now_ns) / (NM_UTILS_NS_PER_SECOND / 1000)),
+		                                        link_change_async_timeout_cb,
+		                                        platform);
+	}
+}
+
+static void
+link_change_async_dispatch (NMPlatform *platform, gboolean refresh)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	AsyncChangeLinkData *data;
+
+	nm_clear_g_source (&priv->async.idle_id);
+
+	if (c_list_is_empty (&priv->async.done_lst_head))
+		return;
+
+	if (refresh)
+		delayed_action_handle_all (platform, FALSE);
+
+	/* the callbacks might start new requests. They go to the pending list,
+	 * so this terminates. */
+	while (!c_list_is_empty (&priv->async.done_lst_head)) {
+		data = c_list_first_entry (&priv->async.done_lst_head, AsyncChangeLinkData, async_lst);
+		c_list_unlink (&data->async_lst);
+		data->callback (platform, data->result, data->user_data);
+		link_change_async_data_free (data);
+	}
+}
+
+static gboolean
+link_change_async_idle_cb (gpointer user_data)
+{
+	NMPlatform *platform = user_data;
+
+	NM_LINUX_PLATFORM_GET_PRIVATE (platform)->async.idle_id = 0;
+	link_change_async_dispatch (platform, TRUE);
+	return G_SOURCE_REMOVE;
+}
+
+static gboolean
+link_change_async_timeout_cb (gpointer user_data)
+{
+	NMPlatform *platform = user_data;
+
+	NM_LINUX_PLATFORM_GET_PRIVATE (platform)->async.timeout_id = 0;
+
+	/* reading from the socket completes the requests that timed out. */
+	delayed_action_handle_all (platform, TRUE);
+	return G_SOURCE_REMOVE;
+}
+
+/**
+ * link_change_async:
+ * @platform: the platform instance
+ * @change_link_type: the kind of change
+ * @ifindex: the link
+ * @nlmsg: (transfer full) (allow-none): the request. %NULL means
+ *   that creating the request failed.
+ * @change_link_data: (allow-none): like for do_change_link(). It is copied.
+ * @callback: invoked with the result, once kernel acknowledged the request.
+ * @user_data: user data for @callback
+ *
+ * Like do_change_link(), but it does not wait for the response of kernel.
+ */
+static void
+link_change_async (NMPlatform *platform,
+                   ChangeLinkType change_link_type,
+                   int ifindex,
+                   struct nl_msg *nlmsg,
+                   const ChangeLinkData *change_link_data,
+                   NMPlatformAsyncCallback callback,
+                   gpointer user_data)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	AsyncChangeLinkData *data;
+	int nle;
+
+	nm_assert (change_link_type != CHANGE_LINK_TYPE_SET_ADDRESS || change_link_data);
+
+	data = g_slice_new0 (AsyncChangeLinkData);
+	data->change_link_type = change_link_type;
+	data->ifindex = ifindex;
+	if (change_link_data) {
+		data->change_link_data = *change_link_data;
+		if (change_link_type == CHANGE_LINK_TYPE_SET_ADDRESS) {
+			data->change_link_data.set_address.address = g_memdup (change_link_data->set_address.address,
+			                                                       change_link_data->set_address.length);
+		}
+	}
+	data->nlmsg = nlmsg;
+	data->callback = callback;
+	data->user_data = user_data;
+	c_list_link_tail (&priv->async.pending_lst_head, &data->async_lst);
+
+	if (!nlmsg) {
+		link_change_async_complete (platform, data, WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN,
+		                            ", failure creating netlink request");
+		return;
+	}
+
+	nle = link_change_async_send (platform, data);
+	if (nle < 0) {
+		link_change_async_complete (platform, data, WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN,
+		                            ", failure sending netlink request");
+		return;
+	}
+
+	if (!priv->async.timeout_id) {
+		priv->async.timeout_id = g_timeout_add (ASYNC_CHANGE_LINK_TIMEOUT_MSEC,
+		                                        link_change_async_timeout_cb,
+		                                        platform);
+	}
+}
+
+/*****************************************************************************/
+
 static gboolean
 link_add (NMPlatform *platform,
           const char *name,
@@ -4860,28 +6364,82 @@ link_refresh (NMPlatform *platform, int ifindex)
 	return !!nm_platform_link_get_obj (platform, ifindex, TRUE);
 }
 
+/* whether kernel supports RTM_GETSTATS. Zero means undecided. */
+static int _support_link_stats = 0;
+
 static gboolean
-link_set_netns (NMPlatform *platform,
-                int ifindex,
-                int netns_fd)
+link_get_all_stats (NMPlatform *platform, GArray *out_stats)
 {
 	nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+	WaitForNlResponseResult seq_result = WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN;
+	const struct if_stats_msg ifsm = {
+		.family = AF_UNSPEC,
+		.filter_mask = IFLA_STATS_FILTER_BIT (IFLA_STATS_LINK_64),
+	};
+	int nle;
 
-	_LOGD ("link: move link %d to network namespace with fd %d", ifindex, netns_fd);
+	if (_support_link_stats < 0)
+		goto fallback;
 
-	nlmsg = _nl_msg_new_link (RTM_NEWLINK,
-	                          0,
-	                          ifindex,
-	                          NULL,
-	                          0,
-	                          0);
+	/* RTM_GETSTATS only returns the counters that we ask for with
+	 * @filter_mask. That is much cheaper than a RTM_GETLINK dump. */
+	nlmsg = nlmsg_alloc_simple (RTM_GETSTATS, NLM_F_DUMP);
 	if (!nlmsg)
-		return FALSE;
+		goto fallback;
+	if (nlmsg_append (nlmsg, (gpointer) &ifsm, sizeof (ifsm), NLMSG_ALIGNTO) < 0)
+		goto fallback;
 
-	NLA_PUT (nlmsg, IFLA_NET_NS_FD, 4, &netns_fd);
-	return do_change_link (platform, CHANGE_LINK_TYPE_UNSPEC, ifindex, nlmsg, NULL) == NM_PLATFORM_ERROR_SUCCESS;
+	event_handler_read_netlink (platform, FALSE);
 
-nla_put_failure:
+	nle = _nl_send_nlmsg (platform, nlmsg, &seq_result, DELAYED_ACTION_RESPONSE_TYPE_LINK_STATS, out_stats);
+	if (nle < 0) {
+		_LOGD ("link-stats: failed sending netlink request \"%s\" (%d)",
+		       nl_geterror (nle), -nle);
+		goto fallback;
+	}
+
+	delayed_action_handle_all (platform, FALSE);
+
+	if (seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK) {
+		_support_link_stats = 1;
+		return TRUE;
+	}
+
+	if (   _support_link_stats == 0
+	    && NM_IN_SET (seq_result, -EOPNOTSUPP, -EINVAL)) {
+		_support_link_stats = -1;
+		_LOGD ("kernel-support: RTM_GETSTATS: not supported, refresh all links instead");
+	}
+
+fallback:
+	/* dump all links. The counters are then taken from the cache. */
+	delayed_action_schedule (platform, DELAYED_ACTION_TYPE_REFRESH_ALL_LINKS, NULL);
+	delayed_action_handle_all (platform, FALSE);
+	return FALSE;
+}
+
+static gboolean
+link_set_netns (NMPlatform *platform,
+                int ifindex,
+                int netns_fd)
+{
+	nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+
+	_LOGD ("link: move link %d to network namespace with fd %d", ifindex, netns_fd);
+
+	nlmsg = _nl_msg_new_link (RTM_NEWLINK,
+	                          0,
+	                          ifindex,
+	                          NULL,
+	                          0,
+	                          0);
+	if (!nlmsg)
+		return FALSE;
+
+	NLA_PUT (nlmsg, IFLA_NET_NS_FD, 4, &netns_fd);
+	return do_change_link (platform, CHANGE_LINK_TYPE_UNSPEC, ifindex, nlmsg, NULL) == NM_PLATFORM_ERROR_SUCCESS;
+
+nla_put_failure:
 	g_return_val_if_reached (FALSE);
 }
 
@@ -4923,6 +6481,28 @@ link_set_up (NMPlatform *platform, int ifindex, gboolean *out_no_firmware)
 	return plerr == NM_PLATFORM_ERROR_SUCCESS;
 }
 
+static void
+link_set_up_async (NMPlatform *platform,
+                   int ifindex,
+                   NMPlatformAsyncCallback callback,
+                   gpointer user_data)
+{
+	_LOGD ("link: change %d: flags: set up (async)", ifindex);
+
+	link_change_async (platform,
+	                   CHANGE_LINK_TYPE_UNSPEC,
+	                   ifindex,
+	                   _nl_msg_new_link (RTM_NEWLINK,
+	                                     0,
+	                                     ifindex,
+	                                     NULL,
+	                                     IFF_UP,
+	                                     IFF_UP),
+	                   NULL,
+	                   callback,
+	                   user_data);
+}
+
 static gboolean
 link_set_down (NMPlatform *platform, int ifindex)
 {
@@ -5029,6 +6609,176 @@ link_supports_vlans (NMPlatform *platform, int ifindex)
 	return nmp_utils_ethtool_supports_vlans (ifindex);
 }
 
+/*****************************************************************************/
+
+/* When NMManager realizes the devices at startup, it asks for the driver
+ * info, the permanent MAC address and SR-IOV support of every link. These
+ * are ethtool ioctls and sysfs reads, done one link after the other.
+ * link_facts_prefetch() gathers them for many links at once on short-lived
+ * worker threads. Until link_facts_clear(), the getters answer from the
+ * prefetched facts, as long as the link was not renamed meanwhile. */
+
+#define LINK_FACTS_MAX_THREADS 8
+
+typedef struct _LinkFacts {
+	int ifindex;
+	char ifname[IFNAMSIZ];
+	bool has_driver_info:1;
+	bool has_perm_addr:1;
+	bool supports_sriov:1;
+	guint8 perm_addr_len;
+	guint8 perm_addr[NM_UTILS_HWADDR_LEN_MAX];
+	NMPUtilsEthtoolDriverInfo driver_info;
+} LinkFacts;
+
+typedef struct {
+	LinkFacts *facts;
+	guint n_facts;
+	volatile gint next;
+} LinkFactsJob;
+
+static void
+_link_facts_gather (LinkFacts *facts)
+{
+	nm_auto_close int dirfd = -1;
+	nm_auto_close int fd = -1;
+	char ifname[IFNAMSIZ];
+	char buf[64];
+	size_t len;
+	ssize_t nn;
+
+	/* this runs on a worker thread. Only use the thread-safe nmp_utils_*()
+	 * helpers, not the platform instance. */
+
+	dirfd = nmp_utils_sysctl_open_netdir (facts->ifindex,
+	                                      facts->ifname[0] ? facts->ifname : NULL,
+	                                      ifname);
+	if (dirfd < 0) {
+		/* the link is gone. Leave it to the getters. */
+		facts->ifname[0] = '\0';
+		return;
+	}
+	memcpy (facts->ifname, ifname, sizeof (ifname));
+
+	facts->has_driver_info = nmp_utils_ethtool_get_driver_info (facts->ifindex, &facts->driver_info);
+
+	if (nmp_utils_ethtool_get_permanent_address (facts->ifindex, facts->perm_addr, &len)) {
+		facts->has_perm_addr = TRUE;
+		facts->perm_addr_len = len;
+	}
+
+	fd = openat (dirfd, "device/sriov_totalvfs", O_RDONLY | O_CLOEXEC);
+	if (fd >= 0) {
+		nn = nm_utils_fd_read_loop (fd, buf, sizeof (buf) - 1, FALSE);
+		if (nn > 0) {
+			buf[nn] = '\0';
+			facts->supports_sriov = _nm_utils_ascii_str_to_int64 (g_strstrip (buf), 10, 0, G_MAXINT32, -1) > 0;
+		}
+	}
+}
+
+static gpointer
+_link_facts_worker (gpointer user_data)
+{
+	LinkFactsJob *job = user_data;
+	guint i;
+
+	while ((i = (guint) g_atomic_int_add (&job->next, 1)) < job->n_facts)
+		_link_facts_gather (&job->facts[i]);
+	return NULL;
+}
+
+static void
+link_facts_clear (NMPlatform *platform)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+
+	g_clear_pointer (&priv->link_facts.idx, g_hash_table_destroy);
+	g_clear_pointer (&priv->link_facts.arr, g_free);
+}
+
+static void
+link_facts_prefetch (NMPlatform *platform, const int *ifindexes, guint n_ifindexes)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	nm_auto_pop_netns NMPNetns *netns = NULL;
+	GThread *threads[LINK_FACTS_MAX_THREADS] = { NULL };
+	LinkFactsJob job = { 0 };
+	gint64 ts = nm_utils_get_monotonic_timestamp_ns ();
+	long n_cpus;
+	guint i, n_threads;
+
+	link_facts_clear (platform);
+
+	if (n_ifindexes == 0)
+		return;
+
+	/* the worker threads inherit the network namespace of the thread
+	 * that creates them. */
+	if (!nm_platform_netns_push (platform, &netns))
+		return;
+
+	job.facts = g_new0 (LinkFacts, n_ifindexes);
+	job.n_facts = n_ifindexes;
+	for (i = 0; i < n_ifindexes; i++) {
+		const NMPlatformLink *pllink;
+
+		job.facts[i].ifindex = ifindexes[i];
+		pllink = nm_platform_link_get (platform, ifindexes[i]);
+		if (pllink)
+			g_strlcpy (job.facts[i].ifname, pllink->name, IFNAMSIZ);
+	}
+
+	/* use one thread per 8 links, up to the number of CPUs. The calling
+	 * thread takes part as well. */
+	n_cpus = sysconf (_SC_NPROCESSORS_ONLN);
+	n_threads = NM_MIN ((n_ifindexes + 7) / 8, LINK_FACTS_MAX_THREADS);
+	n_threads = NM_MAX (NM_MIN (n_threads, (guint) NM_MAX (n_cpus, 1)), 1);
+
+	for (i = 1; i < n_threads; i++)
+		threads[i] = g_thread_try_new ("nm-link-facts", _link_facts_worker, &job, NULL);
+	_link_facts_worker (&job);
+	for (i = 1; i < n_threads; i++) {
+		if (threads[i])
+			g_thread_join (threads[i]);
+	}
+
+	priv->link_facts.arr = job.facts;
+	priv->link_facts.idx = g_hash_table_new (g_direct_hash, g_direct_equal);
+	for (i = 0; i < n_ifindexes; i++) {
+		if (job.facts[i].ifname[0])
+			g_hash_table_insert (priv->link_facts.idx, GINT_TO_POINTER (job.facts[i].ifindex), &job.facts[i]);
+	}
+
+	_LOGD ("link: prefetched facts for %u links on %u threads in %"G_GINT64_FORMAT" usec",
+	       n_ifindexes, n_threads,
+	       (nm_utils_get_monotonic_timestamp_ns () - ts) / 1000);
+}
+
+static const LinkFacts *
+_link_facts_get (NMPlatform *platform, int ifindex)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	const LinkFacts *facts;
+	const NMPlatformLink *pllink;
+
+	if (!priv->link_facts.idx)
+		return NULL;
+
+	facts = g_hash_table_lookup (priv->link_facts.idx, GINT_TO_POINTER (ifindex));
+	if (!facts)
+		return NULL;
+
+	/* ethtool refers to the link by name. If it was renamed meanwhile,
+	 * don't trust the prefetched facts. */
+	pllink = nm_platform_link_get (platform, ifindex);
+	if (!pllink || !nm_streq (pllink->name, facts->ifname))
+		return NULL;
+	return facts;
+}
+
+/*****************************************************************************/
+
 static gboolean
 link_supports_sriov (NMPlatform *platform, int ifindex)
 {
@@ -5036,6 +6786,11 @@ link_supports_sriov (NMPlatform *platform, int ifindex)
 	nm_auto_close int dirfd = -1;
 	char ifname[IFNAMSIZ];
 	int total = -1;
+	const LinkFacts *facts;
+
+	facts = _link_facts_get (platform, ifindex);
+	if (facts)
+		return facts->supports_sriov;
 
 	if (!nm_platform_netns_push (platform, &netns))
 		return FALSE;
@@ -5118,6 +6873,16 @@ link_get_permanent_address (NMPlatform *platform,
                             size_t *length)
 {
 	nm_auto_pop_netns NMPNetns *netns = NULL;
+	const LinkFacts *facts;
+
+	facts = _link_facts_get (platform, ifindex);
+	if (facts) {
+		if (!facts->has_perm_addr)
+			return FALSE;
+		memcpy (buf, facts->perm_addr, facts->perm_addr_len);
+		*length = facts->perm_addr_len;
+		return TRUE;
+	}
 
 	if (!nm_platform_netns_push (platform, &netns))
 		return FALSE;
@@ -5148,6 +6913,35 @@ nla_put_failure:
 	g_return_val_if_reached (FALSE);
 }
 
+static void
+link_set_mtu_async (NMPlatform *platform,
+                    int ifindex,
+                    guint32 mtu,
+                    NMPlatformAsyncCallback callback,
+                    gpointer user_data)
+{
+	struct nl_msg *nlmsg;
+
+	_LOGD ("link: change %d: mtu: %u (async)", ifindex, (unsigned) mtu);
+
+	nlmsg = _nl_msg_new_link (RTM_NEWLINK,
+	                          0,
+	                          ifindex,
+	                          NULL,
+	                          0,
+	                          0);
+	if (!nlmsg)
+		goto nla_put_failure;
+
+	NLA_PUT_U32 (nlmsg, IFLA_MTU, mtu);
+
+	link_change_async (platform, CHANGE_LINK_TYPE_SET_MTU, ifindex, nlmsg, NULL, callback, user_data);
+	return;
+nla_put_failure:
+	nlmsg_free (nlmsg);
+	link_change_async (platform, CHANGE_LINK_TYPE_SET_MTU, ifindex, NULL, NULL, callback, user_data);
+}
+
 static gboolean
 link_set_sriov_num_vfs (NMPlatform *platform, int ifindex, guint num_vfs)
 {
@@ -6217,12 +8011,20 @@ link_get_driver_info (NMPlatform *platform,
 {
 	nm_auto_pop_netns NMPNetns *netns = NULL;
 	NMPUtilsEthtoolDriverInfo driver_info;
+	const LinkFacts *facts;
 
-	if (!nm_platform_netns_push (platform, &netns))
-		return FALSE;
+	facts = _link_facts_get (platform, ifindex);
+	if (facts) {
+		if (!facts->has_driver_info)
+			return FALSE;
+		driver_info = facts->driver_info;
+	} else {
+		if (!nm_platform_netns_push (platform, &netns))
+			return FALSE;
 
-	if (!nmp_utils_ethtool_get_driver_info (ifindex, &driver_info))
-		return FALSE;
+		if (!nmp_utils_ethtool_get_driver_info (ifindex, &driver_info))
+			return FALSE;
+	}
 	NM_SET_OUT (out_driver_name,    g_strdup (driver_info.driver));
 	NM_SET_OUT (out_driver_version, g_strdup (driver_info.version));
 	NM_SET_OUT (out_fw_version,     g_strdup (driver_info.fw_version));
@@ -6407,6 +8209,225 @@ object_delete (NMPlatform *platform,
 
 /*****************************************************************************/
 
+/* Limit the number of requests that we send at once. Each request causes
+ * an ACK and a notification, which must fit into the socket receive buffer.
+ * Also, the send buffer limits how large a single sendmsg() can be. */
+#define TRANSACTION_BATCH_MAX_MSGS    128
+#define TRANSACTION_BATCH_MAX_BYTES   (16 * 1024)
+
+static struct nl_msg *
+_nl_msg_new_transaction_op (const NMPlatformTransactionOp *op)
+{
+	const gboolean is_add = (op->op_type == NMP_TRANSACTION_OP_TYPE_ADD);
+	const NMPObject *obj = op->obj;
+
+	switch (NMP_OBJECT_GET_TYPE (obj)) {
+	case NMP_OBJECT_TYPE_IP4_ADDRESS: {
+		const NMPlatformIP4Address *a = NMP_OBJECT_CAST_IP4_ADDRESS (obj);
+
+		if (!is_add) {
+			return _nl_msg_new_address (RTM_DELADDR,
+			                            0,
+			                            AF_INET,
+			                            a->ifindex,
+			                            &a->address,
+			                            a->plen,
+			                            &a->peer_address,
+			                            0,
+			                            RT_SCOPE_NOWHERE,
+			                            NM_PLATFORM_LIFETIME_PERMANENT,
+			                            NM_PLATFORM_LIFETIME_PERMANENT,
+			                            NULL);
+		}
+		return _nl_msg_new_address (RTM_NEWADDR,
+		                            NLM_F_CREATE | NLM_F_REPLACE,
+		                            AF_INET,
+		                            a->ifindex,
+		                            &a->address,
+		                            a->plen,
+		                            &a->peer_address,
+		                            op->ifa_flags,
+		                            nm_utils_ip4_address_is_link_local (a->address) ? RT_SCOPE_LINK : RT_SCOPE_UNIVERSE,
+		                            op->lifetime,
+		                            op->preferred,
+		                            a->label);
+	}
+	case NMP_OBJECT_TYPE_IP6_ADDRESS: {
+		const NMPlatformIP6Address *a = NMP_OBJECT_CAST_IP6_ADDRESS (obj);
+
+		if (!is_add) {
+			return _nl_msg_new_address (RTM_DELADDR,
+			                            0,
+			                            AF_INET6,
+			                            a->ifindex,
+			                            &a->address,
+			                            a->plen,
+			                            NULL,
+			                            0,
+			                            RT_SCOPE_NOWHERE,
+			                            NM_PLATFORM_LIFETIME_PERMANENT,
+			                            NM_PLATFORM_LIFETIME_PERMANENT,
+			                            NULL);
+		}
+		return _nl_msg_new_address (RTM_NEWADDR,
+		                            NLM_F_CREATE | NLM_F_REPLACE,
+		                            AF_INET6,
+		                            a->ifindex,
+		                            &a->address,
+		                            a->plen,
+		                            &a->peer_address,
+		                            op->ifa_flags,
+		                            RT_SCOPE_UNIVERSE,
+		                            op->lifetime,
+		                            op->preferred,
+		                            NULL);
+	}
+	case NMP_OBJECT_TYPE_IP4_ROUTE:
+	case NMP_OBJECT_TYPE_IP6_ROUTE: {
+		NMPObject obj_stack;
+
+		if (!is_add)
+			return _nl_msg_new_route (RTM_DELROUTE, 0, obj);
+
+		nmp_object_stackinit_obj (&obj_stack, obj);
+		nm_platform_ip_route_normalize (NMP_OBJECT_GET_CLASS (obj)->addr_family,
+		                                NMP_OBJECT_CAST_IP_ROUTE (&obj_stack));
+		return _nl_msg_new_route (RTM_NEWROUTE, op->nlm_flags & NMP_NLM_FLAG_FMASK, &obj_stack);
+	}
+	default:
+		break;
+	}
+	g_return_val_if_reached (NULL);
+}
+
+static void
+transaction_commit (NMPlatform *platform,
+                    NMPlatformTransactionOp *ops,
+                    guint n_ops)
+{
+	gs_free WaitForNlResponseResult *seq_results = NULL;
+	struct nl_msg *nlmsgs[TRANSACTION_BATCH_MAX_MSGS];
+	guint i_start = 0;
+	gboolean need_refetch = FALSE;
+	NMPCache *cache = nm_platform_get_cache (platform);
+	char s_buf[256];
+	guint i, n;
+
+	nm_assert (n_ops > 0);
+
+	seq_results = g_new0 (WaitForNlResponseResult, n_ops);
+
+	event_handler_read_netlink (platform, FALSE);
+
+	i = 0;
+	while (i < n_ops) {
+		gsize n_bytes = 0;
+		int nle;
+
+		/* collect the next batch of messages. The batch covers a contiguous
+		 * range of @ops, so that @seq_results can be passed on directly. */
+		for (n = 0; i < n_ops && n < TRANSACTION_BATCH_MAX_MSGS; i++) {
+			struct nl_msg *nlmsg;
+
+			nlmsg = _nl_msg_new_transaction_op (&ops[i]);
+			if (!nlmsg) {
+				seq_results[i] = WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_UNKNOWN;
+				if (n > 0) {
+					i++;
+					break;
+				}
+				continue;
+			}
+			if (   n > 0
+			    && n_bytes + nlmsg_hdr (nlmsg)->nlmsg_len > TRANSACTION_BATCH_MAX_BYTES) {
+				nlmsg_free (nlmsg);
+				break;
+			}
+			if (n == 0)
+				i_start = i;
+			n_bytes += nlmsg_hdr (nlmsg)->nlmsg_len;
+			nlmsgs[n++] = nlmsg;
+		}
+
+		if (n == 0)
+			continue;
+
+		nle = _nl_send_nlmsg_batch (platform, nlmsgs, n, &seq_results[i_start]);
+		if (nle < 0) {
+			_LOGE ("transaction: failure sending %u netlink requests \"%s\" (%d)",
+			       n, g_strerror (-nle), -nle);
+		}
+
+		while (n > 0) {
+			n--;
+			if (nle < 0)
+				seq_results[i_start + n] = WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_UNKNOWN;
+			nlmsg_free (nlmsgs[n]);
+		}
+
+		/* wait for all responses of this batch. */
+		delayed_action_handle_all (platform, FALSE);
+	}
+
+	for (i = 0; i < n_ops; i++) {
+		NMPlatformTransactionOp *op = &ops[i];
+		const WaitForNlResponseResult seq_result = seq_results[i];
+		const NMPObject *obj = op->obj;
+
+		nm_assert (seq_result);
+
+		if (op->op_type == NMP_TRANSACTION_OP_TYPE_ADD) {
+			_NMLOG ((   seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK
+			         || (   NM_FLAGS_HAS (op->nlm_flags, NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE)
+			             && seq_result < 0))
+			            ? LOGL_DEBUG
+			            : LOGL_WARN,
+			        "do-add-%s[%s]: %s",
+			        NMP_OBJECT_GET_CLASS (obj)->obj_type_name,
+			        nmp_object_to_string (obj, NMP_OBJECT_TO_STRING_ID, NULL, 0),
+			        wait_for_nl_response_to_string (seq_result, s_buf, sizeof (s_buf)));
+
+			op->result = wait_for_nl_response_to_plerr (seq_result);
+
+			/* rh#1484434, see do_add_addrroute(). */
+			if (   NMP_OBJECT_GET_TYPE (obj) == NMP_OBJECT_TYPE_IP6_ADDRESS
+			    && !nmp_cache_lookup_obj (cache, obj)) {
+				delayed_action_schedule_REFRESH_PARTIAL (platform, NMP_OBJECT_TYPE_IP6_ADDRESS, obj->object.ifindex, RT_TABLE_UNSPEC);
+				need_refetch = TRUE;
+			}
+		} else {
+			const char *log_detail;
+			gboolean success;
+
+			success = _delete_object_check_result (obj, seq_result, &log_detail);
+
+			_NMLOG (success ? LOGL_DEBUG : LOGL_WARN,
+			        "do-delete-%s[%s]: %s%s",
+			        NMP_OBJECT_GET_CLASS (obj)->obj_type_name,
+			        nmp_object_to_string (obj, NMP_OBJECT_TO_STRING_ID, NULL, 0),
+			        wait_for_nl_response_to_string (seq_result, s_buf, sizeof (s_buf)),
+			        log_detail);
+
+			op->result =   success
+			             ? NM_PLATFORM_ERROR_SUCCESS
+			             : wait_for_nl_response_to_plerr (seq_result);
+
+			/* rh#1484434, see do_delete_object(). */
+			if (   NMP_OBJECT_GET_TYPE (obj) == NMP_OBJECT_TYPE_IP6_ADDRESS
+			    && nmp_cache_lookup_obj (cache, obj)) {
+				delayed_action_schedule_REFRESH_PARTIAL (platform, NMP_OBJECT_TYPE_IP6_ADDRESS, obj->object.ifindex, RT_TABLE_UNSPEC);
+				need_refetch = TRUE;
+			}
+		}
+	}
+
+	/* Refetch only once per interface for the entire transaction. */
+	if (need_refetch)
+		delayed_action_handle_all (platform, FALSE);
+}
+
+/*****************************************************************************/
+
 static NMPlatformError
 ip_route_get (NMPlatform *platform,
               int addr_family,
@@ -6445,334 +8466,835 @@ ip_route_get (NMPlatform *platform,
 		if (!_nl_addattr_l (&req.n, sizeof (req), RTA_DST, address, addr_len))
 			nm_assert_not_reached ();
 
-		if (oif_ifindex > 0) {
-			gint32 ii = oif_ifindex;
+		if (oif_ifindex > 0) {
+			gint32 ii = oif_ifindex;
+
+			if (!_nl_addattr_l (&req.n, sizeof (req), RTA_OIF, &ii, sizeof (ii)))
+				nm_assert_not_reached ();
+		}
+
+		seq_result = WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN;
+		nle = _nl_send_nlmsghdr (platform, &req.n, &seq_result, DELAYED_ACTION_RESPONSE_TYPE_ROUTE_GET, &route);
+		if (nle < 0) {
+			_LOGE ("get-route: failure sending netlink request \"%s\" (%d)",
+			       g_strerror (-nle), -nle);
+			return NM_PLATFORM_ERROR_UNSPECIFIED;
+		}
+
+		delayed_action_handle_all (platform, FALSE);
+
+		/* Retry, if we failed due to a cache resync. That can happen when the netlink
+		 * socket fills up and we lost the response. */
+	} while (   seq_result == WAIT_FOR_NL_RESPONSE_RESULT_FAILED_RESYNC
+	         && ++try_count < 10);
+
+	if (seq_result < 0) {
+		/* negative seq_result is an errno from kernel. Map it to negative
+		 * NMPlatformError (which are also errno). */
+		return (NMPlatformError) seq_result;
+	}
+
+	if (seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK) {
+		if (route) {
+			NM_SET_OUT (out_route, g_steal_pointer (&route));
+			return NM_PLATFORM_ERROR_SUCCESS;
+		}
+		seq_result = WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_UNKNOWN;
+	}
+
+	return NM_PLATFORM_ERROR_UNSPECIFIED;
+}
+
+/*****************************************************************************/
+
+static NMPlatformError
+qdisc_add (NMPlatform *platform,
+           NMPNlmFlags flags,
+           const NMPlatformQdisc *qdisc)
+{
+	WaitForNlResponseResult seq_result = WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN;
+	int nle;
+	char s_buf[256];
+	nm_auto_nlmsg struct nl_msg *msg = NULL;
+
+	msg = _nl_msg_new_qdisc (RTM_NEWQDISC, flags, qdisc);
+
+	event_handler_read_netlink (platform, FALSE);
+
+	nle = _nl_send_nlmsg (platform, msg, &seq_result, DELAYED_ACTION_RESPONSE_TYPE_VOID, NULL);
+	if (nle < 0) {
+		_LOGE ("do-add-qdisc: failed sending netlink request \"%s\" (%d)",
+		      nl_geterror (nle), -nle);
+		return NM_PLATFORM_ERROR_NETLINK;
+	}
+
+	delayed_action_handle_all (platform, FALSE);
+
+	nm_assert (seq_result);
+
+	_NMLOG (seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK
+	            ? LOGL_DEBUG
+	            : LOGL_WARN,
+	        "do-add-qdisc: %s",
+	        wait_for_nl_response_to_string (seq_result, s_buf, sizeof (s_buf)));
+
+	if (seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK)
+		return NM_PLATFORM_ERROR_SUCCESS;
+
+	return NM_PLATFORM_ERROR_UNSPECIFIED;
+}
+
+/*****************************************************************************/
+
+static NMPlatformError
+tfilter_add (NMPlatform *platform,
+             NMPNlmFlags flags,
+             const NMPlatformTfilter *tfilter)
+{
+	WaitForNlResponseResult seq_result = WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN;
+	int nle;
+	char s_buf[256];
+	nm_auto_nlmsg struct nl_msg *msg = NULL;
+
+	msg = _nl_msg_new_tfilter (RTM_NEWTFILTER, flags, tfilter);
+
+	event_handler_read_netlink (platform, FALSE);
+
+	nle = _nl_send_nlmsg (platform, msg, &seq_result, DELAYED_ACTION_RESPONSE_TYPE_VOID, NULL);
+	if (nle < 0) {
+		_LOGE ("do-add-tfilter: failed sending netlink request \"%s\" (%d)",
+		      nl_geterror (nle), -nle);
+		return NM_PLATFORM_ERROR_NETLINK;
+	}
+
+	delayed_action_handle_all (platform, FALSE);
+
+	nm_assert (seq_result);
+
+	_NMLOG (seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK
+	            ? LOGL_DEBUG
+	            : LOGL_WARN,
+	        "do-add-tfilter: %s",
+	        wait_for_nl_response_to_string (seq_result, s_buf, sizeof (s_buf)));
+
+	if (seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK)
+		return NM_PLATFORM_ERROR_SUCCESS;
+
+	return NM_PLATFORM_ERROR_UNSPECIFIED;
+}
+
+/*****************************************************************************/
+
+#define EVENT_CONDITIONS      ((GIOCondition) (G_IO_IN | G_IO_PRI))
+#define ERROR_CONDITIONS      ((GIOCondition) (G_IO_ERR | G_IO_NVAL))
+#define DISCONNECT_CONDITIONS ((GIOCondition) (G_IO_HUP))
+
+static gboolean
+event_handler (GIOChannel *channel,
+               GIOCondition io_condition,
+               gpointer user_data)
+{
+	delayed_action_handle_all (NM_PLATFORM (user_data), TRUE);
+	return TRUE;
+}
+
+/*****************************************************************************/
+
+/* copied from libnl3's recvmsgs() */
+/**
+ * _nl_recv:
+ * @fd: the netlink socket
+ * @buf: the preallocated receive buffer
+ * @buf_len: the size of @buf
+ * @out_creds: (out): the credentials of the sender
+ * @out_creds_has: (out): whether @out_creds were received. This is
+ *   %FALSE if the control data was truncated (MSG_CTRUNC).
+ *
+ * Like libnl3's nl_recv(), but receives into a preallocated
+ * buffer instead of allocating a new buffer (and credentials)
+ * for every call.
+ *
+ * This does not access the platform instance, so that it can
+ * also be called from the netlink reader thread.
+ *
+ * Returns: the number of bytes received or a negative nlerror.
+ *   On success, the data is in @buf.
+ */
+static int
+_nl_recv (int fd,
+          guint8 *buf,
+          gsize buf_len,
+          struct ucred *out_creds,
+          gboolean *out_creds_has)
+{
+	struct sockaddr_nl nla = { 0 };
+	struct iovec iov = {
+		.iov_base = buf,
+		.iov_len = buf_len,
+	};
+	union {
+		struct cmsghdr cmsghdr;
+		guint8 buf[CMSG_SPACE (sizeof (struct ucred))];
+	} cmsg_buf;
+	struct msghdr msg = {
+		.msg_name = &nla,
+		.msg_namelen = sizeof (nla),
+		.msg_iov = &iov,
+		.msg_iovlen = 1,
+		.msg_control = &cmsg_buf,
+		.msg_controllen = sizeof (cmsg_buf),
+	};
+	struct cmsghdr *cmsg;
+	int n;
+	int errsv;
+
+	*out_creds_has = FALSE;
+
+retry:
+	n = recvmsg (fd, &msg, 0);
+	if (n < 0) {
+		errsv = errno;
+		if (errsv == EINTR)
+			goto retry;
+		if (errsv == EAGAIN) {
+			/* EAGAIN is equal to EWOULDBLOCK. */
+			G_STATIC_ASSERT (EAGAIN == EWOULDBLOCK);
+			return -NLE_AGAIN;
+		}
+		if (errsv == ENOBUFS) {
+			/* we are very much interested in a overrun of the receive buffer.
+			 * Signal the overrun with our own error code. */
+			return -_NLE_NM_NOBUFS;
+		}
+		return -nl_syserr2nlerr (errsv);
+	}
+
+	if (NM_FLAGS_HAS (msg.msg_flags, MSG_TRUNC))
+		return -NLE_MSG_TRUNC;
+
+	if (msg.msg_namelen != sizeof (struct sockaddr_nl))
+		return -NLE_NOADDR;
+
+	if (NM_FLAGS_HAS (msg.msg_flags, MSG_CTRUNC)) {
+		/* the message is complete, but the control data was truncated. We
+		 * cannot trust the credentials, so report none, and the caller
+		 * ignores the message like any message not from kernel. */
+		return n;
+	}
+
+	for (cmsg = CMSG_FIRSTHDR (&msg); cmsg; cmsg = CMSG_NXTHDR (&msg, cmsg)) {
+		if (   cmsg->cmsg_level == SOL_SOCKET
+		    && cmsg->cmsg_type == SCM_CREDENTIALS) {
+			memcpy (out_creds, CMSG_DATA (cmsg), sizeof (*out_creds));
+			*out_creds_has = TRUE;
+			break;
+		}
+	}
+
+	return n;
+}
+
+/*****************************************************************************
+ * netlink reader thread
+ *
+ * Optionally, a dedicated thread receives from the netlink socket and parses
+ * addresses, routes, qdiscs and tfilters into NMPObject instances. The objects
+ * are immutable after creation, and are handed over to the main thread via a
+ * single-producer/single-consumer ring. The main thread only updates the cache
+ * and emits the signals.
+ *
+ * Links are not parsed on the reader thread, because _new_from_nl_link() needs
+ * the cache and the platform instance. Also, the main thread still sends the
+ * requests (with the sequence numbers), so all the bookkeeping about pending
+ * requests stays on the main thread.
+ *****************************************************************************/
+
+#define NETLINK_READER_RING_SIZE 4096
+
+G_STATIC_ASSERT ((NETLINK_READER_RING_SIZE & (NETLINK_READER_RING_SIZE - 1)) == 0);
+
+typedef struct {
+	/* a copy of the message header. */
+	struct nlmsghdr hdr;
+
+	/* whether the reader thread parsed the message. If it did, @obj is
+	 * the result, or %NULL if the message is to be ignored. */
+	bool parsed;
+	NMPObject *obj;
+
+	/* whether @obj is a route that the route filter drops, but that
+	 * replaced another route. See _nmp_object_new_from_nl(). */
+	bool filtered_replace;
+
+	/* if the reader thread didn't parse the message, a copy of the entire
+	 * message. */
+	struct nlmsghdr *msg;
+
+	/* if set, the item carries no message, but a negative netlink error
+	 * from receiving. */
+	int nle;
+} NetlinkReaderItem;
+
+struct _NetlinkReader {
+	GThread *thread;
+
+	/* the netlink socket. It is owned by the platform instance, but
+	 * only the reader thread receives from it. */
+	int fd_nl;
+
+	/* signals the main thread, that there are new items in the ring. */
+	int fd_event;
+
+	/* wakes up the reader thread, when it waits for space in the ring,
+	 * or when it shall stop. */
+	int fd_wakeup;
+
+	guint8 *recv_buf;
+	gsize recv_buf_len;
+
+	/* owned by the platform instance, which outlives the reader. */
+	RouteFilter *route_filter;
+
+	/* @head is only written by the reader thread, @tail only by the main thread.
+	 * The counters are free running, and the index in @ring is the counter modulo
+	 * NETLINK_READER_RING_SIZE. */
+	volatile gint head;
+	volatile gint tail;
+
+	volatile gint producer_waiting;
+	volatile gint stop;
+
+	NetlinkReaderItem ring[NETLINK_READER_RING_SIZE];
+};
+
+static void
+_eventfd_signal (int fd)
+{
+	guint64 v = 1;
+
+	if (write (fd, &v, sizeof (v)) < 0) {
+		/* the eventfd counter is already large. That is fine, the other side
+		 * will wake up anyway. */
+	}
+}
+
+static void
+_eventfd_clear (int fd)
+{
+	guint64 v;
+
+	if (read (fd, &v, sizeof (v)) < 0) {
+		/* EAGAIN. The eventfd was not signaled. */
+	}
+}
+
+static void
+netlink_reader_item_clear (NetlinkReaderItem *item)
+{
+	nm_clear_nmp_object (&item->obj);
+	nm_clear_g_free (&item->msg);
+}
+
+static gboolean
+netlink_reader_push (NetlinkReader *reader, NetlinkReaderItem *item)
+{
+	guint head;
+
+	/* the reader thread is the only writer of @head. */
+	head = (guint) reader->head;
+
+	while (head - ((guint) g_atomic_int_get (&reader->tail)) >= NETLINK_READER_RING_SIZE) {
+		struct pollfd pfd = {
+			.fd = reader->fd_wakeup,
+			.events = POLLIN,
+		};
+
+		/* the ring is full. Let the main thread know that it has work to do,
+		 * and wait until it consumed some items. */
+		_eventfd_signal (reader->fd_event);
+
+		g_atomic_int_set (&reader->producer_waiting, 1);
+		if (head - ((guint) g_atomic_int_get (&reader->tail)) >= NETLINK_READER_RING_SIZE) {
+			if (   poll (&pfd, 1, -1) > 0
+			    && NM_FLAGS_HAS (pfd.revents, POLLIN))
+				_eventfd_clear (reader->fd_wakeup);
+		}
+		g_atomic_int_set (&reader->producer_waiting, 0);
+
+		if (g_atomic_int_get (&reader->stop)) {
+			netlink_reader_item_clear (item);
+			return FALSE;
+		}
+	}
+
+	reader->ring[head % NETLINK_READER_RING_SIZE] = *item;
+	g_atomic_int_set (&reader->head, (gint) (head + 1));
+	return TRUE;
+}
+
+static gboolean
+netlink_reader_pop (NetlinkReader *reader, NetlinkReaderItem *out_item)
+{
+	guint tail;
+
+	/* the main thread is the only writer of @tail. */
+	tail = (guint) reader->tail;
+
+	if (tail == (guint) g_atomic_int_get (&reader->head))
+		return FALSE;
+
+	*out_item = reader->ring[tail % NETLINK_READER_RING_SIZE];
+	g_atomic_int_set (&reader->tail, (gint) (tail + 1));
+
+	if (g_atomic_int_get (&reader->producer_waiting))
+		_eventfd_signal (reader->fd_wakeup);
+	return TRUE;
+}
+
+static gboolean
+netlink_reader_push_msg (NetlinkReader *reader, struct nlmsghdr *hdr)
+{
+	NetlinkReaderItem item = {
+		.hdr = *hdr,
+	};
+
+	switch (hdr->nlmsg_type) {
+	case RTM_NEWADDR:
+		/* the detection only happens once. The result is only read by the main
+		 * thread, after the item is handed over. */
+		if (_support_kernel_extended_ifa_flags_still_undecided ())
+			_support_kernel_extended_ifa_flags_detect (hdr);
+		/* fall through */
+	case RTM_DELADDR:
+	case RTM_NEWROUTE:
+	case RTM_DELROUTE:
+	case RTM_NEWQDISC:
+	case RTM_DELQDISC:
+	case RTM_NEWTFILTER:
+	case RTM_DELTFILTER: {
+		gboolean filtered_replace;
+
+		/* these don't need the cache for parsing. */
+		item.parsed = TRUE;
+		item.obj = _nmp_object_new_from_nl (NULL, NULL, hdr,
+		                                    NM_IN_SET (hdr->nlmsg_type, RTM_DELADDR, RTM_DELROUTE),
+		                                    reader->route_filter,
+		                                    &filtered_replace);
+		item.filtered_replace = filtered_replace;
+		break;
+	}
+	default:
+		break;
+	}
+
+	if (!item.parsed)
+		item.msg = g_memdup (hdr, hdr->nlmsg_len);
+
+	return netlink_reader_push (reader, &item);
+}
+
+static gpointer
+netlink_reader_thread (gpointer user_data)
+{
+	NetlinkReader *reader = user_data;
+	struct ucred creds;
+	gboolean creds_has;
+	struct nlmsghdr *hdr;
+	int n;
+
+	while (!g_atomic_int_get (&reader->stop)) {
+		struct pollfd pfd[2] = {
+			{ .fd = reader->fd_nl,     .events = POLLIN },
+			{ .fd = reader->fd_wakeup, .events = POLLIN },
+		};
+
+		if (poll (pfd, G_N_ELEMENTS (pfd), -1) < 0)
+			continue;
+
+		if (NM_FLAGS_HAS (pfd[1].revents, POLLIN))
+			_eventfd_clear (reader->fd_wakeup);
+
+		while (!g_atomic_int_get (&reader->stop)) {
+			n = _nl_recv (reader->fd_nl,
+			              reader->recv_buf,
+			              reader->recv_buf_len,
+			              &creds,
+			              &creds_has);
+
+			if (n == -NLE_AGAIN)
+				break;
+
+			if (n == -NLE_MSG_TRUNC) {
+				/* see event_handler_recvmsgs(). */
+				if (reader->recv_buf_len < 512*1024) {
+					reader->recv_buf_len *= 2;
+					g_free (reader->recv_buf);
+					reader->recv_buf = g_malloc (reader->recv_buf_len);
+				}
+				n = -_NLE_MSG_TRUNC;
+			}
+
+			if (n < 0) {
+				NetlinkReaderItem item = {
+					.nle = n,
+				};
+
+				netlink_reader_push (reader, &item);
+			} else if (   n > 0
+			           && creds_has
+			           && !creds.pid) {
+				/* unlike event_handler_recvmsgs(), we silently drop messages that
+				 * are not from kernel. */
+				hdr = (struct nlmsghdr *) reader->recv_buf;
+				while (nlmsg_ok (hdr, n)) {
+					if (!netlink_reader_push_msg (reader, hdr))
+						break;
+					hdr = nlmsg_next (hdr, &n);
+				}
+			}
 
-			if (!_nl_addattr_l (&req.n, sizeof (req), RTA_OIF, &ii, sizeof (ii)))
-				nm_assert_not_reached ();
+			/* signal once per datagram, not once per message. */
+			_eventfd_signal (reader->fd_event);
 		}
+	}
 
-		seq_result = WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN;
-		nle = _nl_send_nlmsghdr (platform, &req.n, &seq_result, DELAYED_ACTION_RESPONSE_TYPE_ROUTE_GET, &route);
-		if (nle < 0) {
-			_LOGE ("get-route: failure sending netlink request \"%s\" (%d)",
-			       g_strerror (-nle), -nle);
-			return NM_PLATFORM_ERROR_UNSPECIFIED;
-		}
+	return NULL;
+}
 
-		delayed_action_handle_all (platform, FALSE);
+static NetlinkReader *
+netlink_reader_start (int fd_nl, gsize recv_buf_len, RouteFilter *route_filter)
+{
+	NetlinkReader *reader;
 
-		/* Retry, if we failed due to a cache resync. That can happen when the netlink
-		 * socket fills up and we lost the response. */
-	} while (   seq_result == WAIT_FOR_NL_RESPONSE_RESULT_FAILED_RESYNC
-	         && ++try_count < 10);
+	reader = g_malloc0 (sizeof (NetlinkReader));
+	reader->fd_nl = fd_nl;
+	reader->route_filter = route_filter;
+	reader->fd_event = eventfd (0, EFD_CLOEXEC | EFD_NONBLOCK);
+	reader->fd_wakeup = eventfd (0, EFD_CLOEXEC | EFD_NONBLOCK);
+	g_assert (reader->fd_event >= 0 && reader->fd_wakeup >= 0);
+	reader->recv_buf_len = recv_buf_len;
+	reader->recv_buf = g_malloc (reader->recv_buf_len);
+	reader->thread = g_thread_new ("nm-netlink-reader", netlink_reader_thread, reader);
+	return reader;
+}
 
-	if (seq_result < 0) {
-		/* negative seq_result is an errno from kernel. Map it to negative
-		 * NMPlatformError (which are also errno). */
-		return (NMPlatformError) seq_result;
-	}
+static void
+netlink_reader_stop (NetlinkReader *reader)
+{
+	NetlinkReaderItem item;
 
-	if (seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK) {
-		if (route) {
-			NM_SET_OUT (out_route, g_steal_pointer (&route));
-			return NM_PLATFORM_ERROR_SUCCESS;
-		}
-		seq_result = WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_UNKNOWN;
-	}
+	g_atomic_int_set (&reader->stop, 1);
+	_eventfd_signal (reader->fd_wakeup);
+	g_thread_join (reader->thread);
 
-	return NM_PLATFORM_ERROR_UNSPECIFIED;
+	while (netlink_reader_pop (reader, &item))
+		netlink_reader_item_clear (&item);
+
+	nm_close (reader->fd_event);
+	nm_close (reader->fd_wakeup);
+	g_free (reader->recv_buf);
+	g_free (reader);
 }
 
 /*****************************************************************************/
 
-static NMPlatformError
-qdisc_add (NMPlatform *platform,
-           NMPNlmFlags flags,
-           const NMPlatformQdisc *qdisc)
+/* whether @seq_number belongs to a request of ours that still awaits its
+ * reply. */
+static gboolean
+_nl_seq_is_pending (NMPlatform *platform, guint32 seq_number)
 {
-	WaitForNlResponseResult seq_result = WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN;
-	int nle;
-	char s_buf[256];
-	nm_auto_nlmsg struct nl_msg *msg = NULL;
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	guint i;
 
-	msg = _nl_msg_new_qdisc (RTM_NEWQDISC, flags, qdisc);
+	if (seq_number == 0)
+		return FALSE;
 
-	event_handler_read_netlink (platform, FALSE);
+	for (i = 0; i < priv->pruning_partial->len; i++) {
+		if (g_array_index (priv->pruning_partial, DelayedActionRefreshPartialData, i).seq_number == seq_number)
+			return TRUE;
+	}
 
-	nle = _nl_send_nlmsg (platform, msg, &seq_result, DELAYED_ACTION_RESPONSE_TYPE_VOID, NULL);
-	if (nle < 0) {
-		_LOGE ("do-add-qdisc: failed sending netlink request \"%s\" (%d)",
-		      nl_geterror (nle), -nle);
-		return NM_PLATFORM_ERROR_NETLINK;
+	if (!NM_FLAGS_HAS (priv->delayed_action.flags, DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE))
+		return FALSE;
+
+	for (i = 0; i < priv->delayed_action.list_wait_for_nl_response->len; i++) {
+		if (g_array_index (priv->delayed_action.list_wait_for_nl_response, DelayedActionWaitForNlResponseData, i).seq_number == seq_number)
+			return TRUE;
 	}
+	return FALSE;
+}
 
-	delayed_action_handle_all (platform, FALSE);
+/* Kernel interrupted the dump with sequence number @seq_number, because the
+ * objects changed meanwhile. Request the same dump again, so that only the
+ * ifindex or table that was being dumped gets refreshed. */
+static void
+_nl_dump_interrupted (NMPlatform *platform, guint32 seq_number)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	guint i;
 
-	nm_assert (seq_result);
+	for (i = 0; i < priv->pruning_partial->len; i++) {
+		DelayedActionRefreshPartialData data;
 
-	_NMLOG (seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK
-	            ? LOGL_DEBUG
-	            : LOGL_WARN,
-	        "do-add-qdisc: %s",
-	        wait_for_nl_response_to_string (seq_result, s_buf, sizeof (s_buf)));
+		data = g_array_index (priv->pruning_partial, DelayedActionRefreshPartialData, i);
+		if (data.seq_number != seq_number)
+			continue;
+		data.seq_number = 0;
+		delayed_action_schedule (platform, DELAYED_ACTION_TYPE_REFRESH_PARTIAL, &data);
+		return;
+	}
 
-	if (seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK)
-		return NM_PLATFORM_ERROR_SUCCESS;
+	if (!NM_FLAGS_HAS (priv->delayed_action.flags, DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE))
+		return;
 
-	return NM_PLATFORM_ERROR_UNSPECIFIED;
+	for (i = 0; i < priv->delayed_action.list_wait_for_nl_response->len; i++) {
+		const DelayedActionWaitForNlResponseData *data = &g_array_index (priv->delayed_action.list_wait_for_nl_response, DelayedActionWaitForNlResponseData, i);
+
+		if (   data->seq_number != seq_number
+		    || data->response_type != DELAYED_ACTION_RESPONSE_TYPE_REFRESH_ALL_IN_PROGRESS
+		    || !data->response.out_refresh_all_in_progess)
+			continue;
+		delayed_action_schedule (platform,
+		                         (DelayedActionType) (1LL << (data->response.out_refresh_all_in_progess - priv->delayed_action.refresh_all_in_progess)),
+		                         NULL);
+		return;
+	}
 }
 
-/*****************************************************************************/
+/* handles one message of a datagram. Returns %FALSE, if the remaining
+ * messages of the datagram shall be skipped. */
+static gboolean
+event_handler_recvmsg_one (NMPlatform *platform,
+                           struct nlmsghdr *hdr,
+                           gboolean is_parsed,
+                           NMPObject *obj_parsed,
+                           gboolean filtered_replace,
+                           gboolean handle_events,
+                           int *p_err,
+                           gboolean *p_multipart,
+                           gboolean *p_interrupted)
+{
+	gboolean process_valid_msg = FALSE;
+	WaitForNlResponseResult seq_result;
+	guint32 seq_number;
+	char buf_nlmsghdr[400];
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
 
-static NMPlatformError
-tfilter_add (NMPlatform *platform,
-             NMPNlmFlags flags,
-             const NMPlatformTfilter *tfilter)
-{
-	WaitForNlResponseResult seq_result = WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN;
-	int nle;
-	char s_buf[256];
-	nm_auto_nlmsg struct nl_msg *msg = NULL;
+	_LOGt ("netlink: recvmsg: new message %s",
+	       _nl_nlmsghdr_to_str (hdr, buf_nlmsghdr, sizeof (buf_nlmsghdr)));
 
-	msg = _nl_msg_new_tfilter (RTM_NEWTFILTER, flags, tfilter);
+	priv->nl_stats.n_msgs++;
+	priv->nl_stats.n_bytes += hdr->nlmsg_len;
+	if (!_nl_seq_is_pending (platform, hdr->nlmsg_seq))
+		priv->nl_burst_bytes += hdr->nlmsg_len;
 
-	event_handler_read_netlink (platform, FALSE);
+	if (hdr->nlmsg_flags & NLM_F_MULTI)
+		*p_multipart = TRUE;
 
-	nle = _nl_send_nlmsg (platform, msg, &seq_result, DELAYED_ACTION_RESPONSE_TYPE_VOID, NULL);
-	if (nle < 0) {
-		_LOGE ("do-add-tfilter: failed sending netlink request \"%s\" (%d)",
-		      nl_geterror (nle), -nle);
-		return NM_PLATFORM_ERROR_NETLINK;
+	if (   G_UNLIKELY (priv->nmtst_interrupt_next_dump)
+	    && NM_FLAGS_HAS (hdr->nlmsg_flags, NLM_F_MULTI)
+	    && _nl_seq_is_pending (platform, hdr->nlmsg_seq)) {
+		priv->nmtst_interrupt_next_dump = FALSE;
+		hdr->nlmsg_flags |= NLM_F_DUMP_INTR;
 	}
 
-	delayed_action_handle_all (platform, FALSE);
+	if (hdr->nlmsg_flags & NLM_F_DUMP_INTR) {
+		/*
+		 * We have to continue reading to clear
+		 * all messages until a NLMSG_DONE is
+		 * received and report the inconsistency.
+		 */
+		if (!*p_interrupted)
+			_nl_dump_interrupted (platform, hdr->nlmsg_seq);
+		*p_interrupted = TRUE;
+	}
+
+	/* Other side wishes to see an ack for this message */
+	if (hdr->nlmsg_flags & NLM_F_ACK) {
+		/* FIXME: implement */
+	}
+
+	seq_result = WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_UNKNOWN;
+
+	if (is_parsed) {
+		/* the reader thread already parsed the message. @hdr is only the
+		 * header. */
+		process_valid_msg = TRUE;
+	} else if (hdr->nlmsg_type == NLMSG_DONE) {
+		/* messages terminates a multipart message, this is
+		 * usually the end of a message and therefore we slip
+		 * out of the loop by default. the user may overrule
+		 * this action by skipping this packet. */
+		*p_multipart = FALSE;
+		seq_result = WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK;
+	} else if (hdr->nlmsg_type == NLMSG_NOOP) {
+		/* Message to be ignored, the default action is to
+		 * skip this message if no callback is specified. The
+		 * user may overrule this action by returning
+		 * NL_PROCEED. */
+	} else if (hdr->nlmsg_type == NLMSG_OVERRUN) {
+		/* Data got lost, report back to user. The default action is to
+		 * quit parsing. The user may overrule this action by retuning
+		 * NL_SKIP or NL_PROCEED (dangerous) */
+		*p_err = -NLE_MSG_OVERFLOW;
+		return FALSE;
+	} else if (hdr->nlmsg_type == NLMSG_ERROR) {
+		/* Message carries a nlmsgerr */
+		struct nlmsgerr *e = nlmsg_data (hdr);
+
+		if (hdr->nlmsg_len < nlmsg_size (sizeof (*e))) {
+			/* Truncated error message, the default action
+			 * is to stop parsing. The user may overrule
+			 * this action by returning NL_SKIP or
+			 * NL_PROCEED (dangerous) */
+			*p_err = -NLE_MSG_TRUNC;
+			return FALSE;
+		} else if (e->error) {
+			int errsv = e->error > 0 ? e->error : -e->error;
+
+			/* Error message reported back from kernel. */
+			_LOGD ("netlink: recvmsg: error message from kernel: %s (%d) for request %d",
+			       strerror (errsv),
+			       errsv,
+			       hdr->nlmsg_seq);
+			seq_result = -errsv;
+		} else
+			seq_result = WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK;
+	} else
+		process_valid_msg = TRUE;
 
-	nm_assert (seq_result);
+	seq_number = hdr->nlmsg_seq;
 
-	_NMLOG (seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK
-	            ? LOGL_DEBUG
-	            : LOGL_WARN,
-	        "do-add-tfilter: %s",
-	        wait_for_nl_response_to_string (seq_result, s_buf, sizeof (s_buf)));
+	/* check whether the seq number is different from before, and
+	 * whether the previous number (@nlh_seq_last_seen) is a pending
+	 * refresh-all request. In that case, the pending request is thereby
+	 * completed.
+	 *
+	 * We must do that before processing the message with event_valid_msg(),
+	 * because we must track the completion of the pending request before that. */
+	event_seq_check_refresh_all (platform, seq_number);
+
+	if (process_valid_msg) {
+		/* Valid message (not checking for MULTIPART bit to
+		 * get along with broken kernels. NL_SKIP has no
+		 * effect on this.  */
+
+		if (is_parsed && !obj_parsed) {
+			_LOGT ("event-notification: %s: ignore",
+			       _nl_nlmsghdr_to_str (hdr, buf_nlmsghdr, sizeof (buf_nlmsghdr)));
+		} else
+			event_valid_msg (platform, hdr, obj_parsed, filtered_replace, handle_events);
 
-	if (seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK)
-		return NM_PLATFORM_ERROR_SUCCESS;
+		seq_result = WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK;
+	}
 
-	return NM_PLATFORM_ERROR_UNSPECIFIED;
+	event_seq_check (platform, seq_number, seq_result);
+
+	*p_err = 0;
+	return TRUE;
 }
 
-/*****************************************************************************/
+static int
+event_handler_recvmsgs_reader (NMPlatform *platform, gboolean handle_events)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	NetlinkReaderItem item;
+	int err = 0;
+	gboolean multipart = FALSE;
+	gboolean interrupted = FALSE;
+	gboolean any = FALSE;
 
-#define EVENT_CONDITIONS      ((GIOCondition) (G_IO_IN | G_IO_PRI))
-#define ERROR_CONDITIONS      ((GIOCondition) (G_IO_ERR | G_IO_NVAL))
-#define DISCONNECT_CONDITIONS ((GIOCondition) (G_IO_HUP))
+	/* clear the event first. If the reader thread pushes more items after
+	 * we drained the ring, the event will be signaled again. */
+	_eventfd_clear (priv->reader->fd_event);
 
-static gboolean
-event_handler (GIOChannel *channel,
-               GIOCondition io_condition,
-               gpointer user_data)
-{
-	delayed_action_handle_all (NM_PLATFORM (user_data), TRUE);
-	return TRUE;
-}
+	while (netlink_reader_pop (priv->reader, &item)) {
+		any = TRUE;
 
-/*****************************************************************************/
+		if (item.nle < 0) {
+			if (!handle_events)
+				continue;
+			return item.nle;
+		}
+
+		event_handler_recvmsg_one (platform,
+		                           item.msg ?: &item.hdr,
+		                           item.parsed,
+		                           g_steal_pointer (&item.obj),
+		                           item.filtered_replace,
+		                           handle_events,
+		                           &err,
+		                           &multipart,
+		                           &interrupted);
+		netlink_reader_item_clear (&item);
+	}
+
+	if (!any)
+		return -NLE_AGAIN;
+	if (interrupted)
+		err = -NLE_DUMP_INTR;
+	return err;
+}
 
-/* copied from libnl3's recvmsgs() */
 static int
 event_handler_recvmsgs (NMPlatform *platform, gboolean handle_events)
 {
 	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
-	struct nl_sock *sk = priv->nlh;
-	int n, err = 0, multipart = 0, interrupted = 0;
+	int n, err = 0;
+	gboolean multipart = FALSE, interrupted = FALSE;
 	struct nlmsghdr *hdr;
-	WaitForNlResponseResult seq_result;
+	struct ucred creds;
+	gboolean creds_has;
 
-	/*
-	nla is passed on to not only to nl_recv() but may also be passed
-	to a function pointer provided by the caller which may or may not
-	initialize the variable. Thomas Graf.
-	*/
-	struct sockaddr_nl nla = {0};
-	nm_auto_free struct ucred *creds = NULL;
-	nm_auto_free unsigned char *buf = NULL;
+	if (priv->reader)
+		return event_handler_recvmsgs_reader (platform, handle_events);
 
 continue_reading:
-	g_clear_pointer (&buf, free);
-	g_clear_pointer (&creds, free);
-	errno = 0;
-	n = nl_recv (sk, &nla, &buf, &creds);
-
-	if (n <= 0) {
-		/* workaround libnl3 <= 3.2.15 returning danling pointers in case nl_recv()
-		 * fails. Fixed by libnl3 69468517d0de1675d80f24661ff57a5dbac7275c. */
-		buf = NULL;
-		creds = NULL;
-	}
-
-	switch (n) {
-	case 0:
-		/* Work around a libnl bug fixed in 3.2.22 (375a6294) */
-		if (errno == EAGAIN) {
-			/* EAGAIN is equal to EWOULDBLOCK. If it would not be, we'd have to
-			 * workaround libnl3 mapping EWOULDBLOCK to -NLE_FAILURE. */
-			G_STATIC_ASSERT (EAGAIN == EWOULDBLOCK);
-			n = -NLE_AGAIN;
-		}
-		break;
-	case -NLE_MSG_TRUNC: {
-		int buf_size;
+	n = _nl_recv (nl_socket_get_fd (priv->nlh),
+	              priv->nlh_recv_buf,
+	              priv->nlh_recv_buf_len,
+	              &creds,
+	              &creds_has);
 
+	if (n == -NLE_MSG_TRUNC) {
 		/* the message receive buffer was too small. We lost one message, which
 		 * is unfortunate. Try to double the buffer size for the next time. */
-		buf_size = nl_socket_get_msg_buf_size (sk);
-		if (buf_size < 512*1024) {
-			buf_size *= 2;
-			_LOGT ("netlink: recvmsg: increase message buffer size for recvmsg() to %d bytes", buf_size);
-			if (nl_socket_set_msg_buf_size (sk, buf_size) < 0)
-				nm_assert_not_reached ();
+		if (priv->nlh_recv_buf_len < 512*1024) {
+			priv->nlh_recv_buf_len *= 2;
+			_LOGT ("netlink: recvmsg: increase message buffer size for recvmsg() to %zu bytes", priv->nlh_recv_buf_len);
+			g_free (priv->nlh_recv_buf);
+			priv->nlh_recv_buf = g_malloc (priv->nlh_recv_buf_len);
 			if (!handle_events)
 				goto continue_reading;
 		}
 		n = -_NLE_MSG_TRUNC;
-		break;
-	}
-	case -NLE_NOMEM:
-		if (errno == ENOBUFS) {
-			/* we are very much interested in a overrun of the receive buffer.
-			 * nl_recv() maps all kinds of errors to NLE_NOMEM, so check also
-			 * for errno explicitly. And if so, hack our own return code to signal
-			 * the overrun. */
-			n = -_NLE_NM_NOBUFS;
-		}
-		break;
 	}
 
 	if (n <= 0)
 		return n;
 
-	hdr = (struct nlmsghdr *) buf;
+	hdr = (struct nlmsghdr *) priv->nlh_recv_buf;
 	while (nlmsg_ok (hdr, n)) {
-		nm_auto_nlmsg struct nl_msg *msg = NULL;
-		gboolean abort_parsing = FALSE;
-		gboolean process_valid_msg = FALSE;
-		guint32 seq_number;
-		char buf_nlmsghdr[400];
-
-		msg = nlmsg_convert (hdr);
-		if (!msg) {
-			err = -NLE_NOMEM;
-			goto out;
-		}
-
-		nlmsg_set_proto (msg, NETLINK_ROUTE);
-		nlmsg_set_src (msg, &nla);
-
-		if (!creds || creds->pid) {
-			if (creds)
-				_LOGT ("netlink: recvmsg: received non-kernel message (pid %d)", creds->pid);
+		if (!creds_has || creds.pid) {
+			if (creds_has)
+				_LOGT ("netlink: recvmsg: received non-kernel message (pid %d)", creds.pid);
 			else
 				_LOGT ("netlink: recvmsg: received message without credentials");
 			err = 0;
 			goto stop;
 		}
 
-		_LOGt ("netlink: recvmsg: new message %s",
-		       _nl_nlmsghdr_to_str (hdr, buf_nlmsghdr, sizeof (buf_nlmsghdr)));
-
-		if (creds)
-			nlmsg_set_creds (msg, creds);
-
-		if (hdr->nlmsg_flags & NLM_F_MULTI)
-			multipart = 1;
-
-		if (hdr->nlmsg_flags & NLM_F_DUMP_INTR) {
-			/*
-			 * We have to continue reading to clear
-			 * all messages until a NLMSG_DONE is
-			 * received and report the inconsistency.
-			 */
-			interrupted = 1;
-		}
-
-		/* Other side wishes to see an ack for this message */
-		if (hdr->nlmsg_flags & NLM_F_ACK) {
-			/* FIXME: implement */
-		}
-
-		seq_result = WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_UNKNOWN;
-
-		if (hdr->nlmsg_type == NLMSG_DONE) {
-			/* messages terminates a multipart message, this is
-			 * usually the end of a message and therefore we slip
-			 * out of the loop by default. the user may overrule
-			 * this action by skipping this packet. */
-			multipart = 0;
-			seq_result = WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK;
-		} else if (hdr->nlmsg_type == NLMSG_NOOP) {
-			/* Message to be ignored, the default action is to
-			 * skip this message if no callback is specified. The
-			 * user may overrule this action by returning
-			 * NL_PROCEED. */
-		} else if (hdr->nlmsg_type == NLMSG_OVERRUN) {
-			/* Data got lost, report back to user. The default action is to
-			 * quit parsing. The user may overrule this action by retuning
-			 * NL_SKIP or NL_PROCEED (dangerous) */
-			err = -NLE_MSG_OVERFLOW;
-			abort_parsing = TRUE;
-		} else if (hdr->nlmsg_type == NLMSG_ERROR) {
-			/* Message carries a nlmsgerr */
-			struct nlmsgerr *e = nlmsg_data (hdr);
-
-			if (hdr->nlmsg_len < nlmsg_size (sizeof (*e))) {
-				/* Truncated error message, the default action
-				 * is to stop parsing. The user may overrule
-				 * this action by returning NL_SKIP or
-				 * NL_PROCEED (dangerous) */
-				err = -NLE_MSG_TRUNC;
-				abort_parsing = TRUE;
-			} else if (e->error) {
-				int errsv = e->error > 0 ? e->error : -e->error;
-
-				/* Error message reported back from kernel. */
-				_LOGD ("netlink: recvmsg: error message from kernel: %s (%d) for request %d",
-				       strerror (errsv),
-				       errsv,
-				       nlmsg_hdr (msg)->nlmsg_seq);
-				seq_result = -errsv;
-			} else
-				seq_result = WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK;
-		} else
-			process_valid_msg = TRUE;
-
-		seq_number = nlmsg_hdr (msg)->nlmsg_seq;
-
-		/* check whether the seq number is different from before, and
-		 * whether the previous number (@nlh_seq_last_seen) is a pending
-		 * refresh-all request. In that case, the pending request is thereby
-		 * completed.
-		 *
-		 * We must do that before processing the message with event_valid_msg(),
-		 * because we must track the completion of the pending request before that. */
-		event_seq_check_refresh_all (platform, seq_number);
-
-		if (process_valid_msg) {
-			/* Valid message (not checking for MULTIPART bit to
-			 * get along with broken kernels. NL_SKIP has no
-			 * effect on this.  */
-
-			event_valid_msg (platform, msg, handle_events);
-
-			seq_result = WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK;
-		}
-
-		event_seq_check (platform, seq_number, seq_result);
-
-		if (abort_parsing)
+		if (!event_handler_recvmsg_one (platform,
+		                                hdr,
+		                                FALSE,
+		                                NULL,
+		                                FALSE,
+		                                handle_events,
+		                                &err,
+		                                &multipart,
+		                                &interrupted))
 			goto stop;
 
-		err = 0;
 		hdr = nlmsg_next (hdr, &n);
 	}
 
@@ -6787,7 +9309,6 @@ stop:
 		 * Repeat reading. */
 		goto continue_reading;
 	}
-out:
 	if (interrupted)
 		err = -NLE_DUMP_INTR;
 	return err;
@@ -6795,6 +9316,76 @@ out:
 
 /*****************************************************************************/
 
+/* the kernel queue for the event socket starts with 8 MB. Note that the kernel
+ * accounts the full size of the skbs, so it holds fewer bytes of messages. */
+#define NL_RCVBUF_SIZE_MIN  ((gsize) (8*1024*1024))
+#define NL_RCVBUF_SIZE_MAX  ((gsize) (128*1024*1024))
+
+static void
+_nl_socket_set_rcvbuf (NMPlatform *platform, gsize size)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	int fd = nl_socket_get_fd (priv->nlh);
+	int val;
+	socklen_t len;
+
+	size = CLAMP (size, NL_RCVBUF_SIZE_MIN, NL_RCVBUF_SIZE_MAX);
+	if (size <= priv->nlh_rcvbuf_requested)
+		return;
+	priv->nlh_rcvbuf_requested = size;
+
+	/* SO_RCVBUFFORCE is not limited by net.core.rmem_max, but requires
+	 * CAP_NET_ADMIN. Fall back to SO_RCVBUF otherwise. */
+	val = size;
+	if (   setsockopt (fd, SOL_SOCKET, SO_RCVBUFFORCE, &val, sizeof (val)) < 0
+	    && setsockopt (fd, SOL_SOCKET, SO_RCVBUF, &val, sizeof (val)) < 0) {
+		int errsv = errno;
+
+		_LOGD ("netlink: failed to set receive buffer size to %zu bytes: %s", size, strerror (errsv));
+	}
+
+	len = sizeof (val);
+	if (getsockopt (fd, SOL_SOCKET, SO_RCVBUF, &val, &len) == 0)
+		priv->nl_stats.rcvbuf_size = val;
+
+	_LOGD ("netlink: receive buffer size is %"G_GUINT64_FORMAT" bytes (requested %zu)",
+	       priv->nl_stats.rcvbuf_size, size);
+}
+
+/* called after we read all pending messages. If the backlog was large compared
+ * to the receive buffer, we were close to overflowing and grow the buffer. */
+static void
+_nl_socket_burst_done (NMPlatform *platform)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	guint64 burst = priv->nl_burst_bytes;
+
+	priv->nl_burst_bytes = 0;
+
+	if (burst > priv->nl_stats.peak_backlog)
+		priv->nl_stats.peak_backlog = burst;
+
+	if (burst * 2 > priv->nlh_rcvbuf_requested) {
+		_LOGT ("netlink: read a burst of %"G_GUINT64_FORMAT" bytes, grow receive buffer", burst);
+		_nl_socket_set_rcvbuf (platform, priv->nlh_rcvbuf_requested * 2);
+	}
+}
+
+static gboolean
+netlink_get_stats (NMPlatform *platform, NMPlatformNetlinkStats *out_stats)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+
+	*out_stats = priv->nl_stats;
+	if (priv->route_filter) {
+		out_stats->n_ip4_routes_filtered = (guint) g_atomic_int_get (&priv->route_filter->n_filtered[0]);
+		out_stats->n_ip6_routes_filtered = (guint) g_atomic_int_get (&priv->route_filter->n_filtered[1]);
+	}
+	return TRUE;
+}
+
+/*****************************************************************************/
+
 static gboolean
 event_handler_read_netlink (NMPlatform *platform, gboolean wait_for_acks)
 {
@@ -6825,10 +9416,17 @@ event_handler_read_netlink (NMPlatform *platform, gboolean wait_for_acks)
 				case -NLE_AGAIN:
 					goto after_read;
 				case -NLE_DUMP_INTR:
+					/* the interrupted dump was already requested again by _nl_dump_interrupted(). */
 					_LOGD ("netlink: read: uncritical failure to retrieve incoming events: %s (%d)", nl_geterror (nle), nle);
 					break;
 				case -_NLE_MSG_TRUNC:
 				case -_NLE_NM_NOBUFS:
+					if (nle == -_NLE_NM_NOBUFS) {
+						priv->nl_stats.n_overflows++;
+						_nl_socket_set_rcvbuf (platform, priv->nlh_rcvbuf_requested * 2);
+					} else
+						priv->nl_stats.n_truncated++;
+					priv->nl_stats.n_resyncs++;
 					_LOGI ("netlink: read: %s. Need to resynchronize platform cache",
 					       ({
 					            const char *_reason = "unknown";
@@ -6840,6 +9438,7 @@ event_handler_read_netlink (NMPlatform *platform, gboolean wait_for_acks)
 					       }));
 					event_handler_recvmsgs (platform, FALSE);
 					delayed_action_wait_for_nl_response_complete_all (platform, WAIT_FOR_NL_RESPONSE_RESULT_FAILED_RESYNC);
+					link_change_async_complete_all (platform, WAIT_FOR_NL_RESPONSE_RESULT_FAILED_RESYNC);
 					delayed_action_schedule (platform,
 					                         DELAYED_ACTION_TYPE_REFRESH_ALL_LINKS |
 					                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ADDRESSES |
@@ -6860,6 +9459,10 @@ event_handler_read_netlink (NMPlatform *platform, gboolean wait_for_acks)
 
 after_read:
 
+		_nl_socket_burst_done (platform);
+
+		link_change_async_check (platform);
+
 		if (!NM_FLAGS_HAS (priv->delayed_action.flags, DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE))
 			return any;
 
@@ -6898,7 +9501,9 @@ after_read:
 		timeout_ms = (data_next.timeout_abs_ns - now_ns) / (NM_UTILS_NS_PER_SECOND / 1000);
 
 		memset (&pfd, 0, sizeof (pfd));
-		pfd.fd = nl_socket_get_fd (priv->nlh);
+		pfd.fd = priv->reader
+		         ? priv->reader->fd_event
+		         : nl_socket_get_fd (priv->nlh);
 		pfd.events = POLLIN;
 		r = poll (&pfd, 1, MAX (1, timeout_ms));
 
@@ -7051,7 +9656,11 @@ nm_linux_platform_init (NMLinuxPlatform *self)
 	priv->delayed_action.list_master_connected = g_ptr_array_new ();
 	priv->delayed_action.list_refresh_link = g_ptr_array_new ();
 	priv->delayed_action.list_wait_for_nl_response = g_array_new (FALSE, TRUE, sizeof (DelayedActionWaitForNlResponseData));
+	priv->delayed_action.list_refresh_partial = g_array_new (FALSE, TRUE, sizeof (DelayedActionRefreshPartialData));
+	priv->pruning_partial = g_array_new (FALSE, TRUE, sizeof (DelayedActionRefreshPartialData));
 	priv->wifi_data = g_hash_table_new_full (NULL, NULL, NULL, (GDestroyNotify) wifi_utils_deinit);
+	c_list_init (&priv->async.pending_lst_head);
+	c_list_init (&priv->async.done_lst_head);
 }
 
 static void
@@ -7062,6 +9671,7 @@ constructed (GObject *_object)
 	int channel_flags;
 	gboolean status;
 	int nle;
+	gint64 ts;
 
 	nm_assert (!platform->_netns || platform->_netns == nmp_netns_get_current ());
 
@@ -7089,19 +9699,19 @@ constructed (GObject *_object)
 	nle = nl_socket_set_passcred (priv->nlh, 1);
 	g_assert (!nle);
 
+	priv->nlh_strict_chk = _support_netlink_strict_chk_detect (nl_socket_get_fd (priv->nlh));
+
 	/* No blocking for event socket, so that we can drain it safely. */
 	nle = nl_socket_set_nonblocking (priv->nlh);
 	g_assert (!nle);
 
-	/* use 8 MB for receive socket kernel queue. */
-	nle = nl_socket_set_buffer_size (priv->nlh, 8*1024*1024, 0);
-	g_assert (!nle);
+	/* the receive buffer grows later, if we see that it is too small. */
+	_nl_socket_set_rcvbuf (platform, NL_RCVBUF_SIZE_MIN);
 
-	/* explicitly set the msg buffer size and disable MSG_PEEK.
-	 * If we later encounter NLE_MSG_TRUNC, we will adjust the buffer size. */
-	nl_socket_disable_msg_peek (priv->nlh);
-	nle = nl_socket_set_msg_buf_size (priv->nlh, 32 * 1024);
-	g_assert (!nle);
+	/* we don't use nl_recv() but receive into our own buffer. If we later
+	 * encounter MSG_TRUNC, we will adjust the buffer size. */
+	priv->nlh_recv_buf_len = 32 * 1024;
+	priv->nlh_recv_buf = g_malloc (priv->nlh_recv_buf_len);
 
 	nle = nl_socket_add_memberships (priv->nlh,
 	                                 RTNLGRP_LINK,
@@ -7112,7 +9722,21 @@ constructed (GObject *_object)
 	g_assert (!nle);
 	_LOGD ("Netlink socket for events established: port=%u, fd=%d", nl_socket_get_local_port (priv->nlh), nl_socket_get_fd (priv->nlh));
 
-	priv->event_channel = g_io_channel_unix_new (nl_socket_get_fd (priv->nlh));
+	if (priv->route_filter_spec)
+		priv->route_filter = _route_filter_new (platform, priv->route_filter_spec);
+
+	if (priv->netlink_thread) {
+		/* from now on, only the reader thread receives from the socket. The main
+		 * thread gets woken up via the reader's eventfd. */
+		priv->reader = netlink_reader_start (nl_socket_get_fd (priv->nlh),
+		                                     priv->nlh_recv_buf_len,
+		                                     priv->route_filter);
+		_LOGD ("netlink: receive and parse messages on a reader thread");
+	}
+
+	priv->event_channel = g_io_channel_unix_new (priv->reader
+	                                             ? priv->reader->fd_event
+	                                             : nl_socket_get_fd (priv->nlh));
 	g_io_channel_set_encoding (priv->event_channel, NULL, NULL);
 
 	channel_flags = g_io_channel_get_flags (priv->event_channel);
@@ -7127,6 +9751,7 @@ constructed (GObject *_object)
 	G_OBJECT_CLASS (nm_linux_platform_parent_class)->constructed (_object);
 
 	_LOGD ("populate platform cache");
+	ts = nm_utils_get_monotonic_timestamp_ns ();
 	delayed_action_schedule (platform,
 	                         DELAYED_ACTION_TYPE_REFRESH_ALL_LINKS |
 	                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ADDRESSES |
@@ -7138,11 +9763,16 @@ constructed (GObject *_object)
 	                         NULL);
 
 	delayed_action_handle_all (platform, FALSE);
+	_LOGD ("populate platform cache: done in %"G_GINT64_FORMAT" msec",
+	       (nm_utils_get_monotonic_timestamp_ns () - ts) / NM_UTILS_NS_PER_MSEC);
 
 	/* Set up udev monitoring */
 	if (priv->udev_client) {
 		struct udev_enumerate *enumerator;
 		struct udev_list_entry *devices, *l;
+		guint n_devices = 0;
+
+		ts = nm_utils_get_monotonic_timestamp_ns ();
 
 		/* And read initial device list */
 		enumerator = nm_udev_client_enumerate_new (priv->udev_client);
@@ -7162,9 +9792,13 @@ constructed (GObject *_object)
 
 			udev_device_added (platform, udevice);
 			udev_device_unref (udevice);
+			n_devices++;
 		}
 
 		udev_enumerate_unref (enumerator);
+		_LOGD ("udev: enumerated %u devices in %"G_GINT64_FORMAT" msec",
+		       n_devices,
+		       (nm_utils_get_monotonic_timestamp_ns () - ts) / NM_UTILS_NS_PER_MSEC);
 	}
 }
 
@@ -7177,10 +9811,14 @@ dispose (GObject *object)
 	_LOGD ("dispose");
 
 	delayed_action_wait_for_nl_response_complete_all (platform, WAIT_FOR_NL_RESPONSE_RESULT_FAILED_DISPOSING);
+	link_change_async_complete_all (platform, WAIT_FOR_NL_RESPONSE_RESULT_FAILED_DISPOSING);
+	link_change_async_dispatch (platform, FALSE);
 
 	priv->delayed_action.flags = DELAYED_ACTION_TYPE_NONE;
 	g_ptr_array_set_size (priv->delayed_action.list_master_connected, 0);
 	g_ptr_array_set_size (priv->delayed_action.list_refresh_link, 0);
+	g_array_set_size (priv->delayed_action.list_refresh_partial, 0);
+	g_array_set_size (priv->pruning_partial, 0);
 
 	G_OBJECT_CLASS (nm_linux_platform_parent_class)->dispose (object);
 }
@@ -7193,29 +9831,64 @@ finalize (GObject *object)
 	g_ptr_array_unref (priv->delayed_action.list_master_connected);
 	g_ptr_array_unref (priv->delayed_action.list_refresh_link);
 	g_array_unref (priv->delayed_action.list_wait_for_nl_response);
+	g_array_unref (priv->delayed_action.list_refresh_partial);
+	g_array_unref (priv->pruning_partial);
 
 	g_source_remove (priv->event_id);
 	g_io_channel_unref (priv->event_channel);
+	if (priv->reader)
+		netlink_reader_stop (g_steal_pointer (&priv->reader));
 	nl_socket_free (priv->nlh);
+	if (priv->route_filter)
+		_route_filter_free (priv->route_filter);
+	g_free (priv->route_filter_spec);
+	g_free (priv->nlh_recv_buf);
 
 	g_hash_table_unref (priv->wifi_data);
 
+	link_facts_clear ((NMPlatform *) object);
+
 	if (priv->sysctl_get_prev_values) {
 		sysctl_clear_cache_list = g_slist_remove (sysctl_clear_cache_list, object);
 		g_hash_table_destroy (priv->sysctl_get_prev_values);
 	}
 
+	if (priv->sysctl_ifaces)
+		g_hash_table_destroy (priv->sysctl_ifaces);
+
 	priv->udev_client = nm_udev_client_unref (priv->udev_client);
 
 	G_OBJECT_CLASS (nm_linux_platform_parent_class)->finalize (object);
 }
 
+static void
+set_property (GObject *object, guint prop_id,
+              const GValue *value, GParamSpec *pspec)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (object);
+
+	switch (prop_id) {
+	case PROP_NETLINK_THREAD:
+		/* construct-only */
+		priv->netlink_thread = g_value_get_boolean (value);
+		break;
+	case PROP_ROUTE_FILTER:
+		/* construct-only */
+		priv->route_filter_spec = g_value_dup_string (value);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+		break;
+	}
+}
+
 static void
 nm_linux_platform_class_init (NMLinuxPlatformClass *klass)
 {
 	GObjectClass *object_class = G_OBJECT_CLASS (klass);
 	NMPlatformClass *platform_class = NM_PLATFORM_CLASS (klass);
 
+	object_class->set_property = set_property;
 	object_class->constructed = constructed;
 	object_class->dispose = dispose;
 	object_class->finalize = finalize;
@@ -7227,10 +9900,12 @@ nm_linux_platform_class_init (NMLinuxPlatformClass *klass)
 	platform_class->link_delete = link_delete;
 
 	platform_class->link_refresh = link_refresh;
+	platform_class->link_get_all_stats = link_get_all_stats;
 
 	platform_class->link_set_netns = link_set_netns;
 
 	platform_class->link_set_up = link_set_up;
+	platform_class->link_set_up_async = link_set_up_async;
 	platform_class->link_set_down = link_set_down;
 	platform_class->link_set_arp = link_set_arp;
 	platform_class->link_set_noarp = link_set_noarp;
@@ -7243,6 +9918,7 @@ nm_linux_platform_class_init (NMLinuxPlatformClass *klass)
 	platform_class->link_set_address = link_set_address;
 	platform_class->link_get_permanent_address = link_get_permanent_address;
 	platform_class->link_set_mtu = link_set_mtu;
+	platform_class->link_set_mtu_async = link_set_mtu_async;
 	platform_class->link_set_name = link_set_name;
 	platform_class->link_set_sriov_num_vfs = link_set_sriov_num_vfs;
 
@@ -7254,6 +9930,8 @@ nm_linux_platform_class_init (NMLinuxPlatformClass *klass)
 	platform_class->link_supports_carrier_detect = link_supports_carrier_detect;
 	platform_class->link_supports_vlans = link_supports_vlans;
 	platform_class->link_supports_sriov = link_supports_sriov;
+	platform_class->link_facts_prefetch = link_facts_prefetch;
+	platform_class->link_facts_clear = link_facts_clear;
 
 	platform_class->link_enslave = link_enslave;
 	platform_class->link_release = link_release;
@@ -7292,6 +9970,9 @@ nm_linux_platform_class_init (NMLinuxPlatformClass *klass)
 	platform_class->link_sit_add = link_sit_add;
 
 	platform_class->object_delete = object_delete;
+	platform_class->transaction_commit = transaction_commit;
+	platform_class->netlink_get_stats = netlink_get_stats;
+	platform_class->sysctl_get_stats = sysctl_get_stats;
 	platform_class->ip4_address_add = ip4_address_add;
 	platform_class->ip6_address_add = ip6_address_add;
 	platform_class->ip4_address_delete = ip4_address_delete;
@@ -7306,5 +9987,21 @@ nm_linux_platform_class_init (NMLinuxPlatformClass *klass)
 	platform_class->check_kernel_support = check_kernel_support;
 
 	platform_class->process_events = process_events;
+
+	g_object_class_install_property
+	 (object_class, PROP_NETLINK_THREAD,
+	     g_param_spec_boolean (NM_LINUX_PLATFORM_NETLINK_THREAD, "", "",
+	                           FALSE,
+	                           G_PARAM_WRITABLE |
+	                           G_PARAM_CONSTRUCT_ONLY |
+	                           G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property
+	 (object_class, PROP_ROUTE_FILTER,
+	     g_param_spec_string (NM_LINUX_PLATFORM_ROUTE_FILTER, "", "",
+	                          NULL,
+	                          G_PARAM_WRITABLE |
+	                          G_PARAM_CONSTRUCT_ONLY |
+	                          G_PARAM_STATIC_STRINGS));
 }
 
@@ -30,6 +30,9 @@
 #define NM_IS_LINUX_PLATFORM_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), NM_TYPE_LINUX_PLATFORM))
 #define NM_LINUX_PLATFORM_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS ((obj), NM_TYPE_LINUX_PLATFORM, NMLinuxPlatformClass))
 
+#define NM_LINUX_PLATFORM_NETLINK_THREAD "netlink-thread"
+#define NM_LINUX_PLATFORM_ROUTE_FILTER   "route-filter"
+
 typedef struct _NMLinuxPlatform NMLinuxPlatform;
 typedef struct _NMLinuxPlatformClass NMLinuxPlatformClass;
 
@@ -38,5 +41,24 @@ GType nm_linux_platform_get_type (void);
 NMPlatform *nm_linux_platform_new (gboolean log_with_ptr, gboolean netns_support);
 
 void nm_linux_platform_setup (void);
+void nm_linux_platform_setup_threaded (void);
+void nm_linux_platform_setup_full (gboolean netlink_thread, const char *route_filter);
+
+/*****************************************************************************/
+
+struct nlmsghdr;
+struct _NMPCache;
+
+/* exposed for unit tests (and benchmarking the netlink parser). */
+NMPObject *nmp_object_new_from_nl (NMPlatform *platform,
+                                   const struct _NMPCache *cache,
+                                   struct nlmsghdr *msghdr,
+                                   gboolean id_only);
+
+void _nmtst_linux_platform_refresh_partial (NMPlatform *platform,
+                                            NMPObjectType obj_type,
+                                            int ifindex,
+                                            guint32 table);
+void _nmtst_linux_platform_interrupt_next_dump (NMPlatform *platform);
 
 #endif /* __NETWORKMANAGER_LINUX_PLATFORM_H__ */
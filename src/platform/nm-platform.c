@@ -38,6 +38,7 @@
 #include "nm-core-internal.h"
 #include "nm-utils/nm-dedup-multi.h"
 #include "nm-utils/nm-udev-utils.h"
+#include "nm-utils/c-list.h"
 
 #include "nm-core-utils.h"
 #include "nm-platform-utils.h"
@@ -100,6 +101,26 @@ typedef struct _NMPlatformPrivate {
 	GHashTable *ip4_dev_route_blacklist_hash;
 	NMDedupMultiIndex *multi_idx;
 	NMPCache *cache;
+
+	/* the LinkStatsGroup instances, one per refresh rate. */
+	CList link_stats_groups_lst_head;
+
+	/* coalescing of change signals, see nm_platform_changes_subscribe(). */
+	struct {
+		guint window_ms;
+		guint max_latency_ms;
+		guint timeout_id;
+
+		/* the timestamps of the first and the last event of the window. */
+		gint64 first_ns;
+		gint64 last_ns;
+
+		/* int ifindex -> ChangesIfindex */
+		GHashTable *subscriptions;
+
+		/* int ifindex -> NMPlatformChangeSet, for the current window. */
+		GHashTable *pending;
+	} changes;
 } NMPlatformPrivate;
 
 G_DEFINE_TYPE (NMPlatform, nm_platform, G_TYPE_OBJECT)
@@ -746,17 +767,6 @@ nm_platform_link_get_by_ifname (NMPlatform *self, const char *ifname)
 	return NMP_OBJECT_CAST_LINK (obj);
 }
 
-struct _nm_platform_link_get_by_address_data {
-	gconstpointer address;
-	guint8 length;
-};
-
-static gboolean
-_nm_platform_link_get_by_address_match_link (const NMPObject *obj, struct _nm_platform_link_get_by_address_data *d)
-{
-	return obj->link.addr.len == d->length && !memcmp (obj->link.addr.data, d->address, d->length);
-}
-
 /**
  * nm_platform_link_get_by_address:
  * @self: platform instance
@@ -771,11 +781,9 @@ nm_platform_link_get_by_address (NMPlatform *self,
                                  gconstpointer address,
                                  size_t length)
 {
-	const NMPObject *obj;
-	struct _nm_platform_link_get_by_address_data d = {
-		.address = address,
-		.length = length,
-	};
+	NMPLookup lookup;
+	NMDedupMultiIter iter;
+	const NMPlatformLink *link;
 
 	_CHECK_SELF (self, klass, NULL);
 
@@ -787,10 +795,14 @@ nm_platform_link_get_by_address (NMPlatform *self,
 	if (!address)
 		g_return_val_if_reached (NULL);
 
-	obj = nmp_cache_lookup_link_full (nm_platform_get_cache (self),
-	                                  0, NULL, TRUE, NM_LINK_TYPE_NONE,
-	                                  (NMPObjectMatchFn) _nm_platform_link_get_by_address_match_link, &d);
-	return NMP_OBJECT_CAST_LINK (obj);
+	nmp_lookup_init_link_by_address (&lookup, address, length);
+	nmp_cache_iter_for_each_link (&iter,
+	                              nmp_cache_lookup (nm_platform_get_cache (self), &lookup),
+	                              &link) {
+		if (nmp_object_is_visible (NMP_OBJECT_UP_CAST (link)))
+			return link;
+	}
+	return NULL;
 }
 
 static NMPlatformError
@@ -1137,6 +1149,221 @@ nm_platform_link_refresh (NMPlatform *self, int ifindex)
 	return TRUE;
 }
 
+/*****************************************************************************/
+
+/* All subscriptions with the same refresh rate share one group. The group
+ * fetches the counters of all links at once, and passes them to every
+ * subscriber. That is one netlink request and one wakeup per period,
+ * instead of one per subscriber. */
+typedef struct {
+	CList groups_lst;
+	CList subscriptions_lst_head;
+	NMPlatform *platform;
+	guint refresh_rate_ms;
+	guint timeout_id;
+
+	/* while invoking the callbacks, the next subscription to call. */
+	CList *iter_next;
+	bool collecting:1;
+} LinkStatsGroup;
+
+struct _NMPlatformLinkStatsSubscription {
+	CList subscriptions_lst;
+	LinkStatsGroup *group;
+	NMPlatformLinkStatsCb callback;
+	gpointer user_data;
+};
+
+static int
+_link_stats_cmp (gconstpointer a, gconstpointer b)
+{
+	const NMPlatformLinkStats *s_a = a;
+	const NMPlatformLinkStats *s_b = b;
+
+	return s_a->ifindex < s_b->ifindex ? -1 : (s_a->ifindex > s_b->ifindex ? 1 : 0);
+}
+
+/**
+ * nm_platform_link_get_all_stats:
+ * @self: platform instance
+ *
+ * Fetch the traffic counters of all links from kernel at once. If the platform
+ * cannot do that, the counters of the cached links are returned.
+ *
+ * Returns: (transfer full): an array of #NMPlatformLinkStats, sorted
+ *   by ifindex.
+ */
+GArray *
+nm_platform_link_get_all_stats (NMPlatform *self)
+{
+	GArray *stats;
+
+	_CHECK_SELF (self, klass, NULL);
+
+	stats = g_array_new (FALSE, FALSE, sizeof (NMPlatformLinkStats));
+
+	if (   !klass->link_get_all_stats
+	    || !klass->link_get_all_stats (self, stats)) {
+		NMDedupMultiIter iter;
+		const NMPlatformLink *link;
+
+		g_array_set_size (stats, 0);
+		nmp_cache_iter_for_each_link (&iter,
+		                              nm_platform_lookup_obj_type (self, NMP_OBJECT_TYPE_LINK),
+		                              &link) {
+			NMPlatformLinkStats *s;
+
+			g_array_set_size (stats, stats->len + 1);
+			s = &g_array_index (stats, NMPlatformLinkStats, stats->len - 1);
+			s->ifindex = link->ifindex;
+			s->rx_packets = link->rx_packets;
+			s->rx_bytes = link->rx_bytes;
+			s->tx_packets = link->tx_packets;
+			s->tx_bytes = link->tx_bytes;
+		}
+	}
+
+	g_array_sort (stats, _link_stats_cmp);
+	return stats;
+}
+
+const NMPlatformLinkStats *
+nm_platform_link_stats_lookup (const GArray *stats, int ifindex)
+{
+	NMPlatformLinkStats needle = {
+		.ifindex = ifindex,
+	};
+
+	if (!stats || ifindex <= 0)
+		return NULL;
+
+	return bsearch (&needle,
+	                stats->data,
+	                stats->len,
+	                sizeof (NMPlatformLinkStats),
+	                _link_stats_cmp);
+}
+
+static void
+_link_stats_group_free (LinkStatsGroup *group)
+{
+	nm_assert (c_list_is_empty (&group->subscriptions_lst_head));
+
+	c_list_unlink (&group->groups_lst);
+	nm_clear_g_source (&group->timeout_id);
+	g_slice_free (LinkStatsGroup, group);
+}
+
+static gboolean
+_link_stats_group_timeout_cb (gpointer user_data)
+{
+	LinkStatsGroup *group = user_data;
+	NMPlatform *self = group->platform;
+	gs_unref_array GArray *stats = NULL;
+	NMPlatformLinkStatsSubscription *sub;
+	CList *iter;
+
+	stats = nm_platform_link_get_all_stats (self);
+
+	_LOGT ("link-stats: refresh %u links every %u ms",
+	       stats->len, group->refresh_rate_ms);
+
+	/* subscribers might unsubscribe themselves or others during the callback.
+	 * nm_platform_link_stats_unsubscribe() advances @iter_next, and the group
+	 * is only freed afterwards. */
+	group->collecting = TRUE;
+	for (iter = group->subscriptions_lst_head.next;
+	     iter != &group->subscriptions_lst_head;
+	     iter = group->iter_next) {
+		sub = c_list_entry (iter, NMPlatformLinkStatsSubscription, subscriptions_lst);
+		group->iter_next = iter->next;
+		sub->callback (self, stats, sub->user_data);
+	}
+	group->iter_next = NULL;
+	group->collecting = FALSE;
+
+	if (c_list_is_empty (&group->subscriptions_lst_head)) {
+		group->timeout_id = 0;
+		_link_stats_group_free (group);
+		return G_SOURCE_REMOVE;
+	}
+	return G_SOURCE_CONTINUE;
+}
+
+/**
+ * nm_platform_link_stats_subscribe:
+ * @self: platform instance
+ * @refresh_rate_ms: how often to fetch the counters
+ * @callback: called with the counters of all links, every @refresh_rate_ms.
+ * @user_data: user data for @callback
+ *
+ * All subscriptions with the same @refresh_rate_ms are served by a single
+ * request for the counters of all links.
+ *
+ * Returns: the subscription handle. Release it with
+ *   nm_platform_link_stats_unsubscribe().
+ */
+NMPlatformLinkStatsSubscription *
+nm_platform_link_stats_subscribe (NMPlatform *self,
+                                  guint refresh_rate_ms,
+                                  NMPlatformLinkStatsCb callback,
+                                  gpointer user_data)
+{
+	NMPlatformPrivate *priv;
+	NMPlatformLinkStatsSubscription *sub;
+	LinkStatsGroup *group;
+
+	_CHECK_SELF (self, klass, NULL);
+
+	g_return_val_if_fail (refresh_rate_ms > 0, NULL);
+	g_return_val_if_fail (callback, NULL);
+
+	priv = NM_PLATFORM_GET_PRIVATE (self);
+
+	c_list_for_each_entry (group, &priv->link_stats_groups_lst_head, groups_lst) {
+		if (group->refresh_rate_ms == refresh_rate_ms)
+			goto found;
+	}
+
+	group = g_slice_new0 (LinkStatsGroup);
+	c_list_init (&group->subscriptions_lst_head);
+	c_list_link_tail (&priv->link_stats_groups_lst_head, &group->groups_lst);
+	group->platform = self;
+	group->refresh_rate_ms = refresh_rate_ms;
+	group->timeout_id = g_timeout_add (refresh_rate_ms, _link_stats_group_timeout_cb, group);
+
+found:
+	sub = g_slice_new0 (NMPlatformLinkStatsSubscription);
+	sub->group = group;
+	sub->callback = callback;
+	sub->user_data = user_data;
+	c_list_link_tail (&group->subscriptions_lst_head, &sub->subscriptions_lst);
+	return sub;
+}
+
+void
+nm_platform_link_stats_unsubscribe (NMPlatform *self,
+                                    NMPlatformLinkStatsSubscription *subscription)
+{
+	LinkStatsGroup *group;
+
+	_CHECK_SELF_VOID (self, klass);
+
+	g_return_if_fail (subscription);
+
+	group = subscription->group;
+	nm_assert (group->platform == self);
+
+	if (group->iter_next == &subscription->subscriptions_lst)
+		group->iter_next = subscription->subscriptions_lst.next;
+	c_list_unlink (&subscription->subscriptions_lst);
+	g_slice_free (NMPlatformLinkStatsSubscription, subscription);
+
+	if (   !group->collecting
+	    && c_list_is_empty (&group->subscriptions_lst_head))
+		_link_stats_group_free (group);
+}
+
 static guint
 _link_get_flags (NMPlatform *self, int ifindex)
 {
@@ -1409,6 +1636,39 @@ nm_platform_link_supports_sriov (NMPlatform *self, int ifindex)
 	return klass->link_supports_sriov (self, ifindex);
 }
 
+/**
+ * nm_platform_link_facts_prefetch:
+ * @self: platform instance
+ * @ifindexes: the links to prefetch the facts for
+ * @n_ifindexes: the number of entries in @ifindexes
+ *
+ * Gathers the driver info, the permanent address and SR-IOV support of
+ * the links in one batch, so that the following calls of
+ * nm_platform_link_get_driver_info(), nm_platform_link_get_permanent_address()
+ * and nm_platform_link_supports_sriov() for them don't block. The platform
+ * may do that in parallel. The facts are kept until
+ * nm_platform_link_facts_clear() or the next prefetch.
+ */
+void
+nm_platform_link_facts_prefetch (NMPlatform *self, const int *ifindexes, guint n_ifindexes)
+{
+	_CHECK_SELF_VOID (self, klass);
+
+	g_return_if_fail (ifindexes || n_ifindexes == 0);
+
+	if (klass->link_facts_prefetch)
+		klass->link_facts_prefetch (self, ifindexes, n_ifindexes);
+}
+
+void
+nm_platform_link_facts_clear (NMPlatform *self)
+{
+	_CHECK_SELF_VOID (self, klass);
+
+	if (klass->link_facts_clear)
+		klass->link_facts_clear (self);
+}
+
 gboolean
 nm_platform_link_set_sriov_num_vfs (NMPlatform *self, int ifindex, guint num_vfs)
 {
@@ -1423,6 +1683,42 @@ nm_platform_link_set_sriov_num_vfs (NMPlatform *self, int ifindex, guint num_vfs
 	return klass->link_set_sriov_num_vfs (self, ifindex, num_vfs);
 }
 
+/* For platform implementations without asynchronous requests, do
+ * the request synchronously and report the result from an idle handler. */
+typedef struct {
+	NMPlatform *self;
+	NMPlatformError result;
+	NMPlatformAsyncCallback callback;
+	gpointer user_data;
+} AsyncResultData;
+
+static gboolean
+_async_result_idle_cb (gpointer user_data)
+{
+	AsyncResultData *data = user_data;
+
+	data->callback (data->self, data->result, data->user_data);
+	g_object_unref (data->self);
+	g_slice_free (AsyncResultData, data);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+_async_result_complete_in_idle (NMPlatform *self,
+                                NMPlatformError result,
+                                NMPlatformAsyncCallback callback,
+                                gpointer user_data)
+{
+	AsyncResultData *data;
+
+	data = g_slice_new (AsyncResultData);
+	data->self = g_object_ref (self);
+	data->result = result;
+	data->callback = callback;
+	data->user_data = user_data;
+	g_idle_add (_async_result_idle_cb, data);
+}
+
 /**
  * nm_platform_link_set_up:
  * @self: platform instance
@@ -1442,6 +1738,48 @@ nm_platform_link_set_up (NMPlatform *self, int ifindex, gboolean *out_no_firmwar
 	return klass->link_set_up (self, ifindex, out_no_firmware);
 }
 
+/**
+ * nm_platform_link_set_up_async:
+ * @self: platform instance
+ * @ifindex: Interface index
+ * @callback: invoked with the result. %NM_PLATFORM_ERROR_NO_FIRMWARE
+ *   means that the firmware is missing.
+ * @user_data: user data for @callback
+ *
+ * Bring the interface up, without waiting for kernel to acknowledge
+ * the request. When @callback is invoked, the platform cache already
+ * contains the updated link.
+ */
+void
+nm_platform_link_set_up_async (NMPlatform *self,
+                               int ifindex,
+                               NMPlatformAsyncCallback callback,
+                               gpointer user_data)
+{
+	gboolean no_firmware = FALSE;
+	NMPlatformError result;
+
+	_CHECK_SELF_VOID (self, klass);
+
+	g_return_if_fail (ifindex > 0);
+	g_return_if_fail (callback);
+
+	_LOGD ("link: setting up %s (%d) (async)", nm_strquote_a (25, nm_platform_link_get_name (self, ifindex)), ifindex);
+
+	if (klass->link_set_up_async) {
+		klass->link_set_up_async (self, ifindex, callback, user_data);
+		return;
+	}
+
+	if (klass->link_set_up (self, ifindex, &no_firmware))
+		result = NM_PLATFORM_ERROR_SUCCESS;
+	else if (no_firmware)
+		result = NM_PLATFORM_ERROR_NO_FIRMWARE;
+	else
+		result = NM_PLATFORM_ERROR_UNSPECIFIED;
+	_async_result_complete_in_idle (self, result, callback, user_data);
+}
+
 /**
  * nm_platform_link_set_down:
  * @self: platform instance
@@ -1516,6 +1854,44 @@ nm_platform_link_set_mtu (NMPlatform *self, int ifindex, guint32 mtu)
 	return klass->link_set_mtu (self, ifindex, mtu);
 }
 
+/**
+ * nm_platform_link_set_mtu_async:
+ * @self: platform instance
+ * @ifindex: Interface index
+ * @mtu: The new MTU value
+ * @callback: invoked with the result, like the return value of
+ *   nm_platform_link_set_mtu().
+ * @user_data: user data for @callback
+ *
+ * Set interface MTU, without waiting for kernel to acknowledge
+ * the request.
+ */
+void
+nm_platform_link_set_mtu_async (NMPlatform *self,
+                                int ifindex,
+                                guint32 mtu,
+                                NMPlatformAsyncCallback callback,
+                                gpointer user_data)
+{
+	_CHECK_SELF_VOID (self, klass);
+
+	g_return_if_fail (ifindex > 0);
+	g_return_if_fail (mtu > 0);
+	g_return_if_fail (callback);
+
+	_LOGD ("link: setting '%s' (%d) mtu %"G_GUINT32_FORMAT" (async)", nm_platform_link_get_name (self, ifindex), ifindex, mtu);
+
+	if (klass->link_set_mtu_async) {
+		klass->link_set_mtu_async (self, ifindex, mtu, callback, user_data);
+		return;
+	}
+
+	_async_result_complete_in_idle (self,
+	                                klass->link_set_mtu (self, ifindex, mtu),
+	                                callback,
+	                                user_data);
+}
+
 /**
  * nm_platform_link_get_mtu:
  * @self: platform instance
@@ -3305,6 +3681,8 @@ nm_platform_ip4_address_sync (NMPlatform *self,
 	GHashTable *plat_subnets = NULL;
 	GHashTable *known_subnets = NULL;
 	gs_unref_hashtable GHashTable *known_addresses_idx = NULL;
+	gs_unref_array GArray *transaction = NULL;
+	gs_free guint *known_idx = NULL;
 	guint i, j, len;
 	NMPLookup lookup;
 	guint32 lifetime, preferred;
@@ -3388,10 +3766,9 @@ delete_and_next:
 			}
 		}
 
-		nm_platform_ip4_address_delete (self, ifindex,
-		                                plat_address->address,
-		                                plat_address->plen,
-		                                plat_address->peer_address);
+		if (!transaction)
+			transaction = nm_platform_transaction_new (len);
+		nm_platform_transaction_append (transaction, NMP_TRANSACTION_OP_TYPE_DELETE, plat_obj);
 
 		if (   !ip4_addr_subnets_is_secondary (plat_obj, plat_subnets, plat_addresses, &addr_list)
 		    && addr_list) {
@@ -3408,13 +3785,7 @@ delete_and_next:
 				nm_assert (o);
 
 				if (*o) {
-					const NMPlatformIP4Address *a;
-
-					a = NMP_OBJECT_CAST_IP4_ADDRESS (*o);
-					nm_platform_ip4_address_delete (self, ifindex,
-					                                a->address,
-					                                a->plen,
-					                                a->peer_address);
+					nm_platform_transaction_append (transaction, NMP_TRANSACTION_OP_TYPE_DELETE, *o);
 					nmp_object_unref (*o);
 					*o = NULL;
 				}
@@ -3424,6 +3795,11 @@ delete_and_next:
 	ip4_addr_subnets_destroy_index (plat_subnets, plat_addresses);
 	ip4_addr_subnets_destroy_index (known_subnets, known_addresses);
 
+	if (transaction) {
+		nm_platform_transaction_commit (self, transaction);
+		g_array_set_size (transaction, 0);
+	}
+
 	if (!known_addresses)
 		return TRUE;
 
@@ -3432,8 +3808,10 @@ delete_and_next:
 	            : 0;
 
 	/* Add missing addresses */
+	known_idx = g_new (guint, known_addresses->len);
 	for (i = 0; i < known_addresses->len; i++) {
 		const NMPObject *o;
+		NMPlatformTransactionOp *op;
 
 		o = known_addresses->pdata[i];
 		if (!o)
@@ -3441,19 +3819,35 @@ delete_and_next:
 
 		known_address = NMP_OBJECT_CAST_IP4_ADDRESS (o);
 
+		nm_assert (known_address->ifindex == ifindex);
+
 		if (!nm_utils_lifetime_get (known_address->timestamp, known_address->lifetime, known_address->preferred,
-		                            now, &lifetime, &preferred))
-			goto delete_and_next2;
+		                            now, &lifetime, &preferred)) {
+			nmp_object_unref (o);
+			known_addresses->pdata[i] = NULL;
+			continue;
+		}
 
-		if (!nm_platform_ip4_address_add (self, ifindex, known_address->address, known_address->plen,
-		                                  known_address->peer_address, lifetime, preferred,
-		                                  ifa_flags,
-		                                  known_address->label))
-			goto delete_and_next2;
+		if (!transaction)
+			transaction = nm_platform_transaction_new (known_addresses->len);
+		known_idx[transaction->len] = i;
+		op = nm_platform_transaction_append (transaction, NMP_TRANSACTION_OP_TYPE_ADD, o);
+		op->lifetime = lifetime;
+		op->preferred = preferred;
+		op->ifa_flags = ifa_flags;
+	}
+
+	if (!transaction)
+		return TRUE;
+
+	nm_platform_transaction_commit (self, transaction);
 
-		continue;
-delete_and_next2:
-		nmp_object_unref (o);
+	for (j = 0; j < transaction->len; j++) {
+		if (g_array_index (transaction, NMPlatformTransactionOp, j).result == NM_PLATFORM_ERROR_SUCCESS)
+			continue;
+
+		i = known_idx[j];
+		nmp_object_unref (known_addresses->pdata[i]);
 		known_addresses->pdata[i] = NULL;
 	}
 
@@ -3481,6 +3875,7 @@ nm_platform_ip6_address_sync (NMPlatform *self,
                               gboolean keep_link_local)
 {
 	gs_unref_ptrarray GPtrArray *plat_addresses = NULL;
+	gs_unref_array GArray *transaction = NULL;
 	NMPlatformIP6Address *address;
 	gint32 now = nm_utils_get_monotonic_timestamp_s ();
 	guint i;
@@ -3501,11 +3896,19 @@ nm_platform_ip6_address_sync (NMPlatform *self,
 			if (keep_link_local && IN6_IS_ADDR_LINKLOCAL (&address->address))
 				continue;
 
-			if (!array_contains_ip6_address (known_addresses, address, now))
-				nm_platform_ip6_address_delete (self, ifindex, address->address, address->plen);
+			if (!array_contains_ip6_address (known_addresses, address, now)) {
+				if (!transaction)
+					transaction = nm_platform_transaction_new (plat_addresses->len);
+				nm_platform_transaction_append (transaction, NMP_TRANSACTION_OP_TYPE_DELETE, plat_addresses->pdata[i]);
+			}
 		}
 	}
 
+	if (transaction) {
+		nm_platform_transaction_commit (self, transaction);
+		g_array_set_size (transaction, 0);
+	}
+
 	if (!known_addresses)
 		return TRUE;
 
@@ -3516,8 +3919,11 @@ nm_platform_ip6_address_sync (NMPlatform *self,
 	/* Add missing addresses */
 	for (i = 0; i < known_addresses->len; i++) {
 		const NMPlatformIP6Address *known_address = NMP_OBJECT_CAST_IP6_ADDRESS (known_addresses->pdata[i]);
+		NMPlatformTransactionOp *op;
 		guint32 lifetime, preferred;
 
+		nm_assert (known_address->ifindex == ifindex);
+
 		if (NM_FLAGS_HAS (known_address->n_ifa_flags, IFA_F_TEMPORARY)) {
 			/* Kernel manages these */
 			continue;
@@ -3527,14 +3933,18 @@ nm_platform_ip6_address_sync (NMPlatform *self,
 		                            now, &lifetime, &preferred))
 			continue;
 
-		if (!nm_platform_ip6_address_add (self, ifindex, known_address->address,
-		                                  known_address->plen, known_address->peer_address,
-		                                  lifetime, preferred,
-		                                  ifa_flags | known_address->n_ifa_flags))
-			return FALSE;
+		if (!transaction)
+			transaction = nm_platform_transaction_new (known_addresses->len);
+		op = nm_platform_transaction_append (transaction, NMP_TRANSACTION_OP_TYPE_ADD, known_addresses->pdata[i]);
+		op->lifetime = lifetime;
+		op->preferred = preferred;
+		op->ifa_flags = ifa_flags | known_address->n_ifa_flags;
 	}
 
-	return TRUE;
+	if (!transaction)
+		return TRUE;
+
+	return nm_platform_transaction_commit (self, transaction);
 }
 
 gboolean
@@ -3673,6 +4083,7 @@ nm_platform_ip_route_sync (NMPlatform *self,
 {
 	const NMPlatformVTableRoute *vt;
 	gs_unref_hashtable GHashTable *routes_idx = NULL;
+	gs_unref_array GArray *transaction = NULL;
 	const NMPObject *conf_o;
 	const NMDedupMultiEntry *plat_entry;
 	guint i;
@@ -3692,7 +4103,7 @@ nm_platform_ip_route_sync (NMPlatform *self,
 
 	for (i_type = 0; routes && i_type < 2; i_type++) {
 		for (i = 0; i < routes->len; i++) {
-			NMPlatformError plerr;
+			NMPlatformTransactionOp *op;
 
 			conf_o = routes->pdata[i];
 
@@ -3722,77 +4133,24 @@ nm_platform_ip_route_sync (NMPlatform *self,
 			                                       NMP_CACHE_ID_TYPE_OBJECT_TYPE,
 			                                       conf_o);
 			if (plat_entry) {
-				const NMPObject *plat_o;
-
-				plat_o = plat_entry->obj;
-
 				if (vt->route_cmp (NMP_OBJECT_CAST_IPX_ROUTE (conf_o),
-				                   NMP_OBJECT_CAST_IPX_ROUTE (plat_o),
+				                   NMP_OBJECT_CAST_IPX_ROUTE (plat_entry->obj),
 				                   NM_PLATFORM_IP_ROUTE_CMP_TYPE_SEMANTICALLY) == 0)
 					continue;
+			}
 
+			if (!transaction)
+				transaction = nm_platform_transaction_new (routes->len);
+
+			if (plat_entry) {
 				/* we need to replace the existing route with a (slightly) differnt
-				 * one. Delete it first. */
-				if (!nm_platform_object_delete (self, plat_o)) {
-					/* ignore error. */
-				}
+				 * one. Delete it first. Errors are ignored. */
+				nm_platform_transaction_append (transaction, NMP_TRANSACTION_OP_TYPE_DELETE, plat_entry->obj);
 			}
 
-			plerr = nm_platform_ip_route_add (self,
-			                                    NMP_NLM_FLAG_APPEND
-			                                  | NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE,
-			                                  conf_o);
-			if (plerr != NM_PLATFORM_ERROR_SUCCESS) {
-				if (-((int) plerr) == EEXIST) {
-					/* Don't fail for EEXIST. It's not clear that the existing route
-					 * is identical to the one that we were about to add. However,
-					 * above we should have deleted conflicting (non-identical) routes. */
-					if (_LOGD_ENABLED ()) {
-						plat_entry = nm_platform_lookup_entry (self,
-						                                       NMP_CACHE_ID_TYPE_OBJECT_TYPE,
-						                                       conf_o);
-						if (!plat_entry) {
-							_LOGD ("route-sync: adding route %s failed with EEXIST, however we cannot find such a route",
-							       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)));
-						} else if (vt->route_cmp (NMP_OBJECT_CAST_IPX_ROUTE (conf_o),
-						                          NMP_OBJECT_CAST_IPX_ROUTE (plat_entry->obj),
-						                          NM_PLATFORM_IP_ROUTE_CMP_TYPE_SEMANTICALLY) != 0) {
-							_LOGD ("route-sync: adding route %s failed due to existing (different!) route %s",
-							       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
-							       nmp_object_to_string (plat_entry->obj, NMP_OBJECT_TO_STRING_PUBLIC, sbuf2, sizeof (sbuf2)));
-						}
-					}
-				} else if (   -((int) plerr) == EINVAL
-				           && out_temporary_not_available
-				           && _err_inval_due_to_ipv6_tentative_pref_src (self, conf_o)) {
-					_LOGD ("route-sync: ignore failure to add IPv6 route with tentative IPv6 pref-src: %s: %s",
-					       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
-					       nm_platform_error_to_string (plerr, sbuf_err, sizeof (sbuf_err)));
-					if (!*out_temporary_not_available)
-						*out_temporary_not_available = g_ptr_array_new_full (0, (GDestroyNotify) nmp_object_unref);
-					g_ptr_array_add (*out_temporary_not_available, (gpointer) nmp_object_ref (conf_o));
-				} else if (NMP_OBJECT_CAST_IP_ROUTE (conf_o)->rt_source < NM_IP_CONFIG_SOURCE_USER) {
-					_LOGD ("route-sync: ignore failure to add IPv%c route: %s: %s",
-					       vt->is_ip4 ? '4' : '6',
-					       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
-					       nm_platform_error_to_string (plerr, sbuf_err, sizeof (sbuf_err)));
-				} else {
-					const char *reason = "";
-
-					if (   -((int) plerr) == ENETUNREACH
-					    && (  vt->is_ip4
-					        ? !!NMP_OBJECT_CAST_IP4_ROUTE (conf_o)->gateway
-					        : !IN6_IS_ADDR_UNSPECIFIED (&NMP_OBJECT_CAST_IP6_ROUTE (conf_o)->gateway)))
-						reason = "; is the gateway directly reachable?";
-
-					_LOGW ("route-sync: failure to add IPv%c route: %s: %s%s",
-					       vt->is_ip4 ? '4' : '6',
-					       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
-					       nm_platform_error_to_string (plerr, sbuf_err, sizeof (sbuf_err)),
-					       reason);
-					success = FALSE;
-				}
-			}
+			op = nm_platform_transaction_append (transaction, NMP_TRANSACTION_OP_TYPE_ADD, conf_o);
+			op->nlm_flags =   NMP_NLM_FLAG_APPEND
+			                | NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE;
 		}
 	}
 
@@ -3814,9 +4172,79 @@ nm_platform_ip_route_sync (NMPlatform *self,
 			                               prune_o))
 				continue;
 
-			if (!nm_platform_object_delete (self, prune_o)) {
-				/* ignore error... */
+			/* errors deleting routes are ignored. */
+			if (!transaction)
+				transaction = nm_platform_transaction_new (routes_prune->len);
+			nm_platform_transaction_append (transaction, NMP_TRANSACTION_OP_TYPE_DELETE, prune_o);
+		}
+	}
+
+	if (!transaction)
+		return TRUE;
+
+	/* send all requests at once, and evaluate the results afterwards. Kernel
+	 * processes the requests in order, so device routes are still added before
+	 * the gateway routes that depend on them. */
+	nm_platform_transaction_commit (self, transaction);
+
+	for (i = 0; i < transaction->len; i++) {
+		const NMPlatformTransactionOp *op = &g_array_index (transaction, NMPlatformTransactionOp, i);
+		NMPlatformError plerr = op->result;
+
+		if (   op->op_type != NMP_TRANSACTION_OP_TYPE_ADD
+		    || plerr == NM_PLATFORM_ERROR_SUCCESS)
+			continue;
+
+		conf_o = op->obj;
+
+		if (-((int) plerr) == EEXIST) {
+			/* Don't fail for EEXIST. It's not clear that the existing route
+			 * is identical to the one that we were about to add. However,
+			 * above we should have deleted conflicting (non-identical) routes. */
+			if (_LOGD_ENABLED ()) {
+				plat_entry = nm_platform_lookup_entry (self,
+				                                       NMP_CACHE_ID_TYPE_OBJECT_TYPE,
+				                                       conf_o);
+				if (!plat_entry) {
+					_LOGD ("route-sync: adding route %s failed with EEXIST, however we cannot find such a route",
+					       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)));
+				} else if (vt->route_cmp (NMP_OBJECT_CAST_IPX_ROUTE (conf_o),
+				                          NMP_OBJECT_CAST_IPX_ROUTE (plat_entry->obj),
+				                          NM_PLATFORM_IP_ROUTE_CMP_TYPE_SEMANTICALLY) != 0) {
+					_LOGD ("route-sync: adding route %s failed due to existing (different!) route %s",
+					       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
+					       nmp_object_to_string (plat_entry->obj, NMP_OBJECT_TO_STRING_PUBLIC, sbuf2, sizeof (sbuf2)));
+				}
 			}
+		} else if (   -((int) plerr) == EINVAL
+		           && out_temporary_not_available
+		           && _err_inval_due_to_ipv6_tentative_pref_src (self, conf_o)) {
+			_LOGD ("route-sync: ignore failure to add IPv6 route with tentative IPv6 pref-src: %s: %s",
+			       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
+			       nm_platform_error_to_string (plerr, sbuf_err, sizeof (sbuf_err)));
+			if (!*out_temporary_not_available)
+				*out_temporary_not_available = g_ptr_array_new_full (0, (GDestroyNotify) nmp_object_unref);
+			g_ptr_array_add (*out_temporary_not_available, (gpointer) nmp_object_ref (conf_o));
+		} else if (NMP_OBJECT_CAST_IP_ROUTE (conf_o)->rt_source < NM_IP_CONFIG_SOURCE_USER) {
+			_LOGD ("route-sync: ignore failure to add IPv%c route: %s: %s",
+			       vt->is_ip4 ? '4' : '6',
+			       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
+			       nm_platform_error_to_string (plerr, sbuf_err, sizeof (sbuf_err)));
+		} else {
+			const char *reason = "";
+
+			if (   -((int) plerr) == ENETUNREACH
+			    && (  vt->is_ip4
+			        ? !!NMP_OBJECT_CAST_IP4_ROUTE (conf_o)->gateway
+			        : !IN6_IS_ADDR_UNSPECIFIED (&NMP_OBJECT_CAST_IP6_ROUTE (conf_o)->gateway)))
+				reason = "; is the gateway directly reachable?";
+
+			_LOGW ("route-sync: failure to add IPv%c route: %s: %s%s",
+			       vt->is_ip4 ? '4' : '6',
+			       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
+			       nm_platform_error_to_string (plerr, sbuf_err, sizeof (sbuf_err)),
+			       reason);
+			success = FALSE;
 		}
 	}
 
@@ -4012,6 +4440,222 @@ nm_platform_object_delete (NMPlatform *self,
 
 /*****************************************************************************/
 
+static void
+_transaction_op_clear (gpointer data)
+{
+	NMPlatformTransactionOp *op = data;
+
+	nm_clear_nmp_object (&op->obj);
+}
+
+/**
+ * nm_platform_transaction_new:
+ * @reserved_size: the number of operations to preallocate.
+ *
+ * Returns: a new, empty transaction. It is a #GArray of #NMPlatformTransactionOp,
+ *   to be filled with nm_platform_transaction_append() and released
+ *   with g_array_unref().
+ */
+GArray *
+nm_platform_transaction_new (guint reserved_size)
+{
+	GArray *transaction;
+
+	transaction = g_array_sized_new (FALSE, TRUE, sizeof (NMPlatformTransactionOp), reserved_size);
+	g_array_set_clear_func (transaction, _transaction_op_clear);
+	return transaction;
+}
+
+/**
+ * nm_platform_transaction_append:
+ * @transaction: the transaction, created by nm_platform_transaction_new().
+ * @op_type: whether to add or delete @obj.
+ * @obj: an IPv4/IPv6 address or route. The transaction takes a reference.
+ *
+ * Returns: the newly appended operation, so that the caller can set
+ *   further arguments. The pointer is only valid until the next
+ *   modification of @transaction.
+ */
+NMPlatformTransactionOp *
+nm_platform_transaction_append (GArray *transaction,
+                                NMPTransactionOpType op_type,
+                                const NMPObject *obj)
+{
+	NMPlatformTransactionOp *op;
+
+	nm_assert (transaction);
+	nm_assert (NM_IN_SET (op_type, NMP_TRANSACTION_OP_TYPE_ADD,
+	                               NMP_TRANSACTION_OP_TYPE_DELETE));
+	nm_assert (NM_IN_SET (NMP_OBJECT_GET_TYPE (obj), NMP_OBJECT_TYPE_IP4_ADDRESS,
+	                                                 NMP_OBJECT_TYPE_IP6_ADDRESS,
+	                                                 NMP_OBJECT_TYPE_IP4_ROUTE,
+	                                                 NMP_OBJECT_TYPE_IP6_ROUTE));
+
+	g_array_set_size (transaction, transaction->len + 1);
+	op = &g_array_index (transaction, NMPlatformTransactionOp, transaction->len - 1);
+	op->obj = nmp_object_ref (obj);
+	op->op_type = op_type;
+	op->lifetime = NM_PLATFORM_LIFETIME_PERMANENT;
+	op->preferred = NM_PLATFORM_LIFETIME_PERMANENT;
+	return op;
+}
+
+static void
+_transaction_commit_one_by_one (NMPlatform *self,
+                                NMPlatformTransactionOp *ops,
+                                guint n_ops)
+{
+	NMPlatformClass *klass = NM_PLATFORM_GET_CLASS (self);
+	guint i;
+
+	for (i = 0; i < n_ops; i++) {
+		NMPlatformTransactionOp *op = &ops[i];
+		const gboolean is_add = (op->op_type == NMP_TRANSACTION_OP_TYPE_ADD);
+		gboolean success;
+
+		switch (NMP_OBJECT_GET_TYPE (op->obj)) {
+		case NMP_OBJECT_TYPE_IP4_ADDRESS: {
+			const NMPlatformIP4Address *a = NMP_OBJECT_CAST_IP4_ADDRESS (op->obj);
+
+			success =   is_add
+			          ? klass->ip4_address_add (self, a->ifindex, a->address, a->plen, a->peer_address,
+			                                    op->lifetime, op->preferred, op->ifa_flags, a->label)
+			          : klass->ip4_address_delete (self, a->ifindex, a->address, a->plen, a->peer_address);
+			op->result = success ? NM_PLATFORM_ERROR_SUCCESS : NM_PLATFORM_ERROR_UNSPECIFIED;
+			break;
+		}
+		case NMP_OBJECT_TYPE_IP6_ADDRESS: {
+			const NMPlatformIP6Address *a = NMP_OBJECT_CAST_IP6_ADDRESS (op->obj);
+
+			success =   is_add
+			          ? klass->ip6_address_add (self, a->ifindex, a->address, a->plen, a->peer_address,
+			                                    op->lifetime, op->preferred, op->ifa_flags)
+			          : klass->ip6_address_delete (self, a->ifindex, a->address, a->plen);
+			op->result = success ? NM_PLATFORM_ERROR_SUCCESS : NM_PLATFORM_ERROR_UNSPECIFIED;
+			break;
+		}
+		case NMP_OBJECT_TYPE_IP4_ROUTE:
+		case NMP_OBJECT_TYPE_IP6_ROUTE:
+			if (is_add) {
+				op->result = klass->ip_route_add (self,
+				                                  op->nlm_flags,
+				                                  NMP_OBJECT_GET_CLASS (op->obj)->addr_family,
+				                                  NMP_OBJECT_CAST_IP_ROUTE (op->obj));
+			} else {
+				op->result =   klass->object_delete (self, op->obj)
+				             ? NM_PLATFORM_ERROR_SUCCESS
+				             : NM_PLATFORM_ERROR_UNSPECIFIED;
+			}
+			break;
+		default:
+			nm_assert_not_reached ();
+			op->result = NM_PLATFORM_ERROR_BUG;
+			break;
+		}
+	}
+}
+
+/**
+ * nm_platform_transaction_commit:
+ * @self: the #NMPlatform instance.
+ * @transaction: the transaction, created by nm_platform_transaction_new().
+ *
+ * Executes all operations of @transaction in order. Contrary to calling
+ * nm_platform_ip_route_add() and friends for each object, the platform
+ * implementation may send the requests in batches and collect the responses
+ * afterwards, instead of waiting for the response to each request.
+ *
+ * Afterwards, the @result field of each operation is set.
+ *
+ * Returns: %TRUE, if all operations succeeded.
+ */
+gboolean
+nm_platform_transaction_commit (NMPlatform *self,
+                                GArray *transaction)
+{
+	NMPlatformTransactionOp *ops;
+	char sbuf[sizeof (_nm_utils_to_string_buffer)];
+	gboolean success = TRUE;
+	guint i;
+
+	_CHECK_SELF (self, klass, FALSE);
+
+	nm_assert (transaction);
+
+	if (transaction->len == 0)
+		return TRUE;
+
+	ops = &g_array_index (transaction, NMPlatformTransactionOp, 0);
+
+	if (_LOGD_ENABLED ()) {
+		for (i = 0; i < transaction->len; i++) {
+			_LOGD ("transaction: %s %s: %s",
+			       ops[i].op_type == NMP_TRANSACTION_OP_TYPE_ADD ? "add" : "delete",
+			       NMP_OBJECT_GET_CLASS (ops[i].obj)->obj_type_name,
+			       nmp_object_to_string (ops[i].obj, NMP_OBJECT_TO_STRING_PUBLIC, sbuf, sizeof (sbuf)));
+		}
+	}
+
+	if (klass->transaction_commit)
+		klass->transaction_commit (self, ops, transaction->len);
+	else
+		_transaction_commit_one_by_one (self, ops, transaction->len);
+
+	for (i = 0; i < transaction->len; i++) {
+		if (ops[i].result != NM_PLATFORM_ERROR_SUCCESS)
+			success = FALSE;
+	}
+	return success;
+}
+
+/*****************************************************************************/
+
+/**
+ * nm_platform_netlink_get_stats:
+ * @self: the #NMPlatform instance
+ * @out_stats: the counters of the netlink event socket.
+ *
+ * Returns: %FALSE if the platform has no netlink socket. In that
+ *   case, @out_stats is zeroed.
+ */
+gboolean
+nm_platform_netlink_get_stats (NMPlatform *self,
+                               NMPlatformNetlinkStats *out_stats)
+{
+	_CHECK_SELF (self, klass, FALSE);
+
+	g_return_val_if_fail (out_stats, FALSE);
+
+	memset (out_stats, 0, sizeof (*out_stats));
+	if (!klass->netlink_get_stats)
+		return FALSE;
+	return klass->netlink_get_stats (self, out_stats);
+}
+
+/**
+ * nm_platform_sysctl_get_stats:
+ * @self: the #NMPlatform instance
+ * @out_stats: the counters of the sysctl writes.
+ *
+ * Returns: %FALSE if the platform does not count sysctl writes. In
+ *   that case, @out_stats is zeroed.
+ */
+gboolean
+nm_platform_sysctl_get_stats (NMPlatform *self,
+                              NMPlatformSysctlStats *out_stats)
+{
+	_CHECK_SELF (self, klass, FALSE);
+
+	g_return_val_if_fail (out_stats, FALSE);
+
+	memset (out_stats, 0, sizeof (*out_stats));
+	if (!klass->sysctl_get_stats)
+		return FALSE;
+	return klass->sysctl_get_stats (self, out_stats);
+}
+
+/*****************************************************************************/
+
 NMPlatformError
 nm_platform_ip_route_get (NMPlatform *self,
                           int addr_family,
@@ -6249,6 +6893,360 @@ log_tfilter (NMPlatform *self, NMPObjectType obj_type, int ifindex, NMPlatformTf
 
 /*****************************************************************************/
 
+/* Subscribers of the change sets are kept per ifindex. At the end of a
+ * window, the platform emits one change set per ifindex, and it only calls
+ * the subscribers of that ifindex. A burst of N events on M links thus
+ * costs M callbacks, instead of N signal emissions that each run the
+ * handlers of all devices. */
+typedef struct {
+	int ifindex;
+	CList subscriptions_lst_head;
+
+	/* while the callbacks are invoked (possibly nested), unsubscribing
+	 * only clears the callback and the subscription is freed afterwards. */
+	guint dispatching;
+} ChangesIfindex;
+
+struct _NMPlatformChangesSubscription {
+	CList subscriptions_lst;
+	ChangesIfindex *by_ifindex;
+	NMPlatformChangesCb callback;
+	gpointer user_data;
+};
+
+static void
+_changes_set_free (gpointer data)
+{
+	NMPlatformChangeSet *change_set = data;
+
+	if (change_set->ip6_dad_failed)
+		g_array_unref (change_set->ip6_dad_failed);
+	g_slice_free (NMPlatformChangeSet, change_set);
+}
+
+static int
+_changes_set_cmp (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+	const NMPlatformChangeSet *c_a = *((const NMPlatformChangeSet *const*) a);
+	const NMPlatformChangeSet *c_b = *((const NMPlatformChangeSet *const*) b);
+
+	return c_a->ifindex < c_b->ifindex ? -1 : (c_a->ifindex > c_b->ifindex ? 1 : 0);
+}
+
+static void
+_changes_ifindex_free (ChangesIfindex *by_ifindex)
+{
+	nm_assert (c_list_is_empty (&by_ifindex->subscriptions_lst_head));
+
+	g_slice_free (ChangesIfindex, by_ifindex);
+}
+
+static void
+_changes_dispatch (NMPlatform *self, const NMPlatformChangeSet *change_set)
+{
+	NMPlatformPrivate *priv = NM_PLATFORM_GET_PRIVATE (self);
+	ChangesIfindex *by_ifindex;
+	NMPlatformChangesSubscription *sub, *sub_safe;
+
+	by_ifindex = priv->changes.subscriptions
+	             ? g_hash_table_lookup (priv->changes.subscriptions, GINT_TO_POINTER (change_set->ifindex))
+	             : NULL;
+	if (!by_ifindex)
+		return;
+
+	/* the callback might unsubscribe itself or others, or cause changes that
+	 * are dispatched right away. Subscriptions stay linked until the outermost
+	 * dispatch is done. */
+	by_ifindex->dispatching++;
+	c_list_for_each_entry (sub, &by_ifindex->subscriptions_lst_head, subscriptions_lst) {
+		if (sub->callback)
+			sub->callback (self, change_set, sub->user_data);
+	}
+	if (--by_ifindex->dispatching > 0)
+		return;
+
+	c_list_for_each_entry_safe (sub, sub_safe, &by_ifindex->subscriptions_lst_head, subscriptions_lst) {
+		if (!sub->callback) {
+			c_list_unlink (&sub->subscriptions_lst);
+			g_slice_free (NMPlatformChangesSubscription, sub);
+		}
+	}
+	if (c_list_is_empty (&by_ifindex->subscriptions_lst_head)) {
+		g_hash_table_remove (priv->changes.subscriptions, GINT_TO_POINTER (by_ifindex->ifindex));
+		_changes_ifindex_free (by_ifindex);
+	}
+}
+
+static void
+_changes_flush (NMPlatform *self)
+{
+	NMPlatformPrivate *priv = NM_PLATFORM_GET_PRIVATE (self);
+	gs_unref_hashtable GHashTable *pending = NULL;
+	gs_free NMPlatformChangeSet **change_sets = NULL;
+	GHashTableIter h_iter;
+	NMPlatformChangeSet *change_set;
+	guint i, n, n_events = 0;
+
+	nm_clear_g_source (&priv->changes.timeout_id);
+
+	if (   !priv->changes.pending
+	    || g_hash_table_size (priv->changes.pending) == 0)
+		return;
+
+	/* callbacks may cause new events. They go to a new window. */
+	pending = g_steal_pointer (&priv->changes.pending);
+
+	/* dispatch in ifindex order, so that the result does not depend on
+	 * the hashing. */
+	n = g_hash_table_size (pending);
+	change_sets = g_new (NMPlatformChangeSet *, n);
+	i = 0;
+	g_hash_table_iter_init (&h_iter, pending);
+	while (g_hash_table_iter_next (&h_iter, NULL, (gpointer *) &change_set)) {
+		change_sets[i++] = change_set;
+		n_events += change_set->n_events;
+	}
+	g_qsort_with_data (change_sets, n, sizeof (NMPlatformChangeSet *), _changes_set_cmp, NULL);
+
+	_LOGt ("changes: emit %u change sets for %u events after %"G_GINT64_FORMAT" usec",
+	       n, n_events,
+	       (nm_utils_get_monotonic_timestamp_ns () - priv->changes.first_ns) / 1000);
+
+	for (i = 0; i < n; i++)
+		_changes_dispatch (self, change_sets[i]);
+}
+
+static gboolean
+_changes_timeout_cb (gpointer user_data)
+{
+	NMPlatform *self = user_data;
+	NMPlatformPrivate *priv = NM_PLATFORM_GET_PRIVATE (self);
+	gint64 now_ns, deadline_ns;
+
+	priv->changes.timeout_id = 0;
+
+	/* the window is extended while events keep coming in, but never beyond
+	 * the maximum latency since the first event. */
+	now_ns = nm_utils_get_monotonic_timestamp_ns ();
+	deadline_ns = MIN (priv->changes.last_ns + priv->changes.window_ms * NM_UTILS_NS_PER_MSEC,
+	                   priv->changes.first_ns + priv->changes.max_latency_ms * NM_UTILS_NS_PER_MSEC);
+	if (now_ns < deadline_ns) {
+		priv->changes.timeout_id = g_timeout_add (NM_MAX ((deadline_ns - now_ns) / NM_UTILS_NS_PER_MSEC, 1),
+		                                          _changes_timeout_cb,
+		                                          self);
+		return G_SOURCE_REMOVE;
+	}
+
+	_changes_flush (self);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+_changes_record (NMPlatform *self,
+                 NMPObjectType obj_type,
+                 NMPlatformSignalChangeType change_type,
+                 const NMPObject *obj)
+{
+	NMPlatformPrivate *priv = NM_PLATFORM_GET_PRIVATE (self);
+	NMPlatformChangeSet *change_set;
+	NMPlatformChangeSet change_set_stack;
+	NMPlatformChangeFlags flag;
+	int ifindex;
+
+	ifindex = obj->object.ifindex;
+	if (   ifindex <= 0
+	    || !priv->changes.subscriptions
+	    || !g_hash_table_contains (priv->changes.subscriptions, GINT_TO_POINTER (ifindex)))
+		return;
+
+	switch (obj_type) {
+	case NMP_OBJECT_TYPE_LINK:
+		flag =   change_type == NM_PLATFORM_SIGNAL_ADDED
+		       ? NM_PLATFORM_CHANGE_LINK_ADDED
+		       : (  change_type == NM_PLATFORM_SIGNAL_REMOVED
+		          ? NM_PLATFORM_CHANGE_LINK_REMOVED
+		          : NM_PLATFORM_CHANGE_LINK_CHANGED);
+		break;
+	case NMP_OBJECT_TYPE_IP4_ADDRESS:
+		flag = NM_PLATFORM_CHANGE_IP4_ADDRESS;
+		break;
+	case NMP_OBJECT_TYPE_IP6_ADDRESS:
+		flag = NM_PLATFORM_CHANGE_IP6_ADDRESS;
+		break;
+	case NMP_OBJECT_TYPE_IP4_ROUTE:
+		flag = NM_PLATFORM_CHANGE_IP4_ROUTE;
+		break;
+	case NMP_OBJECT_TYPE_IP6_ROUTE:
+		flag = NM_PLATFORM_CHANGE_IP6_ROUTE;
+		break;
+	default:
+		return;
+	}
+
+	if (priv->changes.window_ms == 0) {
+		change_set_stack = (NMPlatformChangeSet) {
+			.ifindex = ifindex,
+		};
+		change_set = &change_set_stack;
+	} else {
+		if (!priv->changes.pending)
+			priv->changes.pending = g_hash_table_new_full (nm_direct_hash, NULL, NULL, _changes_set_free);
+
+		change_set = g_hash_table_lookup (priv->changes.pending, GINT_TO_POINTER (ifindex));
+		if (!change_set) {
+			change_set = g_slice_new0 (NMPlatformChangeSet);
+			change_set->ifindex = ifindex;
+			g_hash_table_insert (priv->changes.pending, GINT_TO_POINTER (ifindex), change_set);
+		}
+	}
+
+	change_set->changes |= flag;
+	change_set->n_events++;
+
+	if (obj_type == NMP_OBJECT_TYPE_IP6_ADDRESS) {
+		const NMPlatformIP6Address *addr = &obj->ip6_address;
+
+		if (   (change_type == NM_PLATFORM_SIGNAL_CHANGED && NM_FLAGS_HAS (addr->n_ifa_flags, IFA_F_DADFAILED))
+		    || (change_type == NM_PLATFORM_SIGNAL_REMOVED && NM_FLAGS_HAS (addr->n_ifa_flags, IFA_F_TENTATIVE))) {
+			if (!change_set->ip6_dad_failed)
+				change_set->ip6_dad_failed = g_array_new (FALSE, FALSE, sizeof (NMPlatformIP6Address));
+			g_array_append_val (change_set->ip6_dad_failed, *addr);
+		}
+	}
+
+	if (priv->changes.window_ms == 0) {
+		_changes_dispatch (self, change_set);
+		if (change_set->ip6_dad_failed)
+			g_array_unref (change_set->ip6_dad_failed);
+		return;
+	}
+
+	priv->changes.last_ns = nm_utils_get_monotonic_timestamp_ns ();
+	if (!priv->changes.timeout_id) {
+		priv->changes.first_ns = priv->changes.last_ns;
+		priv->changes.timeout_id = g_timeout_add (priv->changes.window_ms, _changes_timeout_cb, self);
+	}
+}
+
+/**
+ * nm_platform_changes_set_window:
+ * @self: platform instance
+ * @window_ms: how long to collect changes before emitting them, or 0
+ *   to emit every change right away.
+ * @max_latency_ms: the longest a change is held back, even if changes
+ *   keep coming in. It is at least @window_ms.
+ *
+ * Configures the coalescing of the change sets that are passed to the
+ * subscribers of nm_platform_changes_subscribe(). The regular signals
+ * of the platform are not affected.
+ */
+void
+nm_platform_changes_set_window (NMPlatform *self,
+                                guint window_ms,
+                                guint max_latency_ms)
+{
+	NMPlatformPrivate *priv;
+
+	_CHECK_SELF_VOID (self, klass);
+
+	priv = NM_PLATFORM_GET_PRIVATE (self);
+
+	priv->changes.window_ms = window_ms;
+	priv->changes.max_latency_ms = NM_MAX (window_ms, max_latency_ms);
+
+	if (window_ms == 0)
+		_changes_flush (self);
+}
+
+guint
+nm_platform_changes_get_window (NMPlatform *self)
+{
+	_CHECK_SELF (self, klass, 0);
+
+	return NM_PLATFORM_GET_PRIVATE (self)->changes.window_ms;
+}
+
+/**
+ * nm_platform_changes_subscribe:
+ * @self: platform instance
+ * @ifindex: the ifindex to watch
+ * @callback: called with what changed on @ifindex.
+ * @user_data: user data for @callback
+ *
+ * Unlike the signals of the platform, @callback is only invoked for
+ * objects on @ifindex. With a window set by nm_platform_changes_set_window(),
+ * all changes of the window are passed at once. Otherwise, it is called
+ * for every change, after the corresponding signal.
+ *
+ * Returns: the subscription handle. Release it with
+ *   nm_platform_changes_unsubscribe().
+ */
+NMPlatformChangesSubscription *
+nm_platform_changes_subscribe (NMPlatform *self,
+                               int ifindex,
+                               NMPlatformChangesCb callback,
+                               gpointer user_data)
+{
+	NMPlatformPrivate *priv;
+	NMPlatformChangesSubscription *sub;
+	ChangesIfindex *by_ifindex;
+
+	_CHECK_SELF (self, klass, NULL);
+
+	g_return_val_if_fail (ifindex > 0, NULL);
+	g_return_val_if_fail (callback, NULL);
+
+	priv = NM_PLATFORM_GET_PRIVATE (self);
+
+	if (!priv->changes.subscriptions)
+		priv->changes.subscriptions = g_hash_table_new (nm_direct_hash, NULL);
+
+	by_ifindex = g_hash_table_lookup (priv->changes.subscriptions, GINT_TO_POINTER (ifindex));
+	if (!by_ifindex) {
+		by_ifindex = g_slice_new0 (ChangesIfindex);
+		by_ifindex->ifindex = ifindex;
+		c_list_init (&by_ifindex->subscriptions_lst_head);
+		g_hash_table_insert (priv->changes.subscriptions, GINT_TO_POINTER (ifindex), by_ifindex);
+	}
+
+	sub = g_slice_new0 (NMPlatformChangesSubscription);
+	sub->by_ifindex = by_ifindex;
+	sub->callback = callback;
+	sub->user_data = user_data;
+	c_list_link_tail (&by_ifindex->subscriptions_lst_head, &sub->subscriptions_lst);
+	return sub;
+}
+
+void
+nm_platform_changes_unsubscribe (NMPlatform *self,
+                                 NMPlatformChangesSubscription *subscription)
+{
+	NMPlatformPrivate *priv;
+	ChangesIfindex *by_ifindex;
+
+	_CHECK_SELF_VOID (self, klass);
+
+	g_return_if_fail (subscription);
+
+	priv = NM_PLATFORM_GET_PRIVATE (self);
+	by_ifindex = subscription->by_ifindex;
+
+	nm_assert (g_hash_table_lookup (priv->changes.subscriptions, GINT_TO_POINTER (by_ifindex->ifindex)) == by_ifindex);
+
+	if (by_ifindex->dispatching) {
+		subscription->callback = NULL;
+		return;
+	}
+
+	c_list_unlink (&subscription->subscriptions_lst);
+	g_slice_free (NMPlatformChangesSubscription, subscription);
+
+	if (c_list_is_empty (&by_ifindex->subscriptions_lst_head)) {
+		g_hash_table_remove (priv->changes.subscriptions, GINT_TO_POINTER (by_ifindex->ifindex));
+		_changes_ifindex_free (by_ifindex);
+	}
+}
+
 void
 nm_platform_cache_update_emit_signal (NMPlatform *self,
                                       NMPCacheOpsType cache_op,
@@ -6321,6 +7319,7 @@ nm_platform_cache_update_emit_signal (NMPlatform *self,
 	               o->object.ifindex,
 	               &o->object,
 	               (int) cache_op);
+	_changes_record (self, klass->obj_type, (NMPlatformSignalChangeType) cache_op, o);
 	nmp_object_unref (o);
 }
 
@@ -6423,6 +7422,7 @@ static void
 nm_platform_init (NMPlatform *self)
 {
 	self->_priv = G_TYPE_INSTANCE_GET_PRIVATE (self, NM_TYPE_PLATFORM, NMPlatformPrivate);
+	c_list_init (&self->_priv->link_stats_groups_lst_head);
 }
 
 static GObject *
@@ -6453,9 +7453,15 @@ finalize (GObject *object)
 	NMPlatform *self = NM_PLATFORM (object);
 	NMPlatformPrivate *priv = NM_PLATFORM_GET_PRIVATE (self);
 
+	nm_assert (c_list_is_empty (&priv->link_stats_groups_lst_head));
+	nm_assert (!priv->changes.subscriptions || g_hash_table_size (priv->changes.subscriptions) == 0);
+
 	nm_clear_g_source (&priv->ip4_dev_route_blacklist_check_id);
 	nm_clear_g_source (&priv->ip4_dev_route_blacklist_gc_timeout_id);
 	g_clear_pointer (&priv->ip4_dev_route_blacklist_hash, g_hash_table_unref);
+	nm_clear_g_source (&priv->changes.timeout_id);
+	g_clear_pointer (&priv->changes.pending, g_hash_table_unref);
+	g_clear_pointer (&priv->changes.subscriptions, g_hash_table_unref);
 	g_clear_object (&self->_netns);
 	nm_dedup_multi_index_unref (priv->multi_idx);
 	nmp_cache_free (priv->cache);
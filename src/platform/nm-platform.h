@@ -361,6 +361,20 @@ typedef union {
 #define __NMPlatformIPRoute_COMMON \
 	__NMPlatformObject_COMMON; \
 	\
+	/* The fields that are part of the route ID and that the cache hashes and
+	 * compares on every lookup come first, so that they share a cache line
+	 * with ifindex and plen. The RTA_METRICS below are rarely looked at. */ \
+	\
+	/* RTA_PRIORITY (iproute2: metric) */ \
+	guint32 metric; \
+	\
+	/* rtm_table, RTA_TABLE.
+	 *
+	 * This is not the original table ID. Instead, 254 (RT_TABLE_MAIN) and
+	 * zero (RT_TABLE_UNSPEC) are swapped, so that the default is the main
+	 * table. Use nm_platform_route_table_coerce()/nm_platform_route_table_uncoerce(). */ \
+	guint32 table_coerced; \
+	\
 	/* The NMIPConfigSource. For routes that we receive from cache this corresponds
 	 * to the rtm_protocol field (and is one of the NM_IP_CONFIG_SOURCE_RTPROT_* values).
 	 * When adding a route, the source will be coerced to the protocol using
@@ -426,17 +440,6 @@ typedef union {
 	/* RTA_METRICS.RTAX_MTU (iproute2: mtu) */ \
 	guint32 mtu; \
 	\
-	\
-	/* RTA_PRIORITY (iproute2: metric) */ \
-	guint32 metric; \
-	\
-	/* rtm_table, RTA_TABLE.
-	 *
-	 * This is not the original table ID. Instead, 254 (RT_TABLE_MAIN) and
-	 * zero (RT_TABLE_UNSPEC) are swapped, so that the default is the main
-	 * table. Use nm_platform_route_table_coerce()/nm_platform_route_table_uncoerce(). */ \
-	guint32 table_coerced; \
-	\
 	/*end*/
 
 
@@ -696,8 +699,154 @@ typedef enum {
 	NM_PLATFORM_KERNEL_SUPPORT_EXTENDED_IFA_FLAGS               = (1LL <<  0),
 	NM_PLATFORM_KERNEL_SUPPORT_USER_IPV6LL                      = (1LL <<  1),
 	NM_PLATFORM_KERNEL_SUPPORT_RTA_PREF                         = (1LL <<  2),
+	NM_PLATFORM_KERNEL_SUPPORT_NETLINK_STRICT_CHK               = (1LL <<  3),
 } NMPlatformKernelSupportFlags;
 
+typedef enum {
+	NMP_TRANSACTION_OP_TYPE_ADD,
+	NMP_TRANSACTION_OP_TYPE_DELETE,
+} NMPTransactionOpType;
+
+/* One queued operation of a platform transaction. See nm_platform_transaction_commit(). */
+typedef struct {
+	/* the IPv4/IPv6 address or route to add or delete. The transaction
+	 * holds a reference to the object. */
+	const NMPObject *obj;
+
+	NMPTransactionOpType op_type;
+
+	/* for adding routes, the NMP_NLM_FLAG_* flags. */
+	NMPNlmFlags nlm_flags;
+
+	/* for adding addresses, the lifetimes (relative to now) and
+	 * the IFA_F_* flags to set. The corresponding fields in @obj
+	 * are ignored. */
+	guint32 lifetime;
+	guint32 preferred;
+	guint32 ifa_flags;
+
+	/* the result of the operation, set by nm_platform_transaction_commit(). */
+	NMPlatformError result;
+} NMPlatformTransactionOp;
+
+/* Counters of the netlink socket that receives kernel events.
+ * See nm_platform_netlink_get_stats(). */
+typedef struct {
+	/* the number of netlink messages and their size in bytes. */
+	guint64 n_msgs;
+	guint64 n_bytes;
+
+	/* the number of times we lost a message, because the receive buffer
+	 * was too small for it. */
+	guint64 n_truncated;
+
+	/* the number of times the socket receive buffer overflowed (ENOBUFS). */
+	guint64 n_overflows;
+
+	/* the number of times we had to resynchronize the entire cache,
+	 * after losing messages. */
+	guint64 n_resyncs;
+
+	/* the largest number of bytes that were pending for us to read
+	 * at once. */
+	guint64 peak_backlog;
+
+	/* the current size of the socket receive buffer (SO_RCVBUF). */
+	guint64 rcvbuf_size;
+
+	/* the number of routes that were not cached, because they
+	 * match main.route-filter. */
+	guint64 n_ip4_routes_filtered;
+	guint64 n_ip6_routes_filtered;
+} NMPlatformNetlinkStats;
+
+/* Counters of the sysctl writes. See nm_platform_sysctl_get_stats(). */
+typedef struct {
+	/* the number of nm_platform_sysctl_set() calls. */
+	guint64 n_writes;
+
+	/* the writes that were skipped, because the value was known
+	 * to be set already. */
+	guint64 n_writes_elided;
+
+	/* the number of per-interface conf directories that are held open. */
+	guint64 n_dirfds;
+} NMPlatformSysctlStats;
+
+/* The traffic counters of one link. See nm_platform_link_get_all_stats(). */
+typedef struct {
+	int ifindex;
+	guint64 rx_packets;
+	guint64 rx_bytes;
+	guint64 tx_packets;
+	guint64 tx_bytes;
+} NMPlatformLinkStats;
+
+typedef struct _NMPlatformLinkStatsSubscription NMPlatformLinkStatsSubscription;
+
+/**
+ * NMPlatformLinkStatsCb:
+ * @self: the platform instance
+ * @stats: the #NMPlatformLinkStats of all links, sorted by ifindex.
+ *   Use nm_platform_link_stats_lookup() to find a link.
+ * @user_data: the user data of the subscription
+ */
+typedef void (*NMPlatformLinkStatsCb) (NMPlatform *self,
+                                       const GArray *stats,
+                                       gpointer user_data);
+
+/* What changed on one ifindex during a coalescing window.
+ * See nm_platform_changes_subscribe(). */
+typedef enum {
+	NM_PLATFORM_CHANGE_NONE         = 0,
+	NM_PLATFORM_CHANGE_LINK_ADDED   = (1LL << 0),
+	NM_PLATFORM_CHANGE_LINK_CHANGED = (1LL << 1),
+	NM_PLATFORM_CHANGE_LINK_REMOVED = (1LL << 2),
+	NM_PLATFORM_CHANGE_IP4_ADDRESS  = (1LL << 3),
+	NM_PLATFORM_CHANGE_IP6_ADDRESS  = (1LL << 4),
+	NM_PLATFORM_CHANGE_IP4_ROUTE    = (1LL << 5),
+	NM_PLATFORM_CHANGE_IP6_ROUTE    = (1LL << 6),
+} NMPlatformChangeFlags;
+
+typedef struct {
+	int ifindex;
+	NMPlatformChangeFlags changes;
+
+	/* how many signals were coalesced into this change set. */
+	guint n_events;
+
+	/* the IPv6 addresses that failed DAD during the window: they were
+	 * changed with IFA_F_DADFAILED, or removed while still tentative.
+	 * An array of #NMPlatformIP6Address, or %NULL if there are none. */
+	GArray *ip6_dad_failed;
+} NMPlatformChangeSet;
+
+typedef struct _NMPlatformChangesSubscription NMPlatformChangesSubscription;
+
+/**
+ * NMPlatformChangesCb:
+ * @self: the platform instance
+ * @change_set: the changes of the subscribed ifindex
+ * @user_data: the user data of the subscription
+ */
+typedef void (*NMPlatformChangesCb) (NMPlatform *self,
+                                     const NMPlatformChangeSet *change_set,
+                                     gpointer user_data);
+
+/**
+ * NMPlatformAsyncCallback:
+ * @self: the platform instance
+ * @result: the result of the request
+ * @user_data: the user data of the request
+ *
+ * The completion of a request like nm_platform_link_set_up_async().
+ * It is invoked exactly once, and never before the function that started
+ * the request returns.
+ */
+typedef void (*NMPlatformAsyncCallback) (NMPlatform *self,
+                                         NMPlatformError result,
+                                         gpointer user_data);
+
 /*****************************************************************************/
 
 struct _NMPlatformPrivate;
@@ -724,12 +873,14 @@ typedef struct {
 	gboolean (*link_delete) (NMPlatform *, int ifindex);
 
 	gboolean (*link_refresh) (NMPlatform *, int ifindex);
+	gboolean (*link_get_all_stats) (NMPlatform *, GArray *out_stats);
 
 	gboolean (*link_set_netns) (NMPlatform *, int ifindex, int netns_fd);
 
 	void (*process_events) (NMPlatform *self);
 
 	gboolean (*link_set_up) (NMPlatform *, int ifindex, gboolean *out_no_firmware);
+	void (*link_set_up_async) (NMPlatform *, int ifindex, NMPlatformAsyncCallback callback, gpointer user_data);
 	gboolean (*link_set_down) (NMPlatform *, int ifindex);
 	gboolean (*link_set_arp) (NMPlatform *, int ifindex);
 	gboolean (*link_set_noarp) (NMPlatform *, int ifindex);
@@ -746,6 +897,7 @@ typedef struct {
 	                                        size_t *length);
 	NMPlatformError (*link_set_address) (NMPlatform *, int ifindex, gconstpointer address, size_t length);
 	NMPlatformError (*link_set_mtu) (NMPlatform *, int ifindex, guint32 mtu);
+	void (*link_set_mtu_async) (NMPlatform *, int ifindex, guint32 mtu, NMPlatformAsyncCallback callback, gpointer user_data);
 	gboolean (*link_set_name) (NMPlatform *, int ifindex, const char *name);
 	gboolean (*link_set_sriov_num_vfs) (NMPlatform *, int ifindex, guint num_vfs);
 
@@ -762,6 +914,9 @@ typedef struct {
 	gboolean (*link_supports_vlans) (NMPlatform *, int ifindex);
 	gboolean (*link_supports_sriov) (NMPlatform *, int ifindex);
 
+	void (*link_facts_prefetch) (NMPlatform *, const int *ifindexes, guint n_ifindexes);
+	void (*link_facts_clear) (NMPlatform *);
+
 	gboolean (*link_enslave) (NMPlatform *, int master, int slave);
 	gboolean (*link_release) (NMPlatform *, int master, int slave);
 
@@ -871,6 +1026,15 @@ typedef struct {
 	                                  NMPNlmFlags flags,
 	                                  const NMPlatformTfilter *tfilter);
 
+	void (*transaction_commit) (NMPlatform *self,
+	                            NMPlatformTransactionOp *ops,
+	                            guint n_ops);
+
+	gboolean (*netlink_get_stats) (NMPlatform *self,
+	                               NMPlatformNetlinkStats *out_stats);
+	gboolean (*sysctl_get_stats) (NMPlatform *self,
+	                              NMPlatformSysctlStats *out_stats);
+
 	NMPlatformKernelSupportFlags (*check_kernel_support) (NMPlatform * self,
 	                                                      NMPlatformKernelSupportFlags request_flags);
 } NMPlatformClass;
@@ -1081,9 +1245,33 @@ gboolean nm_platform_link_supports_slaves (NMPlatform *self, int ifindex);
 const char *nm_platform_link_get_type_name (NMPlatform *self, int ifindex);
 
 gboolean nm_platform_link_refresh (NMPlatform *self, int ifindex);
+
+GArray *nm_platform_link_get_all_stats (NMPlatform *self);
+const NMPlatformLinkStats *nm_platform_link_stats_lookup (const GArray *stats, int ifindex);
+NMPlatformLinkStatsSubscription *nm_platform_link_stats_subscribe (NMPlatform *self,
+                                                                   guint refresh_rate_ms,
+                                                                   NMPlatformLinkStatsCb callback,
+                                                                   gpointer user_data);
+void nm_platform_link_stats_unsubscribe (NMPlatform *self,
+                                         NMPlatformLinkStatsSubscription *subscription);
+
+void nm_platform_changes_set_window (NMPlatform *self,
+                                     guint window_ms,
+                                     guint max_latency_ms);
+guint nm_platform_changes_get_window (NMPlatform *self);
+NMPlatformChangesSubscription *nm_platform_changes_subscribe (NMPlatform *self,
+                                                              int ifindex,
+                                                              NMPlatformChangesCb callback,
+                                                              gpointer user_data);
+void nm_platform_changes_unsubscribe (NMPlatform *self,
+                                      NMPlatformChangesSubscription *subscription);
 void nm_platform_process_events (NMPlatform *self);
 
 gboolean nm_platform_link_set_up (NMPlatform *self, int ifindex, gboolean *out_no_firmware);
+void nm_platform_link_set_up_async (NMPlatform *self,
+                                    int ifindex,
+                                    NMPlatformAsyncCallback callback,
+                                    gpointer user_data);
 gboolean nm_platform_link_set_down (NMPlatform *self, int ifindex);
 gboolean nm_platform_link_set_arp (NMPlatform *self, int ifindex);
 gboolean nm_platform_link_set_noarp (NMPlatform *self, int ifindex);
@@ -1098,6 +1286,11 @@ gboolean nm_platform_link_set_ipv6_token (NMPlatform *self, int ifindex, NMUtils
 gboolean nm_platform_link_get_permanent_address (NMPlatform *self, int ifindex, guint8 *buf, size_t *length);
 NMPlatformError nm_platform_link_set_address (NMPlatform *self, int ifindex, const void *address, size_t length);
 NMPlatformError nm_platform_link_set_mtu (NMPlatform *self, int ifindex, guint32 mtu);
+void nm_platform_link_set_mtu_async (NMPlatform *self,
+                                     int ifindex,
+                                     guint32 mtu,
+                                     NMPlatformAsyncCallback callback,
+                                     gpointer user_data);
 gboolean nm_platform_link_set_name (NMPlatform *self, int ifindex, const char *name);
 gboolean nm_platform_link_set_sriov_num_vfs (NMPlatform *self, int ifindex, guint num_vfs);
 
@@ -1114,6 +1307,9 @@ gboolean nm_platform_link_supports_carrier_detect (NMPlatform *self, int ifindex
 gboolean nm_platform_link_supports_vlans (NMPlatform *self, int ifindex);
 gboolean nm_platform_link_supports_sriov (NMPlatform *self, int ifindex);
 
+void nm_platform_link_facts_prefetch (NMPlatform *self, const int *ifindexes, guint n_ifindexes);
+void nm_platform_link_facts_clear (NMPlatform *self);
+
 gboolean nm_platform_link_enslave (NMPlatform *self, int master, int slave);
 gboolean nm_platform_link_release (NMPlatform *self, int master, int slave);
 
@@ -1282,6 +1478,18 @@ gboolean nm_platform_ip_route_flush (NMPlatform *self,
                                      int addr_family,
                                      int ifindex);
 
+GArray *nm_platform_transaction_new (guint reserved_size);
+NMPlatformTransactionOp *nm_platform_transaction_append (GArray *transaction,
+                                                         NMPTransactionOpType op_type,
+                                                         const NMPObject *obj);
+gboolean nm_platform_transaction_commit (NMPlatform *self,
+                                         GArray *transaction);
+
+gboolean nm_platform_netlink_get_stats (NMPlatform *self,
+                                        NMPlatformNetlinkStats *out_stats);
+gboolean nm_platform_sysctl_get_stats (NMPlatform *self,
+                                       NMPlatformSysctlStats *out_stats);
+
 NMPlatformError nm_platform_ip_route_get (NMPlatform *self,
                                           int addr_family,
                                           gconstpointer address,
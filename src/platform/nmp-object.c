@@ -165,6 +165,26 @@ _idx_obj_part (const DedupMultiIdxType *idx_type,
 		/* just return 1, to indicate that obj_a is partitionable by this idx_type. */
 		return 1;
 
+	case NMP_CACHE_ID_TYPE_LINK_BY_ADDRESS:
+		if (   NMP_OBJECT_GET_TYPE (obj_a) != NMP_OBJECT_TYPE_LINK
+		    || obj_a->link.addr.len == 0) {
+			if (h)
+				nm_hash_update_val (h, obj_a);
+			return 0;
+		}
+		if (obj_b) {
+			return    NMP_OBJECT_GET_TYPE (obj_b) == NMP_OBJECT_TYPE_LINK
+			       && obj_a->link.addr.len == obj_b->link.addr.len
+			       && !memcmp (obj_a->link.addr.data, obj_b->link.addr.data, obj_a->link.addr.len);
+		}
+		if (h) {
+			nm_hash_update_vals (h,
+			                     idx_type->cache_id_type,
+			                     obj_a->link.addr.len);
+			nm_hash_update (h, obj_a->link.addr.data, obj_a->link.addr.len);
+		}
+		return 1;
+
 	case NMP_CACHE_ID_TYPE_DEFAULT_ROUTES:
 		if (   !NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_a), NMP_OBJECT_TYPE_IP4_ROUTE,
 		                                                NMP_OBJECT_TYPE_IP6_ROUTE)
@@ -211,6 +231,27 @@ _idx_obj_part (const DedupMultiIdxType *idx_type,
 		}
 		return 1;
 
+	case NMP_CACHE_ID_TYPE_ROUTES_BY_TABLE:
+		if (   !NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_a), NMP_OBJECT_TYPE_IP4_ROUTE,
+		                                                NMP_OBJECT_TYPE_IP6_ROUTE)
+		    || !nmp_object_is_visible (obj_a)) {
+			if (h)
+				nm_hash_update_val (h, obj_a);
+			return 0;
+		}
+		if (obj_b) {
+			return    NMP_OBJECT_GET_TYPE (obj_a) == NMP_OBJECT_GET_TYPE (obj_b)
+			       && obj_a->ip_route.table_coerced == obj_b->ip_route.table_coerced
+			       && nmp_object_is_visible (obj_b);
+		}
+		if (h) {
+			nm_hash_update_vals (h,
+			                     idx_type->cache_id_type,
+			                     NMP_OBJECT_GET_TYPE (obj_a),
+			                     obj_a->ip_route.table_coerced);
+		}
+		return 1;
+
 	case NMP_CACHE_ID_TYPE_ROUTES_BY_WEAK_ID:
 		obj_type = NMP_OBJECT_GET_TYPE (obj_a);
 		if (   !NM_IN_SET (obj_type, NMP_OBJECT_TYPE_IP4_ROUTE,
@@ -1246,6 +1287,7 @@ static const guint8 _supported_cache_ids_object[] = {
 static const guint8 _supported_cache_ids_link[] = {
 	NMP_CACHE_ID_TYPE_OBJECT_TYPE,
 	NMP_CACHE_ID_TYPE_LINK_BY_IFNAME,
+	NMP_CACHE_ID_TYPE_LINK_BY_ADDRESS,
 	0,
 };
 
@@ -1259,6 +1301,7 @@ static const guint8 _supported_cache_ids_ipx_route[] = {
 	NMP_CACHE_ID_TYPE_OBJECT_TYPE,
 	NMP_CACHE_ID_TYPE_OBJECT_BY_IFINDEX,
 	NMP_CACHE_ID_TYPE_DEFAULT_ROUTES,
+	NMP_CACHE_ID_TYPE_ROUTES_BY_TABLE,
 	NMP_CACHE_ID_TYPE_ROUTES_BY_WEAK_ID,
 	0,
 };
@@ -1570,6 +1613,24 @@ nmp_lookup_init_link_by_ifname (NMPLookup *lookup,
 	return _L (lookup);
 }
 
+const NMPLookup *
+nmp_lookup_init_link_by_address (NMPLookup *lookup,
+                                 gconstpointer address,
+                                 gsize length)
+{
+	NMPObject *o;
+
+	nm_assert (lookup);
+	nm_assert (address);
+	nm_assert (length > 0 && length <= sizeof (o->link.addr.data));
+
+	o = _nmp_object_stackinit_from_type (&lookup->selector_obj, NMP_OBJECT_TYPE_LINK);
+	memcpy (o->link.addr.data, address, length);
+	o->link.addr.len = length;
+	lookup->cache_id_type = NMP_CACHE_ID_TYPE_LINK_BY_ADDRESS;
+	return _L (lookup);
+}
+
 const NMPLookup *
 nmp_lookup_init_object (NMPLookup *lookup,
                         NMPObjectType obj_type,
@@ -1612,6 +1673,24 @@ nmp_lookup_init_route_default (NMPLookup *lookup,
 	return _L (lookup);
 }
 
+const NMPLookup *
+nmp_lookup_init_route_by_table (NMPLookup *lookup,
+                                NMPObjectType obj_type,
+                                guint32 table)
+{
+	NMPObject *o;
+
+	nm_assert (lookup);
+	nm_assert (NM_IN_SET (obj_type, NMP_OBJECT_TYPE_IP4_ROUTE,
+	                                NMP_OBJECT_TYPE_IP6_ROUTE));
+
+	o = _nmp_object_stackinit_from_type (&lookup->selector_obj, obj_type);
+	o->object.ifindex = 1;
+	o->ip_route.table_coerced = nm_platform_route_table_coerce (table);
+	lookup->cache_id_type = NMP_CACHE_ID_TYPE_ROUTES_BY_TABLE;
+	return _L (lookup);
+}
+
 const NMPLookup *
 nmp_lookup_init_route_by_weak_id (NMPLookup *lookup,
                                   const NMPObject *obj)
@@ -2465,6 +2544,33 @@ nmp_cache_dirty_set_all (NMPCache *cache, NMPObjectType obj_type)
 	                                     _nmp_object_stackinit_from_type (&obj_needle, obj_type));
 }
 
+/**
+ * nmp_cache_dirty_set_lookup:
+ * @cache: the #NMPCache
+ * @lookup: the partition of objects to mark as dirty.
+ *
+ * Like nmp_cache_dirty_set_all(), but only marks the objects
+ * of one partition, for example all routes on one ifindex.
+ */
+void
+nmp_cache_dirty_set_lookup (NMPCache *cache, const NMPLookup *lookup)
+{
+	NMDedupMultiIter iter;
+
+	nm_assert (cache);
+	nm_assert (lookup);
+
+	if (lookup->cache_id_type == NMP_CACHE_ID_TYPE_OBJECT_TYPE) {
+		nmp_cache_dirty_set_all (cache, NMP_OBJECT_GET_TYPE (&lookup->selector_obj));
+		return;
+	}
+
+	/* the dirty flag is tracked by the entries of the NMP_CACHE_ID_TYPE_OBJECT_TYPE
+	 * index. Mark those, and not the entries of @lookup's index. */
+	nm_dedup_multi_iter_for_each (&iter, nmp_cache_lookup (cache, lookup))
+		nm_dedup_multi_entry_set_dirty (_lookup_entry (cache, iter.current->obj), TRUE);
+}
+
 /*****************************************************************************/
 
 NMPCache *
@@ -77,6 +77,10 @@ typedef enum { /*< skip >*/
 	/* index for the link objects by ifname. */
 	NMP_CACHE_ID_TYPE_LINK_BY_IFNAME,
 
+	/* index for the link objects by hardware address. Links without
+	 * an address are not indexed. */
+	NMP_CACHE_ID_TYPE_LINK_BY_ADDRESS,
+
 	/* indeces for the visible default-routes, ignoring ifindex.
 	 * This index only contains two partitions: all visible default-routes,
 	 * separate for IPv4 and IPv6. */
@@ -85,6 +89,9 @@ typedef enum { /*< skip >*/
 	/* all the objects that have an ifindex (by object-type) for an ifindex. */
 	NMP_CACHE_ID_TYPE_OBJECT_BY_IFINDEX,
 
+	/* all the routes (by object-type) of a certain routing table. */
+	NMP_CACHE_ID_TYPE_ROUTES_BY_TABLE,
+
 	/* Consider all the destination fields of a route, that is, the ID without the ifindex
 	 * and gateway (meaning: network/plen,metric).
 	 * The reason for this is that `ip route change` can replace an existing route
@@ -565,11 +572,17 @@ const NMPLookup *nmp_lookup_init_obj_type (NMPLookup *lookup,
                                            NMPObjectType obj_type);
 const NMPLookup *nmp_lookup_init_link_by_ifname (NMPLookup *lookup,
                                                  const char *ifname);
+const NMPLookup *nmp_lookup_init_link_by_address (NMPLookup *lookup,
+                                                  gconstpointer address,
+                                                  gsize length);
 const NMPLookup *nmp_lookup_init_object (NMPLookup *lookup,
                                          NMPObjectType obj_type,
                                          int ifindex);
 const NMPLookup *nmp_lookup_init_route_default (NMPLookup *lookup,
                                                 NMPObjectType obj_type);
+const NMPLookup *nmp_lookup_init_route_by_table (NMPLookup *lookup,
+                                                 NMPObjectType obj_type,
+                                                 guint32 table);
 const NMPLookup *nmp_lookup_init_route_by_weak_id (NMPLookup *lookup,
                                                    const NMPObject *obj);
 const NMPLookup *nmp_lookup_init_ip4_route_by_weak_id (NMPLookup *lookup,
@@ -673,6 +686,7 @@ NMPCacheOpsType nmp_cache_update_link_master_connected (NMPCache *cache,
                                                         const NMPObject **out_obj_new);
 
 void nmp_cache_dirty_set_all (NMPCache *cache, NMPObjectType obj_type);
+void nmp_cache_dirty_set_lookup (NMPCache *cache, const NMPLookup *lookup);
 
 NMPCache *nmp_cache_new (NMDedupMultiIndex *multi_idx, gboolean use_udev);
 void nmp_cache_free (NMPCache *cache);
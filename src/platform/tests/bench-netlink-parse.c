@@ -0,0 +1,250 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2018 Red Hat, Inc.
+ */
+
+/* Benchmark for parsing netlink messages: replays a synthesized dump of
+ * many RTM_NEWROUTE messages through the parser, and reports the time and
+ * heap allocations per message and the memory per cached route as one JSON
+ * document on stdout.
+ *
+ * Run it with "make bench". */
+
+#include "nm-default.h"
+
+#include <linux/rtnetlink.h>
+#include <netlink/msg.h>
+
+#include "platform/nmp-object.h"
+#include "platform/nm-linux-platform.h"
+
+#define NMTST_BENCH_COUNT_ALLOCATIONS
+#include "tests/bench-utils.h"
+
+/*****************************************************************************/
+
+NMTST_DEFINE ();
+
+#define N_ROUTES 100000
+
+static void
+_dump_append_attr (GByteArray *dump, struct nlmsghdr **p_hdr, int type, gconstpointer data, gsize len)
+{
+	struct nlattr nla = {
+		.nla_len = NLA_HDRLEN + len,
+		.nla_type = type,
+	};
+	guint8 pad[NLA_ALIGNTO] = { 0 };
+	gsize hdr_offset = ((guint8 *) *p_hdr) - dump->data;
+
+	g_byte_array_append (dump, (const guint8 *) &nla, sizeof (nla));
+	g_byte_array_append (dump, data, len);
+	g_byte_array_append (dump, pad, NLA_ALIGN (len) - len);
+
+	/* the array might have been reallocated. */
+	*p_hdr = (struct nlmsghdr *) &dump->data[hdr_offset];
+	(*p_hdr)->nlmsg_len += NLA_HDRLEN + NLA_ALIGN (len);
+}
+
+/* Create a buffer with the messages that kernel sends in response to
+ * a RTM_GETROUTE dump request. */
+static GByteArray *
+_dump_create (guint n_routes)
+{
+	GByteArray *dump;
+	guint i;
+
+	dump = g_byte_array_sized_new (n_routes * 80 + 100);
+
+	for (i = 0; i < n_routes; i++) {
+		struct nlmsghdr nlh = {
+			.nlmsg_len = NLMSG_LENGTH (sizeof (struct rtmsg)),
+			.nlmsg_type = RTM_NEWROUTE,
+			.nlmsg_flags = NLM_F_MULTI,
+			.nlmsg_seq = 1,
+		};
+		struct rtmsg rtm = {
+			.rtm_family = AF_INET,
+			.rtm_dst_len = 32,
+			.rtm_table = RT_TABLE_MAIN,
+			.rtm_protocol = RTPROT_STATIC,
+			.rtm_scope = RT_SCOPE_UNIVERSE,
+			.rtm_type = RTN_UNICAST,
+		};
+		struct nlmsghdr *hdr;
+		guint32 u32;
+		in_addr_t addr;
+
+		g_byte_array_append (dump, (const guint8 *) &nlh, NLMSG_HDRLEN);
+		g_byte_array_append (dump, (const guint8 *) &rtm, NLMSG_ALIGN (sizeof (rtm)));
+		hdr = (struct nlmsghdr *) &dump->data[dump->len - NLMSG_LENGTH (sizeof (rtm))];
+
+		u32 = RT_TABLE_MAIN;
+		_dump_append_attr (dump, &hdr, RTA_TABLE, &u32, sizeof (u32));
+		addr = htonl (0x0a000000u + i);
+		_dump_append_attr (dump, &hdr, RTA_DST, &addr, sizeof (addr));
+		u32 = 100 + (i % 10);
+		_dump_append_attr (dump, &hdr, RTA_PRIORITY, &u32, sizeof (u32));
+		addr = htonl (0xc0a80101u);
+		_dump_append_attr (dump, &hdr, RTA_GATEWAY, &addr, sizeof (addr));
+		u32 = 1 + (i % 5);
+		_dump_append_attr (dump, &hdr, RTA_OIF, &u32, sizeof (u32));
+	}
+
+	{
+		struct nlmsghdr nlh = {
+			.nlmsg_len = NLMSG_LENGTH (sizeof (int)),
+			.nlmsg_type = NLMSG_DONE,
+			.nlmsg_flags = NLM_F_MULTI,
+			.nlmsg_seq = 1,
+		};
+		int zero = 0;
+
+		g_byte_array_append (dump, (const guint8 *) &nlh, NLMSG_HDRLEN);
+		g_byte_array_append (dump, (const guint8 *) &zero, sizeof (zero));
+	}
+
+	return dump;
+}
+
+static guint
+_dump_parse (GByteArray *dump, gboolean with_nl_msg)
+{
+	struct nlmsghdr *hdr;
+	int remaining;
+	guint n_parsed = 0;
+
+	remaining = dump->len;
+	hdr = (struct nlmsghdr *) dump->data;
+	for (; nlmsg_ok (hdr, remaining); hdr = nlmsg_next (hdr, &remaining)) {
+		nm_auto_nmpobj NMPObject *obj = NULL;
+
+		if (hdr->nlmsg_type == NLMSG_DONE)
+			break;
+
+		if (with_nl_msg) {
+			struct nl_msg *msg;
+
+			/* the previous receive path, which copied each message into a
+			 * struct nl_msg before parsing it. */
+			msg = nlmsg_convert (hdr);
+			g_assert (msg);
+			obj = nmp_object_new_from_nl (NULL, NULL, nlmsg_hdr (msg), FALSE);
+			nlmsg_free (msg);
+		} else
+			obj = nmp_object_new_from_nl (NULL, NULL, hdr, FALSE);
+
+		g_assert (obj);
+		g_assert_cmpint (NMP_OBJECT_GET_TYPE (obj), ==, NMP_OBJECT_TYPE_IP4_ROUTE);
+		g_assert_cmpint (obj->ip4_route.plen, ==, 32);
+		n_parsed++;
+	}
+
+	return n_parsed;
+}
+
+static void
+bench_parse_route_dump (GByteArray *dump, gboolean with_nl_msg)
+{
+	NmtstBenchPhase phase;
+	guint n_parsed;
+
+	/* warm up (the caches). */
+	_dump_parse (dump, with_nl_msg);
+
+	nmtst_bench_phase_start (&phase,
+	                         with_nl_msg ? "parse-with-nl-msg" : "parse-in-place",
+	                         0);
+	n_parsed = _dump_parse (dump, with_nl_msg);
+	phase.n_items = n_parsed;
+	nmtst_bench_phase_end (&phase);
+
+	g_assert_cmpint (n_parsed, ==, N_ROUTES);
+}
+
+/* The heap-bytes of the phase divided by its items is the memory
+ * per cached route. */
+static void
+bench_cache_route (GByteArray *dump)
+{
+	NmtstBenchPhase phase;
+	NMDedupMultiIndex *multi_idx;
+	NMPCache *cache;
+	struct nlmsghdr *hdr;
+	int remaining;
+
+	nmtst_bench_phase_start (&phase, "cache-route", 0);
+
+	multi_idx = nm_dedup_multi_index_new ();
+	cache = nmp_cache_new (multi_idx, FALSE);
+
+	remaining = dump->len;
+	hdr = (struct nlmsghdr *) dump->data;
+	for (; nlmsg_ok (hdr, remaining); hdr = nlmsg_next (hdr, &remaining)) {
+		nm_auto_nmpobj NMPObject *obj = NULL;
+		NMPCacheOpsType ops_type;
+
+		if (hdr->nlmsg_type == NLMSG_DONE)
+			break;
+
+		obj = nmp_object_new_from_nl (NULL, cache, hdr, FALSE);
+		g_assert (obj);
+		ops_type = nmp_cache_update_netlink_route (cache, obj, TRUE, hdr->nlmsg_flags,
+		                                           NULL, NULL, NULL, NULL);
+		g_assert_cmpint (ops_type, ==, NMP_CACHE_OPS_ADDED);
+		phase.n_items++;
+	}
+
+	nmtst_bench_phase_end (&phase);
+
+	g_assert_cmpint (phase.n_items, ==, N_ROUTES);
+
+	nmp_cache_free (cache);
+	nm_dedup_multi_index_unref (multi_idx);
+}
+
+/*****************************************************************************/
+
+int
+main (int argc, char **argv)
+{
+	GOptionEntry options[] = {
+		{ 0 },
+	};
+	GByteArray *dump;
+
+	if (!nmtst_bench_init (&argc, &argv,
+	                       "Benchmark parsing a netlink dump of many routes.",
+	                       options))
+		return 2;
+
+	dump = _dump_create (N_ROUTES);
+
+	bench_parse_route_dump (dump, FALSE);
+	bench_parse_route_dump (dump, TRUE);
+	bench_cache_route (dump);
+
+	g_byte_array_unref (dump);
+
+	nmtst_bench_print ("netlink-parse",
+	                   "routes", N_ROUTES,
+	                   "nmpobject-bytes", (int) (  nmp_class_from_type (NMP_OBJECT_TYPE_IP4_ROUTE)->sizeof_data
+	                                             + G_STRUCT_OFFSET (NMPObject, object)),
+	                   NULL);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,311 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2018 Red Hat, Inc.
+ */
+
+/* Scale benchmark: N VLAN devices x M routes x K connection profiles on
+ * top of the fake platform. Each phase reports wall-clock and CPU time,
+ * the peak RSS and the number of heap allocations as one JSON document
+ * on stdout, so that runs can be compared by a script.
+ *
+ * Run it with "make bench". */
+
+#include "nm-default.h"
+
+#include "nm-keyfile-internal.h"
+#include "NetworkManagerUtils.h"
+#include "platform/nm-fake-platform.h"
+
+#define NMTST_BENCH_COUNT_ALLOCATIONS
+#include "tests/bench-utils.h"
+
+/*****************************************************************************/
+
+NMTST_DEFINE ();
+
+static struct {
+	int n_devices;
+	int n_routes;
+	int n_connections;
+	int n_flaps;
+	int n_match_devices;
+} global_opt = {
+	.n_devices = 5000,
+	.n_routes = 500000,
+	.n_connections = 10000,
+	.n_flaps = 10,
+	.n_match_devices = 50,
+};
+
+/* VLAN ids must be unique per parent, so spread the VLANs over
+ * several parent links. */
+#define VLANS_PER_PARENT 4000
+
+typedef struct {
+	char name[IFNAMSIZ];
+	char parent[IFNAMSIZ];
+	int ifindex;
+	int vlan_id;
+} BenchLink;
+
+/*****************************************************************************/
+
+static void
+_link_changed_cb (NMPlatform *platform,
+                  int obj_type_i,
+                  int ifindex,
+                  const NMPlatformLink *plink,
+                  int change_type_i,
+                  guint *p_n_signals)
+{
+	(*p_n_signals)++;
+}
+
+static BenchLink *
+bench_vlan_add (NMPlatform *platform)
+{
+	BenchLink *links;
+	NmtstBenchPhase phase;
+	int n_parents;
+	int i;
+
+	n_parents = (global_opt.n_devices + VLANS_PER_PARENT - 1) / VLANS_PER_PARENT;
+	for (i = 0; i < n_parents; i++) {
+		g_assert_cmpint (nm_platform_link_dummy_add (platform,
+		                                             nm_sprintf_bufa (IFNAMSIZ, "bparent%d", i),
+		                                             NULL), ==, NM_PLATFORM_ERROR_SUCCESS);
+	}
+
+	links = g_new0 (BenchLink, global_opt.n_devices);
+
+	nmtst_bench_phase_start (&phase, "vlan-add", 0);
+	for (i = 0; i < global_opt.n_devices; i++) {
+		BenchLink *l = &links[i];
+		const NMPlatformLink *plink;
+		int parent_ifindex;
+
+		nm_sprintf_buf (l->name, "bvlan%d", i);
+		nm_sprintf_buf (l->parent, "bparent%d", i / VLANS_PER_PARENT);
+		l->vlan_id = 1 + (i % VLANS_PER_PARENT);
+
+		parent_ifindex = nm_platform_link_get_ifindex (platform, l->parent);
+		g_assert_cmpint (parent_ifindex, >, 0);
+
+		if (nm_platform_link_vlan_add (platform, l->name, parent_ifindex, l->vlan_id, 0, &plink) != NM_PLATFORM_ERROR_SUCCESS)
+			g_error ("failure to add vlan %s", l->name);
+		l->ifindex = plink->ifindex;
+		nm_platform_link_set_up (platform, l->ifindex, NULL);
+		phase.n_items++;
+	}
+	nmtst_bench_phase_end (&phase);
+
+	return links;
+}
+
+static void
+bench_route_add (NMPlatform *platform, const BenchLink *links)
+{
+	NmtstBenchPhase phase;
+	int i;
+
+	nmtst_bench_phase_start (&phase, "route-add", 0);
+	for (i = 0; i < global_opt.n_routes; i++) {
+		const NMPlatformIP4Route route = {
+			.ifindex = links[i % global_opt.n_devices].ifindex,
+			.rt_source = NM_IP_CONFIG_SOURCE_USER,
+			.network = htonl (0x0a000000u + i),
+			.plen = 32,
+			.metric = 100 + (i % 10),
+		};
+
+		if (nm_platform_ip4_route_add (platform, NMP_NLM_FLAG_REPLACE, &route) != NM_PLATFORM_ERROR_SUCCESS)
+			g_error ("failure to add route %d", i);
+		phase.n_items++;
+	}
+	nmtst_bench_phase_end (&phase);
+}
+
+static void
+bench_carrier_flap (NMPlatform *platform, const BenchLink *links)
+{
+	NmtstBenchPhase phase;
+	guint n_signals = 0;
+	gulong handler_id;
+	int r, i;
+
+	handler_id = g_signal_connect (platform, NM_PLATFORM_SIGNAL_LINK_CHANGED, G_CALLBACK (_link_changed_cb), &n_signals);
+
+	nmtst_bench_phase_start (&phase, "carrier-flap", 0);
+	for (r = 0; r < global_opt.n_flaps; r++) {
+		for (i = 0; i < global_opt.n_devices; i++)
+			nm_platform_link_set_down (platform, links[i].ifindex);
+		for (i = 0; i < global_opt.n_devices; i++)
+			nm_platform_link_set_up (platform, links[i].ifindex, NULL);
+	}
+	phase.n_items = n_signals;
+	nmtst_bench_phase_end (&phase);
+
+	g_signal_handler_disconnect (platform, handler_id);
+}
+
+static NMConnection *
+_connection_new (int i, const char *id)
+{
+	gs_unref_keyfile GKeyFile *keyfile = NULL;
+	gs_free char *data = NULL;
+	gs_free char *filename = NULL;
+	gs_free_error GError *error = NULL;
+	NMConnection *connection;
+
+	data = g_strdup_printf ("[connection]\n"
+	                        "id=%s\n"
+	                        "type=vlan\n"
+	                        "interface-name=bvlan%d\n"
+	                        "\n"
+	                        "[vlan]\n"
+	                        "id=%d\n"
+	                        "parent=bparent%d\n"
+	                        "\n"
+	                        "[ipv4]\n"
+	                        "method=auto\n"
+	                        "\n"
+	                        "[ipv6]\n"
+	                        "method=auto\n",
+	                        id,
+	                        i,
+	                        1 + (i % VLANS_PER_PARENT),
+	                        i / VLANS_PER_PARENT);
+	filename = g_strdup_printf (NMCONFDIR "/system-connections/%s", id);
+
+	keyfile = g_key_file_new ();
+	if (!g_key_file_load_from_data (keyfile, data, -1, G_KEY_FILE_NONE, &error))
+		g_error ("failure to load keyfile %s: %s", filename, error->message);
+
+	connection = nm_keyfile_read (keyfile, filename, NULL, NULL, NULL, &error);
+	if (   !connection
+	    || !nm_connection_normalize (connection, NULL, NULL, &error))
+		g_error ("failure to read keyfile %s: %s", filename, error->message);
+	return connection;
+}
+
+static GPtrArray *
+bench_keyfile_read (void)
+{
+	GPtrArray *connections;
+	NmtstBenchPhase phase;
+	char id[50];
+	int i;
+
+	connections = g_ptr_array_new_full (global_opt.n_connections, g_object_unref);
+
+	/* the first profiles match the VLANs, the rest refer to
+	 * interfaces that don't exist. */
+	nmtst_bench_phase_start (&phase, "keyfile-read", global_opt.n_connections);
+	for (i = 0; i < global_opt.n_connections; i++)
+		g_ptr_array_add (connections, _connection_new (i, nm_sprintf_buf (id, "bench-%d", i)));
+	nmtst_bench_phase_end (&phase);
+
+	return connections;
+}
+
+static void
+bench_connection_match (GPtrArray *connections)
+{
+	gs_free NMConnection **list = NULL;
+	NmtstBenchPhase phase;
+	char id[50];
+	int n_matching;
+	int n_devices;
+	int i;
+
+	/* what the manager does when it looks for a profile for an existing
+	 * device on startup: generate a connection from the device and match
+	 * it against the profiles. That diffs the profiles in order until one
+	 * matches, so take the devices whose profiles come last, and only
+	 * some of them. */
+	n_matching = MIN (global_opt.n_devices, global_opt.n_connections);
+	n_devices = MIN (global_opt.n_match_devices, n_matching);
+
+	list = g_new (NMConnection *, connections->len + 1);
+	memcpy (list, connections->pdata, sizeof (NMConnection *) * connections->len);
+	list[connections->len] = NULL;
+
+	nmtst_bench_phase_start (&phase, "connection-match", 0);
+	for (i = n_matching - n_devices; i < n_matching; i++) {
+		gs_unref_object NMConnection *generated = NULL;
+		NMConnection *matched;
+
+		generated = _connection_new (i, nm_sprintf_buf (id, "generated-%d", i));
+		matched = nm_utils_match_connection (list, generated, FALSE, TRUE, -1, -1, NULL, NULL);
+		g_assert (matched == connections->pdata[i]);
+
+		/* the number of profiles compared. */
+		phase.n_items += i + 1;
+	}
+	nmtst_bench_phase_end (&phase);
+}
+
+/*****************************************************************************/
+
+int
+main (int argc, char **argv)
+{
+	GOptionEntry options[] = {
+		{ "devices", 'd', 0, G_OPTION_ARG_INT, &global_opt.n_devices, "Number of VLAN devices", "N" },
+		{ "routes", 'r', 0, G_OPTION_ARG_INT, &global_opt.n_routes, "Number of routes", "M" },
+		{ "connections", 'c', 0, G_OPTION_ARG_INT, &global_opt.n_connections, "Number of connection profiles", "K" },
+		{ "flaps", 'f', 0, G_OPTION_ARG_INT, &global_opt.n_flaps, "Number of carrier flaps per device", "F" },
+		{ "match-devices", 0, 0, G_OPTION_ARG_INT, &global_opt.n_match_devices, "Number of devices to match against all profiles", "D" },
+		{ 0 },
+	};
+	NMPlatform *platform;
+	gs_unref_ptrarray GPtrArray *connections = NULL;
+	gs_free BenchLink *links = NULL;
+
+	if (!nmtst_bench_init (&argc, &argv,
+	                       "Benchmark NetworkManager with many devices, routes and connection profiles.",
+	                       options))
+		return 2;
+
+	if (   global_opt.n_devices <= 0
+	    || global_opt.n_routes < 0
+	    || global_opt.n_connections < 0
+	    || global_opt.n_flaps < 0
+	    || global_opt.n_match_devices < 0) {
+		g_warning ("Invalid arguments: there must be at least one device");
+		return 2;
+	}
+
+	nm_fake_platform_setup ();
+	platform = NM_PLATFORM_GET;
+
+	links = bench_vlan_add (platform);
+	bench_route_add (platform, links);
+	bench_carrier_flap (platform, links);
+	connections = bench_keyfile_read ();
+	bench_connection_match (connections);
+
+	nmtst_bench_print ("scale",
+	                   "devices", global_opt.n_devices,
+	                   "routes", global_opt.n_routes,
+	                   "connections", global_opt.n_connections,
+	                   "flaps", global_opt.n_flaps,
+	                   "match-devices", global_opt.n_match_devices,
+	                   NULL);
+	return EXIT_SUCCESS;
+}
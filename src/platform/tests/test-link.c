@@ -101,6 +101,113 @@ test_loopback (void)
 	g_assert (!nm_platform_link_supports_vlans (NM_PLATFORM_GET, LO_INDEX));
 }
 
+typedef struct {
+	GMainLoop *loop;
+	guint n_called;
+	NMPlatformLinkStatsSubscription *sub_other;
+} LinkStatsData;
+
+static void
+_link_stats_cb (NMPlatform *platform, const GArray *stats, gpointer user_data)
+{
+	LinkStatsData *data = user_data;
+
+	g_assert (nm_platform_link_stats_lookup (stats, LO_INDEX));
+	g_assert (!nm_platform_link_stats_lookup (stats, 0));
+
+	/* unsubscribing during the callback is allowed. */
+	if (data->sub_other) {
+		nm_platform_link_stats_unsubscribe (platform, data->sub_other);
+		data->sub_other = NULL;
+	}
+
+	if (++data->n_called == 2)
+		g_main_loop_quit (data->loop);
+}
+
+static void
+_link_stats_other_cb (NMPlatform *platform, const GArray *stats, gpointer user_data)
+{
+	g_assert_not_reached ();
+}
+
+static void
+test_link_stats (void)
+{
+	LinkStatsData data = {
+		.loop = g_main_loop_new (NULL, FALSE),
+	};
+	gs_unref_array GArray *stats = NULL;
+	NMPlatformLinkStatsSubscription *sub;
+
+	stats = nm_platform_link_get_all_stats (NM_PLATFORM_GET);
+	g_assert (stats);
+	g_assert_cmpint (nm_platform_link_stats_lookup (stats, LO_INDEX)->ifindex, ==, LO_INDEX);
+
+	/* both subscriptions share a group. The first one unsubscribes the
+	 * second, before it is called. */
+	sub = nm_platform_link_stats_subscribe (NM_PLATFORM_GET, 50, _link_stats_cb, &data);
+	data.sub_other = nm_platform_link_stats_subscribe (NM_PLATFORM_GET, 50, _link_stats_other_cb, NULL);
+
+	g_assert (nmtst_main_loop_run (data.loop, 5000));
+	g_assert_cmpint (data.n_called, ==, 2);
+	g_assert (!data.sub_other);
+
+	nm_platform_link_stats_unsubscribe (NM_PLATFORM_GET, sub);
+	g_main_loop_unref (data.loop);
+}
+
+typedef struct {
+	GMainLoop *loop;
+	int ifindex;
+	guint n_called;
+} LinkAsyncData;
+
+static void
+_link_set_up_async_cb (NMPlatform *platform, NMPlatformError result, gpointer user_data)
+{
+	LinkAsyncData *data = user_data;
+
+	g_assert_cmpint (result, ==, NM_PLATFORM_ERROR_SUCCESS);
+	g_assert_cmpint (data->n_called++, ==, 0);
+
+	/* the cache is already up to date. */
+	g_assert (nm_platform_link_is_up (platform, data->ifindex));
+}
+
+static void
+_link_set_mtu_async_cb (NMPlatform *platform, NMPlatformError result, gpointer user_data)
+{
+	LinkAsyncData *data = user_data;
+
+	g_assert_cmpint (result, ==, NM_PLATFORM_ERROR_SUCCESS);
+	g_assert_cmpint (data->n_called++, ==, 1);
+	g_assert_cmpint (nm_platform_link_get_mtu (platform, data->ifindex), ==, 1400);
+	g_main_loop_quit (data->loop);
+}
+
+static void
+test_link_set_async (void)
+{
+	LinkAsyncData data = {
+		.loop = g_main_loop_new (NULL, FALSE),
+	};
+
+	data.ifindex = nmtstp_link_dummy_add (NM_PLATFORM_GET, FALSE, DEVICE_NAME)->ifindex;
+
+	nm_platform_link_set_up_async (NM_PLATFORM_GET, data.ifindex, _link_set_up_async_cb, &data);
+	nm_platform_link_set_mtu_async (NM_PLATFORM_GET, data.ifindex, 1400, _link_set_mtu_async_cb, &data);
+
+	/* the callbacks are never invoked synchronously. */
+	g_assert_cmpint (data.n_called, ==, 0);
+
+	g_assert (nmtst_main_loop_run (data.loop, 2000));
+	g_assert_cmpint (data.n_called, ==, 2);
+
+	nmtstp_link_del (NM_PLATFORM_GET, FALSE, data.ifindex, DEVICE_NAME);
+	g_main_loop_unref (data.loop);
+}
+
 static gboolean
 software_add (NMLinkType link_type, const char *name)
 {
@@ -533,7 +640,127 @@ test_bridge_addr (void)
 	g_assert_cmpint (plink->addr.len, ==, sizeof (addr));
 	g_assert (!memcmp (plink->addr.data, addr, sizeof (addr)));
 
+	plink = nm_platform_link_get_by_address (NM_PLATFORM_GET, addr, sizeof (addr));
+	g_assert (plink);
+	g_assert_cmpint (plink->ifindex, ==, link.ifindex);
+
 	nmtstp_link_del (NULL, -1, link.ifindex, link.name);
+
+	g_assert (!nm_platform_link_get_by_address (NM_PLATFORM_GET, addr, sizeof (addr)));
+}
+
+/*****************************************************************************/
+
+static void
+test_link_facts_prefetch (void)
+{
+	const NMPlatformLink *plink;
+	int ifindex;
+	gs_free char *driver1 = NULL;
+	gs_free char *driver2 = NULL;
+	guint8 perm1[NM_UTILS_HWADDR_LEN_MAX];
+	guint8 perm2[NM_UTILS_HWADDR_LEN_MAX];
+	size_t perm1_len = 0, perm2_len = 0;
+	gboolean perm1_ok, perm2_ok;
+
+	plink = nmtstp_link_dummy_add (NM_PLATFORM_GET, FALSE, DEVICE_NAME);
+	ifindex = plink->ifindex;
+
+	g_assert (nm_platform_link_get_driver_info (NM_PLATFORM_GET, ifindex, &driver1, NULL, NULL));
+	perm1_ok = nm_platform_link_get_permanent_address (NM_PLATFORM_GET, ifindex, perm1, &perm1_len);
+
+	nm_platform_link_facts_prefetch (NM_PLATFORM_GET, &ifindex, 1);
+
+	g_assert (nm_platform_link_get_driver_info (NM_PLATFORM_GET, ifindex, &driver2, NULL, NULL));
+	perm2_ok = nm_platform_link_get_permanent_address (NM_PLATFORM_GET, ifindex, perm2, &perm2_len);
+
+	g_assert_cmpstr (driver1, ==, driver2);
+	g_assert_cmpint (perm1_ok, ==, perm2_ok);
+	if (perm1_ok) {
+		g_assert_cmpint (perm1_len, ==, perm2_len);
+		g_assert (!memcmp (perm1, perm2, perm1_len));
+	}
+	g_assert_cmpint (nm_platform_link_supports_sriov (NM_PLATFORM_GET, ifindex), ==, FALSE);
+
+	nm_platform_link_facts_clear (NM_PLATFORM_GET);
+
+	nmtstp_link_del (NULL, -1, ifindex, DEVICE_NAME);
+}
+
+/*****************************************************************************/
+
+typedef struct {
+	GArray *received;
+	GMainLoop *loop;
+} TestChangesData;
+
+static void
+_test_changes_cb (NMPlatform *platform,
+                  const NMPlatformChangeSet *change_set,
+                  gpointer user_data)
+{
+	TestChangesData *data = user_data;
+	NMPlatformChangeSet c = *change_set;
+
+	c.ip6_dad_failed = NULL;
+	g_array_append_val (data->received, c);
+	if (data->loop)
+		g_main_loop_quit (data->loop);
+}
+
+static void
+test_changes_coalesce (void)
+{
+	TestChangesData data = { };
+	NMPlatformChangesSubscription *sub;
+	const NMPlatformChangeSet *c;
+	int ifindex;
+	guint i;
+
+	data.received = g_array_new (FALSE, FALSE, sizeof (NMPlatformChangeSet));
+
+	ifindex = nmtstp_link_dummy_add (NM_PLATFORM_GET, FALSE, DEVICE_NAME)->ifindex;
+	sub = nm_platform_changes_subscribe (NM_PLATFORM_GET, ifindex, _test_changes_cb, &data);
+
+	/* without a window, every change is passed on right away. */
+	g_assert (nm_platform_link_set_up (NM_PLATFORM_GET, ifindex, NULL));
+	g_assert_cmpint (data.received->len, >, 0);
+	for (i = 0; i < data.received->len; i++) {
+		c = &g_array_index (data.received, NMPlatformChangeSet, i);
+		g_assert_cmpint (c->ifindex, ==, ifindex);
+		g_assert_cmpint (c->n_events, ==, 1);
+	}
+	g_array_set_size (data.received, 0);
+
+	/* with a window, a burst is passed on as one change set. The window is
+	 * long enough that it does not end while the test adds the addresses. */
+	nm_platform_changes_set_window (NM_PLATFORM_GET, 1000, 2000);
+	for (i = 0; i < 5; i++) {
+		in_addr_t a = nmtst_inet4_from_string ("192.0.2.1") + htonl (i);
+
+		nmtstp_ip4_address_add (NM_PLATFORM_GET, FALSE, ifindex, a, 24, a,
+		                        NM_PLATFORM_LIFETIME_PERMANENT, NM_PLATFORM_LIFETIME_PERMANENT,
+		                        0, NULL);
+	}
+	g_assert (nm_platform_link_set_down (NM_PLATFORM_GET, ifindex));
+	g_assert_cmpint (data.received->len, ==, 0);
+
+	data.loop = g_main_loop_new (NULL, FALSE);
+	g_assert (nmtst_main_loop_run (data.loop, 5000));
+	g_clear_pointer (&data.loop, g_main_loop_unref);
+
+	g_assert_cmpint (data.received->len, ==, 1);
+	c = &g_array_index (data.received, NMPlatformChangeSet, 0);
+	g_assert_cmpint (c->ifindex, ==, ifindex);
+	g_assert (NM_FLAGS_ALL (c->changes,   NM_PLATFORM_CHANGE_IP4_ADDRESS
+	                                    | NM_PLATFORM_CHANGE_LINK_CHANGED));
+	g_assert_cmpint (c->n_events, >=, 6);
+
+	nm_platform_changes_set_window (NM_PLATFORM_GET, 0, 0);
+	nm_platform_changes_unsubscribe (NM_PLATFORM_GET, sub);
+	g_array_unref (data.received);
+
+	nmtstp_link_del (NULL, -1, ifindex, DEVICE_NAME);
 }
 
 /*****************************************************************************/
@@ -1970,6 +2197,51 @@ _check_sysctl_skip (void)
 		g_assert_cmpstr (_val, ==, value); \
 	} G_STMT_END
 
+static void
+test_sysctl_shadow (void)
+{
+	const char *const path = "/proc/sys/net/ipv6/conf/" DEVICE_NAME "/accept_ra";
+	NMPlatformSysctlStats stats_0, stats;
+	gs_free char *value_default = NULL;
+	int ifindex;
+
+	if (_check_sysctl_skip ())
+		return;
+
+	value_default = nm_platform_sysctl_get (NM_PLATFORM_GET, NMP_SYSCTL_PATHID_ABSOLUTE ("/proc/sys/net/ipv6/conf/default/accept_ra"));
+	g_assert (value_default);
+	g_assert_cmpstr (value_default, !=, "0");
+
+	ifindex = nmtstp_link_dummy_add (NM_PLATFORM_GET, FALSE, DEVICE_NAME)->ifindex;
+
+	g_assert (nm_platform_sysctl_get_stats (NM_PLATFORM_GET, &stats_0));
+
+	/* the second write is skipped. */
+	g_assert (nm_platform_sysctl_set (NM_PLATFORM_GET, NMP_SYSCTL_PATHID_ABSOLUTE (path), "0"));
+	g_assert (nm_platform_sysctl_set (NM_PLATFORM_GET, NMP_SYSCTL_PATHID_ABSOLUTE (path), "0"));
+	nm_platform_sysctl_get_stats (NM_PLATFORM_GET, &stats);
+	g_assert_cmpint (stats.n_writes - stats_0.n_writes, ==, 2);
+	g_assert_cmpint (stats.n_writes_elided - stats_0.n_writes_elided, ==, 1);
+	_sysctl_assert_eq (NM_PLATFORM_GET, path, "0");
+
+	/* reading the value notices changes from outside. */
+	nmtstp_run_command_check ("echo 1 > %s", path);
+	_sysctl_assert_eq (NM_PLATFORM_GET, path, "1");
+	g_assert (nm_platform_sysctl_set (NM_PLATFORM_GET, NMP_SYSCTL_PATHID_ABSOLUTE (path), "0"));
+	_sysctl_assert_eq (NM_PLATFORM_GET, path, "0");
+
+	/* a new link with the same name starts with the default value. */
+	nmtstp_link_del (NM_PLATFORM_GET, FALSE, ifindex, DEVICE_NAME);
+	ifindex = nmtstp_link_dummy_add (NM_PLATFORM_GET, FALSE, DEVICE_NAME)->ifindex;
+	nm_platform_sysctl_get_stats (NM_PLATFORM_GET, &stats_0);
+	g_assert (nm_platform_sysctl_set (NM_PLATFORM_GET, NMP_SYSCTL_PATHID_ABSOLUTE (path), "0"));
+	nm_platform_sysctl_get_stats (NM_PLATFORM_GET, &stats);
+	g_assert_cmpint (stats.n_writes_elided, ==, stats_0.n_writes_elided);
+	_sysctl_assert_eq (NM_PLATFORM_GET, path, "0");
+
+	nmtstp_link_del (NM_PLATFORM_GET, FALSE, ifindex, DEVICE_NAME);
+}
+
 static void
 test_netns_general (gpointer fixture, gconstpointer test_data)
 {
@@ -2535,12 +2807,16 @@ _nmtstp_setup_tests (void)
 
 	g_test_add_func ("/link/bogus", test_bogus);
 	g_test_add_func ("/link/loopback", test_loopback);
+	g_test_add_func ("/link/stats", test_link_stats);
+	g_test_add_func ("/link/set-async", test_link_set_async);
 	g_test_add_func ("/link/internal", test_internal);
 	g_test_add_func ("/link/software/bridge", test_bridge);
 	g_test_add_func ("/link/software/bond", test_bond);
 	g_test_add_func ("/link/software/team", test_team);
 	g_test_add_func ("/link/software/vlan", test_vlan);
 	g_test_add_func ("/link/software/bridge/addr", test_bridge_addr);
+	g_test_add_func ("/link/facts-prefetch", test_link_facts_prefetch);
+	g_test_add_func ("/link/changes-coalesce", test_changes_coalesce);
 
 	if (nmtstp_is_root_test ()) {
 		g_test_add_func ("/link/external", test_external);
@@ -2561,6 +2837,7 @@ _nmtstp_setup_tests (void)
 		g_test_add_data_func ("/link/create-many-links/1000", GUINT_TO_POINTER (1000), test_create_many_links);
 
 		g_test_add_func ("/link/nl-bugs/veth", test_nl_bugs_veth);
+		g_test_add_func ("/link/sysctl-shadow", test_sysctl_shadow);
 		g_test_add_func ("/link/nl-bugs/spurious-newlink", test_nl_bugs_spuroius_newlink);
 		g_test_add_func ("/link/nl-bugs/spurious-dellink", test_nl_bugs_spuroius_dellink);
 
@@ -22,6 +22,7 @@
 
 #include <libudev.h>
 #include <linux/pkt_sched.h>
+#include <linux/rtnetlink.h>
 
 #include "platform/nmp-object.h"
 #include "nm-utils/nm-udev-utils.h"
@@ -544,6 +545,93 @@ test_cache_qdisc (void)
 
 /*****************************************************************************/
 
+static NMPObject *
+_ip4_route_new (int ifindex, const char *network, guint32 table)
+{
+	const NMPlatformIP4Route r = {
+		.ifindex = ifindex,
+		.network = nmtst_inet4_from_string (network),
+		.plen = 24,
+		.metric = 20,
+		.table_coerced = nm_platform_route_table_coerce (table),
+	};
+
+	return nmp_object_new (NMP_OBJECT_TYPE_IP4_ROUTE, (const NMPlatformObject *) &r);
+}
+
+static guint
+_lookup_route_by_table (NMPCache *cache, NMPObjectType obj_type, guint32 table)
+{
+	NMPLookup lookup;
+	const NMDedupMultiHeadEntry *head_entry;
+	NMDedupMultiIter iter;
+	const NMPObject *o;
+
+	head_entry = nmp_cache_lookup (cache,
+	                               nmp_lookup_init_route_by_table (&lookup, obj_type, table));
+	if (!head_entry)
+		return 0;
+
+	nmp_cache_iter_for_each (&iter, head_entry, &o) {
+		g_assert_cmpint (NMP_OBJECT_GET_TYPE (o), ==, obj_type);
+		g_assert_cmpint (nm_platform_route_table_uncoerce (o->ip_route.table_coerced, TRUE), ==, table);
+	}
+	return head_entry->len;
+}
+
+static void
+test_cache_route_by_table (void)
+{
+	NMPCache *cache;
+	nm_auto_unref_dedup_multi_index NMDedupMultiIndex *multi_idx = NULL;
+	NMPLookup lookup;
+	nm_auto_nmpobj NMPObject *obj_main = _ip4_route_new (1, "192.168.1.0", RT_TABLE_MAIN);
+	nm_auto_nmpobj NMPObject *obj_100a = _ip4_route_new (1, "192.168.2.0", 100);
+	nm_auto_nmpobj NMPObject *obj_100b = _ip4_route_new (2, "192.168.3.0", 100);
+	nm_auto_nmpobj NMPObject *obj_200 = _ip4_route_new (2, "192.168.4.0", 200);
+	nm_auto_nmpobj NMPObject *obj_100a_dump = NULL;
+
+	multi_idx = nm_dedup_multi_index_new ();
+	cache = nmp_cache_new (multi_idx, nmtst_get_rand_int () % 2);
+
+	g_assert (nmp_cache_update_netlink_route (cache, obj_main, FALSE, 0, NULL, NULL, NULL, NULL) == NMP_CACHE_OPS_ADDED);
+	g_assert (nmp_cache_update_netlink_route (cache, obj_100a, FALSE, 0, NULL, NULL, NULL, NULL) == NMP_CACHE_OPS_ADDED);
+	g_assert (nmp_cache_update_netlink_route (cache, obj_100b, FALSE, 0, NULL, NULL, NULL, NULL) == NMP_CACHE_OPS_ADDED);
+	g_assert (nmp_cache_update_netlink_route (cache, obj_200, FALSE, 0, NULL, NULL, NULL, NULL) == NMP_CACHE_OPS_ADDED);
+
+	g_assert_cmpint (_lookup_route_by_table (cache, NMP_OBJECT_TYPE_IP4_ROUTE, RT_TABLE_MAIN), ==, 1);
+	g_assert_cmpint (_lookup_route_by_table (cache, NMP_OBJECT_TYPE_IP4_ROUTE, 100), ==, 2);
+	g_assert_cmpint (_lookup_route_by_table (cache, NMP_OBJECT_TYPE_IP4_ROUTE, 200), ==, 1);
+	g_assert_cmpint (_lookup_route_by_table (cache, NMP_OBJECT_TYPE_IP4_ROUTE, 300), ==, 0);
+	g_assert_cmpint (_lookup_route_by_table (cache, NMP_OBJECT_TYPE_IP6_ROUTE, 100), ==, 0);
+
+	/* a partial refresh of table 100 only marks the routes of that table... */
+	nmp_cache_dirty_set_lookup (cache,
+	                            nmp_lookup_init_route_by_table (&lookup, NMP_OBJECT_TYPE_IP4_ROUTE, 100));
+	g_assert (!nmp_cache_lookup_entry (cache, obj_main)->dirty);
+	g_assert (nmp_cache_lookup_entry (cache, obj_100a)->dirty);
+	g_assert (nmp_cache_lookup_entry (cache, obj_100b)->dirty);
+	g_assert (!nmp_cache_lookup_entry (cache, obj_200)->dirty);
+
+	/* ... the dump only contains the route that still exists... */
+	obj_100a_dump = nmp_object_clone (obj_100a, FALSE);
+	g_assert (nmp_cache_update_netlink_route (cache, obj_100a_dump, TRUE, 0, NULL, NULL, NULL, NULL) == NMP_CACHE_OPS_UNCHANGED);
+	g_assert (!nmp_cache_lookup_entry (cache, obj_100a)->dirty);
+	g_assert (nmp_cache_lookup_entry (cache, obj_100b)->dirty);
+
+	/* ... and only the deleted route gets pruned. */
+	g_assert (nmp_cache_remove (cache, obj_100b, TRUE, TRUE, NULL) == NMP_CACHE_OPS_REMOVED);
+	g_assert (nmp_cache_remove (cache, obj_100a, TRUE, TRUE, NULL) == NMP_CACHE_OPS_UNCHANGED);
+	g_assert (!nmp_cache_lookup_obj (cache, obj_100b));
+	g_assert_cmpint (_lookup_route_by_table (cache, NMP_OBJECT_TYPE_IP4_ROUTE, RT_TABLE_MAIN), ==, 1);
+	g_assert_cmpint (_lookup_route_by_table (cache, NMP_OBJECT_TYPE_IP4_ROUTE, 100), ==, 1);
+	g_assert_cmpint (_lookup_route_by_table (cache, NMP_OBJECT_TYPE_IP4_ROUTE, 200), ==, 1);
+
+	nmp_cache_free (cache);
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE ();
 
 int
@@ -589,6 +677,7 @@ main (int argc, char **argv)
 	g_test_add_func ("/nmp-object/obj-base", test_obj_base);
 	g_test_add_func ("/nmp-object/cache_link", test_cache_link);
 	g_test_add_func ("/nmp-object/cache_qdisc", test_cache_qdisc);
+	g_test_add_func ("/nmp-object/cache_route_by_table", test_cache_route_by_table);
 
 	result = g_test_run ();
 
@@ -24,6 +24,7 @@
 
 #include "nm-core-utils.h"
 #include "platform/nm-platform-utils.h"
+#include "platform/nm-platform-private.h"
 
 #include "test-common.h"
 
@@ -874,6 +875,207 @@ again_find_idx:
 
 /*****************************************************************************/
 
+static const NMPObject *
+_ip4_route_get_by_table (NMPlatform *platform, int ifindex, const char *network, guint32 table)
+{
+	NMDedupMultiIter iter;
+	NMPLookup lookup;
+	const NMPObject *o;
+	in_addr_t addr = nmtst_inet4_from_string (network);
+
+	nmp_cache_iter_for_each (&iter,
+	                         nm_platform_lookup (platform,
+	                                             nmp_lookup_init_route_by_table (&lookup,
+	                                                                             NMP_OBJECT_TYPE_IP4_ROUTE,
+	                                                                             table)),
+	                         &o) {
+		const NMPlatformIP4Route *r = NMP_OBJECT_CAST_IP4_ROUTE (o);
+
+		if (   r->ifindex == ifindex
+		    && r->network == addr
+		    && r->plen == 24)
+			return o;
+	}
+	return NULL;
+}
+
+static void
+_ip4_route_add_stale (NMPlatform *platform, int ifindex, const char *network, guint32 table)
+{
+	const NMPlatformIP4Route r = {
+		.ifindex = ifindex,
+		.network = nmtst_inet4_from_string (network),
+		.plen = 24,
+		.metric = 30,
+		.table_coerced = nm_platform_route_table_coerce (table),
+		.rt_source = NM_IP_CONFIG_SOURCE_RTPROT_BOOT,
+	};
+	nm_auto_nmpobj NMPObject *obj = nmp_object_new (NMP_OBJECT_TYPE_IP4_ROUTE, (const NMPlatformObject *) &r);
+
+	/* put a route into the cache that kernel doesn't have, as if we
+	 * missed the RTM_DELROUTE for it. */
+	g_assert (nmp_cache_update_netlink_route (nm_platform_get_cache (platform),
+	                                          obj,
+	                                          TRUE,
+	                                          0,
+	                                          NULL,
+	                                          NULL,
+	                                          NULL,
+	                                          NULL) == NMP_CACHE_OPS_ADDED);
+	g_assert (_ip4_route_get_by_table (platform, ifindex, network, table));
+}
+
+static guint64
+_ip4_route_refresh_table (NMPlatform *platform, guint32 table)
+{
+	NMPlatformNetlinkStats stats;
+	guint64 n_msgs;
+
+	/* returns the number of netlink messages that the refresh took. */
+	g_assert (nm_platform_netlink_get_stats (platform, &stats));
+	n_msgs = stats.n_msgs;
+	_nmtst_linux_platform_refresh_partial (platform, NMP_OBJECT_TYPE_IP4_ROUTE, 0, table);
+	g_assert (nm_platform_netlink_get_stats (platform, &stats));
+	return stats.n_msgs - n_msgs;
+}
+
+static void
+test_ip4_route_refresh_table (void)
+{
+	NMPlatform *platform = NM_PLATFORM_GET;
+	const int IFINDEX = nm_platform_link_get_ifindex (platform, DEVICE_NAME);
+	guint64 n_msgs;
+	guint64 n_msgs_interrupted;
+
+	nmtstp_run_command_check ("ip route add 10.77.1.0/24 dev %s table 100", DEVICE_NAME);
+	nmtstp_run_command_check ("ip route add 10.77.2.0/24 dev %s table 200", DEVICE_NAME);
+	nm_platform_process_events (platform);
+	g_assert (_ip4_route_get_by_table (platform, IFINDEX, "10.77.1.0", 100));
+	g_assert (_ip4_route_get_by_table (platform, IFINDEX, "10.77.2.0", 200));
+
+	_ip4_route_add_stale (platform, IFINDEX, "10.77.3.0", 100);
+	_ip4_route_add_stale (platform, IFINDEX, "10.77.4.0", 200);
+
+	/* refreshing table 100 prunes the stale route of that table only. */
+	n_msgs = _ip4_route_refresh_table (platform, 100);
+	g_assert_cmpint (n_msgs, >, 0);
+	g_assert (_ip4_route_get_by_table (platform, IFINDEX, "10.77.1.0", 100));
+	g_assert (!_ip4_route_get_by_table (platform, IFINDEX, "10.77.3.0", 100));
+	g_assert (_ip4_route_get_by_table (platform, IFINDEX, "10.77.2.0", 200));
+	g_assert (_ip4_route_get_by_table (platform, IFINDEX, "10.77.4.0", 200));
+
+	/* when kernel interrupts the dump, it is requested again, and the
+	 * refresh takes the messages of two dumps. */
+	_ip4_route_add_stale (platform, IFINDEX, "10.77.3.0", 100);
+	_nmtst_linux_platform_interrupt_next_dump (platform);
+	n_msgs_interrupted = _ip4_route_refresh_table (platform, 100);
+	g_assert_cmpint (n_msgs_interrupted, >=, 2 * n_msgs);
+	g_assert (_ip4_route_get_by_table (platform, IFINDEX, "10.77.1.0", 100));
+	g_assert (!_ip4_route_get_by_table (platform, IFINDEX, "10.77.3.0", 100));
+	g_assert (_ip4_route_get_by_table (platform, IFINDEX, "10.77.4.0", 200));
+
+	_ip4_route_refresh_table (platform, 200);
+	g_assert (_ip4_route_get_by_table (platform, IFINDEX, "10.77.2.0", 200));
+	g_assert (!_ip4_route_get_by_table (platform, IFINDEX, "10.77.4.0", 200));
+
+	nmtstp_run_command_check ("ip route del 10.77.1.0/24 dev %s table 100", DEVICE_NAME);
+	nmtstp_run_command_check ("ip route del 10.77.2.0/24 dev %s table 200", DEVICE_NAME);
+	nm_platform_process_events (platform);
+	g_assert (!_ip4_route_get_by_table (platform, IFINDEX, "10.77.1.0", 100));
+	g_assert (!_ip4_route_get_by_table (platform, IFINDEX, "10.77.2.0", 200));
+}
+
+static void
+_ip4_route_filter_process_events (NMPlatform *platform, NMPlatform *platform_f)
+{
+	nm_platform_process_events (platform);
+	nm_platform_process_events (platform_f);
+}
+
+static void
+test_ip4_route_filter (gconstpointer test_data)
+{
+	const int TEST_IDX = GPOINTER_TO_INT (test_data);
+	NMPlatform *platform = NM_PLATFORM_GET;
+	const int IFINDEX = nm_platform_link_get_ifindex (platform, DEVICE_NAME);
+	const guint32 MAIN = RT_TABLE_MAIN;
+	gs_unref_object NMPlatform *platform_f = NULL;
+	nm_auto_nmpobj NMPObject *obj = NULL;
+	NMPlatformNetlinkStats stats;
+	guint64 n_ip4_filtered;
+	guint64 n_ip6_filtered;
+
+	/* a second platform instance in the same namespace, that doesn't
+	 * cache the routes of bird. */
+	platform_f = g_object_new (NM_TYPE_LINUX_PLATFORM,
+	                           NM_PLATFORM_LOG_WITH_PTR, TRUE,
+	                           NM_LINUX_PLATFORM_NETLINK_THREAD, (gboolean) (TEST_IDX == 2),
+	                           NM_LINUX_PLATFORM_ROUTE_FILTER, "protocol:bird",
+	                           NULL);
+	g_assert (nm_platform_netlink_get_stats (platform_f, &stats));
+	n_ip4_filtered = stats.n_ip4_routes_filtered;
+	n_ip6_filtered = stats.n_ip6_routes_filtered;
+
+	/* a filtered route is not cached. */
+	nmtstp_run_command_check ("ip route add 10.78.1.0/24 dev %s proto bird", DEVICE_NAME);
+	_ip4_route_filter_process_events (platform, platform_f);
+	g_assert (_ip4_route_get_by_table (platform, IFINDEX, "10.78.1.0", MAIN));
+	g_assert (!_ip4_route_get_by_table (platform_f, IFINDEX, "10.78.1.0", MAIN));
+
+	/* neither when it gets replaced... */
+	nmtstp_run_command_check ("ip route replace 10.78.1.0/24 dev %s proto bird", DEVICE_NAME);
+	_ip4_route_filter_process_events (platform, platform_f);
+	g_assert (_ip4_route_get_by_table (platform, IFINDEX, "10.78.1.0", MAIN));
+	g_assert (!_ip4_route_get_by_table (platform_f, IFINDEX, "10.78.1.0", MAIN));
+
+	/* ... and when it replaces a cached route, that route is gone too. */
+	nmtstp_run_command_check ("ip route add 10.78.2.0/24 dev %s proto static metric 20", DEVICE_NAME);
+	_ip4_route_filter_process_events (platform, platform_f);
+	g_assert (_ip4_route_get_by_table (platform_f, IFINDEX, "10.78.2.0", MAIN));
+	nmtstp_run_command_check ("ip route replace 10.78.2.0/24 dev %s proto bird metric 20", DEVICE_NAME);
+	_ip4_route_filter_process_events (platform, platform_f);
+	g_assert (_ip4_route_get_by_table (platform, IFINDEX, "10.78.2.0", MAIN));
+	g_assert (!_ip4_route_get_by_table (platform_f, IFINDEX, "10.78.2.0", MAIN));
+
+	/* a route that was cached before the filter was set, is still
+	 * removed when kernel deletes it. */
+	nmtstp_run_command_check ("ip route add 10.78.3.0/24 dev %s proto bird", DEVICE_NAME);
+	_ip4_route_filter_process_events (platform, platform_f);
+	g_assert (!_ip4_route_get_by_table (platform_f, IFINDEX, "10.78.3.0", MAIN));
+	obj = nmp_object_clone (_ip4_route_get_by_table (platform, IFINDEX, "10.78.3.0", MAIN), FALSE);
+	g_assert (nmp_cache_update_netlink_route (nm_platform_get_cache (platform_f),
+	                                          obj,
+	                                          TRUE,
+	                                          0,
+	                                          NULL,
+	                                          NULL,
+	                                          NULL,
+	                                          NULL) == NMP_CACHE_OPS_ADDED);
+	g_assert (_ip4_route_get_by_table (platform_f, IFINDEX, "10.78.3.0", MAIN));
+	nmtstp_run_command_check ("ip route del 10.78.3.0/24 dev %s proto bird", DEVICE_NAME);
+	_ip4_route_filter_process_events (platform, platform_f);
+	g_assert (!_ip4_route_get_by_table (platform, IFINDEX, "10.78.3.0", MAIN));
+	g_assert (!_ip4_route_get_by_table (platform_f, IFINDEX, "10.78.3.0", MAIN));
+
+	/* the two additions and the two replacements were counted,
+	 * the deletion and the unfiltered route were not. */
+	g_assert (nm_platform_netlink_get_stats (platform_f, &stats));
+	g_assert_cmpint (stats.n_ip4_routes_filtered - n_ip4_filtered, ==, 4);
+	g_assert_cmpint (stats.n_ip6_routes_filtered - n_ip6_filtered, ==, 0);
+
+	/* the platform without filter doesn't count anything. */
+	g_assert (nm_platform_netlink_get_stats (platform, &stats));
+	g_assert_cmpint (stats.n_ip4_routes_filtered, ==, 0);
+
+	nmtstp_run_command_check ("ip route del 10.78.1.0/24 dev %s", DEVICE_NAME);
+	nmtstp_run_command_check ("ip route del 10.78.2.0/24 dev %s", DEVICE_NAME);
+	_ip4_route_filter_process_events (platform, platform_f);
+	g_assert (!_ip4_route_get_by_table (platform, IFINDEX, "10.78.1.0", MAIN));
+	g_assert (!_ip4_route_get_by_table (platform, IFINDEX, "10.78.2.0", MAIN));
+}
+
+/*****************************************************************************/
+
 NMTstpSetupFunc const _nmtstp_setup_platform_func = SETUP;
 
 void
@@ -902,5 +1104,8 @@ _nmtstp_setup_tests (void)
 		add_test_func ("/route/ip4_route_get", test_ip4_route_get);
 		add_test_func ("/route/ip6_route_get", test_ip6_route_get);
 		add_test_func ("/route/ip4_zero_gateway", test_ip4_zero_gateway);
+		add_test_func ("/route/ip4_refresh_table", test_ip4_route_refresh_table);
+		add_test_func_data ("/route/ip4_filter/1", test_ip4_route_filter, GINT_TO_POINTER (1));
+		add_test_func_data ("/route/ip4_filter/2", test_ip4_route_filter, GINT_TO_POINTER (2));
 	}
 }
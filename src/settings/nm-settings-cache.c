@@ -0,0 +1,303 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager system settings service
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2018 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include "nm-settings-cache.h"
+
+#include "nm-core-internal.h"
+#include "nm-core-utils.h"
+
+/*****************************************************************************/
+
+/* The cache file is one serialized GVariant of type CACHE_TYPE:
+ *
+ *   u               CACHE_FORMAT
+ *   s               the version of NetworkManager that wrote the file
+ *   a{s(tttta{sa{sv}})}
+ *                   path -> (inode, size, mtime, ctime, connection)
+ *
+ * mtime and ctime are in nanoseconds, and the connection is the result of
+ * nm_connection_to_dbus() with all secrets. The file is mapped into memory
+ * and its entries are only deserialized when looked up. Normalization may
+ * change between releases, so a file written by a different version is
+ * ignored as a whole.
+ *
+ * A new file is written with only the entries that were looked up or added,
+ * so entries of deleted files drop out. */
+
+#define CACHE_FORMAT  1
+#define CACHE_TYPE    "(usa{s(tttta{sa{sv}})})"
+
+#define _NMLOG_DOMAIN      LOGD_SETTINGS
+#define _NMLOG(level, ...) __NMLOG_DEFAULT (level, _NMLOG_DOMAIN, "settings-cache", __VA_ARGS__)
+
+struct _NMSettingsCache {
+	char *filename;
+
+	/* the mapped cache file, if any. */
+	GVariant *data;
+
+	/* char *path -> GVariant *entry, the entries of @data. */
+	GHashTable *old_entries;
+
+	/* char *path -> GVariant *entry, the entries for the next write. */
+	GHashTable *new_entries;
+
+	bool dirty:1;
+};
+
+/*****************************************************************************/
+
+static guint64
+_timespec_to_nsec (const struct timespec *ts)
+{
+	return ((guint64) ts->tv_sec * NM_UTILS_NS_PER_SECOND) + ts->tv_nsec;
+}
+
+static gboolean
+_entry_matches (GVariant *entry, const struct stat *st)
+{
+	guint64 ino, size, mtime, ctime;
+
+	g_variant_get (entry, "(tttt@a{sa{sv}})", &ino, &size, &mtime, &ctime, NULL);
+	return    ino == (guint64) st->st_ino
+	       && size == (guint64) st->st_size
+	       && mtime == _timespec_to_nsec (&st->st_mtim)
+	       && ctime == _timespec_to_nsec (&st->st_ctim);
+}
+
+static void
+_load (NMSettingsCache *cache)
+{
+	gs_free_error GError *error = NULL;
+	gs_unref_variant GVariant *entries = NULL;
+	GMappedFile *mapped;
+	const char *version;
+	GVariantIter iter;
+	const char *path;
+	GVariant *entry;
+	guint32 format;
+
+	mapped = g_mapped_file_new (cache->filename, FALSE, &error);
+	if (!mapped) {
+		if (!g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_NOENT))
+			_LOGW ("cannot read %s: %s", cache->filename, error->message);
+		return;
+	}
+
+	/* The file is not trusted: GVariant checks the serialized data on
+	 * access, and invalid data reads as default values. */
+	cache->data = g_variant_new_from_data (G_VARIANT_TYPE (CACHE_TYPE),
+	                                       g_mapped_file_get_contents (mapped),
+	                                       g_mapped_file_get_length (mapped),
+	                                       FALSE,
+	                                       (GDestroyNotify) g_mapped_file_unref,
+	                                       mapped);
+	g_variant_ref_sink (cache->data);
+
+	g_variant_get (cache->data, "(u&s@a{s(tttta{sa{sv}})})", &format, &version, &entries);
+	if (   format != CACHE_FORMAT
+	    || !nm_streq (version, VERSION)) {
+		_LOGD ("ignore %s written by version %s", cache->filename, version);
+		return;
+	}
+
+	g_variant_iter_init (&iter, entries);
+	while (g_variant_iter_next (&iter, "{&s@(tttta{sa{sv}})}", &path, &entry))
+		g_hash_table_insert (cache->old_entries, g_strdup (path), entry);
+
+	_LOGD ("loaded %u entries from %s", g_hash_table_size (cache->old_entries), cache->filename);
+}
+
+/**
+ * nm_settings_cache_new:
+ * @filename: the cache file
+ * @rebuild: if %TRUE, @filename is not read, and the next
+ *   nm_settings_cache_write() replaces it.
+ *
+ * Returns: the cache. The file is read right away. A missing, broken or
+ *   outdated file results in an empty cache.
+ */
+NMSettingsCache *
+nm_settings_cache_new (const char *filename, gboolean rebuild)
+{
+	NMSettingsCache *cache;
+
+	g_return_val_if_fail (filename, NULL);
+
+	cache = g_slice_new0 (NMSettingsCache);
+	cache->filename = g_strdup (filename);
+	cache->old_entries = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, (GDestroyNotify) g_variant_unref);
+	cache->new_entries = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, (GDestroyNotify) g_variant_unref);
+
+	if (rebuild)
+		cache->dirty = TRUE;
+	else
+		_load (cache);
+	return cache;
+}
+
+void
+nm_settings_cache_free (NMSettingsCache *cache)
+{
+	if (!cache)
+		return;
+
+	g_hash_table_destroy (cache->old_entries);
+	g_hash_table_destroy (cache->new_entries);
+	if (cache->data)
+		g_variant_unref (cache->data);
+	g_free (cache->filename);
+	g_slice_free (NMSettingsCache, cache);
+}
+
+/**
+ * nm_settings_cache_lookup:
+ * @cache: the cache
+ * @path: the path of the connection file
+ * @st: the current stat() of @path
+ *
+ * Returns: (transfer full): the normalized connection from the cache, or
+ *   %NULL if @path is not cached or changed since. Then the caller parses
+ *   the file itself and passes the result to nm_settings_cache_add().
+ */
+NMConnection *
+nm_settings_cache_lookup (NMSettingsCache *cache,
+                          const char *path,
+                          const struct stat *st)
+{
+	gs_free_error GError *error = NULL;
+	gs_unref_variant GVariant *settings = NULL;
+	NMConnection *connection;
+	GVariant *entry;
+
+	g_return_val_if_fail (cache, NULL);
+	g_return_val_if_fail (path, NULL);
+	g_return_val_if_fail (st, NULL);
+
+	entry = g_hash_table_lookup (cache->old_entries, path);
+	if (!entry || !_entry_matches (entry, st))
+		return NULL;
+
+	settings = g_variant_get_child_value (entry, 4);
+	connection = _nm_simple_connection_new_from_dbus (settings,
+	                                                  NM_SETTING_PARSE_FLAGS_STRICT
+	                                                  | NM_SETTING_PARSE_FLAGS_NORMALIZE,
+	                                                  &error);
+	if (!connection) {
+		_LOGD ("invalid entry for %s: %s", path, error->message);
+		return NULL;
+	}
+	if (!nm_connection_get_uuid (connection)) {
+		g_object_unref (connection);
+		return NULL;
+	}
+
+	g_hash_table_insert (cache->new_entries, g_strdup (path), g_variant_ref (entry));
+	return connection;
+}
+
+/**
+ * nm_settings_cache_add:
+ * @cache: the cache
+ * @path: the path of the connection file
+ * @st: the stat() of @path from before it was parsed
+ * @connection: the normalized connection parsed from @path
+ *
+ * Adds @connection to the next nm_settings_cache_write(). @st must be taken
+ * before parsing the file, so that a file that changes meanwhile does not
+ * match on the next lookup.
+ */
+void
+nm_settings_cache_add (NMSettingsCache *cache,
+                       const char *path,
+                       const struct stat *st,
+                       NMConnection *connection)
+{
+	GVariant *settings;
+	GVariant *entry;
+
+	g_return_if_fail (cache);
+	g_return_if_fail (path);
+	g_return_if_fail (st);
+	g_return_if_fail (NM_IS_CONNECTION (connection));
+
+	settings = nm_connection_to_dbus (connection, NM_CONNECTION_SERIALIZE_ALL);
+	if (!settings)
+		return;
+
+	entry = g_variant_new ("(tttt@a{sa{sv}})",
+	                       (guint64) st->st_ino,
+	                       (guint64) st->st_size,
+	                       _timespec_to_nsec (&st->st_mtim),
+	                       _timespec_to_nsec (&st->st_ctim),
+	                       settings);
+	g_hash_table_insert (cache->new_entries, g_strdup (path), g_variant_ref_sink (entry));
+	cache->dirty = TRUE;
+}
+
+/**
+ * nm_settings_cache_write:
+ * @cache: the cache
+ * @error: error in case of failure
+ *
+ * Replaces the cache file with the entries that were looked up or added.
+ * Does nothing if that would not change the file.
+ *
+ * Returns: %TRUE on success
+ */
+gboolean
+nm_settings_cache_write (NMSettingsCache *cache, GError **error)
+{
+	gs_unref_variant GVariant *data = NULL;
+	GVariantBuilder builder;
+	GHashTableIter iter;
+	const char *path;
+	GVariant *entry;
+
+	g_return_val_if_fail (cache, FALSE);
+
+	if (   !cache->dirty
+	    && g_hash_table_size (cache->new_entries) == g_hash_table_size (cache->old_entries))
+		return TRUE;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{s(tttta{sa{sv}})}"));
+	g_hash_table_iter_init (&iter, cache->new_entries);
+	while (g_hash_table_iter_next (&iter, (gpointer *) &path, (gpointer *) &entry))
+		g_variant_builder_add (&builder, "{s@(tttta{sa{sv}})}", path, entry);
+
+	data = g_variant_ref_sink (g_variant_new ("(usa{s(tttta{sa{sv}})})",
+	                                          (guint32) CACHE_FORMAT,
+	                                          VERSION,
+	                                          &builder));
+
+	/* The cache contains secrets. */
+	if (!nm_utils_file_set_contents (cache->filename,
+	                                 g_variant_get_data (data),
+	                                 g_variant_get_size (data),
+	                                 0600,
+	                                 error))
+		return FALSE;
+
+	_LOGD ("wrote %u entries to %s", g_hash_table_size (cache->new_entries), cache->filename);
+	cache->dirty = FALSE;
+	return TRUE;
+}
@@ -0,0 +1,45 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager system settings service
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2018 Red Hat, Inc.
+ */
+
+#ifndef __NM_SETTINGS_CACHE_H__
+#define __NM_SETTINGS_CACHE_H__
+
+#include <sys/stat.h>
+
+/* A cache of parsed connection files, so that unchanged files don't need
+ * to be parsed again on the next start. It maps the path of a file to the
+ * normalized connection read from it, and is only valid as long as the
+ * inode, size, mtime and ctime of the file stay the same. */
+typedef struct _NMSettingsCache NMSettingsCache;
+
+NMSettingsCache *nm_settings_cache_new (const char *filename, gboolean rebuild);
+void nm_settings_cache_free (NMSettingsCache *cache);
+
+NMConnection *nm_settings_cache_lookup (NMSettingsCache *cache,
+                                        const char *path,
+                                        const struct stat *st);
+void nm_settings_cache_add (NMSettingsCache *cache,
+                            const char *path,
+                            const struct stat *st,
+                            NMConnection *connection);
+
+gboolean nm_settings_cache_write (NMSettingsCache *cache, GError **error);
+
+#endif /* __NM_SETTINGS_CACHE_H__ */
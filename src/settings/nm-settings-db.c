@@ -0,0 +1,640 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager system settings service
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2018 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include "nm-settings-db.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+
+#include "nm-config.h"
+
+/*****************************************************************************/
+
+/* The database is loaded from its keyfile once, on first use. Changes only
+ * update the keyfile in memory and mark it dirty. After @flush_delay_sec, the
+ * keyfile is serialized on the main thread and written on a worker thread,
+ * so many changes in a row cost one write. Other groups and comments in the
+ * file are preserved.
+ *
+ * Optionally, every change is also appended to a binary log right away. The
+ * log is replayed after loading the keyfile, so changes survive a crash even
+ * before the next write of the keyfile. When the keyfile write starts, the
+ * log is renamed to "@log_filename.old", and that is deleted once the
+ * keyfile is written.
+ *
+ * A log record is:
+ *   guint8  op        'S' for set, 'R' for remove
+ *   guint8  key_len
+ *   guint16 value_len (little endian, 0 for remove)
+ *   char    key[key_len]
+ *   char    value[value_len]
+ * A truncated record at the end of the log is ignored. */
+
+#define LOG_OP_SET    'S'
+#define LOG_OP_REMOVE 'R'
+
+typedef struct _WriteData WriteData;
+
+struct _NMSettingsDB {
+	char *filename;
+	char *group;
+	char *log_filename;
+	char *log_filename_old;
+	char list_separator;
+	guint flush_delay_sec;
+
+	/* the whole file. Only @group is modified. */
+	GKeyFile *keyfile;
+
+	/* char *key -> char *value, the raw values of @group in @keyfile,
+	 * for lookups that return a const string. */
+	GHashTable *entries;
+
+	guint flush_id;
+	int log_fd;
+
+	/* the running write, if any. */
+	GThread *writer;
+	WriteData *writer_data;
+
+	bool loaded:1;
+	bool dirty:1;
+};
+
+struct _WriteData {
+	/* the database, or %NULL if it no longer cares about the result. */
+	NMSettingsDB *db;
+
+	char *filename;
+	char *contents;
+	gsize len;
+	char *log_filename_old;
+	GError *error;
+};
+
+/*****************************************************************************/
+
+#define _NMLOG_DOMAIN      LOGD_SETTINGS
+#define _NMLOG(level, ...) __NMLOG_DEFAULT (level, _NMLOG_DOMAIN, "settings-db", __VA_ARGS__)
+
+/*****************************************************************************/
+
+static void _flush_schedule (NMSettingsDB *db);
+
+/*****************************************************************************/
+
+static void
+_entry_set (NMSettingsDB *db, char *key, char *value)
+{
+	g_key_file_set_value (db->keyfile, db->group, key, value);
+	g_hash_table_insert (db->entries, key, value);
+}
+
+static gboolean
+_entry_remove (NMSettingsDB *db, const char *key)
+{
+	if (!g_hash_table_remove (db->entries, key))
+		return FALSE;
+	g_key_file_remove_key (db->keyfile, db->group, key, NULL);
+	return TRUE;
+}
+
+/*****************************************************************************/
+
+static void
+_log_replay (NMSettingsDB *db, const char *log_filename)
+{
+	gs_free char *contents = NULL;
+	gsize len, pos;
+	guint n = 0;
+
+	if (!g_file_get_contents (log_filename, &contents, &len, NULL))
+		return;
+
+	pos = 0;
+	while (pos + 4 <= len) {
+		const guint8 *rec = (const guint8 *) &contents[pos];
+		guint8 op = rec[0];
+		gsize key_len = rec[1];
+		gsize value_len = rec[2] | (((gsize) rec[3]) << 8);
+
+		if (   !NM_IN_SET (op, LOG_OP_SET, LOG_OP_REMOVE)
+		    || key_len == 0
+		    || pos + 4 + key_len + value_len > len)
+			break;
+
+		if (op == LOG_OP_SET) {
+			_entry_set (db,
+			            g_strndup (&contents[pos + 4], key_len),
+			            g_strndup (&contents[pos + 4 + key_len], value_len));
+		} else {
+			gs_free char *key = g_strndup (&contents[pos + 4], key_len);
+
+			_entry_remove (db, key);
+		}
+		pos += 4 + key_len + value_len;
+		n++;
+	}
+
+	if (pos < len)
+		_LOGD ("log '%s': ignore %"G_GSIZE_FORMAT" trailing bytes", log_filename, len - pos);
+	if (n > 0) {
+		_LOGD ("log '%s': replayed %u records", log_filename, n);
+		/* the keyfile is behind the log. */
+		db->dirty = TRUE;
+	}
+}
+
+static void
+_load (NMSettingsDB *db)
+{
+	gs_free_error GError *error = NULL;
+	gs_strfreev char **keys = NULL;
+	gsize i;
+
+	if (db->loaded)
+		return;
+	db->loaded = TRUE;
+
+	if (!g_key_file_load_from_file (db->keyfile, db->filename, G_KEY_FILE_KEEP_COMMENTS, &error)) {
+		if (!g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_NOENT))
+			_LOGW ("error parsing '%s': %s", db->filename, error->message);
+	} else {
+		keys = g_key_file_get_keys (db->keyfile, db->group, NULL, NULL);
+		for (i = 0; keys && keys[i]; i++) {
+			char *value;
+
+			value = g_key_file_get_value (db->keyfile, db->group, keys[i], NULL);
+			if (value)
+				g_hash_table_insert (db->entries, g_strdup (keys[i]), value);
+		}
+	}
+
+	if (db->log_filename) {
+		/* the old log is from a keyfile write that did not finish. */
+		_log_replay (db, db->log_filename_old);
+		_log_replay (db, db->log_filename);
+		if (db->dirty)
+			_flush_schedule (db);
+	}
+
+	_LOGD ("'%s': loaded %u entries", db->filename, g_hash_table_size (db->entries));
+}
+
+static void
+_log_append (NMSettingsDB *db, char op, const char *key, const char *value)
+{
+	gsize key_len, value_len, len;
+	gs_free guint8 *rec = NULL;
+	gssize n;
+
+	if (!db->log_filename)
+		return;
+
+	key_len = strlen (key);
+	value_len = value ? strlen (value) : 0;
+	if (   key_len == 0
+	    || key_len > G_MAXUINT8
+	    || value_len > G_MAXUINT16) {
+		/* does not fit into a record. The keyfile write is scheduled
+		 * anyway. */
+		return;
+	}
+
+	if (db->log_fd < 0) {
+		db->log_fd = open (db->log_filename, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+		if (db->log_fd < 0) {
+			_LOGW ("log '%s': cannot open: %s", db->log_filename, g_strerror (errno));
+			return;
+		}
+	}
+
+	len = 4 + key_len + value_len;
+	rec = g_malloc (len);
+	rec[0] = op;
+	rec[1] = key_len;
+	rec[2] = value_len & 0xFF;
+	rec[3] = value_len >> 8;
+	memcpy (&rec[4], key, key_len);
+	if (value_len)
+		memcpy (&rec[4 + key_len], value, value_len);
+
+	/* one write() per record, so that a crash leaves at most one
+	 * truncated record at the end. */
+	do {
+		n = write (db->log_fd, rec, len);
+	} while (n < 0 && errno == EINTR);
+	if (n != (gssize) len)
+		_LOGW ("log '%s': cannot append: %s", db->log_filename, n < 0 ? g_strerror (errno) : "short write");
+}
+
+/*****************************************************************************/
+
+static void
+_write_data_free (WriteData *wd)
+{
+	g_free (wd->filename);
+	g_free (wd->contents);
+	g_free (wd->log_filename_old);
+	g_clear_error (&wd->error);
+	g_slice_free (WriteData, wd);
+}
+
+static void
+_write (WriteData *wd)
+{
+	if (!g_file_set_contents (wd->filename, wd->contents, wd->len, &wd->error))
+		return;
+	if (wd->log_filename_old)
+		unlink (wd->log_filename_old);
+}
+
+static void
+_write_finish (NMSettingsDB *db, WriteData *wd)
+{
+	nm_assert (wd->db == db);
+
+	if (wd->error) {
+		_LOGW ("error writing '%s': %s", wd->filename, wd->error->message);
+		/* try again with the next flush. */
+		db->dirty = TRUE;
+	} else
+		_LOGT ("'%s': written", wd->filename);
+
+	wd->db = NULL;
+	db->writer = NULL;
+	db->writer_data = NULL;
+}
+
+static gboolean
+_write_done_cb (gpointer user_data)
+{
+	WriteData *wd = user_data;
+	NMSettingsDB *db = wd->db;
+
+	if (db) {
+		g_thread_join (db->writer);
+		_write_finish (db, wd);
+		if (db->dirty)
+			_flush_schedule (db);
+	}
+	_write_data_free (wd);
+	return G_SOURCE_REMOVE;
+}
+
+static gpointer
+_write_thread (gpointer user_data)
+{
+	WriteData *wd = user_data;
+
+	_write (wd);
+
+	/* report back on the main thread. */
+	g_idle_add (_write_done_cb, wd);
+	return NULL;
+}
+
+static WriteData *
+_write_data_new (NMSettingsDB *db)
+{
+	WriteData *wd;
+
+	wd = g_slice_new0 (WriteData);
+	wd->db = db;
+	wd->filename = g_strdup (db->filename);
+	wd->contents = g_key_file_to_data (db->keyfile, &wd->len, NULL);
+
+	if (db->log_filename) {
+		/* Changes from now on go to a new log. If the old log is still there,
+		 * a previous write failed; keep appending to the current log then, so
+		 * that no records are lost. */
+		if (   !g_file_test (db->log_filename_old, G_FILE_TEST_EXISTS)
+		    && g_file_test (db->log_filename, G_FILE_TEST_EXISTS)) {
+			if (db->log_fd >= 0) {
+				nm_close (db->log_fd);
+				db->log_fd = -1;
+			}
+			if (rename (db->log_filename, db->log_filename_old) != 0)
+				_LOGW ("log '%s': cannot rename: %s", db->log_filename, g_strerror (errno));
+		}
+		wd->log_filename_old = g_strdup (db->log_filename_old);
+	}
+
+	db->dirty = FALSE;
+	return wd;
+}
+
+static gboolean
+_flush_timeout_cb (gpointer user_data)
+{
+	NMSettingsDB *db = user_data;
+	WriteData *wd;
+
+	db->flush_id = 0;
+
+	/* _write_done_cb() reschedules if there are new changes. */
+	if (db->writer || !db->dirty)
+		return G_SOURCE_REMOVE;
+
+	wd = _write_data_new (db);
+	db->writer_data = wd;
+	db->writer = g_thread_try_new ("settings-db", _write_thread, wd, NULL);
+	if (!db->writer) {
+		_write (wd);
+		db->writer = NULL;
+		_write_finish (db, wd);
+		_write_data_free (wd);
+	}
+	return G_SOURCE_REMOVE;
+}
+
+static void
+_flush_schedule (NMSettingsDB *db)
+{
+	if (!db->flush_id)
+		db->flush_id = g_timeout_add_seconds (db->flush_delay_sec, _flush_timeout_cb, db);
+}
+
+/*****************************************************************************/
+
+/**
+ * nm_settings_db_new:
+ * @filename: the keyfile of the database
+ * @group: the group in @filename that holds the entries
+ * @list_separator: the list separator for nm_settings_db_get_string_list()
+ *   and nm_settings_db_set_string_list()
+ * @log_filename: (allow-none): if set, the binary log of changes.
+ * @flush_delay_sec: how long to collect changes before writing @filename.
+ *
+ * Returns: the new database. It is loaded on first access.
+ */
+NMSettingsDB *
+nm_settings_db_new (const char *filename,
+                    const char *group,
+                    char list_separator,
+                    const char *log_filename,
+                    guint flush_delay_sec)
+{
+	NMSettingsDB *db;
+
+	g_return_val_if_fail (filename, NULL);
+	g_return_val_if_fail (group, NULL);
+
+	db = g_slice_new0 (NMSettingsDB);
+	db->filename = g_strdup (filename);
+	db->group = g_strdup (group);
+	db->list_separator = list_separator;
+	db->flush_delay_sec = flush_delay_sec;
+	db->log_fd = -1;
+	if (log_filename) {
+		db->log_filename = g_strdup (log_filename);
+		db->log_filename_old = g_strdup_printf ("%s.old", log_filename);
+	}
+	db->keyfile = g_key_file_new ();
+	db->entries = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	return db;
+}
+
+/**
+ * nm_settings_db_free:
+ * @db: the database
+ *
+ * Writes pending changes, then frees @db.
+ */
+void
+nm_settings_db_free (NMSettingsDB *db)
+{
+	if (!db)
+		return;
+
+	nm_settings_db_flush (db);
+
+	if (db->log_fd >= 0)
+		nm_close (db->log_fd);
+	g_hash_table_unref (db->entries);
+	g_key_file_unref (db->keyfile);
+	g_free (db->filename);
+	g_free (db->group);
+	g_free (db->log_filename);
+	g_free (db->log_filename_old);
+	g_slice_free (NMSettingsDB, db);
+}
+
+const char *
+nm_settings_db_get_value (NMSettingsDB *db, const char *key)
+{
+	g_return_val_if_fail (db, NULL);
+	g_return_val_if_fail (key, NULL);
+
+	_load (db);
+	return g_hash_table_lookup (db->entries, key);
+}
+
+/**
+ * nm_settings_db_get_string_list:
+ * @db: the database
+ * @key: the key
+ * @out_len: (out) (allow-none): the number of elements
+ *
+ * Returns: (transfer full): the value of @key parsed as a keyfile list,
+ *   or %NULL if there is no entry for @key.
+ */
+char **
+nm_settings_db_get_string_list (NMSettingsDB *db, const char *key, gsize *out_len)
+{
+	gs_unref_keyfile GKeyFile *keyfile = NULL;
+	const char *value;
+
+	NM_SET_OUT (out_len, 0);
+
+	value = nm_settings_db_get_value (db, key);
+	if (!value)
+		return NULL;
+
+	/* let GKeyFile do the unescaping, so that the format is exactly the
+	 * one of g_key_file_set_string_list(). */
+	keyfile = g_key_file_new ();
+	g_key_file_set_list_separator (keyfile, db->list_separator);
+	g_key_file_set_value (keyfile, db->group, key, value);
+	return g_key_file_get_string_list (keyfile, db->group, key, out_len, NULL);
+}
+
+void
+nm_settings_db_set_value (NMSettingsDB *db, const char *key, const char *value)
+{
+	const char *old;
+
+	g_return_if_fail (db);
+	g_return_if_fail (key);
+	g_return_if_fail (value);
+
+	_load (db);
+
+	old = g_hash_table_lookup (db->entries, key);
+	if (nm_streq0 (old, value))
+		return;
+
+	_entry_set (db, g_strdup (key), g_strdup (value));
+	_log_append (db, LOG_OP_SET, key, value);
+	db->dirty = TRUE;
+	_flush_schedule (db);
+}
+
+void
+nm_settings_db_set_string_list (NMSettingsDB *db,
+                                const char *key,
+                                const char *const*list,
+                                gsize len)
+{
+	gs_unref_keyfile GKeyFile *keyfile = NULL;
+	gs_free char *value = NULL;
+
+	g_return_if_fail (db);
+	g_return_if_fail (key);
+
+	keyfile = g_key_file_new ();
+	g_key_file_set_list_separator (keyfile, db->list_separator);
+	g_key_file_set_string_list (keyfile, db->group, key, list, len);
+	value = g_key_file_get_value (keyfile, db->group, key, NULL);
+	nm_settings_db_set_value (db, key, value ?: "");
+}
+
+void
+nm_settings_db_remove (NMSettingsDB *db, const char *key)
+{
+	g_return_if_fail (db);
+	g_return_if_fail (key);
+
+	_load (db);
+
+	if (!_entry_remove (db, key))
+		return;
+
+	_log_append (db, LOG_OP_REMOVE, key, NULL);
+	db->dirty = TRUE;
+	_flush_schedule (db);
+}
+
+/**
+ * nm_settings_db_flush:
+ * @db: the database
+ *
+ * Waits for a running write, and writes pending changes synchronously.
+ * This is for shutdown.
+ */
+void
+nm_settings_db_flush (NMSettingsDB *db)
+{
+	WriteData *wd;
+
+	g_return_if_fail (db);
+
+	nm_clear_g_source (&db->flush_id);
+
+	if (db->writer) {
+		/* the idle callback of the thread only frees the data now. */
+		wd = db->writer_data;
+		g_thread_join (db->writer);
+		_write_finish (db, wd);
+	}
+
+	if (!db->dirty)
+		return;
+
+	wd = _write_data_new (db);
+	_write (wd);
+	_write_finish (db, wd);
+	_write_data_free (wd);
+}
+
+/*****************************************************************************/
+
+#define SETTINGS_TIMESTAMPS_FILE      NMSTATEDIR "/timestamps"
+#define SETTINGS_TIMESTAMPS_LOG_FILE  NMSTATEDIR "/timestamps.log"
+#define SETTINGS_SEEN_BSSIDS_FILE     NMSTATEDIR "/seen-bssids"
+#define SETTINGS_SEEN_BSSIDS_LOG_FILE NMSTATEDIR "/seen-bssids.log"
+
+static NMSettingsDB *timestamps_db;
+static NMSettingsDB *seen_bssids_db;
+
+static gboolean
+_use_log (void)
+{
+	NMConfig *config = nm_config_get ();
+
+	return    config
+	       && nm_config_data_get_value_boolean (nm_config_get_data_orig (config),
+	                                            NM_CONFIG_KEYFILE_GROUP_MAIN,
+	                                            NM_CONFIG_KEYFILE_KEY_MAIN_CONNECTION_STATE_LOG,
+	                                            FALSE);
+}
+
+/* With the log, changes are safe on disk right away. The keyfile can then
+ * be rewritten less often. */
+#define FLUSH_DELAY_SEC(use_log) ((use_log) ? 60 : 5)
+
+NMSettingsDB *
+nm_settings_db_get_timestamps (void)
+{
+	if (G_UNLIKELY (!timestamps_db)) {
+		gboolean use_log = _use_log ();
+
+		timestamps_db = nm_settings_db_new (SETTINGS_TIMESTAMPS_FILE,
+		                                    "timestamps",
+		                                    ';',
+		                                    use_log ? SETTINGS_TIMESTAMPS_LOG_FILE : NULL,
+		                                    FLUSH_DELAY_SEC (use_log));
+	}
+	return timestamps_db;
+}
+
+NMSettingsDB *
+nm_settings_db_get_seen_bssids (void)
+{
+	if (G_UNLIKELY (!seen_bssids_db)) {
+		gboolean use_log = _use_log ();
+
+		seen_bssids_db = nm_settings_db_new (SETTINGS_SEEN_BSSIDS_FILE,
+		                                     "seen-bssids",
+		                                     ',',
+		                                     use_log ? SETTINGS_SEEN_BSSIDS_LOG_FILE : NULL,
+		                                     FLUSH_DELAY_SEC (use_log));
+	}
+	return seen_bssids_db;
+}
+
+/**
+ * nm_settings_db_flush_all:
+ *
+ * Writes the pending changes of the timestamps and seen-bssids
+ * databases. Call this before exiting.
+ */
+void
+nm_settings_db_flush_all (void)
+{
+	if (timestamps_db)
+		nm_settings_db_flush (timestamps_db);
+	if (seen_bssids_db)
+		nm_settings_db_flush (seen_bssids_db);
+}
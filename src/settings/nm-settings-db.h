@@ -0,0 +1,52 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager system settings service
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2018 Red Hat, Inc.
+ */
+
+#ifndef __NM_SETTINGS_DB_H__
+#define __NM_SETTINGS_DB_H__
+
+/* A key/value store for per-connection state, like the timestamps and the
+ * seen BSSIDs. It is kept in memory and written back to a keyfile in the
+ * background. */
+typedef struct _NMSettingsDB NMSettingsDB;
+
+NMSettingsDB *nm_settings_db_new (const char *filename,
+                                  const char *group,
+                                  char list_separator,
+                                  const char *log_filename,
+                                  guint flush_delay_sec);
+void nm_settings_db_free (NMSettingsDB *db);
+
+const char *nm_settings_db_get_value (NMSettingsDB *db, const char *key);
+char **nm_settings_db_get_string_list (NMSettingsDB *db, const char *key, gsize *out_len);
+
+void nm_settings_db_set_value (NMSettingsDB *db, const char *key, const char *value);
+void nm_settings_db_set_string_list (NMSettingsDB *db,
+                                     const char *key,
+                                     const char *const*list,
+                                     gsize len);
+void nm_settings_db_remove (NMSettingsDB *db, const char *key);
+
+void nm_settings_db_flush (NMSettingsDB *db);
+
+NMSettingsDB *nm_settings_db_get_timestamps (void);
+NMSettingsDB *nm_settings_db_get_seen_bssids (void);
+void nm_settings_db_flush_all (void);
+
+#endif /* __NM_SETTINGS_DB_H__ */
@@ -0,0 +1,162 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager system settings service
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2018 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include "nm-settings-read-pool.h"
+
+#include "nm-meta-setting.h"
+#include "crypto.h"
+#include "nm-config.h"
+
+/*****************************************************************************/
+
+#define _NMLOG_DOMAIN      LOGD_SETTINGS
+#define _NMLOG(level, ...) __NMLOG_DEFAULT (level, _NMLOG_DOMAIN, "settings-read", __VA_ARGS__)
+
+/*****************************************************************************/
+
+typedef struct {
+	const char *const*filenames;
+	NMSettingsReadResult *results;
+	NMSettingsReadFunc read_func;
+} RunData;
+
+guint
+nm_settings_read_pool_get_n_threads (void)
+{
+	NMConfig *config = nm_config_get ();
+
+	if (!config)
+		return 0;
+	return nm_config_data_get_value_int64 (nm_config_get_data_orig (config),
+	                                       NM_CONFIG_KEYFILE_GROUP_MAIN,
+	                                       NM_CONFIG_KEYFILE_KEY_MAIN_SETTINGS_READ_THREADS,
+	                                       10, 0, 64, 0);
+}
+
+/* libnm-core registers setting types and initializes the crypto backend
+ * lazily, and neither is thread-safe. Do both on the main thread before
+ * the first file is read on a worker. */
+static void
+_prepare_libnm_core (void)
+{
+	static gboolean prepared = FALSE;
+	guint i;
+
+	if (prepared)
+		return;
+	prepared = TRUE;
+
+	for (i = 0; i < _NM_META_SETTING_TYPE_NUM; i++)
+		g_type_class_unref (g_type_class_ref (nm_meta_setting_infos[i].get_setting_gtype ()));
+	g_type_class_unref (g_type_class_ref (NM_TYPE_SIMPLE_CONNECTION));
+
+	crypto_init (NULL);
+}
+
+static void
+_read_cb (gpointer task, gpointer user_data)
+{
+	RunData *run_data = user_data;
+	guint i = GPOINTER_TO_UINT (task) - 1;
+	NMSettingsReadResult *result = &run_data->results[i];
+
+	result->data = run_data->read_func (run_data->filenames[i], &result->error);
+}
+
+/**
+ * nm_settings_read_pool_run:
+ * @filenames: the files to read
+ * @n_filenames: the number of files
+ * @read_func: the function reading one file on a worker thread
+ * @n_threads: the maximum number of threads, usually
+ *   nm_settings_read_pool_get_n_threads()
+ *
+ * Calls @read_func for every file on a pool of worker threads and waits
+ * until all files are read. The main loop does not run meanwhile, so the
+ * daemon cannot change any state that @read_func might look at.
+ *
+ * Returns: an array with one result per file, in the order of @filenames.
+ *   Free it with nm_settings_read_results_free(). Returns %NULL if reading
+ *   in parallel is disabled or not worth it; the caller then reads the
+ *   files itself.
+ */
+NMSettingsReadResult *
+nm_settings_read_pool_run (const char *const*filenames,
+                           guint n_filenames,
+                           NMSettingsReadFunc read_func,
+                           guint n_threads)
+{
+	gs_free_error GError *error = NULL;
+	RunData run_data;
+	GThreadPool *pool;
+	guint i;
+	gint64 start;
+
+	g_return_val_if_fail (read_func, NULL);
+
+	if (n_threads <= 1 || n_filenames <= 1)
+		return NULL;
+
+	_prepare_libnm_core ();
+
+	run_data = (RunData) {
+		.filenames = filenames,
+		.results = g_new0 (NMSettingsReadResult, n_filenames),
+		.read_func = read_func,
+	};
+
+	pool = g_thread_pool_new (_read_cb, &run_data, MIN (n_threads, n_filenames), FALSE, &error);
+	if (!pool) {
+		_LOGW ("cannot start threads to read connections: %s", error->message);
+		g_free (run_data.results);
+		return NULL;
+	}
+
+	start = nm_utils_get_monotonic_timestamp_us ();
+	for (i = 0; i < n_filenames; i++)
+		g_thread_pool_push (pool, GUINT_TO_POINTER (i + 1), NULL);
+	g_thread_pool_free (pool, FALSE, TRUE);
+
+	_LOGD ("read %u files with %u threads in %"G_GINT64_FORMAT" usec",
+	       n_filenames, MIN (n_threads, n_filenames),
+	       nm_utils_get_monotonic_timestamp_us () - start);
+
+	return run_data.results;
+}
+
+void
+nm_settings_read_results_free (NMSettingsReadResult *results,
+                               guint n_results,
+                               GDestroyNotify data_free)
+{
+	guint i;
+
+	if (!results)
+		return;
+
+	for (i = 0; i < n_results; i++) {
+		if (results[i].data && data_free)
+			data_free (results[i].data);
+		g_clear_error (&results[i].error);
+	}
+	g_free (results);
+}
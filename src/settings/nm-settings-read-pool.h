@@ -0,0 +1,48 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager system settings service
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2018 Red Hat, Inc.
+ */
+
+#ifndef __NM_SETTINGS_READ_POOL_H__
+#define __NM_SETTINGS_READ_POOL_H__
+
+/* Parses connection files on a pool of worker threads, so that settings
+ * plugins only need to do the cheap part of loading on the main thread.
+ *
+ * @read_func runs on a worker thread. It must only parse and verify the
+ * file into detached objects, and must not touch singletons or any other
+ * state of the daemon. It returns plugin specific data, and/or sets @error. */
+typedef gpointer (*NMSettingsReadFunc) (const char *filename, GError **error);
+
+typedef struct {
+	gpointer data;
+	GError *error;
+} NMSettingsReadResult;
+
+guint nm_settings_read_pool_get_n_threads (void);
+
+NMSettingsReadResult *nm_settings_read_pool_run (const char *const*filenames,
+                                                 guint n_filenames,
+                                                 NMSettingsReadFunc read_func,
+                                                 guint n_threads);
+
+void nm_settings_read_results_free (NMSettingsReadResult *results,
+                                    guint n_results,
+                                    GDestroyNotify data_free);
+
+#endif /* __NM_SETTINGS_READ_POOL_H__ */
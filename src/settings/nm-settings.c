@@ -122,7 +122,8 @@ typedef struct {
 
 	GSList *plugins;
 	gboolean connections_loaded;
-	GHashTable *connections;
+	GHashTable *connections;          /* D-Bus path::connection */
+	GHashTable *connections_by_uuid;  /* uuid::connection */
 	NMSettingsConnection **connections_cached_list;
 	GSList *unmanaged_specs;
 	GSList *unrecognized_specs;
@@ -290,21 +291,13 @@ NMSettingsConnection *
 nm_settings_get_connection_by_uuid (NMSettings *self, const char *uuid)
 {
 	NMSettingsPrivate *priv;
-	NMSettingsConnection *candidate;
-	GHashTableIter iter;
 
 	g_return_val_if_fail (NM_IS_SETTINGS (self), NULL);
 	g_return_val_if_fail (uuid != NULL, NULL);
 
 	priv = NM_SETTINGS_GET_PRIVATE (self);
 
-	g_hash_table_iter_init (&iter, priv->connections);
-	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &candidate)) {
-		if (g_strcmp0 (uuid, nm_settings_connection_get_uuid (candidate)) == 0)
-			return candidate;
-	}
-
-	return NULL;
+	return g_hash_table_lookup (priv->connections_by_uuid, uuid);
 }
 
 static void
@@ -480,15 +473,11 @@ gboolean
 nm_settings_has_connection (NMSettings *self, NMSettingsConnection *connection)
 {
 	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
-	GHashTableIter iter;
-	gpointer data;
-
-	g_hash_table_iter_init (&iter, priv->connections);
-	while (g_hash_table_iter_next (&iter, NULL, &data))
-		if (data == connection)
-			return TRUE;
+	const char *path;
 
-	return FALSE;
+	path = nm_connection_get_path (NM_CONNECTION (connection));
+	return    path
+	       && g_hash_table_lookup (priv->connections, path) == connection;
 }
 
 const GSList *
@@ -821,6 +810,7 @@ connection_removed (NMSettingsConnection *connection, gpointer user_data)
 	NMSettings *self = NM_SETTINGS (user_data);
 	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
 	const char *cpath = nm_connection_get_path (NM_CONNECTION (connection));
+	const char *uuid;
 
 	if (!g_hash_table_lookup (priv->connections, cpath))
 		g_return_if_reached ();
@@ -839,6 +829,9 @@ connection_removed (NMSettingsConnection *connection, gpointer user_data)
 	g_object_unref (self);
 
 	/* Forget about the connection internally */
+	uuid = nm_settings_connection_get_uuid (connection);
+	if (g_hash_table_lookup (priv->connections_by_uuid, uuid) == connection)
+		g_hash_table_remove (priv->connections_by_uuid, uuid);
 	g_hash_table_remove (priv->connections, (gpointer) cpath);
 	g_clear_pointer (&priv->connections_cached_list, g_free);
 
@@ -900,21 +893,12 @@ claim_connection (NMSettings *self, NMSettingsConnection *connection)
 {
 	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
 	GError *error = NULL;
-	GHashTableIter iter;
-	gpointer data;
 	const char *path;
 	NMSettingsConnection *existing;
 
 	g_return_if_fail (NM_IS_SETTINGS_CONNECTION (connection));
 	g_return_if_fail (nm_connection_get_path (NM_CONNECTION (connection)) == NULL);
 
-	g_hash_table_iter_init (&iter, priv->connections);
-	while (g_hash_table_iter_next (&iter, NULL, &data)) {
-		/* prevent duplicates */
-		if (data == connection)
-			return;
-	}
-
 	if (!nm_connection_normalize (NM_CONNECTION (connection), NULL, NULL, &error)) {
 		_LOGW ("plugin provided invalid connection: %s", error->message);
 		g_error_free (error);
@@ -922,6 +906,10 @@ claim_connection (NMSettings *self, NMSettingsConnection *connection)
 	}
 
 	existing = nm_settings_get_connection_by_uuid (self, nm_settings_connection_get_uuid (connection));
+	if (existing == connection) {
+		/* prevent duplicates */
+		return;
+	}
 	if (existing) {
 		/* Cannot add duplicate connections per UUID. Just return without action and
 		 * log a warning.
@@ -974,6 +962,14 @@ claim_connection (NMSettings *self, NMSettingsConnection *connection)
 	g_hash_table_insert (priv->connections,
 	                     (gpointer) nm_connection_get_path (NM_CONNECTION (connection)),
 	                     g_object_ref (connection));
+
+	/* The UUID of an exported connection cannot change (see _update_prepare()),
+	 * so the index only needs updating here and in connection_removed().
+	 * The key is copied, because the string is owned by the setting which
+	 * gets replaced on update. */
+	g_hash_table_insert (priv->connections_by_uuid,
+	                     g_strdup (nm_settings_connection_get_uuid (connection)),
+	                     connection);
 	g_clear_pointer (&priv->connections_cached_list, g_free);
 
 	nm_utils_log_connection_diff (NM_CONNECTION (connection), NULL, LOGL_DEBUG, LOGD_CORE, "new connection", "++ ");
@@ -1849,6 +1845,7 @@ nm_settings_init (NMSettings *self)
 	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
 
 	priv->connections = g_hash_table_new_full (nm_str_hash, g_str_equal, NULL, g_object_unref);
+	priv->connections_by_uuid = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, NULL);
 
 	priv->agent_mgr = g_object_ref (nm_agent_manager_get ());
 	priv->config = g_object_ref (nm_config_get ());
@@ -1887,6 +1884,7 @@ finalize (GObject *object)
 	NMSettings *self = NM_SETTINGS (object);
 	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
 
+	g_hash_table_destroy (priv->connections_by_uuid);
 	g_hash_table_destroy (priv->connections);
 	g_clear_pointer (&priv->connections_cached_list, g_free);
 
@@ -400,34 +400,15 @@ nm_ifcfg_connection_init (NMIfcfgConnection *connection)
 	                  G_CALLBACK (filename_changed), NULL);
 }
 
-NMIfcfgConnection *
-nm_ifcfg_connection_new (NMConnection *source,
-                         const char *full_path,
-                         GError **error,
-                         gboolean *out_ignore_error)
+static NMIfcfgConnection *
+_new (NMConnection *tmp,
+      const char *unhandled_spec,
+      const char *full_path,
+      GError **error)
 {
 	GObject *object;
-	NMConnection *tmp;
-	char *unhandled_spec = NULL;
 	const char *unmanaged_spec = NULL, *unrecognized_spec = NULL;
 
-	g_assert (source || full_path);
-
-	if (out_ignore_error)
-		*out_ignore_error = FALSE;
-
-	/* If we're given a connection already, prefer that instead of re-reading */
-	if (source)
-		tmp = g_object_ref (source);
-	else {
-		tmp = connection_from_file (full_path,
-		                            &unhandled_spec,
-		                            error,
-		                            out_ignore_error);
-		if (!tmp)
-			return NULL;
-	}
-
 	if (unhandled_spec && g_str_has_prefix (unhandled_spec, "unmanaged:"))
 		unmanaged_spec = unhandled_spec + strlen ("unmanaged:");
 	else if (unhandled_spec && g_str_has_prefix (unhandled_spec, "unrecognized:"))
@@ -451,11 +432,97 @@ nm_ifcfg_connection_new (NMConnection *source,
 	else
 		g_clear_object (&object);
 
-	g_object_unref (tmp);
-	g_free (unhandled_spec);
 	return (NMIfcfgConnection *) object;
 }
 
+NMIfcfgConnection *
+nm_ifcfg_connection_new (NMConnection *source,
+                         const char *full_path,
+                         GError **error,
+                         gboolean *out_ignore_error)
+{
+	NMIfcfgConnectionRead *read;
+	NMIfcfgConnection *connection;
+
+	g_assert (source || full_path);
+
+	if (out_ignore_error)
+		*out_ignore_error = FALSE;
+
+	/* If we're given a connection already, prefer that instead of re-reading */
+	if (source)
+		return _new (source, NULL, full_path, error);
+
+	read = nm_ifcfg_connection_read (full_path, error);
+	if (!read->connection) {
+		if (out_ignore_error)
+			*out_ignore_error = read->ignore_error;
+		nm_ifcfg_connection_read_free (read);
+		return NULL;
+	}
+
+	connection = _new (read->connection, read->unhandled_spec, full_path, error);
+	nm_ifcfg_connection_read_free (read);
+	return connection;
+}
+
+/**
+ * nm_ifcfg_connection_read:
+ * @full_path: the ifcfg file to read
+ * @error: error in case of failure
+ *
+ * Reads @full_path into a detached #NMConnection. Apart from looking up
+ * links in the platform cache, this does not touch any state of the daemon,
+ * so it may be called on a worker thread while the main thread waits.
+ *
+ * Returns: (transfer full): the result, also on failure. Then its
+ *   connection is %NULL and @error is set.
+ */
+NMIfcfgConnectionRead *
+nm_ifcfg_connection_read (const char *full_path, GError **error)
+{
+	NMIfcfgConnectionRead *read;
+
+	g_return_val_if_fail (full_path, NULL);
+
+	read = g_slice_new0 (NMIfcfgConnectionRead);
+	read->connection = connection_from_file (full_path,
+	                                         &read->unhandled_spec,
+	                                         error,
+	                                         &read->ignore_error);
+	return read;
+}
+
+void
+nm_ifcfg_connection_read_free (NMIfcfgConnectionRead *read)
+{
+	if (!read)
+		return;
+	g_clear_object (&read->connection);
+	g_free (read->unhandled_spec);
+	g_slice_free (NMIfcfgConnectionRead, read);
+}
+
+/**
+ * nm_ifcfg_connection_new_from_read:
+ * @read: the result of nm_ifcfg_connection_read() with a connection
+ * @full_path: the file @read was read from
+ * @error: error in case of failure
+ *
+ * Like nm_ifcfg_connection_new() without source, but for a file that
+ * was already read.
+ */
+NMIfcfgConnection *
+nm_ifcfg_connection_new_from_read (const NMIfcfgConnectionRead *read,
+                                   const char *full_path,
+                                   GError **error)
+{
+	g_return_val_if_fail (read && read->connection, NULL);
+	g_return_val_if_fail (full_path, NULL);
+
+	return _new (read->connection, read->unhandled_spec, full_path, error);
+}
+
 static void
 dispose (GObject *object)
 {
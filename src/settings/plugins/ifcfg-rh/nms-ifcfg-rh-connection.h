@@ -44,6 +44,19 @@ NMIfcfgConnection *nm_ifcfg_connection_new (NMConnection *source,
                                             GError **error,
                                             gboolean *out_ignore_error);
 
+typedef struct {
+	NMConnection *connection;
+	char *unhandled_spec;
+	gboolean ignore_error;
+} NMIfcfgConnectionRead;
+
+NMIfcfgConnectionRead *nm_ifcfg_connection_read (const char *full_path, GError **error);
+void nm_ifcfg_connection_read_free (NMIfcfgConnectionRead *read);
+
+NMIfcfgConnection *nm_ifcfg_connection_new_from_read (const NMIfcfgConnectionRead *read,
+                                                      const char *full_path,
+                                                      GError **error);
+
 const char *nm_ifcfg_connection_get_unmanaged_spec (NMIfcfgConnection *self);
 const char *nm_ifcfg_connection_get_unrecognized_spec (NMIfcfgConnection *self);
 
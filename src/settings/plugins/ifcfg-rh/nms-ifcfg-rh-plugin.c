@@ -35,6 +35,7 @@
 #include "nm-dbus-compat.h"
 #include "nm-setting-connection.h"
 #include "settings/nm-settings-plugin.h"
+#include "settings/nm-settings-read-pool.h"
 #include "nm-config.h"
 #include "NetworkManagerUtils.h"
 #include "nm-exported-object.h"
@@ -64,6 +65,13 @@ typedef struct {
 	} dbus;
 
 	GHashTable *connections;  /* uuid::connection */
+
+	/* Index of the connections above by their backing file. @filenames
+	 * remembers the name under which a connection was indexed, so that the
+	 * stale entry can be dropped when the connection gets renamed. */
+	GHashTable *connections_by_filename;  /* filename::connection */
+	GHashTable *filenames;                /* connection::filename */
+
 	gboolean initialized;
 
 	GFileMonitor *ifcfg_monitor;
@@ -109,6 +117,7 @@ NM_DEFINE_SINGLETON_GETTER (SettingsPluginIfcfg, settings_plugin_ifcfg_get, SETT
 static NMIfcfgConnection *update_connection (SettingsPluginIfcfg *plugin,
                                              NMConnection *source,
                                              const char *full_path,
+                                             const NMSettingsReadResult *read,
                                              NMIfcfgConnection *connection,
                                              gboolean protect_existing_connection,
                                              GHashTable *protected_connections,
@@ -116,6 +125,62 @@ static NMIfcfgConnection *update_connection (SettingsPluginIfcfg *plugin,
 
 /*****************************************************************************/
 
+static void
+_filename_index_update (SettingsPluginIfcfg *self, NMSettingsConnection *connection)
+{
+	SettingsPluginIfcfgPrivate *priv = SETTINGS_PLUGIN_IFCFG_GET_PRIVATE (self);
+	const char *old_filename;
+	const char *filename;
+
+	old_filename = g_hash_table_lookup (priv->filenames, connection);
+	filename = nm_settings_connection_get_filename (connection);
+	if (nm_streq0 (old_filename, filename))
+		return;
+
+	if (   old_filename
+	    && g_hash_table_lookup (priv->connections_by_filename, old_filename) == connection)
+		g_hash_table_remove (priv->connections_by_filename, old_filename);
+
+	if (filename) {
+		g_hash_table_insert (priv->connections_by_filename, g_strdup (filename), connection);
+		g_hash_table_insert (priv->filenames, connection, g_strdup (filename));
+	} else
+		g_hash_table_remove (priv->filenames, connection);
+}
+
+static void
+connection_filename_changed_cb (NMSettingsConnection *connection, GParamSpec *pspec, gpointer user_data)
+{
+	_filename_index_update (user_data, connection);
+}
+
+static void
+_filename_index_add (SettingsPluginIfcfg *self, NMSettingsConnection *connection)
+{
+	g_signal_connect (connection, "notify::" NM_SETTINGS_CONNECTION_FILENAME,
+	                  G_CALLBACK (connection_filename_changed_cb),
+	                  self);
+	_filename_index_update (self, connection);
+}
+
+static void
+_filename_index_remove (SettingsPluginIfcfg *self, NMSettingsConnection *connection)
+{
+	SettingsPluginIfcfgPrivate *priv = SETTINGS_PLUGIN_IFCFG_GET_PRIVATE (self);
+	const char *old_filename;
+
+	g_signal_handlers_disconnect_by_func (connection, connection_filename_changed_cb, self);
+
+	old_filename = g_hash_table_lookup (priv->filenames, connection);
+	if (!old_filename)
+		return;
+	if (g_hash_table_lookup (priv->connections_by_filename, old_filename) == connection)
+		g_hash_table_remove (priv->connections_by_filename, old_filename);
+	g_hash_table_remove (priv->filenames, connection);
+}
+
+/*****************************************************************************/
+
 static void
 connection_ifcfg_changed (NMIfcfgConnection *connection, gpointer user_data)
 {
@@ -134,13 +199,16 @@ connection_ifcfg_changed (NMIfcfgConnection *connection, gpointer user_data)
 
 	_LOGD ("connection_ifcfg_changed("NM_IFCFG_CONNECTION_LOG_FMTD"): %s", NM_IFCFG_CONNECTION_LOG_ARGD (connection), "reload");
 
-	update_connection (self, NULL, path, connection, TRUE, NULL, NULL);
+	update_connection (self, NULL, path, NULL, connection, TRUE, NULL, NULL);
 }
 
 static void
 connection_removed_cb (NMSettingsConnection *obj, gpointer user_data)
 {
-	g_hash_table_remove (SETTINGS_PLUGIN_IFCFG_GET_PRIVATE ((SettingsPluginIfcfg *) user_data)->connections,
+	SettingsPluginIfcfg *self = user_data;
+
+	_filename_index_remove (self, obj);
+	g_hash_table_remove (SETTINGS_PLUGIN_IFCFG_GET_PRIVATE (self)->connections,
 	                     nm_connection_get_uuid (NM_CONNECTION (obj)));
 }
 
@@ -159,6 +227,7 @@ remove_connection (SettingsPluginIfcfg *self, NMIfcfgConnection *connection)
 	unrecognized = !!nm_ifcfg_connection_get_unrecognized_spec (connection);
 
 	g_object_ref (connection);
+	_filename_index_remove (self, NM_SETTINGS_CONNECTION (connection));
 	g_hash_table_remove (priv->connections, nm_connection_get_uuid (NM_CONNECTION (connection)));
 	if (!unmanaged && !unrecognized)
 		nm_settings_connection_signal_remove (NM_SETTINGS_CONNECTION (connection));
@@ -175,23 +244,17 @@ static NMIfcfgConnection *
 find_by_path (SettingsPluginIfcfg *self, const char *path)
 {
 	SettingsPluginIfcfgPrivate *priv = SETTINGS_PLUGIN_IFCFG_GET_PRIVATE (self);
-	GHashTableIter iter;
-	NMSettingsConnection *candidate = NULL;
 
 	g_return_val_if_fail (path != NULL, NULL);
 
-	g_hash_table_iter_init (&iter, priv->connections);
-	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &candidate)) {
-		if (g_strcmp0 (path, nm_settings_connection_get_filename (candidate)) == 0)
-			return NM_IFCFG_CONNECTION (candidate);
-	}
-	return NULL;
+	return g_hash_table_lookup (priv->connections_by_filename, path);
 }
 
 static NMIfcfgConnection *
 update_connection (SettingsPluginIfcfg *self,
                    NMConnection *source,
                    const char *full_path,
+                   const NMSettingsReadResult *read,
                    NMIfcfgConnection *connection,
                    gboolean protect_existing_connection,
                    GHashTable *protected_connections,
@@ -214,8 +277,21 @@ update_connection (SettingsPluginIfcfg *self,
 		_LOGD ("loading from file \"%s\"...", full_path);
 
 	/* Create a NMIfcfgConnection instance, either by reading from @full_path or
-	 * based on @source. */
-	connection_new = nm_ifcfg_connection_new (source, full_path, &local, &ignore_error);
+	 * based on @source. If @read is given, @full_path was already read on a
+	 * worker thread. */
+	if (read) {
+		const NMIfcfgConnectionRead *r = read->data;
+
+		if (r->connection)
+			connection_new = nm_ifcfg_connection_new_from_read (r, full_path, &local);
+		else {
+			connection_new = NULL;
+			ignore_error = r->ignore_error;
+			if (read->error)
+				local = g_error_copy (read->error);
+		}
+	} else
+		connection_new = nm_ifcfg_connection_new (source, full_path, &local, &ignore_error);
 	if (!connection_new) {
 		/* Unexpected failure. Probably the file is invalid? */
 		if (   connection
@@ -342,6 +418,7 @@ update_connection (SettingsPluginIfcfg *self,
 					g_hash_table_insert (priv->connections,
 					                     g_strdup (nm_connection_get_uuid (NM_CONNECTION (connection_by_uuid))),
 					                     connection_by_uuid);
+					_filename_index_add (self, NM_SETTINGS_CONNECTION (connection_by_uuid));
 				}
 			} else {
 				if (old_unmanaged /* && !new_unmanaged */) {
@@ -374,6 +451,7 @@ update_connection (SettingsPluginIfcfg *self,
 		else
 			_LOGI ("new connection "NM_IFCFG_CONNECTION_LOG_FMT, NM_IFCFG_CONNECTION_LOG_ARG (connection_new));
 		g_hash_table_insert (priv->connections, g_strdup (uuid), connection_new);
+		_filename_index_add (self, NM_SETTINGS_CONNECTION (connection_new));
 
 		g_signal_connect (connection_new, NM_SETTINGS_CONNECTION_REMOVED,
 		                  G_CALLBACK (connection_removed_cb),
@@ -429,7 +507,7 @@ ifcfg_dir_changed (GFileMonitor *monitor,
 		case G_FILE_MONITOR_EVENT_CREATED:
 		case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
 			/* Update or new */
-			update_connection (plugin, NULL, ifcfg_path, connection, TRUE, NULL, NULL);
+			update_connection (plugin, NULL, ifcfg_path, NULL, connection, TRUE, NULL, NULL);
 			break;
 		default:
 			break;
@@ -508,6 +586,7 @@ read_connections (SettingsPluginIfcfg *plugin)
 	guint i;
 	GPtrArray *filenames;
 	GHashTable *paths;
+	NMSettingsReadResult *results;
 
 	dir = g_dir_open (IFCFG_DIR, 0, &err);
 	if (!dir) {
@@ -541,11 +620,22 @@ read_connections (SettingsPluginIfcfg *plugin)
 	g_ptr_array_sort_with_data (filenames, (GCompareDataFunc) _sort_paths, paths);
 	g_hash_table_destroy (paths);
 
+	/* Parsing the files is independent per file and can happen on worker
+	 * threads. Resolving UUID conflicts depends on the order above, so the
+	 * connections are still added one by one. */
+	results = nm_settings_read_pool_run ((const char *const*) filenames->pdata,
+	                                     filenames->len,
+	                                     (NMSettingsReadFunc) nm_ifcfg_connection_read,
+	                                     nm_settings_read_pool_get_n_threads ());
+
 	for (i = 0; i < filenames->len; i++) {
-		connection = update_connection (plugin, NULL, filenames->pdata[i], NULL, FALSE, alive_connections, NULL);
+		connection = update_connection (plugin, NULL, filenames->pdata[i],
+		                                results ? &results[i] : NULL,
+		                                NULL, FALSE, alive_connections, NULL);
 		if (connection)
 			g_hash_table_add (alive_connections, connection);
 	}
+	nm_settings_read_results_free (results, filenames->len, (GDestroyNotify) nm_ifcfg_connection_read_free);
 	g_ptr_array_free (filenames, TRUE);
 
 	g_hash_table_iter_init (&iter, priv->connections);
@@ -613,7 +703,7 @@ load_connection (NMSettingsPlugin *config,
 		return FALSE;
 
 	connection = find_by_path (plugin, ifcfg_path);
-	update_connection (plugin, NULL, ifcfg_path, connection, TRUE, NULL, NULL);
+	update_connection (plugin, NULL, ifcfg_path, NULL, connection, TRUE, NULL, NULL);
 	if (!connection)
 		connection = find_by_path (plugin, ifcfg_path);
 
@@ -689,7 +779,7 @@ add_connection (NMSettingsPlugin *config,
 		if (!nms_ifcfg_rh_writer_can_write_connection (connection, error))
 			return NULL;
 	}
-	return NM_SETTINGS_CONNECTION (update_connection (self, reread ?: connection, path, NULL, FALSE, NULL, error));
+	return NM_SETTINGS_CONNECTION (update_connection (self, reread ?: connection, path, NULL, NULL, FALSE, NULL, error));
 }
 
 static void
@@ -991,6 +1081,8 @@ settings_plugin_ifcfg_init (SettingsPluginIfcfg *plugin)
 	SettingsPluginIfcfgPrivate *priv = SETTINGS_PLUGIN_IFCFG_GET_PRIVATE ((SettingsPluginIfcfg *) plugin);
 
 	priv->connections = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, g_object_unref);
+	priv->connections_by_filename = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, NULL);
+	priv->filenames = g_hash_table_new_full (nm_direct_hash, NULL, NULL, g_free);
 }
 
 static void
@@ -1026,9 +1118,17 @@ dispose (GObject *object)
 	_dbus_clear (self);
 
 	if (priv->connections) {
+		GHashTableIter iter;
+		gpointer connection;
+
+		g_hash_table_iter_init (&iter, priv->connections);
+		while (g_hash_table_iter_next (&iter, NULL, &connection))
+			g_signal_handlers_disconnect_by_func (connection, connection_filename_changed_cb, object);
 		g_hash_table_destroy (priv->connections);
 		priv->connections = NULL;
 	}
+	g_clear_pointer (&priv->connections_by_filename, g_hash_table_destroy);
+	g_clear_pointer (&priv->filenames, g_hash_table_destroy);
 
 	if (priv->ifcfg_monitor) {
 		if (priv->ifcfg_monitor_id)
@@ -66,6 +66,11 @@ struct _shvarLine {
 	char *line;
 	const char *key;
 	char *key_with_prefix;
+
+	/* A key may be assigned more than once in a file, and the last
+	 * assignment wins. shvarFile indexes only that last line; this
+	 * points to the previous line with the same key, if any. */
+	struct _shvarLine *prev_shadowed;
 };
 
 typedef struct _shvarLine shvarLine;
@@ -74,6 +79,11 @@ struct _shvarFile {
 	char      *fileName;
 	int        fd;
 	CList      lst_head;
+
+	/* The lines of @lst_head that have a key, indexed by their key.
+	 * For a key that occurs multiple times, this contains the last line. */
+	GHashTable *lst_idx;
+
 	gboolean   modified;
 };
 
@@ -624,6 +634,18 @@ out_error:
 
 /*****************************************************************************/
 
+static guint
+_line_hash (gconstpointer ptr)
+{
+	return nm_str_hash (((const shvarLine *) ptr)->key);
+}
+
+static gboolean
+_line_equal (gconstpointer a, gconstpointer b)
+{
+	return nm_streq (((const shvarLine *) a)->key, ((const shvarLine *) b)->key);
+}
+
 static shvarFile *
 svFile_new (const char *name)
 {
@@ -633,6 +655,7 @@ svFile_new (const char *name)
 	s->fd = -1;
 	s->fileName = g_strdup (name);
 	c_list_init (&s->lst_head);
+	s->lst_idx = g_hash_table_new (_line_hash, _line_equal);
 	return s;
 }
 
@@ -780,6 +803,25 @@ line_free (shvarLine *line)
 	g_slice_free (shvarLine, line);
 }
 
+static shvarLine *
+line_lookup (shvarFile *s, const char *key)
+{
+	shvarLine needle = { .key = key };
+
+	return g_hash_table_lookup (s->lst_idx, &needle);
+}
+
+static void
+line_link_tail (shvarFile *s, shvarLine *line)
+{
+	c_list_link_tail (&s->lst_head, &line->lst);
+	if (line->key) {
+		/* the new line shadows a previous one with the same key. */
+		line->prev_shadowed = line_lookup (s, line->key);
+		g_hash_table_add (s->lst_idx, line);
+	}
+}
+
 /*****************************************************************************/
 
 /* Open the file <name>, returning a shvarFile on success and NULL on failure.
@@ -837,9 +879,9 @@ svOpenFileInternal (const char *name, gboolean create, GError **error)
 	s = svFile_new (name);
 
 	for (p = arena; (q = strchr (p, '\n')) != NULL; p = q + 1)
-		c_list_link_tail (&s->lst_head, &line_new_parse (p, q - p)->lst);
+		line_link_tail (s, line_new_parse (p, q - p));
 	if (p[0])
-		c_list_link_tail (&s->lst_head, &line_new_parse (p, strlen (p))->lst);
+		line_link_tail (s, line_new_parse (p, strlen (p)));
 	g_free (arena);
 
 	/* closefd is set if we opened the file read-only, so go ahead and
@@ -919,21 +961,14 @@ svFindFirstKeyWithPrefix (shvarFile *s, const char *key_prefix)
 static const char *
 _svGetValue (shvarFile *s, const char *key, char **to_free)
 {
-	CList *current;
-	const shvarLine *line, *l;
+	const shvarLine *line;
 	const char *v;
 
 	nm_assert (s);
 	nm_assert (_shell_is_name (key, -1));
 	nm_assert (to_free);
 
-	line = NULL;
-	c_list_for_each (current, &s->lst_head) {
-		l = c_list_entry (current, shvarLine, lst);
-		if (l->key && nm_streq (l->key, key))
-			line = l;
-	}
-
+	line = line_lookup (s, key);
 	if (line && line->line) {
 		v = svUnescape (line->line, to_free);
 		if (!v) {
@@ -1195,7 +1230,6 @@ do_clear:
 gboolean
 svSetValue (shvarFile *s, const char *key, const char *value)
 {
-	CList *current;
 	shvarLine *line, *l;
 	gboolean changed = FALSE;
 
@@ -1204,17 +1238,14 @@ svSetValue (shvarFile *s, const char *key, const char *value)
 
 	nm_assert (_shell_is_name (key, -1));
 
-	line = NULL;
-	c_list_for_each (current, &s->lst_head) {
-		l = c_list_entry (current, shvarLine, lst);
-		if (l->key && nm_streq (l->key, key)) {
-			if (line) {
-				/* if we find multiple entries for the same key, we can
-				 * delete all but the last. */
-				line_free (line);
-				changed = TRUE;
-			}
-			line = l;
+	line = line_lookup (s, key);
+	if (line) {
+		/* if we find multiple entries for the same key, we can
+		 * delete all but the last. */
+		while ((l = line->prev_shadowed)) {
+			line->prev_shadowed = l->prev_shadowed;
+			line_free (l);
+			changed = TRUE;
 		}
 	}
 
@@ -1226,7 +1257,7 @@ svSetValue (shvarFile *s, const char *key, const char *value)
 		}
 	} else {
 		if (!line) {
-			c_list_link_tail (&s->lst_head, &line_new_build (key, value)->lst);
+			line_link_tail (s, line_new_build (key, value));
 			changed = TRUE;
 		} else {
 			if (line_set (line, value))
@@ -1381,6 +1412,7 @@ svCloseFile (shvarFile *s)
 	if (s->fd >= 0)
 		nm_close (s->fd);
 	g_free (s->fileName);
+	g_hash_table_destroy (s->lst_idx);
 	c_list_for_each_safe (current, safe, &s->lst_head)
 		line_free (c_list_entry (current, shvarLine, lst));
 	g_slice_free (shvarFile, s);
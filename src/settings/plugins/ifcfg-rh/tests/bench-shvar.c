@@ -0,0 +1,235 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager system settings service
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2018 Red Hat, Inc.
+ */
+
+/* Benchmark for shvarFile: reads many ifcfg files with many numbered
+ * addresses, and looks up and sets their keys like the ifcfg-rh reader
+ * and writer do. This is run once with few addresses per file and once
+ * with many, and fails if the cost per key grows with the size of the
+ * file. Prints one JSON document on stdout.
+ *
+ * Run it with "make bench". */
+
+#include "nm-default.h"
+
+#include <unistd.h>
+
+#include "settings/plugins/ifcfg-rh/shvar.h"
+
+#include "tests/bench-utils.h"
+
+/*****************************************************************************/
+
+NMTST_DEFINE ();
+
+static struct {
+	int n_files;
+	int n_addresses;
+} global_opt = {
+	.n_files = 10000,
+	.n_addresses = 256,
+};
+
+/* The cost per key with all addresses may be at most this many times the
+ * cost with a sixteenth of them. A lookup that scans all lines of the
+ * file would be around 16 times as expensive. */
+#define MAX_COST_RATIO 3.0
+
+/* The keys looked up per address, like the reader does for IPv4. */
+static const char *const address_keys[] = { "IPADDR", "PREFIX", "NETMASK", "GATEWAY" };
+
+/*****************************************************************************/
+
+static char *
+_ifcfg_path (const char *dir, int i)
+{
+	return g_strdup_printf ("%s/ifcfg-bench-%d", dir, i);
+}
+
+static void
+_ifcfg_write (const char *dir, int n_files, int n_addresses)
+{
+	GString *data;
+	int i, j;
+
+	data = g_string_new (NULL);
+	for (i = 0; i < n_files; i++) {
+		gs_free char *filename = NULL;
+		gs_free_error GError *error = NULL;
+
+		g_string_printf (data,
+		                 "TYPE=Ethernet\n"
+		                 "NAME=bench-%d\n"
+		                 "DEVICE=eth%d\n"
+		                 "ONBOOT=no\n"
+		                 "BOOTPROTO=none\n",
+		                 i, i);
+		for (j = 0; j < n_addresses; j++) {
+			g_string_append_printf (data,
+			                        "IPADDR%d=10.%d.%d.%d\n"
+			                        "PREFIX%d=24\n",
+			                        j, (i >> 8) & 0xff, i & 0xff, j & 0xff,
+			                        j);
+		}
+
+		filename = _ifcfg_path (dir, i);
+		if (!g_file_set_contents (filename, data->str, data->len, &error))
+			g_error ("failure to write ifcfg file %s: %s", filename, error->message);
+	}
+	g_string_free (data, TRUE);
+}
+
+static void
+_ifcfg_remove (const char *dir, int n_files)
+{
+	int i;
+
+	for (i = 0; i < n_files; i++) {
+		gs_free char *filename = _ifcfg_path (dir, i);
+
+		unlink (filename);
+	}
+}
+
+static shvarFile *
+_ifcfg_open (const char *dir, int i)
+{
+	gs_free char *filename = _ifcfg_path (dir, i);
+	gs_free_error GError *error = NULL;
+	shvarFile *f;
+
+	f = svOpenFile (filename, &error);
+	if (!f)
+		g_error ("failure to read %s: %s", filename, error->message);
+	return f;
+}
+
+/* Returns the CPU time per key of reading all addresses, plus that of
+ * reading the file and setting all addresses. */
+static double
+bench_shvar (const char *dir, int n_addresses, const char *read_name, const char *set_name)
+{
+	NmtstBenchPhase phase;
+	guint n_keys;
+	double cost;
+	int i, j;
+	guint k;
+
+	_ifcfg_write (dir, global_opt.n_files, n_addresses);
+
+	n_keys = global_opt.n_files * n_addresses * G_N_ELEMENTS (address_keys);
+
+	nmtst_bench_phase_start (&phase, read_name, n_keys);
+	for (i = 0; i < global_opt.n_files; i++) {
+		shvarFile *f = _ifcfg_open (dir, i);
+
+		for (j = 0; j < n_addresses; j++) {
+			for (k = 0; k < G_N_ELEMENTS (address_keys); k++) {
+				char key[64];
+				gs_free char *value = NULL;
+
+				nm_sprintf_buf (key, "%s%d", address_keys[k], j);
+				value = svGetValueStr_cp (f, key);
+				g_assert (value || k >= 2);
+			}
+		}
+		svCloseFile (f);
+	}
+	nmtst_bench_phase_end (&phase);
+	cost = (double) phase.cpu / n_keys;
+
+	nmtst_bench_phase_start (&phase, set_name, n_keys);
+	for (i = 0; i < global_opt.n_files; i++) {
+		shvarFile *f = _ifcfg_open (dir, i);
+
+		for (j = 0; j < n_addresses; j++) {
+			for (k = 0; k < G_N_ELEMENTS (address_keys); k++) {
+				char key[64];
+
+				nm_sprintf_buf (key, "%s%d", address_keys[k], j);
+				svSetValueStr (f, key, k == 1 ? "16" : NULL);
+			}
+		}
+		svCloseFile (f);
+	}
+	nmtst_bench_phase_end (&phase);
+	cost += (double) phase.cpu / n_keys;
+
+	_ifcfg_remove (dir, global_opt.n_files);
+	return cost;
+}
+
+/*****************************************************************************/
+
+static gboolean
+read_argv (int *argc, char ***argv)
+{
+	GOptionEntry options[] = {
+		{ "ifcfg-files", 0, 0, G_OPTION_ARG_INT, &global_opt.n_files, "Number of ifcfg files", "N" },
+		{ "ifcfg-addresses", 0, 0, G_OPTION_ARG_INT, &global_opt.n_addresses, "Number of addresses per ifcfg file", "N" },
+		{ 0 },
+	};
+
+	if (!nmtst_bench_init (argc, argv,
+	                       "Benchmark reading and updating many ifcfg files with many keys.",
+	                       options))
+		return FALSE;
+
+	if (   global_opt.n_files < 1
+	    || global_opt.n_addresses < 16) {
+		g_warning ("Invalid arguments");
+		return FALSE;
+	}
+	return TRUE;
+}
+
+int
+main (int argc, char **argv)
+{
+	gs_free char *dir = NULL;
+	gs_free_error GError *error = NULL;
+	int n_small;
+	double cost_small, cost;
+
+	if (!read_argv (&argc, &argv))
+		return 2;
+
+	dir = g_dir_make_tmp ("bench-shvar-XXXXXX", &error);
+	if (!dir)
+		g_error ("failure to create temporary directory: %s", error->message);
+
+	n_small = global_opt.n_addresses / 16;
+
+	cost_small = bench_shvar (dir, n_small, "read-small", "set-small");
+	cost = bench_shvar (dir, global_opt.n_addresses, "read", "set");
+
+	nmtst_bench_print ("shvar",
+	                   "ifcfg-files", global_opt.n_files,
+	                   "ifcfg-addresses", global_opt.n_addresses,
+	                   NULL);
+
+	rmdir (dir);
+
+	if (cost > MAX_COST_RATIO * MAX (cost_small, 0.01)) {
+		g_printerr ("looking up a key in an ifcfg file does not scale: %.3f usec with %d addresses, %.3f usec with %d addresses\n",
+		            cost, global_opt.n_addresses, cost_small, n_small);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
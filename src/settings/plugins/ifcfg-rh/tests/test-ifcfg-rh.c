@@ -55,6 +55,7 @@
 #include "settings/plugins/ifcfg-rh/nms-ifcfg-rh-reader.h"
 #include "settings/plugins/ifcfg-rh/nms-ifcfg-rh-writer.h"
 #include "settings/plugins/ifcfg-rh/nms-ifcfg-rh-utils.h"
+#include "settings/nm-settings-read-pool.h"
 
 #include "nm-test-utils-core.h"
 
@@ -9434,6 +9435,67 @@ test_svUnescape (void)
 
 /*****************************************************************************/
 
+static void
+test_svDuplicateKeys (void)
+{
+	nmtst_auto_unlinkfile char *filename = g_strdup (TEST_SCRATCH_DIR_TMP"/ifcfg-test-duplicate-keys");
+	gs_free_error GError *error = NULL;
+	gs_free char *contents = NULL;
+	shvarFile *sv;
+	gboolean success;
+
+	nmtst_file_set_contents (filename,
+	                         "#L1\n"
+	                         "KEY=k1\n"
+	                         "UNSET=u1\n"
+	                         "KEY=k2\n"
+	                         "OTHER=o1\n"
+	                         "UNSET=u2\n"
+	                         "KEY=k3\n"
+	                         "UNSET=u3\n"
+	                         "#L2\n");
+
+	sv = _svOpenFile (filename);
+
+	/* the last assignment wins. */
+	_svGetValue_check (sv, "KEY", "k3");
+	_svGetValue_check (sv, "UNSET", "u3");
+	_svGetValue_check (sv, "OTHER", "o1");
+
+	/* setting a key replaces the last assignment and drops the others. */
+	g_assert (svSetValue (sv, "KEY", "k4"));
+	_svGetValue_check (sv, "KEY", "k4");
+	g_assert (!svSetValue (sv, "KEY", "k4"));
+
+	g_assert (svSetValue (sv, "UNSET", NULL));
+	_svGetValue_check (sv, "UNSET", NULL);
+	g_assert (!svSetValue (sv, "UNSET", NULL));
+
+	g_assert (svSetValue (sv, "NEW", "n1"));
+	_svGetValue_check (sv, "NEW", "n1");
+
+	success = svWriteFile (sv, 0644, &error);
+	nmtst_assert_success (success, error);
+	svCloseFile (sv);
+
+	contents = nmtst_file_get_contents (filename);
+	g_assert_cmpstr (contents, ==,
+	                 "#L1\n"
+	                 "OTHER=o1\n"
+	                 "KEY=k4\n"
+	                 "#L2\n"
+	                 "NEW=n1\n");
+
+	sv = _svOpenFile (filename);
+	_svGetValue_check (sv, "KEY", "k4");
+	_svGetValue_check (sv, "UNSET", NULL);
+	_svGetValue_check (sv, "OTHER", "o1");
+	_svGetValue_check (sv, "NEW", "n1");
+	svCloseFile (sv);
+}
+
+/*****************************************************************************/
+
 static void
 test_write_unknown (gconstpointer test_data)
 {
@@ -9647,6 +9709,53 @@ test_utils_ignore (void)
 
 /*****************************************************************************/
 
+/* what nm_ifcfg_connection_read() does, which is not part of the
+ * reader library. */
+static gpointer
+_read_pool_read_cb (const char *filename, GError **error)
+{
+	gs_free char *unhandled = NULL;
+	NMConnection *connection;
+
+	connection = connection_from_file (filename, &unhandled, error, NULL);
+	g_assert (!unhandled);
+	return connection;
+}
+
+static void
+test_read_pool (void)
+{
+	const char *const filenames[] = {
+		TEST_IFCFG_DIR "/network-scripts/ifcfg-test-dns-options",
+		TEST_IFCFG_DIR "/network-scripts/ifcfg-test-wifi-open",
+		TEST_IFCFG_DIR "/network-scripts/ifcfg-test-permissions",
+		TEST_IFCFG_DIR "/network-scripts/ifcfg-test-bridge-main",
+		TEST_IFCFG_DIR "/network-scripts/ifcfg-test-infiniband",
+		TEST_IFCFG_DIR "/network-scripts/ifcfg-test-read-proxy-basic",
+	};
+	NMSettingsReadResult *results;
+	guint i;
+
+	/* with main.settings-read-threads=0, the plugin reads the files itself. */
+	g_assert (!nm_settings_read_pool_run (filenames, G_N_ELEMENTS (filenames), _read_pool_read_cb, 0));
+
+	/* with threads, the connections must be the same. */
+	results = nm_settings_read_pool_run (filenames, G_N_ELEMENTS (filenames), _read_pool_read_cb, 4);
+	g_assert (results);
+	for (i = 0; i < G_N_ELEMENTS (filenames); i++) {
+		gs_unref_object NMConnection *connection = NULL;
+		gs_free_error GError *error = NULL;
+
+		connection = _read_pool_read_cb (filenames[i], &error);
+		g_assert_no_error (error);
+		g_assert_no_error (results[i].error);
+		nmtst_assert_connection_equals (connection, FALSE, results[i].data, FALSE);
+	}
+	nm_settings_read_results_free (results, G_N_ELEMENTS (filenames), g_object_unref);
+}
+
+/*****************************************************************************/
+
 #define TPATH "/settings/plugins/ifcfg-rh/"
 
 #define TEST_IFCFG_WIFI_OPEN_SSID_LONG_QUOTED TEST_IFCFG_DIR"/network-scripts/ifcfg-test-wifi-open-ssid-long-quoted"
@@ -9664,6 +9773,7 @@ int main (int argc, char **argv)
 		g_error ("failure to create test directory \"%s\": %s", TEST_SCRATCH_DIR_TMP, g_strerror (errno));
 
 	g_test_add_func (TPATH "svUnescape", test_svUnescape);
+	g_test_add_func (TPATH "svDuplicateKeys", test_svDuplicateKeys);
 
 	g_test_add_data_func (TPATH "write-unknown/1", TEST_IFCFG_DIR"/network-scripts/ifcfg-test-write-unknown-1", test_write_unknown);
 	g_test_add_data_func (TPATH "write-unknown/2", TEST_IFCFG_DIR"/network-scripts/ifcfg-test-write-unknown-2", test_write_unknown);
@@ -9686,6 +9796,7 @@ int main (int argc, char **argv)
 	g_test_add_data_func (TPATH "static-ip6-only-gw/2001:db8:8:4::2", "2001:db8:8:4::2", test_write_wired_static_ip6_only_gw);
 	g_test_add_data_func (TPATH "static-ip6-only-gw/::ffff:255.255.255.255", "::ffff:255.255.255.255", test_write_wired_static_ip6_only_gw);
 	g_test_add_func (TPATH "read-dns-options", test_read_dns_options);
+	g_test_add_func (TPATH "read-pool", test_read_pool);
 	g_test_add_func (TPATH "clear-master", test_clear_master);
 
 	nmtst_add_test_func (TPATH "read-static",           test_read_wired_static, TEST_IFCFG_DIR"/network-scripts/ifcfg-test-wired-static",           "System test-wired-static",           GINT_TO_POINTER (TRUE));
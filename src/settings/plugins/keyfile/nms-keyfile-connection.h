@@ -40,4 +40,10 @@ NMSKeyfileConnection *nms_keyfile_connection_new (NMConnection *source,
                                                   const char *filename,
                                                   GError **error);
 
+NMConnection *nms_keyfile_connection_read (const char *full_path, GError **error);
+
+NMSKeyfileConnection *nms_keyfile_connection_new_from_read (NMConnection *read_connection,
+                                                            const char *full_path,
+                                                            GError **error);
+
 #endif /* __NMS_KEYFILE_CONNECTION_H__ */
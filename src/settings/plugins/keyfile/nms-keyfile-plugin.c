@@ -38,6 +38,8 @@
 #include "nm-core-internal.h"
 
 #include "settings/nm-settings-plugin.h"
+#include "settings/nm-settings-read-pool.h"
+#include "settings/nm-settings-cache.h"
 
 #include "nms-keyfile-connection.h"
 #include "nms-keyfile-writer.h"
@@ -45,9 +47,19 @@
 
 /*****************************************************************************/
 
+#define CACHE_FILE NMSTATEDIR "/keyfile-connections.cache"
+
+/*****************************************************************************/
+
 typedef struct {
 	GHashTable *connections;  /* uuid::connection */
 
+	/* Index of the connections above by their backing file. @filenames
+	 * remembers the name under which a connection was indexed, so that the
+	 * stale entry can be dropped when the connection gets renamed. */
+	GHashTable *connections_by_filename;  /* filename::connection */
+	GHashTable *filenames;                /* connection::filename */
+
 	gboolean initialized;
 	GFileMonitor *monitor;
 	gulong monitor_id;
@@ -84,10 +96,69 @@ G_DEFINE_TYPE_EXTENDED (NMSKeyfilePlugin, nms_keyfile_plugin, G_TYPE_OBJECT, 0,
 
 /*****************************************************************************/
 
+static void
+_filename_index_update (NMSKeyfilePlugin *self, NMSettingsConnection *connection)
+{
+	NMSKeyfilePluginPrivate *priv = NMS_KEYFILE_PLUGIN_GET_PRIVATE (self);
+	const char *old_filename;
+	const char *filename;
+
+	old_filename = g_hash_table_lookup (priv->filenames, connection);
+	filename = nm_settings_connection_get_filename (connection);
+	if (nm_streq0 (old_filename, filename))
+		return;
+
+	if (   old_filename
+	    && g_hash_table_lookup (priv->connections_by_filename, old_filename) == connection)
+		g_hash_table_remove (priv->connections_by_filename, old_filename);
+
+	if (filename) {
+		g_hash_table_insert (priv->connections_by_filename, g_strdup (filename), connection);
+		g_hash_table_insert (priv->filenames, connection, g_strdup (filename));
+	} else
+		g_hash_table_remove (priv->filenames, connection);
+}
+
+static void
+connection_filename_changed_cb (NMSettingsConnection *connection, GParamSpec *pspec, gpointer user_data)
+{
+	_filename_index_update (user_data, connection);
+}
+
+static void
+_filename_index_add (NMSKeyfilePlugin *self, NMSettingsConnection *connection)
+{
+	g_signal_connect (connection, "notify::" NM_SETTINGS_CONNECTION_FILENAME,
+	                  G_CALLBACK (connection_filename_changed_cb),
+	                  self);
+	_filename_index_update (self, connection);
+}
+
+static void
+_filename_index_remove (NMSKeyfilePlugin *self, NMSettingsConnection *connection)
+{
+	NMSKeyfilePluginPrivate *priv = NMS_KEYFILE_PLUGIN_GET_PRIVATE (self);
+	const char *old_filename;
+
+	g_signal_handlers_disconnect_by_func (connection, connection_filename_changed_cb, self);
+
+	old_filename = g_hash_table_lookup (priv->filenames, connection);
+	if (!old_filename)
+		return;
+	if (g_hash_table_lookup (priv->connections_by_filename, old_filename) == connection)
+		g_hash_table_remove (priv->connections_by_filename, old_filename);
+	g_hash_table_remove (priv->filenames, connection);
+}
+
+/*****************************************************************************/
+
 static void
 connection_removed_cb (NMSettingsConnection *obj, gpointer user_data)
 {
-	g_hash_table_remove (NMS_KEYFILE_PLUGIN_GET_PRIVATE ((NMSKeyfilePlugin *) user_data)->connections,
+	NMSKeyfilePlugin *self = user_data;
+
+	_filename_index_remove (self, obj);
+	g_hash_table_remove (NMS_KEYFILE_PLUGIN_GET_PRIVATE (self)->connections,
 	                     nm_connection_get_uuid (NM_CONNECTION (obj)));
 }
 
@@ -105,6 +176,7 @@ remove_connection (NMSKeyfilePlugin *self, NMSKeyfileConnection *connection)
 	/* Removing from the hash table should drop the last reference */
 	g_object_ref (connection);
 	g_signal_handlers_disconnect_by_func (connection, connection_removed_cb, self);
+	_filename_index_remove (self, NM_SETTINGS_CONNECTION (connection));
 	removed = g_hash_table_remove (NMS_KEYFILE_PLUGIN_GET_PRIVATE (self)->connections,
 	                               nm_connection_get_uuid (NM_CONNECTION (connection)));
 	nm_settings_connection_signal_remove (NM_SETTINGS_CONNECTION (connection));
@@ -117,17 +189,10 @@ static NMSKeyfileConnection *
 find_by_path (NMSKeyfilePlugin *self, const char *path)
 {
 	NMSKeyfilePluginPrivate *priv = NMS_KEYFILE_PLUGIN_GET_PRIVATE (self);
-	GHashTableIter iter;
-	NMSettingsConnection *candidate = NULL;
 
 	g_return_val_if_fail (path != NULL, NULL);
 
-	g_hash_table_iter_init (&iter, priv->connections);
-	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &candidate)) {
-		if (g_strcmp0 (path, nm_settings_connection_get_filename (candidate)) == 0)
-			return NMS_KEYFILE_CONNECTION (candidate);
-	}
-	return NULL;
+	return g_hash_table_lookup (priv->connections_by_filename, path);
 }
 
 /* update_connection:
@@ -136,6 +201,8 @@ find_by_path (NMSKeyfilePlugin *self, const char *path)
  *   and updates it. When passing @source, this adds a connection from
  *   memory.
  * @full_path: the filename of the keyfile to be loaded
+ * @read: (allow-none): the result of nms_keyfile_connection_read() for
+ *   @full_path, if the file was already read on a worker thread.
  * @connection: an existing connection that might be updated.
  *   If given, @connection must be an existing connection that is currently
  *   owned by the plugin.
@@ -165,6 +232,7 @@ static NMSKeyfileConnection *
 update_connection (NMSKeyfilePlugin *self,
                    NMConnection *source,
                    const char *full_path,
+                   const NMSettingsReadResult *read,
                    NMSKeyfileConnection *connection,
                    gboolean protect_existing_connection,
                    GHashTable *protected_connections,
@@ -182,7 +250,15 @@ update_connection (NMSKeyfilePlugin *self,
 	if (full_path)
 		_LOGD ("loading from file \"%s\"...", full_path);
 
-	connection_new = nms_keyfile_connection_new (source, full_path, &local);
+	if (read) {
+		if (read->data)
+			connection_new = nms_keyfile_connection_new_from_read (read->data, full_path, &local);
+		else {
+			connection_new = NULL;
+			local = g_error_copy (read->error);
+		}
+	} else
+		connection_new = nms_keyfile_connection_new (source, full_path, &local);
 	if (!connection_new) {
 		/* Error; remove the connection */
 		if (source)
@@ -279,6 +355,7 @@ update_connection (NMSKeyfilePlugin *self,
 		else
 			_LOGI ("new connection "NMS_KEYFILE_CONNECTION_LOG_FMT, NMS_KEYFILE_CONNECTION_LOG_ARG (connection_new));
 		g_hash_table_insert (priv->connections, g_strdup (uuid), connection_new);
+		_filename_index_add (self, NM_SETTINGS_CONNECTION (connection_new));
 
 		g_signal_connect (connection_new, NM_SETTINGS_CONNECTION_REMOVED,
 		                  G_CALLBACK (connection_removed_cb),
@@ -325,7 +402,7 @@ dir_changed (GFileMonitor *monitor,
 	case G_FILE_MONITOR_EVENT_CREATED:
 	case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
 		if (exists)
-			update_connection (NMS_KEYFILE_PLUGIN (config), NULL, full_path, connection, TRUE, NULL, NULL);
+			update_connection (NMS_KEYFILE_PLUGIN (config), NULL, full_path, NULL, connection, TRUE, NULL, NULL);
 		break;
 	default:
 		break;
@@ -411,6 +488,81 @@ _sort_paths (const char **f1, const char **f2, GHashTable *paths)
 	return strcmp (*f1, *f2);
 }
 
+/* Reads @filenames, from the cache where possible. The cache is only used
+ * on the initial load; reloading parses all files and rebuilds it.
+ *
+ * Returns: the results in the order of @filenames, or %NULL if the files
+ *   are to be read by update_connection(). */
+static NMSettingsReadResult *
+read_files (NMSKeyfilePlugin *self, const char *const*filenames, guint n_filenames)
+{
+	NMSKeyfilePluginPrivate *priv = NMS_KEYFILE_PLUGIN_GET_PRIVATE (self);
+	NMSettingsCache *cache;
+	NMSettingsReadResult *results;
+	NMSettingsReadResult *missed_results;
+	gs_free struct stat *stats = NULL;
+	gs_free gboolean *has_stats = NULL;
+	gs_free guint *missed = NULL;
+	gs_free const char **missed_filenames = NULL;
+	gs_free_error GError *error = NULL;
+	guint n_missed = 0;
+	guint i;
+
+	if (!nm_config_data_get_value_boolean (nm_config_get_data_orig (priv->config),
+	                                       NM_CONFIG_KEYFILE_GROUP_KEYFILE,
+	                                       NM_CONFIG_KEYFILE_KEY_KEYFILE_CACHE,
+	                                       FALSE)) {
+		return nm_settings_read_pool_run (filenames,
+		                                  n_filenames,
+		                                  (NMSettingsReadFunc) nms_keyfile_connection_read,
+		                                  nm_settings_read_pool_get_n_threads ());
+	}
+
+	cache = nm_settings_cache_new (CACHE_FILE, priv->initialized);
+
+	results = g_new0 (NMSettingsReadResult, n_filenames);
+	stats = g_new (struct stat, n_filenames);
+	has_stats = g_new (gboolean, n_filenames);
+	missed = g_new (guint, n_filenames);
+	missed_filenames = g_new (const char *, n_filenames);
+
+	for (i = 0; i < n_filenames; i++) {
+		has_stats[i] = (stat (filenames[i], &stats[i]) == 0);
+		if (has_stats[i])
+			results[i].data = nm_settings_cache_lookup (cache, filenames[i], &stats[i]);
+		if (!results[i].data) {
+			missed[n_missed] = i;
+			missed_filenames[n_missed] = filenames[i];
+			n_missed++;
+		}
+	}
+
+	_LOGD ("loaded %u of %u connections from the cache", n_filenames - n_missed, n_filenames);
+
+	missed_results = nm_settings_read_pool_run (missed_filenames,
+	                                            n_missed,
+	                                            (NMSettingsReadFunc) nms_keyfile_connection_read,
+	                                            nm_settings_read_pool_get_n_threads ());
+	for (i = 0; i < n_missed; i++) {
+		NMSettingsReadResult *result = &results[missed[i]];
+
+		if (missed_results)
+			*result = missed_results[i];
+		else
+			result->data = nms_keyfile_connection_read (missed_filenames[i], &result->error);
+
+		if (result->data && has_stats[missed[i]])
+			nm_settings_cache_add (cache, missed_filenames[i], &stats[missed[i]], result->data);
+	}
+	g_free (missed_results);
+
+	if (!nm_settings_cache_write (cache, &error))
+		_LOGW ("cannot write the connection cache: %s", error->message);
+	nm_settings_cache_free (cache);
+
+	return results;
+}
+
 static void
 read_connections (NMSettingsPlugin *config)
 {
@@ -426,6 +578,7 @@ read_connections (NMSettingsPlugin *config)
 	guint i;
 	GPtrArray *filenames;
 	GHashTable *paths;
+	NMSettingsReadResult *results;
 
 	dir = g_dir_open (nms_keyfile_utils_get_path (), 0, &error);
 	if (!dir) {
@@ -456,11 +609,19 @@ read_connections (NMSettingsPlugin *config)
 	g_ptr_array_sort_with_data (filenames, (GCompareDataFunc) _sort_paths, paths);
 	g_hash_table_destroy (paths);
 
+	/* Parsing the files is independent per file and can happen on worker
+	 * threads. Resolving UUID conflicts depends on the order above, so the
+	 * connections are still added one by one. */
+	results = read_files (self, (const char *const*) filenames->pdata, filenames->len);
+
 	for (i = 0; i < filenames->len; i++) {
-		connection = update_connection (self, NULL, filenames->pdata[i], NULL, FALSE, alive_connections, NULL);
+		connection = update_connection (self, NULL, filenames->pdata[i],
+		                                results ? &results[i] : NULL,
+		                                NULL, FALSE, alive_connections, NULL);
 		if (connection)
 			g_hash_table_add (alive_connections, connection);
 	}
+	nm_settings_read_results_free (results, filenames->len, g_object_unref);
 	g_ptr_array_free (filenames, TRUE);
 
 	g_hash_table_iter_init (&iter, priv->connections);
@@ -512,7 +673,7 @@ load_connection (NMSettingsPlugin *config,
 	if (nms_keyfile_utils_should_ignore_file (filename + dir_len + 1))
 		return FALSE;
 
-	connection = update_connection (self, NULL, filename, find_by_path (self, filename), TRUE, NULL, NULL);
+	connection = update_connection (self, NULL, filename, NULL, find_by_path (self, filename), TRUE, NULL, NULL);
 
 	return (connection != NULL);
 }
@@ -543,7 +704,7 @@ add_connection (NMSettingsPlugin *config,
 		                                    error))
 			return NULL;
 	}
-	return NM_SETTINGS_CONNECTION (update_connection (self, reread ?: connection, path, NULL, FALSE, NULL, error));
+	return NM_SETTINGS_CONNECTION (update_connection (self, reread ?: connection, path, NULL, NULL, FALSE, NULL, error));
 }
 
 static GSList *
@@ -590,6 +751,8 @@ nms_keyfile_plugin_init (NMSKeyfilePlugin *plugin)
 
 	priv->config = g_object_ref (nm_config_get ());
 	priv->connections = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, g_object_unref);
+	priv->connections_by_filename = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, NULL);
+	priv->filenames = g_hash_table_new_full (nm_direct_hash, NULL, NULL, g_free);
 }
 
 static void
@@ -625,9 +788,17 @@ dispose (GObject *object)
 	}
 
 	if (priv->connections) {
+		GHashTableIter iter;
+		gpointer connection;
+
+		g_hash_table_iter_init (&iter, priv->connections);
+		while (g_hash_table_iter_next (&iter, NULL, &connection))
+			g_signal_handlers_disconnect_by_func (connection, connection_filename_changed_cb, object);
 		g_hash_table_destroy (priv->connections);
 		priv->connections = NULL;
 	}
+	g_clear_pointer (&priv->connections_by_filename, g_hash_table_destroy);
+	g_clear_pointer (&priv->filenames, g_hash_table_destroy);
 
 	if (priv->config) {
 		g_signal_handlers_disconnect_by_func (priv->config, config_changed_cb, object);
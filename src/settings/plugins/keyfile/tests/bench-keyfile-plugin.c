@@ -0,0 +1,265 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager system settings service
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2018 Red Hat, Inc.
+ */
+
+/* Benchmark for the keyfile settings plugin: loads a directory with many
+ * keyfiles, then reloads every file by name like the file monitor does.
+ * This is run once with a tenth of the files and once with all of them,
+ * and fails if the cost per file grows with the number of connections.
+ * Prints one JSON document on stdout, see "tests/bench-utils.h".
+ *
+ * Run it with "make bench". */
+
+#include "nm-default.h"
+
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "nm-config.h"
+#include "nm-auth-manager.h"
+#include "settings/nm-settings-plugin.h"
+#include "settings/plugins/keyfile/nms-keyfile-plugin.h"
+
+#include "tests/bench-utils.h"
+
+/*****************************************************************************/
+
+NMTST_DEFINE ();
+
+static struct {
+	int n_keyfiles;
+} global_opt = {
+	.n_keyfiles = 50000,
+};
+
+/* The per-file cost with all files may be at most this many times the
+ * per-file cost with a tenth of them. A lookup that scans all connections
+ * would be around 10 times as expensive. */
+#define MAX_COST_RATIO 3.0
+
+/*****************************************************************************/
+
+static char *
+_keyfile_path (const char *dir, int i)
+{
+	return g_strdup_printf ("%s/bench-%d", dir, i);
+}
+
+static void
+_keyfiles_write (const char *dir, int from, int to)
+{
+	int i;
+
+	for (i = from; i < to; i++) {
+		gs_free char *data = NULL;
+		gs_free char *filename = NULL;
+		gs_free char *uuid = NULL;
+		gs_free_error GError *error = NULL;
+
+		uuid = nm_utils_uuid_generate ();
+		data = g_strdup_printf ("[connection]\n"
+		                        "id=bench-%d\n"
+		                        "uuid=%s\n"
+		                        "type=ethernet\n"
+		                        "autoconnect=false\n"
+		                        "\n"
+		                        "[ipv4]\n"
+		                        "method=auto\n"
+		                        "\n"
+		                        "[ipv6]\n"
+		                        "method=auto\n",
+		                        i,
+		                        uuid);
+		filename = _keyfile_path (dir, i);
+		if (!g_file_set_contents (filename, data, -1, &error))
+			g_error ("failure to write keyfile %s: %s", filename, error->message);
+		chmod (filename, 0600);
+	}
+}
+
+static void
+_keyfiles_remove (const char *dir, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++) {
+		gs_free char *filename = _keyfile_path (dir, i);
+
+		unlink (filename);
+	}
+	rmdir (dir);
+}
+
+/* Returns the CPU time per file of reloading all files by name. */
+static double
+bench_plugin (const char *dir, int n_keyfiles, const char *load_name, const char *reload_name)
+{
+	gs_unref_object NMSettingsPlugin *plugin = NULL;
+	GSList *connections;
+	NmtstBenchPhase phase;
+	int i;
+
+	plugin = NM_SETTINGS_PLUGIN (nms_keyfile_plugin_new ());
+
+	nmtst_bench_phase_start (&phase, load_name, n_keyfiles);
+	connections = nm_settings_plugin_get_connections (plugin);
+	nmtst_bench_phase_end (&phase);
+
+	g_assert_cmpint (g_slist_length (connections), ==, n_keyfiles);
+	g_slist_free (connections);
+
+	nmtst_bench_phase_start (&phase, reload_name, n_keyfiles);
+	for (i = 0; i < n_keyfiles; i++) {
+		gs_free char *filename = _keyfile_path (dir, i);
+
+		g_assert (nm_settings_plugin_load_connection (plugin, filename));
+	}
+	nmtst_bench_phase_end (&phase);
+
+	return (double) phase.cpu / n_keyfiles;
+}
+
+/*****************************************************************************/
+
+static NMConfig *
+_config_setup (const char *dir, const char *keyfile_dir)
+{
+	gs_free char *config_file = NULL;
+	gs_free char *config_data = NULL;
+	gs_free char *state_file = NULL;
+	gs_free_error GError *error = NULL;
+	NMConfigCmdLineOptions *cli;
+	GOptionContext *context;
+	NMConfig *config;
+	char *argv_data[] = {
+		"bench-keyfile-plugin",
+		"--config", NULL,
+		"--intern-config", "",
+		"--config-dir", "/no/such/dir",
+		"--system-config-dir", "",
+		"--state-file", NULL,
+	};
+	char **argv = argv_data;
+	int argc = G_N_ELEMENTS (argv_data);
+
+	config_file = g_build_filename (dir, "NetworkManager.conf", NULL);
+	state_file = g_build_filename (dir, "NetworkManager.state", NULL);
+	config_data = g_strdup_printf ("[main]\n"
+	                               "monitor-connection-files=false\n"
+	                               "\n"
+	                               "[keyfile]\n"
+	                               "path=%s\n",
+	                               keyfile_dir);
+	if (!g_file_set_contents (config_file, config_data, -1, &error))
+		g_error ("failure to write %s: %s", config_file, error->message);
+	argv_data[2] = config_file;
+	argv_data[10] = state_file;
+
+	cli = nm_config_cmd_line_options_new (FALSE);
+	context = g_option_context_new (NULL);
+	nm_config_cmd_line_options_add_to_entries (cli, context);
+	if (!g_option_context_parse (context, &argc, &argv, &error))
+		g_error ("invalid config options: %s", error->message);
+	g_option_context_free (context);
+
+	config = nm_config_setup (cli, NULL, &error);
+	if (!config)
+		g_error ("failure to setup config: %s", error->message);
+	nm_config_cmd_line_options_free (cli);
+	return config;
+}
+
+static void
+_config_remove (const char *dir)
+{
+	gs_free char *config_file = g_build_filename (dir, "NetworkManager.conf", NULL);
+	gs_free char *state_file = g_build_filename (dir, "NetworkManager.state", NULL);
+
+	unlink (config_file);
+	unlink (state_file);
+	rmdir (dir);
+}
+
+int
+main (int argc, char **argv)
+{
+	GOptionEntry options[] = {
+		{ "keyfiles", 0, 0, G_OPTION_ARG_INT, &global_opt.n_keyfiles, "Number of keyfiles", "N" },
+		{ 0 },
+	};
+	gs_free char *dir = NULL;
+	gs_free char *keyfile_dir = NULL;
+	gs_free_error GError *error = NULL;
+	NMConfig *config;
+	NmtstBenchPhase phase;
+	int n_small;
+	double cost_small, cost;
+
+	_nm_utils_set_testing (NM_UTILS_TEST_NO_KEYFILE_OWNER_CHECK);
+
+	if (!nmtst_bench_init (&argc, &argv,
+	                       "Benchmark loading many keyfiles with the keyfile settings plugin.",
+	                       options))
+		return 2;
+
+	if (global_opt.n_keyfiles < 10) {
+		g_warning ("Invalid arguments");
+		return 2;
+	}
+
+	dir = g_dir_make_tmp ("bench-keyfile-plugin-XXXXXX", &error);
+	if (!dir)
+		g_error ("failure to create temporary directory: %s", error->message);
+	keyfile_dir = g_build_filename (dir, "system-connections", NULL);
+	if (g_mkdir (keyfile_dir, 0700) != 0)
+		g_error ("failure to create %s", keyfile_dir);
+
+	config = _config_setup (dir, keyfile_dir);
+	nm_auth_manager_setup (FALSE);
+
+	n_small = global_opt.n_keyfiles / 10;
+
+	nmtst_bench_phase_start (&phase, "write-small", n_small);
+	_keyfiles_write (keyfile_dir, 0, n_small);
+	nmtst_bench_phase_end (&phase);
+
+	cost_small = bench_plugin (keyfile_dir, n_small, "load-small", "reload-small");
+
+	nmtst_bench_phase_start (&phase, "write", global_opt.n_keyfiles - n_small);
+	_keyfiles_write (keyfile_dir, n_small, global_opt.n_keyfiles);
+	nmtst_bench_phase_end (&phase);
+
+	cost = bench_plugin (keyfile_dir, global_opt.n_keyfiles, "load", "reload");
+
+	nmtst_bench_print ("keyfile-plugin",
+	                   "keyfiles", global_opt.n_keyfiles,
+	                   NULL);
+
+	g_object_unref (config);
+
+	_keyfiles_remove (keyfile_dir, global_opt.n_keyfiles);
+	_config_remove (dir);
+
+	if (cost > MAX_COST_RATIO * MAX (cost_small, 1.0)) {
+		g_printerr ("reloading a keyfile by name does not scale: %.1f usec with %d files, %.1f usec with %d files\n",
+		            cost, global_opt.n_keyfiles, cost_small, n_small);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -34,6 +34,8 @@
 #include "settings/plugins/keyfile/nms-keyfile-reader.h"
 #include "settings/plugins/keyfile/nms-keyfile-writer.h"
 #include "settings/plugins/keyfile/nms-keyfile-utils.h"
+#include "settings/plugins/keyfile/nms-keyfile-connection.h"
+#include "settings/nm-settings-read-pool.h"
 
 #include "nm-test-utils-core.h"
 
@@ -2765,6 +2767,50 @@ _escape_filename (const char *filename, gboolean would_be_ignored)
 		g_error ("Escaping filename \"%s\" yielded \"%s\", but this is ignored", filename, esc);
 }
 
+static void
+test_read_pool (void)
+{
+	const char *const filenames[] = {
+		TEST_KEYFILES_DIR "/Test_Wired_Connection_IP6",
+		TEST_KEYFILES_DIR "/Test_Wireless_Connection",
+		TEST_KEYFILES_DIR "/Test_String_SSID",
+		TEST_KEYFILES_DIR "/ATT_Data_Connect_BT",
+		TEST_KEYFILES_DIR "/Test_Wired_TLS_New",
+		TEST_KEYFILES_DIR "/Test_InfiniBand_Connection",
+		TEST_KEYFILES_DIR "/Test_Bridge_Main",
+		TEST_KEYFILES_DIR "/Test_Bridge_Component",
+		TEST_KEYFILES_DIR "/Test_New_Wired_Group_Name",
+		TEST_KEYFILES_DIR "/Test_New_Wireless_Group_Names",
+	};
+	NMSettingsReadResult *results;
+	guint i;
+
+	/* with main.settings-read-threads=0, the plugin reads the files itself. */
+	g_assert (!nm_settings_read_pool_run (filenames,
+	                                      G_N_ELEMENTS (filenames),
+	                                      (NMSettingsReadFunc) nms_keyfile_connection_read,
+	                                      0));
+
+	/* with threads, the connections must be the same. */
+	results = nm_settings_read_pool_run (filenames,
+	                                     G_N_ELEMENTS (filenames),
+	                                     (NMSettingsReadFunc) nms_keyfile_connection_read,
+	                                     4);
+	g_assert (results);
+	for (i = 0; i < G_N_ELEMENTS (filenames); i++) {
+		gs_unref_object NMConnection *connection = NULL;
+		gs_free_error GError *error = NULL;
+
+		connection = nms_keyfile_connection_read (filenames[i], &error);
+		g_assert_no_error (error);
+		g_assert_no_error (results[i].error);
+		nmtst_assert_connection_equals (connection, FALSE, results[i].data, FALSE);
+	}
+	nm_settings_read_results_free (results, G_N_ELEMENTS (filenames), g_object_unref);
+}
+
+/*****************************************************************************/
+
 static void
 test_nm_keyfile_plugin_utils_escape_filename (void)
 {
@@ -2871,6 +2917,8 @@ int main (int argc, char **argv)
 	g_test_add_func ("/keyfile/test_read_tc_config", test_read_tc_config);
 	g_test_add_func ("/keyfile/test_write_tc_config", test_write_tc_config);
 
+	g_test_add_func ("/keyfile/test_read_pool", test_read_pool);
+
 	g_test_add_func ("/keyfile/test_nm_keyfile_plugin_utils_escape_filename", test_nm_keyfile_plugin_utils_escape_filename);
 
 	return g_test_run ();
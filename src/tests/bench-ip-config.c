@@ -0,0 +1,201 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2018 Red Hat, Inc.
+ */
+
+/* Microbenchmark for NMIP4Config/NMIP6Config: builds configs with many
+ * routes and times nm_ip4_config_equal()/nm_ip6_config_equal() and the
+ * DNS content hash. Prints one JSON document on stdout, see
+ * "tests/bench-utils.h".
+ *
+ * Run it with "make bench". */
+
+#include "nm-default.h"
+
+#include <arpa/inet.h>
+
+#include "nm-ip4-config.h"
+#include "nm-ip6-config.h"
+#include "platform/nm-platform.h"
+
+#define NMTST_BENCH_COUNT_ALLOCATIONS
+#include "tests/bench-utils.h"
+
+/*****************************************************************************/
+
+NMTST_DEFINE ();
+
+static struct {
+	int n_routes;
+	int n_iterations;
+} global_opt = {
+	.n_routes = 1000,
+	.n_iterations = 10000,
+};
+
+/*****************************************************************************/
+
+static NMIP4Config *
+_ip4_config_build (NMDedupMultiIndex *multi_idx, guint n_routes)
+{
+	NMIP4Config *config;
+	guint i;
+
+	config = nm_ip4_config_new (multi_idx, 1);
+
+	nm_ip4_config_add_address (config, nmtst_platform_ip4_address ("192.168.1.10", NULL, 24));
+	for (i = 0; i < n_routes; i++) {
+		const NMPlatformIP4Route r = {
+			.rt_source = NM_IP_CONFIG_SOURCE_DHCP,
+			.network = htonl (0x0a000000u + (i << 8)),
+			.plen = 24,
+			.gateway = nmtst_inet4_from_string ("192.168.1.1"),
+			.metric = 100,
+		};
+
+		nm_ip4_config_add_route (config, &r, NULL);
+	}
+	nm_ip4_config_add_nameserver (config, nmtst_inet4_from_string ("192.168.1.1"));
+	nm_ip4_config_add_domain (config, "example.com");
+	nm_ip4_config_add_search (config, "example.com");
+	return config;
+}
+
+static NMIP6Config *
+_ip6_config_build (NMDedupMultiIndex *multi_idx, guint n_routes)
+{
+	NMIP6Config *config;
+	guint i;
+
+	config = nm_ip6_config_new (multi_idx, 1);
+
+	nm_ip6_config_add_address (config, nmtst_platform_ip6_address ("2001:db8::10", NULL, 64));
+	for (i = 0; i < n_routes; i++) {
+		NMPlatformIP6Route r = {
+			.rt_source = NM_IP_CONFIG_SOURCE_NDISC,
+			.plen = 64,
+			.metric = 100,
+		};
+
+		r.network = *nmtst_inet6_from_string ("2001:db8:1::");
+		r.gateway = *nmtst_inet6_from_string ("fe80::1");
+		r.network.s6_addr[4] = i >> 8;
+		r.network.s6_addr[5] = i & 0xFF;
+		nm_ip6_config_add_route (config, &r, NULL);
+	}
+	nm_ip6_config_add_nameserver (config, nmtst_inet6_from_string ("2001:db8::1"));
+	nm_ip6_config_add_domain (config, "example.com");
+	return config;
+}
+
+static void
+bench_ip4 (NMDedupMultiIndex *multi_idx)
+{
+	gs_unref_object NMIP4Config *a = NULL;
+	gs_unref_object NMIP4Config *b = NULL;
+	NmtstBenchPhase phase;
+	NMPlatformIP4Route r;
+	guint64 h = 0;
+	int i;
+
+	nmtst_bench_phase_start (&phase, "ip4-build", 2 * global_opt.n_routes);
+	a = _ip4_config_build (multi_idx, global_opt.n_routes);
+	b = _ip4_config_build (multi_idx, global_opt.n_routes);
+	nmtst_bench_phase_end (&phase);
+
+	nmtst_bench_phase_start (&phase, "ip4-equal", global_opt.n_iterations);
+	for (i = 0; i < global_opt.n_iterations; i++)
+		g_assert (nm_ip4_config_equal (a, b));
+	nmtst_bench_phase_end (&phase);
+
+	r = *nmtst_platform_ip4_route ("172.16.0.0", 16, "192.168.1.1");
+	nm_ip4_config_add_route (b, &r, NULL);
+
+	nmtst_bench_phase_start (&phase, "ip4-differ", global_opt.n_iterations);
+	for (i = 0; i < global_opt.n_iterations; i++)
+		g_assert (!nm_ip4_config_equal (a, b));
+	nmtst_bench_phase_end (&phase);
+
+	nmtst_bench_phase_start (&phase, "ip4-dns-hash", global_opt.n_iterations);
+	for (i = 0; i < global_opt.n_iterations; i++)
+		h += nm_ip4_config_get_content_hash (a, TRUE);
+	nmtst_bench_phase_end (&phase);
+	(void) h;
+}
+
+static void
+bench_ip6 (NMDedupMultiIndex *multi_idx)
+{
+	gs_unref_object NMIP6Config *a = NULL;
+	gs_unref_object NMIP6Config *b = NULL;
+	NmtstBenchPhase phase;
+	int i;
+
+	nmtst_bench_phase_start (&phase, "ip6-build", 2 * global_opt.n_routes);
+	a = _ip6_config_build (multi_idx, global_opt.n_routes);
+	b = _ip6_config_build (multi_idx, global_opt.n_routes);
+	nmtst_bench_phase_end (&phase);
+
+	nmtst_bench_phase_start (&phase, "ip6-equal", global_opt.n_iterations);
+	for (i = 0; i < global_opt.n_iterations; i++)
+		g_assert (nm_ip6_config_equal (a, b));
+	nmtst_bench_phase_end (&phase);
+
+	nm_ip6_config_add_domain (b, "example.org");
+
+	nmtst_bench_phase_start (&phase, "ip6-differ", global_opt.n_iterations);
+	for (i = 0; i < global_opt.n_iterations; i++)
+		g_assert (!nm_ip6_config_equal (a, b));
+	nmtst_bench_phase_end (&phase);
+}
+
+/*****************************************************************************/
+
+int
+main (int argc, char **argv)
+{
+	GOptionEntry options[] = {
+		{ "config-routes", 0, 0, G_OPTION_ARG_INT, &global_opt.n_routes, "Number of routes per config", "N" },
+		{ "iterations", 0, 0, G_OPTION_ARG_INT, &global_opt.n_iterations, "Number of comparisons", "I" },
+		{ 0 },
+	};
+	nm_auto_unref_dedup_multi_index NMDedupMultiIndex *multi_idx = NULL;
+
+	if (!nmtst_bench_init (&argc, &argv,
+	                       "Benchmark comparing NMIP4Config/NMIP6Config with many routes.",
+	                       options))
+		return 2;
+
+	if (   global_opt.n_routes < 0
+	    || global_opt.n_routes > 0xFFFF
+	    || global_opt.n_iterations <= 0) {
+		g_warning ("Invalid arguments");
+		return 2;
+	}
+
+	multi_idx = nm_dedup_multi_index_new ();
+
+	bench_ip4 (multi_idx);
+	bench_ip6 (multi_idx);
+
+	nmtst_bench_print ("ip-config",
+	                   "routes", global_opt.n_routes,
+	                   "iterations", global_opt.n_iterations,
+	                   NULL);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,272 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2018 Red Hat, Inc.
+ */
+
+#ifndef __NM_BENCH_UTILS_H__
+#define __NM_BENCH_UTILS_H__
+
+/* Helpers for the benchmarks that "make bench" runs. A benchmark measures
+ * one or more phases and prints them as one JSON document on stdout:
+ *
+ *   {
+ *     "benchmark": "NAME",
+ *     "PARAM": VALUE, ...
+ *     "phases": [
+ *       { "name": ..., "items": ..., "wall-usec": ..., "cpu-usec": ...,
+ *         "max-rss-kb": ..., "allocations": ..., "heap-bytes": ... }, ...
+ *     ]
+ *   }
+ *
+ * "allocations" and "heap-bytes" (the change of the allocated heap memory
+ * during the phase) are only known if the program defines
+ * NMTST_BENCH_COUNT_ALLOCATIONS before including this header, and are null
+ * otherwise. That interposes malloc() and friends of glibc, so only one
+ * source file of a program may do that.
+ *
+ * This header is meant to be included once per program, by the file that
+ * has main(). */
+
+#include <stdlib.h>
+#include <sys/resource.h>
+
+#include "nm-test-utils-core.h"
+
+/*****************************************************************************/
+
+#if defined (NMTST_BENCH_COUNT_ALLOCATIONS) && defined (__GLIBC__)
+
+#include <malloc.h>
+
+extern void *__libc_malloc (size_t size);
+extern void *__libc_calloc (size_t nmemb, size_t size);
+extern void *__libc_realloc (void *ptr, size_t size);
+extern void __libc_free (void *ptr);
+
+static gsize _nmtst_bench_n_allocs;
+static gssize _nmtst_bench_heap_bytes;
+
+void *
+malloc (size_t size)
+{
+	void *p;
+
+	_nmtst_bench_n_allocs++;
+	p = __libc_malloc (size);
+	if (p)
+		_nmtst_bench_heap_bytes += malloc_usable_size (p);
+	return p;
+}
+
+void *
+calloc (size_t nmemb, size_t size)
+{
+	void *p;
+
+	_nmtst_bench_n_allocs++;
+	p = __libc_calloc (nmemb, size);
+	if (p)
+		_nmtst_bench_heap_bytes += malloc_usable_size (p);
+	return p;
+}
+
+void *
+realloc (void *ptr, size_t size)
+{
+	gsize old_size = ptr ? malloc_usable_size (ptr) : 0;
+	void *p;
+
+	_nmtst_bench_n_allocs++;
+	p = __libc_realloc (ptr, size);
+	if (p)
+		_nmtst_bench_heap_bytes += (gssize) malloc_usable_size (p) - (gssize) old_size;
+	else if (!size)
+		_nmtst_bench_heap_bytes -= old_size;
+	return p;
+}
+
+void
+free (void *ptr)
+{
+	if (ptr)
+		_nmtst_bench_heap_bytes -= malloc_usable_size (ptr);
+	__libc_free (ptr);
+}
+
+#define NMTST_BENCH_ALLOCATIONS_SUPPORTED TRUE
+#else
+static gsize _nmtst_bench_n_allocs;
+static gssize _nmtst_bench_heap_bytes;
+#define NMTST_BENCH_ALLOCATIONS_SUPPORTED FALSE
+#endif
+
+/*****************************************************************************/
+
+typedef struct {
+	const char *name;
+	guint n_items;
+	gint64 start_wall;
+	gint64 start_cpu;
+	gsize start_allocs;
+	gssize start_heap_bytes;
+
+	/* the results, set by nmtst_bench_phase_end(). */
+	gint64 wall;
+	gint64 cpu;
+	gsize n_allocs;
+	gssize heap_bytes;
+} NmtstBenchPhase;
+
+static GString *_nmtst_bench_phases;
+
+static inline gint64
+_nmtst_bench_rusage (glong *out_max_rss)
+{
+	struct rusage ru;
+
+	getrusage (RUSAGE_SELF, &ru);
+	NM_SET_OUT (out_max_rss, ru.ru_maxrss);
+	return   ((gint64) ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * G_USEC_PER_SEC
+	       + ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+}
+
+/**
+ * nmtst_bench_init:
+ * @argc: the arguments of main()
+ * @argv: the arguments of main()
+ * @summary: the summary for --help
+ * @entries: the options of the benchmark
+ *
+ * Initializes the test utils and parses the command line. Unknown
+ * options are ignored, because "make bench" passes the same BENCH_ARGS
+ * to all benchmarks.
+ *
+ * Returns: %FALSE if the command line is invalid.
+ */
+static inline gboolean
+nmtst_bench_init (int *argc, char ***argv, const char *summary, const GOptionEntry *entries)
+{
+	GOptionContext *context;
+	gs_free_error GError *error = NULL;
+	gboolean success;
+
+	if (NMTST_BENCH_ALLOCATIONS_SUPPORTED) {
+		/* let the allocation counter see glib's slice allocations. */
+		g_setenv ("G_SLICE", "always-malloc", TRUE);
+	}
+
+	nmtst_init_with_logging (argc, argv, "WARN", "DEFAULT");
+
+	context = g_option_context_new (NULL);
+	g_option_context_set_summary (context, summary);
+	g_option_context_add_main_entries (context, entries, NULL);
+	g_option_context_set_ignore_unknown_options (context, TRUE);
+
+	success = g_option_context_parse (context, argc, argv, &error);
+	if (!success)
+		g_warning ("Error parsing command line arguments: %s", error->message);
+	g_option_context_free (context);
+
+	_nmtst_bench_phases = g_string_new (NULL);
+	return success;
+}
+
+static inline void
+nmtst_bench_phase_start (NmtstBenchPhase *phase, const char *name, guint n_items)
+{
+	*phase = (NmtstBenchPhase) {
+		.name = name,
+		.n_items = n_items,
+		.start_allocs = _nmtst_bench_n_allocs,
+		.start_heap_bytes = _nmtst_bench_heap_bytes,
+		.start_cpu = _nmtst_bench_rusage (NULL),
+		.start_wall = g_get_monotonic_time (),
+	};
+}
+
+/**
+ * nmtst_bench_phase_end:
+ * @phase: the phase started with nmtst_bench_phase_start()
+ *
+ * Records the results in @phase and adds it to the output. @phase->n_items
+ * may be changed before, if it was not known at the start.
+ */
+static inline void
+nmtst_bench_phase_end (NmtstBenchPhase *phase)
+{
+	glong max_rss;
+
+	phase->wall = g_get_monotonic_time () - phase->start_wall;
+	phase->cpu = _nmtst_bench_rusage (&max_rss) - phase->start_cpu;
+	phase->n_allocs = _nmtst_bench_n_allocs - phase->start_allocs;
+	phase->heap_bytes = _nmtst_bench_heap_bytes - phase->start_heap_bytes;
+
+	if (_nmtst_bench_phases->len)
+		g_string_append (_nmtst_bench_phases, ",\n");
+	g_string_append_printf (_nmtst_bench_phases,
+	                        "    { \"name\": \"%s\", \"items\": %u, \"wall-usec\": %"G_GINT64_FORMAT", "
+	                        "\"cpu-usec\": %"G_GINT64_FORMAT", \"max-rss-kb\": %ld, ",
+	                        phase->name,
+	                        phase->n_items,
+	                        phase->wall,
+	                        phase->cpu,
+	                        max_rss);
+	if (NMTST_BENCH_ALLOCATIONS_SUPPORTED) {
+		g_string_append_printf (_nmtst_bench_phases,
+		                        "\"allocations\": %"G_GSIZE_FORMAT", \"heap-bytes\": %"G_GSSIZE_FORMAT" }",
+		                        phase->n_allocs,
+		                        phase->heap_bytes);
+	} else
+		g_string_append (_nmtst_bench_phases, "\"allocations\": null, \"heap-bytes\": null }");
+}
+
+/**
+ * nmtst_bench_print:
+ * @benchmark: the name of the benchmark
+ * @...: pairs of a parameter name and its int value, terminated by %NULL.
+ *
+ * Prints the JSON document with all phases on stdout.
+ */
+static inline void
+nmtst_bench_print (const char *benchmark, ...)
+{
+	GString *str;
+	const char *param;
+	va_list ap;
+
+	str = g_string_new (NULL);
+	g_string_append_printf (str, "{\n  \"benchmark\": \"%s\",\n", benchmark);
+
+	va_start (ap, benchmark);
+	while ((param = va_arg (ap, const char *)))
+		g_string_append_printf (str, "  \"%s\": %d,\n", param, va_arg (ap, int));
+	va_end (ap);
+
+	g_string_append_printf (str,
+	                        "  \"phases\": [\n"
+	                        "%s\n"
+	                        "  ]\n"
+	                        "}\n",
+	                        _nmtst_bench_phases->str);
+	g_print ("%s", str->str);
+	g_string_free (str, TRUE);
+
+	g_string_truncate (_nmtst_bench_phases, 0);
+}
+
+#endif /* __NM_BENCH_UTILS_H__ */
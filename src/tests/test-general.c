@@ -22,12 +22,16 @@
 
 #include <string.h>
 #include <errno.h>
+#include <unistd.h>
 
 /* need math.h for isinf() and INFINITY. No need to link with -lm */
 #include <math.h>
 
 #include "NetworkManagerUtils.h"
 #include "nm-core-internal.h"
+#include "settings/nm-settings-db.h"
+#include "settings/nm-settings-read-pool.h"
+#include "settings/nm-settings-cache.h"
 
 #include "nm-test-utils-core.h"
 
@@ -1729,6 +1733,218 @@ test_nm_utils_exp10 (void)
 
 /*****************************************************************************/
 
+static void
+test_settings_db (void)
+{
+	gs_free char *dir = NULL;
+	gs_free char *filename = NULL;
+	gs_free char *log_filename = NULL;
+	gs_free char *log_filename_old = NULL;
+	gs_unref_keyfile GKeyFile *keyfile = NULL;
+	gs_strfreev char **list = NULL;
+	gs_free char *value = NULL;
+	const char *const bssids[] = { "00:11:22:33:44:55", "66:77:88:99:aa:bb" };
+	NMSettingsDB *db, *db2;
+	gsize len;
+
+	dir = g_dir_make_tmp ("nm-test-settings-db-XXXXXX", NULL);
+	g_assert (dir);
+	filename = g_build_filename (dir, "db", NULL);
+	log_filename = g_build_filename (dir, "db.log", NULL);
+	log_filename_old = g_strdup_printf ("%s.old", log_filename);
+
+	/* without a log, the changes are written on flush. */
+	db = nm_settings_db_new (filename, "group", ',', NULL, 5);
+	g_assert (!nm_settings_db_get_value (db, "uuid-a"));
+	nm_settings_db_set_value (db, "uuid-a", "100");
+	nm_settings_db_set_string_list (db, "uuid-b", bssids, G_N_ELEMENTS (bssids));
+	g_assert (!g_file_test (filename, G_FILE_TEST_EXISTS));
+	nm_settings_db_free (db);
+
+	keyfile = g_key_file_new ();
+	g_key_file_set_list_separator (keyfile, ',');
+	g_assert (g_key_file_load_from_file (keyfile, filename, G_KEY_FILE_NONE, NULL));
+	value = g_key_file_get_value (keyfile, "group", "uuid-a", NULL);
+	g_assert_cmpstr (value, ==, "100");
+	list = g_key_file_get_string_list (keyfile, "group", "uuid-b", &len, NULL);
+	g_assert_cmpint (len, ==, 2);
+	g_assert_cmpstr (list[0], ==, bssids[0]);
+	g_assert_cmpstr (list[1], ==, bssids[1]);
+	nm_clear_g_free (&value);
+	g_clear_pointer (&list, g_strfreev);
+
+	/* with a log, a second instance sees the changes before the keyfile
+	 * is written. */
+	db = nm_settings_db_new (filename, "group", ',', log_filename, 5);
+	nm_settings_db_set_value (db, "uuid-a", "200");
+	nm_settings_db_remove (db, "uuid-b");
+	g_assert (g_file_test (log_filename, G_FILE_TEST_EXISTS));
+
+	db2 = nm_settings_db_new (filename, "group", ',', log_filename, 5);
+	g_assert_cmpstr (nm_settings_db_get_value (db2, "uuid-a"), ==, "200");
+	g_assert (!nm_settings_db_get_value (db2, "uuid-b"));
+	list = nm_settings_db_get_string_list (db2, "uuid-b", &len);
+	g_assert (!list);
+	g_assert_cmpint (len, ==, 0);
+	nm_settings_db_free (db2);
+	nm_settings_db_free (db);
+
+	/* after the keyfile is written, the log is gone. */
+	g_assert (!g_file_test (log_filename, G_FILE_TEST_EXISTS));
+	g_assert (!g_file_test (log_filename_old, G_FILE_TEST_EXISTS));
+	db = nm_settings_db_new (filename, "group", ',', NULL, 5);
+	g_assert_cmpstr (nm_settings_db_get_value (db, "uuid-a"), ==, "200");
+	nm_settings_db_free (db);
+
+	/* other groups and comments in the file are kept. */
+	g_assert (g_file_set_contents (filename,
+	                               "# comment\n"
+	                               "[group]\n"
+	                               "uuid-a=300\n"
+	                               "\n"
+	                               "[other]\n"
+	                               "key=value\n",
+	                               -1, NULL));
+	db = nm_settings_db_new (filename, "group", ',', NULL, 5);
+	nm_settings_db_set_value (db, "uuid-c", "400");
+	nm_settings_db_free (db);
+
+	g_assert (g_key_file_load_from_file (keyfile, filename, G_KEY_FILE_KEEP_COMMENTS, NULL));
+	value = g_key_file_get_value (keyfile, "group", "uuid-a", NULL);
+	g_assert_cmpstr (value, ==, "300");
+	nm_clear_g_free (&value);
+	value = g_key_file_get_value (keyfile, "group", "uuid-c", NULL);
+	g_assert_cmpstr (value, ==, "400");
+	nm_clear_g_free (&value);
+	value = g_key_file_get_value (keyfile, "other", "key", NULL);
+	g_assert_cmpstr (value, ==, "value");
+	nm_clear_g_free (&value);
+	value = g_key_file_get_comment (keyfile, NULL, NULL, NULL);
+	g_assert (value && strstr (value, "comment"));
+	nm_clear_g_free (&value);
+
+	unlink (filename);
+	rmdir (dir);
+}
+
+/*****************************************************************************/
+
+static gpointer
+_settings_read_cb (const char *filename, GError **error)
+{
+	if (g_str_has_suffix (filename, "0")) {
+		g_set_error (error, NM_SETTINGS_ERROR, NM_SETTINGS_ERROR_INVALID_CONNECTION,
+		             "cannot read %s", filename);
+		return NULL;
+	}
+	return g_strdup_printf ("read:%s", filename);
+}
+
+static void
+test_settings_read_pool (void)
+{
+	gs_unref_ptrarray GPtrArray *filenames = g_ptr_array_new_with_free_func (g_free);
+	NMSettingsReadResult *results;
+	guint i;
+
+	for (i = 0; i < 200; i++)
+		g_ptr_array_add (filenames, g_strdup_printf ("/no/such/dir/file-%u", i));
+
+	/* with one thread, the caller reads the files itself. */
+	results = nm_settings_read_pool_run ((const char *const*) filenames->pdata,
+	                                     filenames->len,
+	                                     _settings_read_cb,
+	                                     1);
+	g_assert (!results);
+
+	results = nm_settings_read_pool_run ((const char *const*) filenames->pdata,
+	                                     filenames->len,
+	                                     _settings_read_cb,
+	                                     4);
+	g_assert (results);
+	for (i = 0; i < filenames->len; i++) {
+		const char *filename = filenames->pdata[i];
+
+		if (i % 10 == 0) {
+			g_assert (!results[i].data);
+			g_assert_error (results[i].error, NM_SETTINGS_ERROR, NM_SETTINGS_ERROR_INVALID_CONNECTION);
+			g_assert (strstr (results[i].error->message, filename));
+		} else {
+			gs_free char *expected = g_strdup_printf ("read:%s", filename);
+
+			g_assert_no_error (results[i].error);
+			g_assert_cmpstr (results[i].data, ==, expected);
+		}
+	}
+	nm_settings_read_results_free (results, filenames->len, g_free);
+}
+
+/*****************************************************************************/
+
+static void
+test_settings_cache (void)
+{
+	gs_free char *dir = NULL;
+	gs_free char *filename = NULL;
+	gs_free char *profile = NULL;
+	gs_unref_object NMConnection *connection = NULL;
+	gs_unref_object NMConnection *cached = NULL;
+	NMSettingsCache *cache;
+	struct stat st, st_changed;
+
+	dir = g_dir_make_tmp ("nm-test-settings-cache-XXXXXX", NULL);
+	g_assert (dir);
+	filename = g_build_filename (dir, "cache", NULL);
+	profile = g_build_filename (dir, "profile", NULL);
+
+	g_assert (g_file_set_contents (profile, "[connection]\n", -1, NULL));
+	g_assert (stat (profile, &st) == 0);
+
+	connection = nmtst_create_minimal_connection ("cache-1", NULL, NM_SETTING_WIRED_SETTING_NAME, NULL);
+	nmtst_connection_normalize (connection);
+
+	/* a missing file is an empty cache. */
+	cache = nm_settings_cache_new (filename, FALSE);
+	g_assert (!nm_settings_cache_lookup (cache, profile, &st));
+	nm_settings_cache_add (cache, profile, &st, connection);
+	g_assert (nm_settings_cache_write (cache, NULL));
+	nm_settings_cache_free (cache);
+	g_assert (g_file_test (filename, G_FILE_TEST_EXISTS));
+
+	cache = nm_settings_cache_new (filename, FALSE);
+	cached = nm_settings_cache_lookup (cache, profile, &st);
+	g_assert (cached);
+	g_assert (nm_connection_compare (cached, connection, NM_SETTING_COMPARE_FLAG_EXACT));
+
+	/* a changed file is not taken from the cache. */
+	st_changed = st;
+	st_changed.st_size++;
+	g_assert (!nm_settings_cache_lookup (cache, profile, &st_changed));
+	st_changed = st;
+	st_changed.st_ctim.tv_nsec = (st_changed.st_ctim.tv_nsec + 1) % NM_UTILS_NS_PER_SECOND;
+	g_assert (!nm_settings_cache_lookup (cache, profile, &st_changed));
+	g_assert (!nm_settings_cache_lookup (cache, "/no/such/file", &st));
+	g_assert (nm_settings_cache_write (cache, NULL));
+	nm_settings_cache_free (cache);
+
+	/* rebuilding ignores the file, and writing drops all entries that
+	 * were not added again. */
+	cache = nm_settings_cache_new (filename, TRUE);
+	g_assert (!nm_settings_cache_lookup (cache, profile, &st));
+	g_assert (nm_settings_cache_write (cache, NULL));
+	nm_settings_cache_free (cache);
+
+	cache = nm_settings_cache_new (filename, FALSE);
+	g_assert (!nm_settings_cache_lookup (cache, profile, &st));
+	nm_settings_cache_free (cache);
+
+	unlink (profile);
+	unlink (filename);
+	rmdir (dir);
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE ();
 
 int
@@ -1773,6 +1989,10 @@ main (int argc, char **argv)
 	g_test_add_func ("/general/stable-id/parse", test_stable_id_parse);
 	g_test_add_func ("/general/stable-id/generated-complete", test_stable_id_generated_complete);
 
+	g_test_add_func ("/general/settings-db", test_settings_db);
+	g_test_add_func ("/general/settings-read-pool", test_settings_read_pool);
+	g_test_add_func ("/general/settings-cache", test_settings_cache);
+
 	return g_test_run ();
 }
 
@@ -328,6 +328,146 @@ test_strip_search_trailing_dot (void)
 	g_object_unref (config);
 }
 
+static void
+test_content_hash (void)
+{
+	gs_unref_object NMIP4Config *a = NULL;
+	gs_unref_object NMIP4Config *b = NULL;
+	NMPlatformIP4Route route;
+	guint64 hash_dns;
+
+	a = build_test_config ();
+	b = build_test_config ();
+
+	g_assert_cmpuint (nm_ip4_config_get_content_hash (a, FALSE), ==, nm_ip4_config_get_content_hash (b, FALSE));
+	g_assert (nm_ip4_config_equal (a, b));
+
+	/* adding a route changes the hash, but not the DNS hash. */
+	hash_dns = nm_ip4_config_get_content_hash (b, TRUE);
+	route = *nmtst_platform_ip4_route ("10.1.0.0", 16, "192.168.1.1");
+	nm_ip4_config_add_route (b, &route, NULL);
+	g_assert_cmpuint (nm_ip4_config_get_content_hash (a, FALSE), !=, nm_ip4_config_get_content_hash (b, FALSE));
+	g_assert_cmpuint (nm_ip4_config_get_content_hash (b, TRUE), ==, hash_dns);
+	g_assert (!nm_ip4_config_equal (a, b));
+
+	/* ... and removing it restores it. */
+	_nmtst_ip4_config_del_route (b, nm_ip4_config_get_num_routes (b) - 1);
+	g_assert_cmpuint (nm_ip4_config_get_content_hash (a, FALSE), ==, nm_ip4_config_get_content_hash (b, FALSE));
+	g_assert (nm_ip4_config_equal (a, b));
+
+	/* the order of nameservers matters. */
+	nm_ip4_config_del_nameserver (b, 0);
+	g_assert_cmpuint (nm_ip4_config_get_content_hash (b, TRUE), !=, hash_dns);
+	nm_ip4_config_add_nameserver (b, nmtst_inet4_from_string ("4.2.2.1"));
+	g_assert_cmpuint (nm_ip4_config_get_content_hash (b, TRUE), !=, hash_dns);
+	g_assert (!nm_ip4_config_equal (a, b));
+
+	nm_ip4_config_reset_nameservers (b);
+	nm_ip4_config_add_nameserver (b, nmtst_inet4_from_string ("4.2.2.1"));
+	nm_ip4_config_add_nameserver (b, nmtst_inet4_from_string ("4.2.2.2"));
+	g_assert_cmpuint (nm_ip4_config_get_content_hash (b, TRUE), ==, hash_dns);
+	g_assert (nm_ip4_config_equal (a, b));
+
+	nm_ip4_config_set_nis_domain (b, "example.com");
+	g_assert (!nm_ip4_config_equal (a, b));
+	nm_ip4_config_set_nis_domain (b, NULL);
+	g_assert (nm_ip4_config_equal (a, b));
+
+	/* replace() and subtract() keep the hash in sync. */
+	nm_ip4_config_reset_routes (b);
+	nm_ip4_config_reset_domains (b);
+	g_assert (!nm_ip4_config_equal (a, b));
+	nm_ip4_config_replace (b, a, NULL);
+	g_assert_cmpuint (nm_ip4_config_get_content_hash (a, FALSE), ==, nm_ip4_config_get_content_hash (b, FALSE));
+	g_assert (nm_ip4_config_equal (a, b));
+
+	nm_ip4_config_subtract (b, a, 0);
+	g_assert_cmpuint (nm_ip4_config_get_num_routes (b), ==, 0);
+	g_assert_cmpuint (nm_ip4_config_get_num_addresses (b), ==, 0);
+	g_assert (!nm_ip4_config_equal (a, b));
+
+	g_assert (nm_ip4_config_equal (NULL, NULL));
+	g_assert (!nm_ip4_config_equal (a, NULL));
+}
+
+static void
+test_version (void)
+{
+	gs_unref_object NMIP4Config *a = NULL;
+	gs_unref_object NMIP4Config *b = NULL;
+	NMPlatformIP4Route route;
+	guint64 version;
+
+	a = build_test_config ();
+	b = build_test_config ();
+
+	/* versions are unique, even for equal configs. */
+	g_assert_cmpuint (nm_ip4_config_get_version (a), !=, nm_ip4_config_get_version (b));
+
+	version = nm_ip4_config_get_version (b);
+	route = *nmtst_platform_ip4_route ("10.1.0.0", 16, "192.168.1.1");
+	nm_ip4_config_add_route (b, &route, NULL);
+	g_assert_cmpuint (nm_ip4_config_get_version (b), >, version);
+
+	version = nm_ip4_config_get_version (b);
+	nm_ip4_config_add_nameserver (b, nmtst_inet4_from_string ("4.2.2.1"));
+	g_assert_cmpuint (nm_ip4_config_get_version (b), ==, version);
+	nm_ip4_config_set_mtu (b, 1400, NM_IP_CONFIG_SOURCE_USER);
+	g_assert_cmpuint (nm_ip4_config_get_version (b), >, version);
+
+	version = nm_ip4_config_get_version (a);
+	nm_ip4_config_replace (a, b, NULL);
+	g_assert_cmpuint (nm_ip4_config_get_version (a), >, version);
+
+	/* replacing with an identical config leaves the version alone. */
+	version = nm_ip4_config_get_version (a);
+	nm_ip4_config_replace (a, b, NULL);
+	g_assert_cmpuint (nm_ip4_config_get_version (a), ==, version);
+}
+
+static void
+_assert_route_data_slice (GVariant *route_data, guint32 offset, guint32 limit, gsize expected_len)
+{
+	gs_unref_variant GVariant *reply = NULL;
+	gs_unref_variant GVariant *routes = NULL;
+	guint32 total;
+
+	reply = g_variant_ref_sink (_nm_ip_config_route_data_slice (route_data, offset, limit));
+	g_variant_get (reply, "(@aa{sv}u)", &routes, &total);
+	g_assert_cmpuint (total, ==, g_variant_n_children (route_data));
+	g_assert_cmpuint (g_variant_n_children (routes), ==, expected_len);
+}
+
+static void
+test_route_data_slice (void)
+{
+	gs_unref_object NMIP4Config *config = NULL;
+	gs_unref_variant GVariant *route_data = NULL;
+	gs_unref_variant GVariant *route_data2 = NULL;
+	gs_unref_variant GVariant *child = NULL;
+	gs_unref_variant GVariant *child2 = NULL;
+	NMPlatformIP4Route route;
+
+	config = build_test_config ();
+	g_object_get (config, NM_IP4_CONFIG_ROUTE_DATA, &route_data, NULL);
+	g_assert_cmpuint (g_variant_n_children (route_data), ==, 3);
+
+	_assert_route_data_slice (route_data, 0, 0, 3);
+	_assert_route_data_slice (route_data, 0, 1, 1);
+	_assert_route_data_slice (route_data, 1, 5, 2);
+	_assert_route_data_slice (route_data, 3, 0, 0);
+	_assert_route_data_slice (route_data, 10, 1, 0);
+
+	/* unchanged routes keep their cached representation. */
+	route = *nmtst_platform_ip4_route ("10.1.0.0", 16, "192.168.1.1");
+	nm_ip4_config_add_route (config, &route, NULL);
+	g_object_get (config, NM_IP4_CONFIG_ROUTE_DATA, &route_data2, NULL);
+	g_assert_cmpuint (g_variant_n_children (route_data2), ==, 4);
+	child = g_variant_get_child_value (route_data, 0);
+	child2 = g_variant_get_child_value (route_data2, 0);
+	g_assert (g_variant_equal (child, child2));
+}
+
 /*****************************************************************************/
 
 NMTST_DEFINE ();
@@ -343,6 +483,9 @@ main (int argc, char **argv)
 	g_test_add_func ("/ip4-config/add-route-with-source", test_add_route_with_source);
 	g_test_add_func ("/ip4-config/merge-subtract-mtu", test_merge_subtract_mtu);
 	g_test_add_func ("/ip4-config/strip-search-trailing-dot", test_strip_search_trailing_dot);
+	g_test_add_func ("/ip4-config/content-hash", test_content_hash);
+	g_test_add_func ("/ip4-config/route-data-slice", test_route_data_slice);
+	g_test_add_func ("/ip4-config/version", test_version);
 
 	return g_test_run ();
 }